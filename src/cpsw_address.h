@@ -24,11 +24,15 @@ class   CDevImpl;
 class   CAddressImpl;
 class   CompositePathIterator;
 class   IAddress;
+class   CShadowCache;
+class   IReadHook;
+class   IWriteHook;
 
 typedef shared_ptr<CDevImpl> DevImpl;
 typedef weak_ptr<CDevImpl>   WDevImpl;
 typedef shared_ptr<IAddress> Address;
 typedef shared_ptr<CAddressImpl> AddressImpl;
+typedef shared_ptr<CShadowCache> ShadowCacheImpl;
 
 class CReadArgs {
 public:
@@ -38,16 +42,30 @@ public:
 	uint64_t          off_;
 	CTimeout          timeout_;
 	AsyncIO           aio_;
+	IReadHook        *hook_;
 	CReadArgs()
 	: cacheable_ ( IField::UNKNOWN_CACHEABLE ),
 	  dst_       ( NULL ),
 	  nbytes_    ( 0 ),
 	  off_       ( 0 ),
-	  timeout_   ( TIMEOUT_INDEFINITE )
+	  timeout_   ( TIMEOUT_INDEFINITE ),
+	  hook_      ( NULL )
 	{
 	}
 };
 
+// If a hook is passed in CReadArgs then it is executed
+// instead of the transport's 'read(CReadArgs*)' method,
+// i.e., the hook sees the transport and the offset/size
+// of every elementary read operation. The hook must
+// fill 'dst_' (synchronously) and return the number
+// of bytes 'read'.
+class IReadHook {
+public:
+	virtual uint64_t read(const CAddressImpl *xprt, CReadArgs *args) = 0;
+	virtual ~IReadHook() {}
+};
+
 class CWriteArgs {
 public:
 	IField::Cacheable cacheable_;
@@ -57,6 +75,8 @@ public:
 	uint8_t           msk1_;
 	uint8_t           mskn_;
 	CTimeout          timeout_;
+	AsyncIO           aio_;
+	IWriteHook       *hook_;
 	CWriteArgs()
 	: cacheable_ ( IField::UNKNOWN_CACHEABLE ),
 	  src_       ( NULL ),
@@ -64,11 +84,21 @@ public:
 	  nbytes_    ( 0 ),
 	  msk1_      ( 0 ),
 	  mskn_      ( 0 ),
-	  timeout_   ( TIMEOUT_INDEFINITE )
+	  timeout_   ( TIMEOUT_INDEFINITE ),
+	  hook_      ( NULL )
 	{
 	}
 };
 
+// Same as IReadHook, for writes; the hook must consume
+// 'src_' (synchronously) and return the number of bytes
+// 'written'.
+class IWriteHook {
+public:
+	virtual uint64_t write(const CAddressImpl *xprt, CWriteArgs *args) = 0;
+	virtual ~IWriteHook() {}
+};
+
 
 class IAddress : public IChild {
 	public:
@@ -181,6 +211,10 @@ class CAddressImpl : public IAddress {
 
 		virtual unsigned getAlignment() const { return 1; }
 
+		// transports which maintain a shadow copy of the
+		// device registers return it here
+		virtual ShadowCacheImpl getShadowCache() const { return ShadowCacheImpl(); }
+
 		virtual int      incOpen();
 		virtual int      open (CompositePathIterator *);
 		virtual int      decOpen();
@@ -171,6 +171,18 @@ public:
 	const static int NORT_THREAD_PRIORITY =  0;
 	const static int   NO_THREAD_PRIORITY = -1; /* no thread in module */
 
+	// Note: 'RunToCompletion' lets a module process its input on the thread
+	//       of the module below it (e.g., the UDP RX thread) rather than
+	//       using a thread and input queue of its own. This saves context
+	//       switches on the receive path. It is ignored if the module below
+	//       does not support inline delivery (RSSI) and for the V2 TDEST
+	//       demultiplexer.
+	// Note: 'SRPBusyPollUS' lets a thread waiting for a synchronous SRP reply
+	//       spin for up to that many microseconds before blocking. With UDP
+	//       and no RSSI/TDEST demultiplexer the spinning thread receives from
+	//       the socket itself (SO_BUSY_POLL, if permitted) and processes the
+	//       reply inline; the SRP VC demultiplexer is then run-to-completion.
+	//       This trades a CPU (which is kept busy) for latency.
 	// Note: most of the parameters configured into a ProtoStackBuilder object are
 	//       only used if the associated protocol module is not already present
 	//       and they are ignored otherwise.
@@ -185,6 +197,16 @@ public:
 	virtual bool               hasSRPDynTimeout()                  = 0; // dynamically adjusted timeout (based on RTT)
 	virtual void               setSRPRetryCount(unsigned)          = 0; // default: 10
 	virtual unsigned           getSRPRetryCount()                  = 0;
+	virtual void               setSRPMaxOutstanding(unsigned)      = 0; // default: 1 (synchronous transactions are serialized)
+	virtual unsigned           getSRPMaxOutstanding()              = 0;
+	virtual void               setSRPPipelineDepth(unsigned)       = 0; // default: 4 (chunks of a large transfer in flight)
+	virtual unsigned           getSRPPipelineDepth()               = 0;
+	virtual void               useSRPShadowCache(bool)             = 0; // default: NO (see IShadowCache)
+	virtual bool               hasSRPShadowCache()                 = 0;
+	virtual void               setSRPHedgeBudget(unsigned)         = 0; // default: 0 (off); max. percentage of reads re-issued speculatively
+	virtual unsigned           getSRPHedgeBudget()                 = 0;
+	virtual void               setSRPBusyPollUS(uint64_t)          = 0; // default: 0 (off); spin this long for a sync. reply before blocking (see below)
+	virtual uint64_t           getSRPBusyPollUS()                  = 0;
 
 	virtual void               setSRPDefaultWriteMode(WriteMode)   = 0; // default: POSTED
 	virtual WriteMode          getSRPDefaultWriteMode()            = 0;
@@ -196,6 +218,8 @@ public:
 	virtual unsigned           getTcpOutQueueDepth()               = 0;
 	virtual void               setTcpThreadPriority(int)           = 0;
 	virtual int                getTcpThreadPriority()              = 0;
+	virtual void               setTcpIOUring(bool)                 = 0; // default: NO (receive with io_uring if available)
+	virtual bool               getTcpIOUring()                     = 0;
 
 	virtual bool               hasUdp()                            = 0; // default: YES
 	virtual void               setUdpPort(unsigned)                = 0; // default: 8192
@@ -204,6 +228,20 @@ public:
 	virtual unsigned           getUdpOutQueueDepth()               = 0;
 	virtual void               setUdpNumRxThreads(unsigned)        = 0; // default: 1
 	virtual unsigned           getUdpNumRxThreads()                = 0;
+	virtual void               setUdpRxBatchSize(unsigned)         = 0; // default: 1 (max. datagrams per receive syscall)
+	virtual unsigned           getUdpRxBatchSize()                 = 0;
+	virtual void               setUdpTxBatchSize(unsigned)         = 0; // default: 1 (max. datagrams per send syscall)
+	virtual unsigned           getUdpTxBatchSize()                 = 0;
+	virtual void               setUdpTxBatchUS(unsigned)           = 0; // default: 0 (never delay a datagram)
+	virtual unsigned           getUdpTxBatchUS()                   = 0;
+	virtual void               setUdpSegmentOffload(bool)          = 0; // default: NO (GSO on TX, GRO on RX)
+	virtual bool               getUdpSegmentOffload()              = 0;
+	virtual void               setUdpIOPool(bool)                  = 0; // default: NO (serve RX and poller by the shared I/O pool)
+	virtual bool               getUdpIOPool()                      = 0;
+	virtual void               setUdpIOUring(bool)                 = 0; // default: NO (use io_uring for RX and TX batches if available)
+	virtual bool               getUdpIOUring()                     = 0;
+	virtual void               setUdpShardedRx(bool)               = 0; // default: NO (RX threads own sockets/ports; SRP VCs pick the shard)
+	virtual bool               getUdpShardedRx()                   = 0;
 	virtual void               setUdpPollSecs(int)                 = 0; // default: NO if SRP w/o TDEST or RSSI, 60s if no SRP
 	virtual int                getUdpPollSecs()                    = 0;
 	virtual void               setUdpThreadPriority(int)           = 0;
@@ -227,6 +265,8 @@ public:
 	virtual unsigned           getDepackLdFragWinSize()            = 0;
 	virtual void               setDepackThreadPriority(int)        = 0;
 	virtual int                getDepackThreadPriority()           = 0;
+	virtual void               setDepackRunToCompletion(bool)      = 0; // default: NO (see below)
+	virtual bool               getDepackRunToCompletion()          = 0;
 
 	virtual void               useSRPMux(bool)                     = 0; // default: YES if SRP, NO if no SRP
 	virtual bool               hasSRPMux()                         = 0;
@@ -236,6 +276,8 @@ public:
 	virtual unsigned           getSRPMuxOutQueueDepth()            = 0;
 	virtual void               setSRPMuxThreadPriority(int)        = 0;
 	virtual int                getSRPMuxThreadPriority()           = 0;
+	virtual void               setSRPMuxRunToCompletion(bool)      = 0; // default: NO (see below)
+	virtual bool               getSRPMuxRunToCompletion()          = 0;
 
 	virtual void               useTDestMux(bool)                   = 0; // default: NO
 	virtual bool               hasTDestMux()                       = 0;
@@ -249,6 +291,8 @@ public:
 	virtual unsigned           getTDestMuxInpQueueDepth()          = 0;
 	virtual void               setTDestMuxThreadPriority(int)      = 0;
 	virtual int                getTDestMuxThreadPriority()         = 0;
+	virtual void               setTDestMuxRunToCompletion(bool)    = 0; // default: NO (see below)
+	virtual bool               getTDestMuxRunToCompletion()        = 0;
 
 	virtual void               setIPAddr(uint32_t)                 = 0;
 	virtual uint32_t           getIPAddr()                         = 0;
@@ -315,6 +359,18 @@ public:
 	virtual const char *getSocksProxyString() const = 0;
 	virtual const char *getRssiBridgeString() const = 0;
 
+	// Serve the UDP sockets of all protocol stacks created by
+	// this device (after this call) by the process-wide I/O pool
+	// instead of dedicated threads.
+	virtual void        useIOPool(bool)             = 0; // default: NO
+	virtual bool        hasIOPool()           const = 0;
+
+	// Number of workers of the process-wide I/O pool; must be set
+	// before the pool is first used. Zero (default) picks the number
+	// of online CPUs (unless overridden by the env-var CPSW_IO_POOL_SIZE).
+	static void         setIOPoolSize(unsigned);
+	static unsigned     getIOPoolSize();
+
 	static NetIODev create(const char *name, const char *ipaddr);
 };
 
@@ -311,16 +311,34 @@ public:
 	 * This helps creating a configuration file for the first
 	 * time.
 	 *
+	 * If 'prefetch' is 'true' then the hierarchy is traversed
+	 * twice: all values are first read asynchronously (with many
+	 * requests outstanding) and the YAML nodes are then created
+	 * (in the same order as without 'prefetch') from the values
+	 * read. Values which fail to be read asynchronously are
+	 * read again (synchronously) during the second pass.
+	 *
 	 * RETURNS: number of entries saved/loaded
 	 */
-	virtual uint64_t    dumpConfigToYaml (YAML::Node   &tmplt)   const = 0;
-	virtual uint64_t    loadConfigFromYaml(YAML::Node  &config)  const = 0;
+	virtual uint64_t    dumpConfigToYaml (YAML::Node   &tmplt, bool prefetch = false) const = 0;
+	/*!
+	 * If 'posted' is 'true' then values of entries with equal 'configPrio'
+	 * (which are adjacent in the configuration) are written asynchronously;
+	 * the method waits for all outstanding writes whenever the priority
+	 * changes and before returning. Failed writes are reported together
+	 * (by a single IOError which lists their paths and YAML marks).
+	 * Entries which cannot be written asynchronously (e.g., commands)
+	 * are executed synchronously once all previous writes have completed.
+	 * NOTE: asynchronous SRP transactions are not retried, i.e., on a
+	 *       lossy link (without RSSI) a lost reply results in an error.
+	 */
+	virtual uint64_t    loadConfigFromYaml(YAML::Node  &config, bool posted = false)  const = 0;
 	/*!
 	 * This helper routine runs the file through CPSW's YAML preprocessor;
 	 * i.e. configurations loaded with this routine may use #include, #once
 	 * etc.
 	 */
-	virtual uint64_t    loadConfigFromYamlFile(const char* filename, const char *incdir = 0) const = 0;
+	virtual uint64_t    loadConfigFromYamlFile(const char* filename, const char *incdir = 0, bool posted = false) const = 0;
 
 	// create a path
 	static  Path        create();             // absolute; starting at root
@@ -731,6 +749,18 @@ public:
 	virtual unsigned setVal(uint32_t    *p, unsigned nelms = 1, IndexRange *range = 0) = 0;
 	virtual unsigned setVal(uint16_t    *p, unsigned nelms = 1, IndexRange *range = 0) = 0;
 	virtual unsigned setVal(uint8_t     *p, unsigned nelms = 1, IndexRange *range = 0) = 0;
+	/*!
+	 * Asynchronous write; the values are consumed (copied or transmitted) before
+	 * 'setVal' returns, i.e., the caller may reuse the buffer immediately.
+	 * The 'aio' callback is executed once the target has acknowledged the
+	 * write (or once it failed or timed out). Note that the callback may be
+	 * executed from the context of the caller if the underlying transport
+	 * is synchronous.
+	 */
+	virtual unsigned setVal(AsyncIO aio, uint64_t *p, unsigned nelms = 1, IndexRange *range = 0) = 0;
+	virtual unsigned setVal(AsyncIO aio, uint32_t *p, unsigned nelms = 1, IndexRange *range = 0) = 0;
+	virtual unsigned setVal(AsyncIO aio, uint16_t *p, unsigned nelms = 1, IndexRange *range = 0) = 0;
+	virtual unsigned setVal(AsyncIO aio, uint8_t  *p, unsigned nelms = 1, IndexRange *range = 0) = 0;
 	/*!
 	 * If the underlying element has an Enum menu attached then writing strings
 	 * to the interface will cause these to be mapped through the Enum into raw
@@ -738,6 +768,7 @@ public:
 	 */
 	virtual unsigned setVal(const char* *p, unsigned nelms = 1, IndexRange *range = 0) = 0;
 	virtual unsigned setVal(uint64_t     v, IndexRange *range = 0) = 0; // set all elements to same value
+	virtual unsigned setVal(AsyncIO aio, uint64_t v, IndexRange *range = 0) = 0; // set all elements to same value
 	virtual unsigned setVal(const char*  v, IndexRange *range = 0) = 0; // set all elements to same value
 	virtual ~IScalVal_WO () {}
 
@@ -872,7 +903,9 @@ public:
 	 * Write values -- see ScalVal_WO::setVal().
 	 */
 	virtual unsigned setVal(double    *p, unsigned nelms = 1, IndexRange *range = 0) = 0;
+	virtual unsigned setVal(AsyncIO aio, double *p, unsigned nelms = 1, IndexRange *range = 0) = 0;
 	virtual unsigned setVal(double     v, IndexRange *range = 0) = 0; // set all elements to same value
+	virtual unsigned setVal(AsyncIO aio, double v, IndexRange *range = 0) = 0; // set all elements to same value
 
 	virtual ~IDoubleVal_WO(){}
 
@@ -895,6 +928,299 @@ public:
 	static DoubleVal create(ConstPath path);
 };
 
+/*!
+ * Interface to the register shadow cache of the device (SRP endpoint)
+ * a path is routed through. The cache must be enabled when the
+ * hierarchy is built (IProtoStackBuilder::useSRPShadowCache() or
+ * the YAML 'SRP: shadowCache' key).
+ *
+ * Reads of WT_CACHEABLE and WB_CACHEABLE fields are served from the
+ * cache once it holds their data. Writes to WT_CACHEABLE fields update
+ * the device and the cache. Writes to WB_CACHEABLE fields only update
+ * the cache (unless bits have to be merged into a byte which is not
+ * cached yet) and are written to the device by 'flush()'.
+ *
+ * NOTE: containers are WB_CACHEABLE by default; registers which
+ *       change 'behind our back' (status, counters) or which must
+ *       be written immediately (commands) must be declared
+ *       NOT_CACHEABLE or WT_CACHEABLE if the cache is enabled.
+ */
+class IShadowCache;
+typedef shared_ptr<IShadowCache> ShadowCache;
+
+class IShadowCache {
+public:
+	/*!
+	 * Write all modified (write-back) data to the device.
+	 *
+	 * RETURNS: number of bytes written.
+	 */
+	virtual uint64_t flush()           = 0;
+
+	/*!
+	 * Discard all cached data; the next read of any
+	 * register goes to the device.
+	 * Modified data which have not been flushed are lost!
+	 */
+	virtual void     invalidate()      = 0;
+
+	/*!
+	 * Statistics: number of reads which were served from
+	 * the cache, number of reads which went to the device
+	 * and number of modified bytes waiting to be flushed.
+	 */
+	virtual uint64_t getHits()   const = 0;
+	virtual uint64_t getMisses() const = 0;
+	virtual uint64_t getDirty()  const = 0;
+
+	virtual ~IShadowCache() {}
+
+	/*!
+	 * Obtain the shadow cache of the device 'path' is routed through.
+	 * Throws 'InvalidArgError' if there is no cache.
+	 */
+	static ShadowCache create(ConstPath path);
+};
+
+/*!
+ * Snapshot of all integral (ScalVal_RO) leaves underneath a path.
+ *
+ * When the snapshot is created the byte ranges occupied by all
+ * leaves are computed. Ranges which are adjacent or separated by
+ * no more than 'gapTolerance' bytes are merged so that the entire
+ * subtree can be read with a few large block transfers ('update()').
+ * Gaps are only bridged between WT_CACHEABLE/WB_CACHEABLE ranges,
+ * i.e., registers which may be read without side-effects, if the
+ * gap lies inside the device containing these registers and no
+ * leaf (including leaves which are not part of the snapshot, e.g.,
+ * commands) which is not cacheable overlaps it; NOT_CACHEABLE
+ * registers are never read speculatively.
+ *
+ * Individual values are then decoded from the local image
+ * (no communication takes place).
+ */
+class ISnapshot;
+typedef shared_ptr<ISnapshot> Snapshot;
+
+class ISnapshot {
+public:
+	static const unsigned DFLT_GAP_TOLERANCE = 64; /* bytes */
+
+	/*!
+	 * (Re-)read the image from the device(s).
+	 */
+	virtual void       update()                                = 0;
+
+	/*!
+	 * The leaves covered by this snapshot
+	 */
+	virtual unsigned   getNumScalVals()                  const = 0;
+	virtual ScalVal_RO getScalVal(unsigned idx)          const = 0;
+
+	/*!
+	 * Decode values from the image obtained by the last 'update()'.
+	 * Semantics are identical to IScalVal_RO::getVal(). 'val' must
+	 * be covered by the snapshot ('InvalidArgError' is thrown
+	 * otherwise) but it does not have to be one of the objects
+	 * returned by 'getScalVal()'.
+	 */
+	virtual unsigned   getVal(ScalVal_RO val, uint64_t *p, unsigned nelms = 1, IndexRange *range = 0) = 0;
+	virtual unsigned   getVal(ScalVal_RO val, CString  *p, unsigned nelms = 1, IndexRange *range = 0) = 0;
+
+	/*!
+	 * Statistics: number of block transfers and number of
+	 * bytes which are read by 'update()'.
+	 */
+	virtual unsigned   getNumReads()                     const = 0;
+	virtual uint64_t   getNumBytes()                     const = 0;
+
+	virtual ~ISnapshot() {}
+
+	/*!
+	 * Create a snapshot of all leaves underneath 'path'. Note that
+	 * the image is not read before 'update()' is executed.
+	 */
+	static Snapshot create(ConstPath path, unsigned gapTolerance = DFLT_GAP_TOLERANCE);
+};
+
+/*!
+ * A configuration (as accepted by IPath::loadConfigFromYaml())
+ * compiled into a flat list of raw writes ('plan').
+ *
+ * Compiling a plan resolves all paths, enums and encodings once
+ * and records the data the address layer would pass to the
+ * transports; no communication takes place. Contiguous writes
+ * to WB_CACHEABLE areas are merged into single operations.
+ * Writes are grouped into 'levels' (delimited by changes of
+ * 'configPrio' as in a posted load) and 'apply()' executes them
+ * in their original order.
+ *
+ * A plan may be saved to a file and loaded into a hierarchy which
+ * must be identical to the one the plan was compiled for. This is
+ * verified by means of a hash of the hierarchy (YAML) definition
+ * which is stored in the file.
+ *
+ * NOTE: only ScalVal/DoubleVal settings can be compiled; a
+ *       configuration which e.g., executes commands is rejected
+ *       with a 'ConfigurationError'.
+ */
+class IConfigPlan;
+typedef shared_ptr<IConfigPlan> ConfigPlan;
+
+class IConfigPlan {
+public:
+	/*!
+	 * Write the configuration to the hardware.
+	 *
+	 * RETURNS: number of values (as 'loadConfigFromYaml()' would)
+	 */
+	virtual uint64_t   apply()                           const = 0;
+
+	/*!
+	 * Save to a file (which can be loaded with 'load()').
+	 */
+	virtual void       save(const char *filename)        const = 0;
+
+	/*!
+	 * Statistics: number of values, write operations,
+	 * levels and bytes.
+	 */
+	virtual uint64_t   getNumValues()                    const = 0;
+	virtual unsigned   getNumWrites()                    const = 0;
+	virtual unsigned   getNumLevels()                    const = 0;
+	virtual uint64_t   getNumBytes()                     const = 0;
+
+	virtual uint32_t   getHierarchyHash()                const = 0;
+
+	virtual ~IConfigPlan() {}
+
+	/*!
+	 * Compile the configuration 'config' for the hierarchy
+	 * underneath 'path'.
+	 */
+	static ConfigPlan compile(ConstPath path, YAML::Node &config);
+
+	/*!
+	 * Compile a configuration file; the file is run through
+	 * CPSW's YAML preprocessor (see 'loadConfigFromYamlFile()').
+	 */
+	static ConfigPlan compileYamlFile(ConstPath path, const char *filename, const char *incdir = 0);
+
+	/*!
+	 * Load a plan from a file; 'root' is the root of the hierarchy.
+	 * An 'InvalidArgError' is thrown if the hierarchy doesn't match.
+	 */
+	static ConfigPlan load(Hub root, const char *filename);
+};
+
+/*!
+ * Round-trip time and error statistics of the SRP transport
+ * a path is routed through. Every SRP transport talks to a
+ * single virtual channel.
+ *
+ * Round-trip times are recorded (without locking) into
+ * log-scale histograms with eight buckets per octave, i.e.,
+ * percentiles are accurate to ~12%. Synchronous and asynchronous
+ * transactions travel over separate channels and are recorded
+ * in separate histograms.
+ *
+ * 'dumpYaml()' produces a map with the counters and a
+ * summary of every histogram.
+ */
+class ISRPStats;
+typedef shared_ptr<ISRPStats> SRPStats;
+
+class ISRPStats : public IYamlSupportBase {
+public:
+	typedef enum Channel { SYNCHRONOUS = 0, ASYNCHRONOUS = 1 } Channel;
+
+	/*!
+	 * Summary of a histogram; all times in micro-seconds
+	 */
+	struct Latency {
+		uint64_t count_;
+		double   avgUs_;
+		double   p50Us_;
+		double   p99Us_;
+		double   p999Us_;
+		double   maxUs_;
+	};
+
+	virtual Latency  getLatency(Channel ch = SYNCHRONOUS) const = 0;
+
+	/*!
+	 * Number of transactions which were re-sent because
+	 * no reply arrived in time.
+	 */
+	virtual uint64_t getRetries()                         const = 0;
+
+	/*!
+	 * Number of operations which failed because no reply
+	 * arrived (after exhausting all retries).
+	 */
+	virtual uint64_t getTimeouts()                        const = 0;
+
+	/*!
+	 * Number of replies to recently issued transactions
+	 * which nobody was waiting for anymore (duplicate replies
+	 * to retried transactions or replies arriving after the
+	 * requester gave up).
+	 */
+	virtual uint64_t getLateReplies()                     const = 0;
+
+	/*!
+	 * Number of replies with a transaction ID which was
+	 * not recently issued by this transport.
+	 */
+	virtual uint64_t getTidMismatches()                   const = 0;
+
+	/*!
+	 * Number of synchronous reads which were re-issued
+	 * speculatively because their reply took longer than
+	 * the 99th percentile of the round-trip time
+	 * (see IProtoStackBuilder::setSRPHedgeBudget()).
+	 */
+	virtual uint64_t getHedges()                          const = 0;
+
+	/*!
+	 * Number of hedged reads which were answered by the
+	 * speculative request first (i.e., hedging helped).
+	 */
+	virtual uint64_t getHedgeWins()                       const = 0;
+
+	/*!
+	 * Number of reads which would have been hedged but
+	 * the hedge budget was exhausted.
+	 */
+	virtual uint64_t getHedgesThrottled()                 const = 0;
+
+	/*!
+	 * Number of synchronous replies which were received
+	 * by polling the transport on the requester's thread
+	 * while busy-polling (see
+	 * IProtoStackBuilder::setSRPBusyPollUS()). Replies
+	 * which were queued by the RX thread while the
+	 * requester was spinning are not counted.
+	 */
+	virtual uint64_t getBusyPollHits()                    const = 0;
+
+	virtual unsigned getVirtualChannel()                  const = 0;
+
+	/*!
+	 * Clear all histograms and counters.
+	 */
+	virtual void     reset()                                    = 0;
+
+	virtual ~ISRPStats() {}
+
+	/*!
+	 * Obtain the statistics of the SRP transport 'path' is
+	 * routed through. Throws 'InvalidArgError' if there is
+	 * no such transport.
+	 */
+	static SRPStats create(ConstPath path);
+};
+
 /*!
  * Obtain the GIT version string of the library
  */
@@ -7,7 +7,9 @@
 #include <cpsw_error.h>
 #include <cpsw_shared_obj.h>
 
-
+// limits for the size (log2) of the TID index
+#define HASH_LD_MIN  4
+#define HASH_LD_MAX 14
 
 class CListAnchor : public CShObj, public CAsyncIOTransactionNode {
 private:
@@ -80,9 +82,16 @@ AsyncIOTransactionNode prev = AsyncIOTransactionNode( prev_ );
 }
 
 
+// Pending transactions are kept on a list which is ordered by
+// deadline (all transactions use the same timeout; thus posting
+// order is deadline order) and the timeout thread only has to
+// look at the list head.
+// Replies are matched by looking up their TID in a hash table
+// (intrusive chains) so that completion is O(1) no matter how
+// many transactions are outstanding.
 class CAsyncIOTransactionManager : public CRunnable, public IAsyncIOTransactionManager {
 private:
-	CMtx                     pendingMtx_;  // protect pendingList_
+	CMtx                     pendingMtx_;  // protect pendingList_ and hashTbl_
 	AsyncIOTransactionNode   pendingListHead_; // list head + tail of pending transactions
 	AsyncIOTransactionNode   pendingListTail_; // list head + tail of pending transactions
 
@@ -91,14 +100,54 @@ private:
 
 	CTimeout                 timeout_;
 
-	void addHead_unl(AsyncIOTransactionNode node)
+	unsigned                 hashShift_;
+	CAsyncIOTransactionNode **hashTbl_;
+
+	CAsyncIOTransactionManager(const CAsyncIOTransactionManager&);
+	CAsyncIOTransactionManager & operator=(const CAsyncIOTransactionManager&);
+
+	// multiplicative (fibonacci) hash; TID bits may be located
+	// anywhere in the 32-bit word.
+	CAsyncIOTransactionNode **hashHead(TID tid)
 	{
-		node->addAfter( pendingListHead_ );
+		return &hashTbl_[ (uint32_t)(tid * 0x9e3779b1) >> hashShift_ ];
 	}
 
 	void addTail_unl(AsyncIOTransactionNode node)
 	{
+	CAsyncIOTransactionNode **head = hashHead( node->tid_ );
+
 		node->addBefore( pendingListTail_ );
+
+		if ( (node->hashNext_ = *head) )
+			node->hashNext_->hashPrev_ = &node->hashNext_;
+		node->hashPrev_ = head;
+		*head           = node.get();
+	}
+
+	void remove_unl(AsyncIOTransactionNode node)
+	{
+		node->remove();
+
+		if ( node->hashNext_ )
+			node->hashNext_->hashPrev_ = node->hashPrev_;
+		*node->hashPrev_ = node->hashNext_;
+		node->hashNext_  = 0;
+		node->hashPrev_  = 0;
+	}
+
+	// find the oldest pending transaction matching 'tid'
+	CAsyncIOTransactionNode *find_unl(TID tid)
+	{
+	CAsyncIOTransactionNode *p;
+	CAsyncIOTransactionNode *found = 0;
+
+		// new nodes are added to the chain head
+		for ( p = *hashHead( tid ); p; p = p->hashNext_ ) {
+			if ( p->tid_ == tid )
+				found = p;
+		}
+		return found;
 	}
 
 protected:
@@ -106,7 +155,7 @@ protected:
 
 public:
 
-	CAsyncIOTransactionManager(uint64_t timeoutUs);
+	CAsyncIOTransactionManager(uint64_t timeoutUs, unsigned tidBits);
 
 	bool
 	pendingListEmpty()
@@ -134,12 +183,22 @@ public:
 	virtual ~CAsyncIOTransactionManager();
 };
 
-CAsyncIOTransactionManager::CAsyncIOTransactionManager(uint64_t timeoutUs)
+CAsyncIOTransactionManager::CAsyncIOTransactionManager(uint64_t timeoutUs, unsigned tidBits)
 : CRunnable("AsyncIOTimeout"),
   pendingListHead_( CShObj::create< shared_ptr<CListAnchor> >() ),
   pendingListTail_( CShObj::create< shared_ptr<CListAnchor> >() ),
   timeout_ (timeoutUs)
 {
+unsigned ld = tidBits;
+
+		if ( ld < HASH_LD_MIN )
+			ld = HASH_LD_MIN;
+		if ( ld > HASH_LD_MAX )
+			ld = HASH_LD_MAX;
+
+		hashShift_ = 32 - ld;
+		hashTbl_   = new CAsyncIOTransactionNode*[ 1 << ld ]();
+
 		pendingListHead_->next_ = pendingListTail_;
 		pendingListTail_->prev_ = pendingListHead_;
 		threadStart();
@@ -150,8 +209,9 @@ CAsyncIOTransactionManager::post(AsyncIOTransactionNode xact, TID tid, AsyncIO c
 {
 	xact->tid_        = tid;
 
-	clock_gettime( CLOCK_MONOTONIC, &xact->timeout_.tv_ );
+	clock_gettime( CLOCK_MONOTONIC, &xact->posted_.tv_ );
 
+	xact->timeout_    = xact->posted_;
 	xact->timeout_   += timeout_;
 	xact->aio_        = callback;
 	{
@@ -175,15 +235,14 @@ CAsyncIOTransactionManager::complete(BufChain bc, TID tid)
 	// access of protected 'pendingList'
 	{
 		CMtx::lg guard( &pendingMtx_ );
-		pendingListTail_->tid_ = tid; // sentinel
-		for ( xact = pendingListHead_->next_; xact->tid_ != tid; xact = xact->next_ ) {
-			/* nothing left to do */
-		}
-		if ( xact == pendingListTail_ ) {
+		CAsyncIOTransactionNode *found = find_unl( tid );
+		if ( ! found ) {
 			/* not found! */
 			return -1;
 		}
-		xact->remove();
+		// the list holds a reference; take it before unlinking
+		xact = AsyncIOTransactionNode( found->prev_ )->next_;
+		remove_unl( xact );
 	}
 
 	doComplete( xact, bc );
@@ -216,7 +275,7 @@ CAsyncIOTransactionManager::threadBody()
 			clock_gettime( CLOCK_MONOTONIC, &now.tv_ );
 			if ( xact->timeout_ < now ) {
 				/* Timeout expired */
-				xact->remove();
+				remove_unl( xact );
 
 			} else {
 				/* wait for the next timeout */
@@ -273,18 +332,20 @@ AsyncIOTransactionNode xact;
 	// flush remaining transactions
 	pendingMtx_.l();
 	while ( (xact = getHead_unl()) ) {
-		xact->remove();
+		remove_unl( xact );
 		pendingMtx_.u();
 		doComplete( xact );
 		pendingMtx_.l();
 	}
 	pendingMtx_.u();
+
+	delete [] hashTbl_;
 }
 
 AsyncIOTransactionManager
-IAsyncIOTransactionManager::create(uint64_t timeoutUs)
+IAsyncIOTransactionManager::create(uint64_t timeoutUs, unsigned tidBits)
 {
-	return cpsw::make_shared<CAsyncIOTransactionManager>( timeoutUs );
+	return cpsw::make_shared<CAsyncIOTransactionManager>( timeoutUs, tidBits );
 }
 
 CAsyncIOCompletion::CAsyncIOCompletion(AsyncIO parent)
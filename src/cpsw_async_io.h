@@ -25,7 +25,9 @@ public:
 
 	virtual ~IAsyncIOTransactionManager() {}
 
-	static AsyncIOTransactionManager create(uint64_t timeoutUs = 500000);
+	// 'tidBits' is the number of significant bits in a TID; it
+	// is used to size the table which indexes pending transactions.
+	static AsyncIOTransactionManager create(uint64_t timeoutUs = 500000, unsigned tidBits = 32);
 };
 
 // A transaction object
@@ -35,7 +37,13 @@ private:
 	AsyncIOTransactionNode              next_;
 	weak_ptr<CAsyncIOTransactionNode>   prev_;
 
+	// TID index (hash chain); the node is kept alive
+	// by the pending list, hence raw pointers suffice
+	CAsyncIOTransactionNode            *hashNext_;
+	CAsyncIOTransactionNode           **hashPrev_;
+
 	IAsyncIOTransactionManager::TID     tid_;
+	CTimeout                            posted_;
 	CTimeout                            timeout_;
 	AsyncIO                             aio_;
 
@@ -58,6 +66,8 @@ protected:
 	
 public:
 	CAsyncIOTransactionNode()
+	: hashNext_( 0 ),
+	  hashPrev_( 0 )
 	{
 	}
 
@@ -66,6 +76,12 @@ public:
 	// to be overridden by concrete transaction classes
 	virtual void complete(BufChain) = 0;
 
+	// time (CLOCK_MONOTONIC) when the transaction was posted
+	const CTimeout &getPosted() const
+	{
+		return posted_;
+	}
+
 	friend class CAsyncIOTransactionManager;
 };
 
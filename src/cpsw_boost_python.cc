@@ -272,6 +272,13 @@ PyObject  *op = o.ptr(); // no need for incrementing the refcnt while 'o' is ali
 	return IScalVal_setVal( val.get(), op, from, to );
 }
 
+static boost::python::object wrap_ScalVal_setValAsync(ScalVal val, AsyncGetValWrapperContext ctxt, object &o, int from, int to)
+{
+unsigned rval = ctxt->issueSetVal( val.get(), o.ptr(), from, to, ctxt );
+
+	return boost::python::object( rval );
+}
+
 static int64_t
 wrap_Stream_read(Stream val, object &o, int64_t timeoutUs, uint64_t offset)
 {
@@ -445,6 +452,28 @@ static boost::python::object wrap_DoubleVal_RO_getVal(DoubleVal_RO val, int from
 	return ctxt.complete( 0 );
 }
 
+static boost::python::object wrap_DoubleVal_setValAsync(DoubleVal val, AsyncGetValWrapperContext ctxt, object &o, int from, int to)
+{
+unsigned rval = ctxt->issueSetVal( val.get(), o.ptr(), from, to, ctxt );
+
+	return boost::python::object( rval );
+}
+
+static SRPStats wrap_SRPStats_create(Path p)
+{
+	return ISRPStats::create( p );
+}
+
+static boost::python::object wrap_SRPStats_getLatency(SRPStats stats, int channel)
+{
+	return boost::python::object( boost::python::handle<>( ISRPStats_getLatency( stats.get(), channel ) ) );
+}
+
+static std::string wrap_SRPStats_dumpYaml(SRPStats stats)
+{
+	return ISRPStats_dumpYamlString( stats.get() );
+}
+
 static unsigned wrap_DoubleVal_setVal(DoubleVal val, object &o, int from, int to)
 {
 PyObject  *op = o.ptr(); // no need for incrementing the refcnt while 'o' is alive
@@ -599,6 +628,7 @@ BOOST_PYTHON_MODULE(pycpsw)
 	register_ptr_to_python<Command                        >();
 	register_ptr_to_python<Stream                         >();
 	register_ptr_to_python<StreamMgr                      >();
+	register_ptr_to_python<SRPStats                       >();
 
 	register_ptr_to_python< shared_ptr<std::string const> >();
 
@@ -1334,6 +1364,11 @@ BOOST_PYTHON_MODULE(pycpsw)
 			"will extract values directly from the buffer. No enum strings are supported in\n"
 			"this case."
 		)
+		.def("setValAsync",             wrap_ScalVal_setValAsync,
+			( arg("self"), arg("AsyncIO"), arg("values"), arg("fromIdx") = -1, arg("toIdx") = -1 ),
+			"Write values asynchronously; the callback is executed (with 'None') once\n"
+			"the write has been acknowledged"
+		)
 		.def("create",       &IScalVal::create,
 			( arg("path") ),
 			"\n"
@@ -1448,6 +1483,11 @@ BOOST_PYTHON_MODULE(pycpsw)
 			"A negative 'toIdx' is equivalent to 'toIdx' == 'fromIdx' and results in only\n"
 			"the single element at 'fromIdx' to be written.\n"
 		)
+		.def("setValAsync",             wrap_DoubleVal_setValAsync,
+			( arg("self"), arg("AsyncIO"), arg("values"), arg("fromIdx") = -1, arg("toIdx") = -1 ),
+			"Write values asynchronously; the callback is executed (with 'None') once\n"
+			"the write has been acknowledged"
+		)
 		.def("create",       &IDoubleVal::create,
 			( arg("path") ),
 			"\n"
@@ -1574,6 +1614,87 @@ BOOST_PYTHON_MODULE(pycpsw)
 		.staticmethod("create")
 	;
 
+	// wrap 'ISRPStats' interface
+	class_<ISRPStats, boost::noncopyable>
+	SRPStats_Clazz(
+		"SRPStats",
+		"\n"
+		"Round-trip time and error statistics of a SRP transport.\n"
+		"\n"
+		"Round-trip times of synchronous and asynchronous transactions\n"
+		"are recorded in separate log-scale histograms (accurate to ~12%).",
+		no_init
+	);
+
+	SRPStats_Clazz
+		.def("getLatency",       wrap_SRPStats_getLatency,
+			( arg("self"), arg("channel") = (int)ISRPStats::SYNCHRONOUS ),
+			"\n"
+			"Return a dict with the number of samples ('count') and the average,\n"
+			"median, 99th, 99.9th percentile and maximum round-trip time\n"
+			"('avgUs', 'p50Us', 'p99Us', 'p999Us', 'maxUs') in micro-seconds\n"
+			"of the SYNCHRONOUS or ASYNCHRONOUS channel."
+		)
+		.def("getRetries",       &ISRPStats::getRetries,
+			( arg("self") ),
+			"\n"
+			"Return the number of transactions which were re-sent."
+		)
+		.def("getTimeouts",      &ISRPStats::getTimeouts,
+			( arg("self") ),
+			"\n"
+			"Return the number of operations which failed for lack of a reply."
+		)
+		.def("getLateReplies",   &ISRPStats::getLateReplies,
+			( arg("self") ),
+			"\n"
+			"Return the number of replies which nobody was waiting for anymore."
+		)
+		.def("getTidMismatches", &ISRPStats::getTidMismatches,
+			( arg("self") ),
+			"\n"
+			"Return the number of replies with a foreign transaction ID."
+		)
+		.def("getHedges",        &ISRPStats::getHedges,
+			( arg("self") ),
+			"\n"
+			"Return the number of reads which were re-issued speculatively."
+		)
+		.def("getHedgeWins",     &ISRPStats::getHedgeWins,
+			( arg("self") ),
+			"\n"
+			"Return the number of hedged reads answered by the speculative request."
+		)
+		.def("getHedgesThrottled",&ISRPStats::getHedgesThrottled,
+			( arg("self") ),
+			"\n"
+			"Return the number of reads not hedged because the budget was exhausted."
+		)
+		.def("getVirtualChannel",&ISRPStats::getVirtualChannel,
+			( arg("self") ),
+			"\n"
+			"Return the virtual channel the transport talks to."
+		)
+		.def("reset",            &ISRPStats::reset,
+			( arg("self") ),
+			"\n"
+			"Clear all histograms and counters."
+		)
+		.def("dumpYaml",         wrap_SRPStats_dumpYaml,
+			( arg("self") ),
+			"\n"
+			"Return all statistics as a string in YAML format."
+		)
+		.def("create",           wrap_SRPStats_create,
+			( arg("path") ),
+			"\n"
+			"Obtain the statistics of the SRP transport 'path' is routed through."
+		)
+		.staticmethod("create")
+		.setattr("SYNCHRONOUS",  (int)ISRPStats::SYNCHRONOUS)
+		.setattr("ASYNCHRONOUS", (int)ISRPStats::ASYNCHRONOUS)
+	;
+
 	// these macros must all be executed from the same scope so
 	// that the 'translator' objects of base classes are still
 	// 'alive'.
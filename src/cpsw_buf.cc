@@ -97,7 +97,12 @@ private:
 	weak_ptr<CBufChainImpl> chain_;
 	BufImpl                 next_; 
 	weak_ptr<CBufImpl>      prev_;
-	unsigned short          beg_,  end_, capa_;
+	// a slab (plus headroom) exceeds 64k
+	unsigned                beg_,  end_, capa_;
+	// a view references the memory of another buffer ('slab_')
+	// and keeps it alive; otherwise 'mem_' points to 'data_'.
+	BufImpl                 slab_;
+	uint8_t                *mem_;
 	// no alignment of the data area is guaranteed - but this is not necessary
 	// as we always treat it what it is: a raw array of bytes.
 	// Any conversion to or from more structured types (including cardinals)
@@ -108,7 +113,7 @@ protected:
 	virtual void     delFromChain();
 
 public:
-	CBufImpl(CFreeListNodeKey<CBufImpl> k, unsigned short capa);
+	CBufImpl(CFreeListNodeKey<CBufImpl> k, unsigned capa);
 
 	virtual void     addToChain(BufChainImpl c);
 
@@ -117,7 +122,7 @@ public:
 	virtual size_t   getSize()     { return end_ - beg_;                      }
 	virtual size_t   getAvail()    { return getCapacity() - end_;             }
 	virtual size_t   getHeadroom() { return beg_;                             }
-	virtual uint8_t *getPayload()  { return data_ + beg_;                     }
+	virtual uint8_t *getPayload()  { return mem_  + beg_;                     }
 
 	virtual void     setSize(size_t);
 	virtual void     setPayload(uint8_t*);
@@ -138,6 +143,8 @@ public:
 	virtual void     unlink();
 	virtual void     split();
 
+	virtual Buf      slice(size_t off, size_t size);
+
 	virtual void     unlinkCheap(CBufChainImpl::Key k)
 	{
 		next_.reset();
@@ -157,18 +164,28 @@ public:
 	static BufImpl getBuf(size_t capa, bool clip = false);
 };
 
-static CFreeListExtra<CBufImpl, 2048 - sizeof(CBufImpl)> freeListBig;
+static CFreeListExtra<CBufImpl, IBuf::CAPA_SLAB + CBufImpl::HEADROOM> freeListSlab;
+static CFreeListExtra<CBufImpl, 10240 - sizeof(CBufImpl)>             freeListJumbo;
+static CFreeListExtra<CBufImpl, 2048 - sizeof(CBufImpl)>              freeListBig;
+// views carry no data of their own
+static CFreeListExtra<CBufImpl, 0>                                    freeListView;
 
 // free lists ordered in decreasing order of node size
 static IFreeListExtra<CBufImpl> *freeListPool[] = {
-	&freeListBig
+	&freeListSlab,
+	&freeListJumbo,
+	&freeListBig,
+	&freeListView
 };
 
-CBufImpl::CBufImpl(CFreeListNodeKey<CBufImpl> k, unsigned short capa)
+#define NUM_SIZE_CLASSES (sizeof(freeListPool)/sizeof(freeListPool[0]) - 1)
+
+CBufImpl::CBufImpl(CFreeListNodeKey<CBufImpl> k, unsigned capa)
 : CFreeListNode<CBufImpl>( k ),
   beg_(HEADROOM),
   end_(HEADROOM),
-  capa_(capa)
+  capa_(capa),
+  mem_(data_)
 {
 }
 
@@ -194,10 +211,10 @@ BufChainImpl c;
 
 	if ( !p ) {
 		beg_ = 0;
-	} else if ( p < data_ || p > data_ + getCapacity() ) {
+	} else if ( p < mem_ || p > mem_ + getCapacity() ) {
 		throw InvalidArgError("requested payload pointer out of range");
 	} else  {
-		beg_ = p - data_;
+		beg_ = p - mem_;
 		if ( end_ < beg_ )
 			end_ = beg_;
 	}
@@ -227,7 +244,7 @@ void CBufImpl::reinit()
 {
 unsigned     old_size = getSize();
 BufChainImpl c;
-	beg_ = end_ = HEADROOM;
+	beg_ = end_ = slab_ ? 0 : HEADROOM;
 	if ( (c=getChainImpl()) ) {
 		c->addSize( getSize() - old_size );
 	}
@@ -377,24 +394,45 @@ void CBufImpl::split()
 	}
 }
 
-BufImpl CBufImpl::getBuf(size_t capa, bool clip)
+Buf CBufImpl::slice(size_t off, size_t size)
 {
-unsigned maxcap = freeListPool[0]->getExtraSize();
+BufImpl rval;
+
+	if ( off + size > getSize() )
+		throw InvalidArgError("slice exceeds payload");
 
-IFreeListExtra<CBufImpl> *flp = &freeListBig;
+	rval        = freeListView.get();
+	// always reference the slab itself; views of views
+	// must not keep a chain of intermediate views alive
+	rval->slab_ = slab_ ? slab_ : getSelf();
+	rval->mem_  = getPayload() + off;
+	rval->beg_  = 0;
+	rval->end_  = size;
+	rval->capa_ = size;
+
+	return rval;
+}
 
+BufImpl CBufImpl::getBuf(size_t capa, bool clip)
+{
+unsigned i;
+
+	// CAPA_MAX traditionally meant 'biggest buffer' - which used to
+	// be the MTU-sized one. Keep it that way since TX paths fragment
+	// at buffer boundaries.
 	if ( CAPA_MAX == capa )
-		capa = maxcap;
+		return freeListBig.get();
 
-	if ( capa > maxcap ) {
-		if ( clip ) {
-			capa = maxcap;
-		} else {
-			throw InvalidArgError("ATM all buffers are std. MTU size");
-		}
+	// smallest class that fits
+	for ( i = NUM_SIZE_CLASSES; i > 0; i-- ) {
+		if ( capa + HEADROOM <= freeListPool[i-1]->getExtraSize() )
+			return freeListPool[i-1]->get();
 	}
 
-	return flp->get();
+	if ( ! clip )
+		throw InvalidArgError("requested buffer capacity too big");
+
+	return freeListPool[0]->get();
 }
 
 Buf IBuf::getBuf(size_t capa, bool clip)
@@ -97,13 +97,26 @@ public:
 	// at the head of the second one)
 	virtual void     split()              = 0;
 
+	// create a new buffer which references 'size' bytes of this
+	// buffer's payload (starting 'off' bytes into the payload)
+	// without copying. The memory backing the view is kept alive
+	// for as long as any view exists. Views have no headroom and
+	// no space available at the tail.
+	virtual Buf      slice(size_t off, size_t size) = 0;
+
 	virtual         ~IBuf() {}
 
 	const static size_t CAPA_ETH_BIG = 1500 - 20 - 8;
 	const static size_t CAPA_ETH_JUM = 9000;
 	const static size_t CAPA_ETH_HDR = 128;
+	const static size_t CAPA_SLAB    = 65535 - 20 - 8; // what fits a slab (max. UDP payload; a GRO packet)
 	const static size_t CAPA_MAX     = 65535; // only 64k afaik - but this is enough
 
+	// Buffers come in a few size classes and the smallest class
+	// which holds 'capa' bytes of payload (after the headroom) is used.
+	// NOTE: CAPA_MAX yields a buffer of the standard (MTU-sized)
+	//       class - code which fragments at buffer boundaries relies
+	//       on this. Jumbo buffers and slabs must be asked for explicitly.
 	// 'clip' == false throws if  request for 'capa' cannot
 	// be satisfied. 'clip' == true clips to max. available
 	// (caller can check via 'getCapacity()').
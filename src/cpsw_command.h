@@ -236,6 +236,16 @@ protected:
 			return 1;
 		}
 
+		// commands are executed synchronously
+		template <typename T>
+		unsigned setValT(AsyncIO aio, T *p, IndexRange *range, unsigned nelms = 1)
+		{
+		unsigned rval = setValT( p, range, nelms );
+			if ( aio )
+				aio->callback( 0 );
+			return rval;
+		}
+
 public:
 		CSequenceScalVal_WOAdapt(Key &k, ConstPath p, shared_ptr<const CSequenceCommandImpl> ie);
 
@@ -248,8 +258,14 @@ public:
 		virtual unsigned setVal(uint16_t    *p, unsigned nelms = 1, IndexRange *range = 0) { return setValT( p, range, nelms ); }
 		virtual unsigned setVal(uint8_t     *p, unsigned nelms = 1, IndexRange *range = 0) { return setValT( p, range, nelms ); }
 
+		virtual unsigned setVal(AsyncIO aio, uint64_t *p, unsigned nelms = 1, IndexRange *range = 0) { return setValT( aio, p, range, nelms ); }
+		virtual unsigned setVal(AsyncIO aio, uint32_t *p, unsigned nelms = 1, IndexRange *range = 0) { return setValT( aio, p, range, nelms ); }
+		virtual unsigned setVal(AsyncIO aio, uint16_t *p, unsigned nelms = 1, IndexRange *range = 0) { return setValT( aio, p, range, nelms ); }
+		virtual unsigned setVal(AsyncIO aio, uint8_t  *p, unsigned nelms = 1, IndexRange *range = 0) { return setValT( aio, p, range, nelms ); }
+
 		virtual unsigned setVal(const char* *p, unsigned nelms = 1, IndexRange *range = 0) { return setValT( p, range, nelms ); }
 		virtual unsigned setVal(uint64_t     v, IndexRange *range = 0)                     { return setValT(&v, range, 1     ); }
+		virtual unsigned setVal(AsyncIO aio, uint64_t v, IndexRange *range = 0)            { return setValT( aio, &v, range, 1 ); }
 		virtual unsigned setVal(const char*  v, IndexRange *range = 0)                     { return setValT(&v, range, 1     ); }
 
 protected:
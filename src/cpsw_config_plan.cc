@@ -0,0 +1,499 @@
+ //@C Copyright Notice
+ //@C ================
+ //@C This file is part of CPSW. It is subject to the license terms in the LICENSE.txt
+ //@C file found in the top-level directory of this distribution and at
+ //@C https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html.
+ //@C
+ //@C No part of CPSW, including this file, may be copied, modified, propagated, or
+ //@C distributed except according to the terms contained in the LICENSE.txt file.
+
+#include <cpsw_api_user.h>
+#include <cpsw_address.h>
+#include <cpsw_path.h>
+#include <cpsw_entry.h>
+#include <cpsw_crc32_le.h>
+#include <cpsw_error.h>
+#include <cpsw_yaml.h>
+#include <string.h>
+#include <errno.h>
+#include <stdio.h>
+#include <vector>
+#include <string>
+
+#define __STDC_FORMAT_MACROS
+#include <inttypes.h>
+
+//#define CONFIG_PLAN_DEBUG
+
+using cpsw::dynamic_pointer_cast;
+
+// A configuration plan is compiled by loading the configuration
+// with a CConfigLoadCtxt which hands a write hook to every entry.
+// The hook records the raw data (after all paths, enums and encodings
+// have been resolved) which the address layer passes to the transports.
+// The priority barriers executed by the loader delimit 'levels'.
+//
+// Transports are identified by the path of the first leaf written
+// through them and the distance (number of path elements) from the leaf
+// to the transport so that they can be looked up in a hierarchy which
+// is built from scratch when a plan is loaded from a file.
+class CConfigPlanImpl : public IConfigPlan {
+private:
+	struct Xprt {
+		std::string      leaf_;
+		unsigned         depth_;
+		AddressImpl      addr_;
+		// keeps the device open
+		ScalVal_Base     val_;
+	};
+
+	struct Write {
+		unsigned          xprt_;
+		unsigned          level_;
+		uint64_t          off_;
+		unsigned          nbytes_;
+		uint8_t           msk1_;
+		uint8_t           mskn_;
+		IField::Cacheable cacheable_;
+		uint64_t          data_;    // offset into 'data_'
+	};
+
+	class CRecorder : public CConfigLoadCtxt, public IWriteHook {
+	private:
+		CConfigPlanImpl *plan_;
+		ConstPath        cur_;
+		unsigned         level_;
+		bool             empty_;
+
+	public:
+		CRecorder(CConfigPlanImpl *plan)
+		: plan_ ( plan ),
+		  level_( 0    ),
+		  empty_( true )
+		{
+		}
+
+		virtual IWriteHook *getWriteHook(ConstPath p)
+		{
+			cur_ = p;
+			return this;
+		}
+
+		virtual void barrier()
+		{
+			if ( ! empty_ ) {
+				level_++;
+				empty_ = true;
+			}
+		}
+
+		virtual uint64_t write(const CAddressImpl *xprt, CWriteArgs *args)
+		{
+			plan_->record( cur_, level_, xprt, args );
+			empty_ = false;
+			return args->nbytes_;
+		}
+
+		unsigned getNumLevels() const
+		{
+			return empty_ ? level_ : level_ + 1;
+		}
+	};
+
+	static const char     MAGIC[8];
+	static const uint32_t VERSION = 1;
+
+	std::vector<Xprt>    xprts_;
+	std::vector<Write>   writes_;
+	std::vector<uint8_t> data_;
+	uint64_t             numValues_;
+	unsigned             numLevels_;
+	uint32_t             hash_;
+
+	CConfigPlanImpl(const CConfigPlanImpl&);
+	CConfigPlanImpl & operator=(const CConfigPlanImpl&);
+
+	void record(ConstPath leaf, unsigned level, const CAddressImpl *xprt, CWriteArgs *args);
+
+	void toArgs(const Write &w, CWriteArgs *args) const;
+
+	void checkAlignment(const Write &w) const;
+
+	void attach(Xprt *x, ConstPath leaf);
+
+public:
+	CConfigPlanImpl(ConstPath p, YAML::Node &config);
+
+	CConfigPlanImpl(Hub root, const char *filename);
+
+	static uint32_t hierarchyHash(Hub root);
+
+	virtual uint64_t apply() const;
+
+	virtual void     save(const char *filename) const;
+
+	virtual uint64_t getNumValues() const
+	{
+		return numValues_;
+	}
+
+	virtual unsigned getNumWrites() const
+	{
+		return writes_.size();
+	}
+
+	virtual unsigned getNumLevels() const
+	{
+		return numLevels_;
+	}
+
+	virtual uint64_t getNumBytes() const
+	{
+		return data_.size();
+	}
+
+	virtual uint32_t getHierarchyHash() const
+	{
+		return hash_;
+	}
+};
+
+const char CConfigPlanImpl::MAGIC[8] = { 'C', 'P', 'S', 'W', 'P', 'L', 'A', 'N' };
+
+CConfigPlanImpl::CConfigPlanImpl(ConstPath p, YAML::Node &config)
+: numValues_( 0 ),
+  numLevels_( 0 ),
+  hash_     ( hierarchyHash( p->origin() ) )
+{
+CRecorder recorder( this );
+
+	numValues_ = IPathImpl::toPathImpl( p->clone() )->processYamlConfig( config, false, &recorder );
+	numLevels_ = recorder.getNumLevels();
+}
+
+uint32_t
+CConfigPlanImpl::hierarchyHash(Hub root)
+{
+shared_ptr<const CEntryImpl> rooti( dynamic_pointer_cast<const CEntryImpl>( root ) );
+YAML::Node                   node;
+YAML::Emitter                emit;
+CCpswCrc32LE                 crc32;
+
+	if ( ! rooti )
+		throw InternalError("CConfigPlanImpl: root not an EntryImpl?");
+
+	rooti->dumpYaml( node );
+	emit << node;
+
+	return crc32( -1, (uint8_t*)emit.c_str(), emit.size() ) ^ -1;
+}
+
+void
+CConfigPlanImpl::attach(Xprt *x, ConstPath leaf)
+{
+CompositePathIterator it( leaf );
+unsigned              d;
+
+	// the leaf's ScalVal opens all devices up to the transport
+	x->val_ = IScalVal_Base::create( leaf );
+	for ( d = 0; d < x->depth_ && ! it.atEnd(); d++ )
+		++it;
+	if ( it.atEnd() || ! (x->addr_ = dynamic_pointer_cast<AddressImpl::element_type>( it->c_p_ )) )
+		throw InvalidArgError( std::string("ConfigPlan: transport of ") + x->leaf_ + " not found" );
+}
+
+void
+CConfigPlanImpl::record(ConstPath leaf, unsigned level, const CAddressImpl *xprt, CWriteArgs *args)
+{
+unsigned idx;
+
+	for ( idx = 0; idx < xprts_.size(); idx++ ) {
+		if ( xprts_[idx].addr_.get() == xprt )
+			break;
+	}
+
+	if ( idx == xprts_.size() ) {
+		CompositePathIterator it( leaf );
+		Xprt                  x;
+
+		x.leaf_  = leaf->toString();
+		x.depth_ = 0;
+		while ( ! it.atEnd() && it->c_p_.get() != xprt ) {
+			++it;
+			x.depth_++;
+		}
+		attach( &x, leaf );
+		if ( x.addr_.get() != xprt )
+			throw InternalError("ConfigPlan: transport not found in path");
+		xprts_.push_back( x );
+	}
+
+	// merge with the previous write if they are contiguous
+	// and the area permits writing them in one operation
+	// (same rule the address layer applies to arrays).
+	if ( ! writes_.empty() ) {
+		Write &l = writes_.back();
+		if (    l.xprt_            == idx
+		     && l.level_           == level
+		     && l.off_ + l.nbytes_ == args->off_
+		     && l.mskn_            == 0
+		     && args->msk1_        == 0
+		     && l.cacheable_       >= IField::WB_CACHEABLE
+		     && args->cacheable_   >= IField::WB_CACHEABLE ) {
+			l.nbytes_ += args->nbytes_;
+			l.mskn_    = args->mskn_;
+			data_.insert( data_.end(), args->src_, args->src_ + args->nbytes_ );
+			// the merged range must satisfy the transport's
+			// requirements, too.
+			checkAlignment( l );
+			return;
+		}
+	}
+
+	Write w;
+	w.xprt_      = idx;
+	w.level_     = level;
+	w.off_       = args->off_;
+	w.nbytes_    = args->nbytes_;
+	w.msk1_      = args->msk1_;
+	w.mskn_      = args->mskn_;
+	w.cacheable_ = args->cacheable_;
+	w.data_      = data_.size();
+	data_.insert( data_.end(), args->src_, args->src_ + args->nbytes_ );
+	checkAlignment( w );
+	writes_.push_back( w );
+
+#ifdef CONFIG_PLAN_DEBUG
+	fprintf(CPSW::fDbg(), "ConfigPlan: %s -> xprt %u, level %u, @0x%" PRIx64 ", %u bytes\n", leaf->toString().c_str(), idx, level, w.off_, w.nbytes_);
+#endif
+}
+
+void
+CConfigPlanImpl::toArgs(const Write &w, CWriteArgs *args) const
+{
+	args->cacheable_ = w.cacheable_;
+	args->src_       = data_.empty() ? 0 : const_cast<uint8_t*>( &data_[ w.data_ ] );
+	args->off_       = w.off_;
+	args->nbytes_    = w.nbytes_;
+	args->msk1_      = w.msk1_;
+	args->mskn_      = w.mskn_;
+}
+
+// apply the checks the address layer performs before every write
+// (to recorded elements) to the ranges actually written by the plan.
+void
+CConfigPlanImpl::checkAlignment(const Write &w) const
+{
+CWriteArgs args;
+
+	toArgs( w, &args );
+	xprts_[ w.xprt_ ].addr_->checkWriteAlignmentReqs( &args );
+}
+
+uint64_t
+CConfigPlanImpl::apply() const
+{
+std::vector<Write>::const_iterator it;
+
+	for ( it = writes_.begin(); it != writes_.end(); ++it ) {
+		CWriteArgs args;
+		toArgs( *it, &args );
+		xprts_[ it->xprt_ ].addr_->write( &args );
+	}
+	return numValues_;
+}
+
+// The file format is a sequence of little-endian integers,
+// strings (length + characters) and raw data.
+
+static void putU32(std::vector<uint8_t> *b, uint32_t v)
+{
+	for ( unsigned i = 0; i < 4; i++, v >>= 8 )
+		b->push_back( (uint8_t)v );
+}
+
+static void putU64(std::vector<uint8_t> *b, uint64_t v)
+{
+	putU32( b, (uint32_t)v );
+	putU32( b, (uint32_t)(v >> 32) );
+}
+
+class CPlanReader {
+private:
+	const std::vector<uint8_t> &b_;
+	size_t                      pos_;
+
+	const uint8_t *get(size_t n)
+	{
+		if ( n > b_.size() - pos_ )
+			throw InvalidArgError("ConfigPlan: file truncated");
+		pos_ += n;
+		return &b_[pos_ - n];
+	}
+
+public:
+	CPlanReader(const std::vector<uint8_t> &b)
+	: b_  ( b ),
+	  pos_( 0 )
+	{
+	}
+
+	uint32_t getU32()
+	{
+	const uint8_t *p = get( 4 );
+		return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+	}
+
+	uint64_t getU64()
+	{
+	uint64_t l = getU32();
+		return l | ((uint64_t)getU32() << 32);
+	}
+
+	std::string getStr()
+	{
+	uint32_t l = getU32();
+		return std::string( (const char*)get( l ), l );
+	}
+
+	void getRaw(void *d, size_t n)
+	{
+		memcpy( d, get( n ), n );
+	}
+};
+
+void
+CConfigPlanImpl::save(const char *filename) const
+{
+std::vector<uint8_t>                b;
+std::vector<Xprt>::const_iterator   xit;
+std::vector<Write>::const_iterator  wit;
+FILE                               *f;
+
+	b.insert( b.end(), MAGIC, MAGIC + sizeof(MAGIC) );
+	putU32( &b, VERSION    );
+	putU32( &b, hash_      );
+	putU64( &b, numValues_ );
+	putU32( &b, numLevels_ );
+
+	putU32( &b, xprts_.size() );
+	for ( xit = xprts_.begin(); xit != xprts_.end(); ++xit ) {
+		putU32( &b, xit->depth_ );
+		putU32( &b, xit->leaf_.size() );
+		b.insert( b.end(), xit->leaf_.begin(), xit->leaf_.end() );
+	}
+
+	putU32( &b, writes_.size() );
+	for ( wit = writes_.begin(); wit != writes_.end(); ++wit ) {
+		putU32( &b, wit->xprt_      );
+		putU32( &b, wit->level_     );
+		putU64( &b, wit->off_       );
+		putU32( &b, wit->nbytes_    );
+		putU32( &b, wit->cacheable_ | (wit->msk1_ << 8) | (wit->mskn_ << 16) );
+	}
+
+	putU64( &b, data_.size() );
+	b.insert( b.end(), data_.begin(), data_.end() );
+
+	if ( ! (f = fopen( filename, "w" )) )
+		throw IOError( (std::string("ConfigPlan: unable to create ") + filename).c_str(), errno );
+	if ( 1 != fwrite( &b[0], b.size(), 1, f ) ) {
+		int err = errno;
+		fclose( f );
+		throw IOError( (std::string("ConfigPlan: unable to write ") + filename).c_str(), err );
+	}
+	if ( fclose( f ) )
+		throw IOError( (std::string("ConfigPlan: unable to write ") + filename).c_str(), errno );
+}
+
+CConfigPlanImpl::CConfigPlanImpl(Hub root, const char *filename)
+: numValues_( 0 ),
+  numLevels_( 0 ),
+  hash_     ( 0 )
+{
+std::vector<uint8_t>  b;
+uint8_t               buf[4096];
+size_t                got;
+FILE                 *f;
+char                  magic[sizeof(MAGIC)];
+unsigned              i, n;
+Path                  top( IPath::create( root ) );
+
+	if ( ! (f = fopen( filename, "r" )) )
+		throw IOError( (std::string("ConfigPlan: unable to open ") + filename).c_str(), errno );
+	while ( (got = fread( buf, 1, sizeof(buf), f )) > 0 )
+		b.insert( b.end(), buf, buf + got );
+	fclose( f );
+
+	CPlanReader rd( b );
+
+	rd.getRaw( magic, sizeof(magic) );
+	if ( memcmp( magic, MAGIC, sizeof(MAGIC) ) || VERSION != rd.getU32() )
+		throw InvalidArgError( std::string("ConfigPlan: not a (supported) plan file: ") + filename );
+
+	hash_ = rd.getU32();
+	if ( hash_ != hierarchyHash( root ) )
+		throw InvalidArgError( std::string("ConfigPlan: hierarchy does not match ") + filename );
+
+	numValues_ = rd.getU64();
+	numLevels_ = rd.getU32();
+
+	n = rd.getU32();
+	for ( i = 0; i < n; i++ ) {
+		Xprt x;
+		x.depth_ = rd.getU32();
+		x.leaf_  = rd.getStr();
+		attach( &x, top->findByName( x.leaf_.c_str() ) );
+		xprts_.push_back( x );
+	}
+
+	n = rd.getU32();
+	for ( i = 0; i < n; i++ ) {
+		Write    w;
+		uint32_t flags;
+		w.xprt_      = rd.getU32();
+		w.level_     = rd.getU32();
+		w.off_       = rd.getU64();
+		w.nbytes_    = rd.getU32();
+		flags        = rd.getU32();
+		w.cacheable_ = (IField::Cacheable)(flags & 0xff);
+		w.msk1_      = (uint8_t)(flags >>  8);
+		w.mskn_      = (uint8_t)(flags >> 16);
+		if ( w.xprt_ >= xprts_.size() )
+			throw InvalidArgError( std::string("ConfigPlan: corrupted file ") + filename );
+		checkAlignment( w );
+		writes_.push_back( w );
+	}
+
+	data_.resize( rd.getU64() );
+	if ( ! data_.empty() )
+		rd.getRaw( &data_[0], data_.size() );
+
+	for ( i = 0, got = 0; i < writes_.size(); i++ ) {
+		writes_[i].data_  = got;
+		got              += writes_[i].nbytes_;
+	}
+	if ( got != data_.size() )
+		throw InvalidArgError( std::string("ConfigPlan: corrupted file ") + filename );
+}
+
+ConfigPlan
+IConfigPlan::compile(ConstPath p, YAML::Node &config)
+{
+	if ( p->empty() && ! p->origin() )
+		throw InvalidPathError("<EMPTY>");
+	return cpsw::make_shared<CConfigPlanImpl>( p, config );
+}
+
+ConfigPlan
+IConfigPlan::compileYamlFile(ConstPath p, const char *filename, const char *incdir)
+{
+YAML::Node conf( CYamlFieldFactoryBase::loadPreprocessedYamlFile( filename, incdir, false ) );
+	return compile( p, conf );
+}
+
+ConfigPlan
+IConfigPlan::load(Hub root, const char *filename)
+{
+	return cpsw::make_shared<CConfigPlanImpl>( root, filename );
+}
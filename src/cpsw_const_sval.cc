@@ -105,12 +105,24 @@ CConstIntEntryImpl::dumpMyConfigToYaml(Path p, YAML::Node &n) const
 	return 0;
 }
 
+uint64_t
+CConstIntEntryImpl::fetchMyConfigToYaml(Path p, YAML::Node &n, CConfigDumpCtxt *ctxt) const
+{
+	return dumpMyConfigToYaml( p, n );
+}
+
 uint64_t
 CConstIntEntryImpl::loadMyConfigFromYaml(Path p, YAML::Node &n) const
 {
 	throw ConfigurationError("This class doesn't implement 'loadMyConfigFromYaml'");
 }
 
+uint64_t
+CConstIntEntryImpl::postMyConfigFromYaml(Path p, YAML::Node &n, CConfigLoadCtxt *ctxt) const
+{
+	return loadMyConfigFromYaml( p, n );
+}
+
 uint64_t
 CConstIntEntryImpl::getInt() const
 {
@@ -161,6 +173,13 @@ unsigned rval = getVal(buf, nelms, elsz, it);
 	return rval;
 }
 
+unsigned
+CConstIntEntryAdapt::getVal(IReadHook *hook, uint8_t  *buf, unsigned nelms, unsigned elsz, SlicedPathIterator *it)
+{
+	// nothing to read
+	return getVal(buf, nelms, elsz, it);
+}
+
 unsigned
 CConstIntEntryAdapt::getVal(uint8_t  *buf, unsigned nelms, unsigned elsz, SlicedPathIterator *it)
 {
@@ -38,7 +38,9 @@ public:
 	virtual void dumpYamlPart(YAML::Node &n) const;
 
 	virtual uint64_t dumpMyConfigToYaml(Path p, YAML::Node &n) const;
+	virtual uint64_t fetchMyConfigToYaml(Path p, YAML::Node &n, CConfigDumpCtxt *ctxt) const;
 	virtual uint64_t loadMyConfigFromYaml(Path p, YAML::Node &n) const;
+	virtual uint64_t postMyConfigFromYaml(Path p, YAML::Node &n, CConfigLoadCtxt *ctxt) const;
 
 	CConstIntEntryImpl(const CConstIntEntryImpl &orig, Key &k)
 	:CIntEntryImpl(orig, k),
@@ -63,6 +65,7 @@ public:
 
 	virtual unsigned getVal(uint8_t  *, unsigned, unsigned, SlicedPathIterator *it);
 	virtual unsigned getVal(AsyncIO aio, uint8_t  *, unsigned, unsigned, SlicedPathIterator *it);
+	virtual unsigned getVal(IReadHook *hook, uint8_t  *, unsigned, unsigned, SlicedPathIterator *it);
 };
 
 class CConstDblEntryAdapt : public virtual CDoubleVal_ROAdapt {
@@ -123,6 +123,12 @@ PyUniqueObj status;
 		tmp.transfer( status );
 	} else {
 		complete(0).transfer( result );
+		if ( ! result.get() ) {
+			// asynchronous write; no result
+			Py_INCREF( Py_None );
+			PyUniqueObj none( Py_None );
+			none.transfer( result );
+		}
 	}
 
 	/* Call into Python */
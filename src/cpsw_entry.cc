@@ -14,6 +14,8 @@
 #include <cpsw_stream_adapt.h>
 #include <cpsw_hub.h>
 #include <ctype.h>
+#include <string.h>
+#include <exception>
 
 #include <cpsw_obj_cnt.h>
 
@@ -203,16 +205,21 @@ void CEntryImpl::setConfigPrio(int configPrio)
 	this->configPrioSet_ = true;
 }
 
-uint64_t CEntryImpl::processYamlConfig(Path p, YAML::Node &n, bool doDump) const
+uint64_t CEntryImpl::processYamlConfig(Path p, YAML::Node &n, bool doDump, CConfigCtxt *ctxt) const
 {
 	if ( doDump ) {
 		uint64_t rval;
-		rval = dumpMyConfigToYaml( p, n );
+		if ( ctxt )
+			rval = fetchMyConfigToYaml( p, n, static_cast<CConfigDumpCtxt*>( ctxt ) );
+		else
+			rval = dumpMyConfigToYaml( p, n );
 		if ( n ) {
 			// attach a tag.
 			n.SetTag( YAML_KEY_value );
 		}
 		return rval;
+	} else if ( ctxt ) {
+		return postMyConfigFromYaml(p, n, static_cast<CConfigLoadCtxt*>( ctxt ));
 	} else {
 		return loadMyConfigFromYaml(p, n);
 	}
@@ -236,6 +243,305 @@ CEntryImpl::loadMyConfigFromYaml(Path p, YAML::Node &n) const
 	throw ConfigurationError("This class doesn't implement loadMyConfigFromYaml");
 }
 
+uint64_t
+CEntryImpl::postMyConfigFromYaml(Path p, YAML::Node &n, CConfigLoadCtxt *ctxt) const
+{
+	if ( ctxt->getWriteHook( p ) ) {
+		throw ConfigurationError( std::string("Unable to record the configuration of ") + p->toString() + " (not a ScalVal)" );
+	}
+	// we don't know what the synchronous version does;
+	// it may depend on everything posted so far.
+	ctxt->barrier();
+	return loadMyConfigFromYaml(p, n);
+}
+
+uint64_t
+CEntryImpl::fetchMyConfigToYaml(Path p, YAML::Node &n, CConfigDumpCtxt *ctxt) const
+{
+	// nothing to prefetch; the result of the first pass
+	// is discarded anyways.
+	if ( ctxt->isPrefetching() ) {
+		n = YAML::Node( YAML::NodeType::Undefined );
+		return 0;
+	}
+	return dumpMyConfigToYaml(p, n);
+}
+
+CConfigCtxt::CConfigCtxt(const char *name, unsigned window)
+: mtx_        ( name                    ),
+  window_     ( window > 0 ? window : 1 ),
+  outstanding_( 0                       )
+{
+}
+
+void
+CConfigCtxt::acquire_unguarded()
+{
+int err;
+
+	while ( outstanding_ >= window_ ) {
+		if ( (err = pthread_cond_wait( cond_.getp(), mtx_.getp() )) ) {
+			throw InternalError("CConfigCtxt: pthread_cond_wait failed", err);
+		}
+	}
+	outstanding_++;
+}
+
+void
+CConfigCtxt::release_unguarded()
+{
+	--outstanding_;
+	pthread_cond_broadcast( cond_.getp() );
+}
+
+void
+CConfigCtxt::drain_unguarded()
+{
+int err;
+
+	while ( outstanding_ > 0 ) {
+		if ( (err = pthread_cond_wait( cond_.getp(), mtx_.getp() )) ) {
+			throw InternalError("CConfigCtxt: pthread_cond_wait failed", err);
+		}
+	}
+}
+
+CConfigCtxt::~CConfigCtxt()
+{
+}
+
+class CConfigLoadCtxt::CPostedWrite : public IAsyncIO {
+private:
+	CConfigLoadCtxt *ctxt_;
+	std::string      what_;
+	bool             done_;
+
+public:
+	CPostedWrite(CConfigLoadCtxt *ctxt, const std::string &what)
+	: ctxt_( ctxt  ),
+	  what_( what  ),
+	  done_( false )
+	{
+	}
+
+	virtual void callback(CPSWError *err)
+	{
+		done_ = true;
+		ctxt_->complete( what_, err );
+	}
+
+	virtual ~CPostedWrite()
+	{
+		if ( ! done_ ) {
+			if ( std::uncaught_exception() ) {
+				// the write could not even be issued; the
+				// exception reports that (and aborts the load)
+				ctxt_->complete( what_, 0 );
+			} else {
+				// the write may never have reached the hardware
+				IOError err("write not completed");
+				ctxt_->complete( what_, &err );
+			}
+		}
+	}
+};
+
+CConfigLoadCtxt::CConfigLoadCtxt(unsigned window)
+: CConfigCtxt( "CONFIG_LOAD", window ),
+  numErrors_ ( 0                     ),
+  havePrio_  ( false                 ),
+  prio_      ( 0                     )
+{
+}
+
+AsyncIO
+CConfigLoadCtxt::post(ConstPath p, const YAML::Node &n, Val_Base val)
+{
+YAML::Mark mrk( n.Mark() );
+char       buf[100];
+
+	::snprintf( buf, sizeof(buf), " (YAML line %d, column %d)", mrk.line + 1, mrk.column + 1 );
+
+	{
+	CMtx::lg guard( &mtx_ );
+		acquire_unguarded();
+		vals_.push_back( val );
+	}
+
+	return cpsw::make_shared<CPostedWrite>( this, p->toString() + buf );
+}
+
+void
+CConfigLoadCtxt::complete(const std::string &what, CPSWError *err)
+{
+CMtx::lg guard( &mtx_ );
+	if ( err ) {
+		if ( numErrors_++ < MAX_ERRORS_LIST )
+			errors_.push_back( what + ": " + err->getInfo() );
+	}
+	release_unguarded();
+}
+
+unsigned
+CConfigLoadCtxt::wait()
+{
+CMtx::lg guard( &mtx_ );
+	drain_unguarded();
+	vals_.clear();
+	return numErrors_;
+}
+
+void
+CConfigLoadCtxt::barrier()
+{
+unsigned                                 n;
+char                                     buf[100];
+std::vector<std::string>::const_iterator it;
+
+	if ( 0 == (n = wait()) )
+		return;
+
+	::snprintf( buf, sizeof(buf), "%u posted write(s) failed:", n );
+
+	std::string msg( buf );
+	for ( it = errors_.begin(); it != errors_.end(); ++it ) {
+		msg += "\n  ";
+		msg += *it;
+	}
+	if ( n > errors_.size() ) {
+		msg += "\n  ...";
+	}
+	errors_.clear();
+	numErrors_ = 0;
+	throw IOError( msg );
+}
+
+void
+CConfigLoadCtxt::setPrio(int prio)
+{
+	if ( havePrio_ && prio != prio_ )
+		barrier();
+	havePrio_ = true;
+	prio_     = prio;
+}
+
+CConfigLoadCtxt::~CConfigLoadCtxt()
+{
+	try {
+		wait();
+	} catch ( CPSWError &e ) {
+		fprintf( CPSW::fErr(), "~CConfigLoadCtxt: %s\n", e.getInfo().c_str() );
+	}
+}
+
+class CConfigDumpCtxt::CFetch : public IAsyncIO {
+private:
+	CConfigDumpCtxt *ctxt_;
+	unsigned         idx_;
+	bool             done_;
+
+public:
+	CFetch(CConfigDumpCtxt *ctxt, unsigned idx)
+	: ctxt_( ctxt  ),
+	  idx_ ( idx   ),
+	  done_( false )
+	{
+	}
+
+	virtual void callback(CPSWError *err)
+	{
+		done_ = true;
+		ctxt_->complete( idx_, err );
+	}
+
+	virtual ~CFetch()
+	{
+		// the read could not be issued; the slot
+		// remains invalid.
+		if ( ! done_ ) {
+			IOError err("read not issued");
+			ctxt_->complete( idx_, &err );
+		}
+	}
+};
+
+CConfigDumpCtxt::CConfigDumpCtxt(unsigned window)
+: CConfigCtxt ( "CONFIG_DUMP", window ),
+  prefetching_( true                  ),
+  next_       ( 0                     )
+{
+}
+
+AsyncIO
+CConfigDumpCtxt::prefetch(const CEntryImpl *e, unsigned nelms, Val_Base val, void **bufp)
+{
+unsigned idx;
+	{
+	CMtx::lg guard( &mtx_ );
+		if ( ! prefetching_ )
+			throw InternalError("CConfigDumpCtxt: prefetch() called during second pass");
+		acquire_unguarded();
+		idx = slots_.size();
+		slots_.push_back( Slot() );
+		Slot &s  = slots_.back();
+		s.entry_ = e;
+		s.buf_.resize( nelms );
+		s.valid_ = false;
+		s.val_   = val;
+		*bufp    = &s.buf_[0];
+	}
+	return cpsw::make_shared<CFetch>( this, idx );
+}
+
+void
+CConfigDumpCtxt::complete(unsigned idx, CPSWError *err)
+{
+CMtx::lg guard( &mtx_ );
+	slots_[idx].valid_ = ! err;
+	slots_[idx].val_.reset();
+	release_unguarded();
+}
+
+void
+CConfigDumpCtxt::replay()
+{
+CMtx::lg guard( &mtx_ );
+	drain_unguarded();
+	prefetching_ = false;
+	next_        = 0;
+}
+
+bool
+CConfigDumpCtxt::fetch(const CEntryImpl *e, unsigned nelms, void *buf)
+{
+	// the second pass is executed by a single thread; no locking required
+	if ( prefetching_ || next_ >= slots_.size() )
+		return false;
+
+	Slot &s = slots_[next_];
+
+	if ( s.entry_ != e || s.buf_.size() != nelms ) {
+		// traversal differs from the first pass (should not happen); give up
+		next_ = slots_.size();
+		return false;
+	}
+	next_++;
+	if ( ! s.valid_ )
+		return false;
+	memcpy( buf, &s.buf_[0], nelms * sizeof(s.buf_[0]) );
+	return true;
+}
+
+CConfigDumpCtxt::~CConfigDumpCtxt()
+{
+CMtx::lg guard( &mtx_ );
+	try {
+		drain_unguarded();
+	} catch ( CPSWError &e ) {
+		fprintf( CPSW::fErr(), "~CConfigDumpCtxt: %s\n", e.getInfo().c_str() );
+	}
+}
+
 void CEntryImpl::accept(IVisitor *v, RecursionOrder order, int depth)
 {
 	v->visit( getSelf() );
@@ -13,11 +13,15 @@
 #include <cpsw_api_builder.h>
 #include <cpsw_shared_obj.h>
 #include <cpsw_mutex.h>
+#include <cpsw_condvar.h>
 
 
 #include <cpsw_yaml.h>
 
 #include <typeinfo>
+#include <vector>
+#include <deque>
+#include <string>
 
 using cpsw::weak_ptr;
 
@@ -34,6 +38,141 @@ class IEntryAdapterKey;
 class IEntryAdapt;
 typedef shared_ptr<IEntryAdapt>       EntryAdapt;
 
+class IWriteHook;
+
+// Common part of the contexts for loading/dumping a configuration
+// with asynchronous I/O: the number of outstanding operations is
+// limited so that replies do not overrun the transport's queues.
+class CConfigCtxt {
+public:
+	static const unsigned DFLT_WINDOW     = 8;
+
+protected:
+	CMtx                     mtx_;
+	CCond                    cond_;
+	unsigned                 window_;
+	unsigned                 outstanding_;
+
+	CConfigCtxt(const char *name, unsigned window);
+
+	// the following MUST be called with 'mtx_' held
+
+	// blocks while 'window_' operations are outstanding
+	void     acquire_unguarded();
+	void     release_unguarded();
+	// blocks until there are no outstanding operations
+	void     drain_unguarded();
+
+private:
+	CConfigCtxt(const CConfigCtxt&);
+	CConfigCtxt & operator=(const CConfigCtxt&);
+
+public:
+	virtual ~CConfigCtxt();
+};
+
+// Loading a configuration with posted writes: entries may
+// issue asynchronous writes with a completion obtained from
+// 'post()'. 'barrier()' waits until all posted writes have
+// completed and throws an (aggregate) error if any of them
+// failed; the error message lists the YAML marks of the
+// failed values.
+class CConfigLoadCtxt : public CConfigCtxt {
+public:
+	// max. number of failed writes listed in the error message
+	static const unsigned MAX_ERRORS_LIST = 10;
+
+private:
+	class CPostedWrite;
+
+	unsigned                 numErrors_;
+	std::vector<std::string> errors_;
+	// priority of the entries loaded most recently
+	bool                     havePrio_;
+	int                      prio_;
+	// keeps the devices open while writes are in flight
+	std::vector<Val_Base>    vals_;
+
+	void complete(const std::string &what, CPSWError *err);
+
+	unsigned wait();
+
+public:
+	CConfigLoadCtxt(unsigned window = DFLT_WINDOW);
+
+	// completion for a write of 'p' (by means of 'val') with
+	// the value taken from 'n'
+	AsyncIO  post(ConstPath p, const YAML::Node &n, Val_Base val);
+
+	// a context may record (rather than execute) the writes
+	// of 'p' by returning a hook; NULL by default.
+	virtual IWriteHook *getWriteHook(ConstPath p)
+	{
+		return NULL;
+	}
+
+	virtual void barrier();
+
+	// entries of priority 'prio' are about to be loaded; executes
+	// a barrier if the priority differs from the previous one (at
+	// whatever depth of the hierarchy the latter was loaded).
+	void setPrio(int prio);
+
+	// waits for outstanding writes (but does not throw)
+	~CConfigLoadCtxt();
+};
+
+// Dumping a configuration with prefetched values: the hierarchy
+// is traversed twice. During the first pass entries issue
+// asynchronous reads into buffers obtained from 'prefetch()'
+// (without producing any YAML). 'replay()' waits for all reads
+// to complete and the second pass then builds the YAML tree,
+// entries picking up their values with 'fetch()' in the same
+// order they were prefetched.
+// Values which could not be prefetched (the read failed or the
+// traversal differs) must be read synchronously.
+class CConfigDumpCtxt : public CConfigCtxt {
+private:
+	class CFetch;
+
+	struct Slot {
+		const CEntryImpl      *entry_;
+		std::vector<uint64_t>  buf_;
+		bool                   valid_;
+		// keeps the device open while the read is in flight
+		Val_Base               val_;
+	};
+
+	// a deque does not move elements (buffers in use) when growing
+	std::deque<Slot>         slots_;
+	bool                     prefetching_;
+	unsigned                 next_;
+
+	void complete(unsigned idx, CPSWError *err);
+
+public:
+	CConfigDumpCtxt(unsigned window = DFLT_WINDOW);
+
+	bool     isPrefetching() const
+	{
+		return prefetching_;
+	}
+
+	// completion for a read of 'nelms' 64-bit (integer or double)
+	// values of 'e' (by means of 'val') into '*bufp'
+	AsyncIO  prefetch(const CEntryImpl *e, unsigned nelms, Val_Base val, void **bufp);
+
+	// wait for all prefetches and switch to the second pass
+	void     replay();
+
+	// copy the prefetched values of 'e' to 'buf'; returns
+	// 'false' if they are not available.
+	bool     fetch(const CEntryImpl *e, unsigned nelms, void *buf);
+
+	// waits for outstanding reads
+	~CConfigDumpCtxt();
+};
+
 class CEntryImpl: public virtual IField, public CShObj, public CYamlSupportBase {
 	public:
 		static const int CONFIG_PRIO_OFF      = 0;
@@ -118,7 +257,18 @@ class CEntryImpl: public virtual IField, public CShObj, public CYamlSupportBase
 		virtual uint64_t dumpMyConfigToYaml(Path, YAML::Node &) const;
 		virtual uint64_t loadMyConfigFromYaml(Path, YAML::Node &) const;
 
-		virtual uint64_t processYamlConfig(Path, YAML::Node &, bool) const;
+		// Load configuration with writes posted to 'ctxt'; the default
+		// implementation executes a barrier and then 'loadMyConfigFromYaml()'
+		virtual uint64_t postMyConfigFromYaml(Path, YAML::Node &, CConfigLoadCtxt *) const;
+
+		// Dump configuration with reads prefetched by 'ctxt'; the default
+		// implementation does nothing during the prefetch pass and then
+		// executes 'dumpMyConfigToYaml()'
+		virtual uint64_t fetchMyConfigToYaml(Path, YAML::Node &, CConfigDumpCtxt *) const;
+
+		// 'ctxt' is a CConfigDumpCtxt when dumping and a CConfigLoadCtxt
+		// when loading; it may be NULL (synchronous I/O)
+		virtual uint64_t processYamlConfig(Path, YAML::Node &, bool, CConfigCtxt *ctxt) const;
 
 		// Every subclass MUST implement the 'getClassName()' virtual
 		// method. Just copy-paste this one:
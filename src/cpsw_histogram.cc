@@ -0,0 +1,86 @@
+ //@C Copyright Notice
+ //@C ================
+ //@C This file is part of CPSW. It is subject to the license terms in the LICENSE.txt
+ //@C file found in the top-level directory of this distribution and at
+ //@C https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html.
+ //@C
+ //@C No part of CPSW, including this file, may be copied, modified, propagated, or
+ //@C distributed except according to the terms contained in the LICENSE.txt file.
+
+#include <cpsw_histogram.h>
+
+CLatencyHistogram::CLatencyHistogram()
+{
+	reset();
+}
+
+uint64_t
+CLatencyHistogram::lowerBound(unsigned idx)
+{
+unsigned shft;
+
+	if ( idx < (1 << SUB_BITS) )
+		return idx;
+	shft = (idx >> SUB_BITS) - 1;
+	return (uint64_t)( (1 << SUB_BITS) | (idx & ((1 << SUB_BITS) - 1)) ) << shft;
+}
+
+uint64_t
+CLatencyHistogram::upperBound(unsigned idx)
+{
+	if ( idx < (1 << SUB_BITS) )
+		return idx;
+	return lowerBound( idx ) + ( ((uint64_t)1 << ((idx >> SUB_BITS) - 1)) - 1 );
+}
+
+void
+CLatencyHistogram::summarize(Summary *s) const
+{
+static const unsigned PERMILLE[] = { 500, 990, 999 };
+uint64_t             *res     [] = { &s->p50Ns_, &s->p99Ns_, &s->p999Ns_ };
+uint64_t              cnt     [NBUCKETS];
+uint64_t              tot = 0;
+uint64_t              acc = 0;
+unsigned              i, p;
+
+	// work on a copy so that all percentiles refer
+	// to the same set of samples
+	for ( i = 0; i < NBUCKETS; i++ ) {
+		tot += (cnt[i] = buckets_[i].load( cpsw::memory_order_relaxed ));
+	}
+
+	s->count_ = tot;
+	s->sumNs_ = sum_.load( cpsw::memory_order_relaxed );
+	s->maxNs_ = max_.load( cpsw::memory_order_relaxed );
+
+	for ( p = 0; p < sizeof(PERMILLE)/sizeof(PERMILLE[0]); p++ ) {
+		*res[p] = 0;
+	}
+
+	if ( 0 == tot )
+		return;
+
+	for ( i = 0, p = 0; i < NBUCKETS && p < sizeof(PERMILLE)/sizeof(PERMILLE[0]); i++ ) {
+		acc += cnt[i];
+		// rank of the sample at the percentile (rounded up)
+		while ( p < sizeof(PERMILLE)/sizeof(PERMILLE[0]) && acc * 1000 >= tot * PERMILLE[p] ) {
+			*res[p] = upperBound( i );
+			if ( *res[p] > s->maxNs_ )
+				*res[p] = s->maxNs_;
+			p++;
+		}
+	}
+}
+
+void
+CLatencyHistogram::reset()
+{
+unsigned i;
+
+	for ( i = 0; i < NBUCKETS; i++ ) {
+		buckets_[i].store( 0, cpsw::memory_order_relaxed );
+	}
+	count_.store( 0, cpsw::memory_order_relaxed );
+	sum_.store  ( 0, cpsw::memory_order_relaxed );
+	max_.store  ( 0, cpsw::memory_order_relaxed );
+}
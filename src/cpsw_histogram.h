@@ -0,0 +1,92 @@
+ //@C Copyright Notice
+ //@C ================
+ //@C This file is part of CPSW. It is subject to the license terms in the LICENSE.txt
+ //@C file found in the top-level directory of this distribution and at
+ //@C https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html.
+ //@C
+ //@C No part of CPSW, including this file, may be copied, modified, propagated, or
+ //@C distributed except according to the terms contained in the LICENSE.txt file.
+
+#ifndef CPSW_HISTOGRAM_H
+#define CPSW_HISTOGRAM_H
+
+#include <cpsw_compat.h>
+#include <stdint.h>
+
+// Log-scale histogram of latencies (in nano-seconds).
+//
+// Every octave is divided into 2^SUB_BITS buckets, i.e., the
+// relative width of a bucket is at most 1/2^SUB_BITS. Values
+// below 2^SUB_BITS have buckets of their own.
+//
+// 'record()' does not lock and may be executed by many threads
+// concurrently. Readers sample the (relaxed) counters; a summary
+// computed while samples are added may thus be slightly
+// inconsistent (e.g., the count may not match the sum of the
+// buckets) but every sample is eventually accounted for.
+class CLatencyHistogram {
+public:
+	static const unsigned SUB_BITS = 3;
+	static const unsigned NBUCKETS = (64 - SUB_BITS + 1) << SUB_BITS;
+
+	struct Summary {
+		uint64_t count_;
+		uint64_t sumNs_;
+		uint64_t p50Ns_;
+		uint64_t p99Ns_;
+		uint64_t p999Ns_;
+		uint64_t maxNs_;
+	};
+
+private:
+	cpsw::atomic<uint64_t> buckets_[NBUCKETS];
+	cpsw::atomic<uint64_t> count_;
+	cpsw::atomic<uint64_t> sum_;
+	cpsw::atomic<uint64_t> max_;
+
+	CLatencyHistogram(const CLatencyHistogram&);
+	CLatencyHistogram & operator=(const CLatencyHistogram&);
+
+public:
+	CLatencyHistogram();
+
+	static unsigned bucketOf(uint64_t ns)
+	{
+	unsigned shft;
+
+		if ( ns < (1 << SUB_BITS) )
+			return ns;
+		shft = 63 - __builtin_clzll( ns ) - SUB_BITS;
+		return ( (shft + 1) << SUB_BITS ) + ( (ns >> shft) & ((1 << SUB_BITS) - 1) );
+	}
+
+	// smallest value recorded in bucket 'idx'
+	static uint64_t lowerBound(unsigned idx);
+
+	// largest value recorded in bucket 'idx'
+	static uint64_t upperBound(unsigned idx);
+
+	void record(uint64_t ns)
+	{
+	uint64_t m = max_.load( cpsw::memory_order_relaxed );
+
+		buckets_[ bucketOf( ns ) ].fetch_add( 1, cpsw::memory_order_relaxed );
+		sum_.fetch_add( ns, cpsw::memory_order_relaxed );
+		count_.fetch_add( 1, cpsw::memory_order_relaxed );
+		while ( ns > m && ! max_.compare_exchange_weak( m, ns, cpsw::memory_order_relaxed ) )
+			/* retry; 'm' was updated */;
+	}
+
+	uint64_t getCount() const
+	{
+		return count_.load( cpsw::memory_order_relaxed );
+	}
+
+	// percentiles are reported as the upper bound of the bucket
+	// they fall into (but never more than the maximum)
+	void summarize(Summary *) const;
+
+	void reset();
+};
+
+#endif
@@ -224,8 +224,16 @@ uint64_t  got;
 
 	nargs.off_ += f * args->nbytes_;
 
+	// array elements are contiguous; if the entry permits it then
+	// read the entire range in one operation (the transport breaks
+	// it up into chunks it can handle)
+	if ( t > f && getEntryImpl()->getCacheable() >= IField::WT_CACHEABLE ) {
+		nargs.nbytes_ *= t - f + 1;
+		t              = f;
+	}
+
 	for ( i = f; i <= t; i++ ) {
-		got         = read( &nargs );
+		got         = nargs.hook_ ? nargs.hook_->read( this, &nargs ) : read( &nargs );
 		rval       += got;
 		nargs.off_ += got;
 		if ( 0 != nargs.dst_ )
@@ -269,15 +277,31 @@ uint64_t   put;
 
 	nargs.off_ += f * args->nbytes_;
 
+	// array elements are contiguous; unless bits have to be merged
+	// into every element write the entire range in one operation.
+	if (    t > f
+	     && getEntryImpl()->getCacheable() >= IField::WB_CACHEABLE
+	     && nargs.msk1_ == 0
+	     && nargs.mskn_ == 0
+	   ) {
+		// alignment of all elements is identical to the first one's
+		checkWriteAlignmentReqs( &nargs );
+		nargs.nbytes_ *= t - f + 1;
+		t              = f;
+	}
+
 	for ( i = f; i <= t; i++ ) {
 		checkWriteAlignmentReqs( &nargs );
-		put         = write( &nargs );
+		put         = nargs.hook_ ? nargs.hook_->write( this, &nargs ) : write( &nargs );
 		rval       += put;
 		nargs.off_ += put;
 		if ( 0 != nargs.src_ )
 			nargs.src_ += put;
 	}
 
+	if ( isSync_ && nargs.aio_ ) {
+		nargs.aio_->callback( 0 );
+	}
 	return rval;
 }
 
@@ -553,7 +577,7 @@ MyChildren::iterator it;
 }
 
 uint64_t
-CDevImpl::processYamlConfig(Path p, YAML::Node &n, bool doDump) const
+CDevImpl::processYamlConfig(Path p, YAML::Node &n, bool doDump, CConfigCtxt *ctxt) const
 {
 const char *job  = doDump ? "'dump'" : "'load'";
 uint64_t    rval = 0;
@@ -573,7 +597,7 @@ uint64_t    rval = 0;
 		// a subclass may and override 'dumpYamlConfig()/loadYamlConfig()'.
 		// Such settings would end up in the 'self' node.
 		YAML::Node self;
-		rval += CEntryImpl::processYamlConfig( p, self, doDump );
+		rval += CEntryImpl::processYamlConfig( p, self, doDump, ctxt );
 		if ( self && ! self.IsNull() ) {
 			// only save 'self' if there is anything...
 			n.push_back(self);
@@ -591,7 +615,7 @@ uint64_t    rval = 0;
 			IPathImpl::toPathImpl( p )->append( a, 0, a->getNelms() - 1 );
 
 			// dump child into the 'child' node
-			rval += a->getEntryImpl()->processYamlConfig( p, child, doDump );
+			rval += a->getEntryImpl()->processYamlConfig( p, child, doDump, ctxt );
 
 			if ( child && ! child.IsNull() ) {
 				// they actually put something there;
@@ -623,7 +647,7 @@ uint64_t    rval = 0;
 				// If this node has a 'value' tag then that means that the
 				// node contains settings for *this* device (see above).
 				// A subclass of CDevImpl may want to load/save state here...
-				rval += CEntryImpl::processYamlConfig( p, child, doDump );
+				rval += CEntryImpl::processYamlConfig( p, child, doDump, ctxt );
 			} else {
 				YAML::Mark mrk( child.Mark() );
 				// no 'value' tag; this means that the child must be a map
@@ -649,12 +673,19 @@ uint64_t    rval = 0;
 					// try to find the entity referred to by the yaml node in our hierarchy
 					Path descendant( findByName( key.c_str() ) );
 
+					if ( ctxt && ! doDump ) {
+						// posted writes are only ordered w.r.t. entries of
+						// a different priority; the context waits when the
+						// priority changes. Note that the previous entry may
+						// have been loaded at a different depth (e.g., the
+						// last one of a sibling's subtree).
+						int prio = IPathImpl::toPathImpl( descendant )->tailAsPathEntry().c_p_->getEntryImpl()->getConfigPrio();
+						static_cast<CConfigLoadCtxt*>( ctxt )->setPrio( prio );
+					}
+
 					p->append( descendant );
 
-					if ( doDump )
-						rval += p->dumpConfigToYaml( item->second );
-					else
-						rval += p->loadConfigFromYaml( item->second );
+					rval += IPathImpl::toPathImpl( p )->processYamlConfig( item->second, doDump, ctxt );
 
 					int i = descendant->size();
 
@@ -124,7 +124,7 @@ class CDevImpl : public CEntryImpl, public virtual IDev {
 
 		virtual void startUp();
 
-		virtual uint64_t processYamlConfig(Path p, YAML::Node &, bool) const;
+		virtual uint64_t processYamlConfig(Path p, YAML::Node &, bool, CConfigCtxt *ctxt) const;
 };
 
 #define NULLHUB     Hub( static_cast<IHub *>(NULL) )
@@ -0,0 +1,338 @@
+ //@C Copyright Notice
+ //@C ================
+ //@C This file is part of CPSW. It is subject to the license terms in the LICENSE.txt
+ //@C file found in the top-level directory of this distribution and at
+ //@C https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html.
+ //@C
+ //@C No part of CPSW, including this file, may be copied, modified, propagated, or
+ //@C distributed except according to the terms contained in the LICENSE.txt file.
+
+#include <cpsw_io_pool.h>
+#include <cpsw_error.h>
+#include <cpsw_stdio.h>
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+//#define IO_POOL_DEBUG
+
+#define MAX_EVENTS 16
+
+CMtx     CIOPool::mtx_( "IO Pool" );
+CIOPool *CIOPool::thePool_    = NULL;
+unsigned CIOPool::numWorkers_ = CIOPool::DFLT_NUM_WORKERS;
+
+CIOPool::CWorker::CWorker()
+: CRunnable( "IO Pool Worker" ),
+  mtx_     ( "IO Pool Worker" ),
+  current_ ( NULL             )
+{
+struct epoll_event ev;
+
+	if ( (epfd_ = epoll_create1( EPOLL_CLOEXEC )) < 0 ) {
+		throw InternalError("CIOPool: epoll_create1 failed", errno);
+	}
+	// wakes us up when a timer is added
+	if ( (wakefd_ = eventfd( 0, EFD_CLOEXEC | EFD_NONBLOCK )) < 0 ) {
+		close( epfd_ );
+		throw InternalError("CIOPool: eventfd failed", errno);
+	}
+	memset( &ev, 0, sizeof(ev) );
+	ev.events   = EPOLLIN;
+	ev.data.ptr = NULL;
+	if ( epoll_ctl( epfd_, EPOLL_CTL_ADD, wakefd_, &ev ) ) {
+		close( wakefd_ );
+		close( epfd_ );
+		throw InternalError("CIOPool: epoll_ctl failed", errno);
+	}
+	threadStart();
+}
+
+CIOPool::CWorker::~CWorker()
+{
+	threadStop();
+	close( wakefd_ );
+	close( epfd_ );
+}
+
+unsigned
+CIOPool::CWorker::getLoad()
+{
+CMtx::lg guard( &mtx_ );
+	return handlers_.size();
+}
+
+bool
+CIOPool::CWorker::isRegistered_unl(IIOPoolHandler *h)
+{
+unsigned i;
+	for ( i = 0; i < handlers_.size(); i++ ) {
+		if ( handlers_[i] == h )
+			return true;
+	}
+	return false;
+}
+
+void
+CIOPool::CWorker::addFd(int fd, IIOPoolHandler *h)
+{
+struct epoll_event ev;
+CMtx::lg           guard( &mtx_ );
+
+	memset( &ev, 0, sizeof(ev) );
+	ev.events   = EPOLLIN;
+	ev.data.ptr = h;
+	handlers_.push_back( h );
+	if ( epoll_ctl( epfd_, EPOLL_CTL_ADD, fd, &ev ) ) {
+		handlers_.pop_back();
+		throw InternalError("CIOPool: epoll_ctl(EPOLL_CTL_ADD) failed", errno);
+	}
+}
+
+void
+CIOPool::CWorker::addTimer(IIOPoolHandler *h, const CTimeout &period)
+{
+Timer    t;
+uint64_t one = 1;
+
+	t.handler_ = h;
+	t.period_  = period;
+	clock_gettime( CLOCK_MONOTONIC, &t.due_.tv_ );
+	t.due_    += period;
+
+	{
+	CMtx::lg guard( &mtx_ );
+		handlers_.push_back( h );
+		timers_.push_back( t );
+	}
+
+	// the worker might be sleeping longer than the new period
+	if ( write( wakefd_, &one, sizeof(one) ) < 0 ) {
+		fprintf(CPSW::fErr(), "WARNING: CIOPool: unable to wake up worker: %s\n", strerror(errno));
+	}
+}
+
+void
+CIOPool::CWorker::remove(int fd, IIOPoolHandler *h)
+{
+unsigned i;
+int      err;
+CMtx::lg guard( &mtx_ );
+
+	if ( fd >= 0 ) {
+		epoll_ctl( epfd_, EPOLL_CTL_DEL, fd, NULL );
+	}
+
+	for ( i = 0; i < handlers_.size(); i++ ) {
+		if ( handlers_[i] == h ) {
+			handlers_.erase( handlers_.begin() + i );
+			break;
+		}
+	}
+
+	for ( i = 0; i < timers_.size(); i++ ) {
+		if ( timers_[i].handler_ == h ) {
+			timers_.erase( timers_.begin() + i );
+			break;
+		}
+	}
+
+	// a handler removing itself must not wait
+	if ( ! pthread_equal( pthread_self(), getTid() ) ) {
+		while ( current_ == h ) {
+			if ( (err = pthread_cond_wait( idle_.getp(), mtx_.getp() )) ) {
+				throw InternalError("CIOPool: pthread_cond_wait failed", err);
+			}
+		}
+	}
+}
+
+void
+CIOPool::CWorker::dispatch(IIOPoolHandler *h, bool timeout)
+{
+	{
+	CMtx::lg guard( &mtx_ );
+		// event might be stale (handler removed meanwhile)
+		if ( ! isRegistered_unl( h ) )
+			return;
+		current_ = h;
+	}
+
+	try {
+		if ( timeout )
+			h->handleTimeout();
+		else
+			h->handleInput();
+	} catch ( CPSWError &e ) {
+		fprintf(CPSW::fErr(), "WARNING: CIOPool: handler threw '%s' -- IGNORED\n", e.getInfo().c_str());
+	}
+
+	{
+	CMtx::lg guard( &mtx_ );
+		current_ = NULL;
+		pthread_cond_broadcast( idle_.getp() );
+	}
+}
+
+// run the expired timers; return the number of ms until
+// the next one is due (-1 if there are no timers)
+int
+CIOPool::CWorker::runTimers()
+{
+CTimeout        now;
+CTimeout        next;
+IIOPoolHandler *h;
+unsigned        i;
+
+	do {
+		h    = NULL;
+		next = TIMEOUT_INDEFINITE;
+		{
+		CMtx::lg guard( &mtx_ );
+			clock_gettime( CLOCK_MONOTONIC, &now.tv_ );
+			for ( i = 0; i < timers_.size(); i++ ) {
+				if ( ! ( now < timers_[i].due_ ) ) {
+					h                = timers_[i].handler_;
+					timers_[i].due_  = now + timers_[i].period_;
+					break;
+				}
+				if ( next.isIndefinite() || timers_[i].due_ < next ) {
+					next = timers_[i].due_;
+				}
+			}
+		}
+		if ( h ) {
+			dispatch( h, true );
+		}
+	} while ( h );
+
+	if ( next.isIndefinite() )
+		return -1;
+
+	next -= now;
+
+	return next.tv_.tv_sec * 1000 + ( next.tv_.tv_nsec + 999999 ) / 1000000;
+}
+
+void *
+CIOPool::CWorker::threadBody()
+{
+struct epoll_event ev[MAX_EVENTS];
+int                n, i;
+uint64_t           cnt;
+
+	while ( 1 ) {
+		n = epoll_wait( epfd_, ev, MAX_EVENTS, runTimers() );
+		if ( n < 0 ) {
+			if ( EINTR == errno )
+				continue;
+			perror("CIOPool: epoll_wait");
+			sleep( 1 );
+			continue;
+		}
+		for ( i = 0; i < n; i++ ) {
+			if ( ! ev[i].data.ptr ) {
+				// just a wake-up
+				if ( read( wakefd_, &cnt, sizeof(cnt) ) < 0 ) {
+					/* nothing to do */
+				}
+				continue;
+			}
+			dispatch( (IIOPoolHandler*)ev[i].data.ptr, false );
+		}
+	}
+	return NULL;
+}
+
+CIOPool::CIOPool(unsigned numWorkers)
+{
+unsigned i;
+	for ( i = 0; i < numWorkers; i++ ) {
+		workers_.push_back( new CWorker() );
+	}
+#ifdef IO_POOL_DEBUG
+	fprintf(CPSW::fDbg(), "CIOPool: %u workers started\n", numWorkers);
+#endif
+}
+
+CIOPool *
+CIOPool::getPool()
+{
+CMtx::lg guard( &mtx_ );
+	if ( ! thePool_ ) {
+		unsigned    n = numWorkers_;
+		const char *env;
+		if ( DFLT_NUM_WORKERS == n && (env = getenv( "CPSW_IO_POOL_SIZE" )) ) {
+			n = strtoul( env, NULL, 0 );
+		}
+		if ( DFLT_NUM_WORKERS == n ) {
+			long ncpus = sysconf( _SC_NPROCESSORS_ONLN );
+			n = ncpus > 0 ? ncpus : 1;
+		}
+		// never destroyed; workers live until the process exits
+		thePool_ = new CIOPool( n );
+	}
+	return thePool_;
+}
+
+void
+CIOPool::setNumWorkers(unsigned n)
+{
+CMtx::lg guard( &mtx_ );
+	if ( thePool_ && n != thePool_->workers_.size() ) {
+		throw ConfigurationError("CIOPool: cannot resize pool which is already in use");
+	}
+	numWorkers_ = n;
+}
+
+unsigned
+CIOPool::getNumWorkers()
+{
+CMtx::lg guard( &mtx_ );
+	return thePool_ ? thePool_->workers_.size() : numWorkers_;
+}
+
+unsigned
+CIOPool::getNumWorkersRunning()
+{
+CMtx::lg guard( &mtx_ );
+	return thePool_ ? thePool_->workers_.size() : 0;
+}
+
+CIOPool::CWorker *
+CIOPool::leastLoaded()
+{
+unsigned i, load, min = 0;
+CWorker *rval = NULL;
+
+	for ( i = 0; i < workers_.size(); i++ ) {
+		load = workers_[i]->getLoad();
+		if ( ! rval || load < min ) {
+			rval = workers_[i];
+			min  = load;
+		}
+	}
+	return rval;
+}
+
+CIOPool::CWorker *
+CIOPool::addFd(int fd, IIOPoolHandler *h)
+{
+CWorker *w = leastLoaded();
+	w->addFd( fd, h );
+	return w;
+}
+
+CIOPool::CWorker *
+CIOPool::addTimer(IIOPoolHandler *h, const CTimeout &period)
+{
+CWorker *w = leastLoaded();
+	w->addTimer( h, period );
+	return w;
+}
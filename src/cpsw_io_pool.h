@@ -0,0 +1,134 @@
+ //@C Copyright Notice
+ //@C ================
+ //@C This file is part of CPSW. It is subject to the license terms in the LICENSE.txt
+ //@C file found in the top-level directory of this distribution and at
+ //@C https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html.
+ //@C
+ //@C No part of CPSW, including this file, may be copied, modified, propagated, or
+ //@C distributed except according to the terms contained in the LICENSE.txt file.
+
+#ifndef CPSW_IO_POOL_H
+#define CPSW_IO_POOL_H
+
+#include <cpsw_thread.h>
+#include <cpsw_mutex.h>
+#include <cpsw_condvar.h>
+#include <cpsw_api_timeout.h>
+
+#include <vector>
+
+// Process-wide pool of I/O workers. Instead of dedicating
+// (mostly idle) threads to every protocol stack, file
+// descriptors are distributed across a fixed number of
+// workers which wait for all of their descriptors and
+// timers with a single epoll set.
+//
+// A handler is executed by exactly one worker, i.e., it
+// is never entered concurrently.
+//
+// Handlers run on a shared thread and must not block!
+
+class IIOPoolHandler {
+public:
+	// the file descriptor is readable (level-triggered;
+	// called again if the handler leaves data behind).
+	virtual void handleInput()   = 0;
+
+	// a periodic timer expired
+	virtual void handleTimeout() = 0;
+
+	virtual ~IIOPoolHandler() {}
+};
+
+class CIOPool {
+public:
+	// 0 picks the number of online CPUs
+	static const unsigned DFLT_NUM_WORKERS = 0;
+
+private:
+	class CWorker : public CRunnable {
+	private:
+		struct Timer {
+			IIOPoolHandler *handler_;
+			CTimeout        period_;
+			CTimeout        due_;
+		};
+
+		int                           epfd_;
+		CMtx                          mtx_;
+		CCond                         idle_;
+		std::vector<IIOPoolHandler *> handlers_;
+		std::vector<Timer>            timers_;
+		IIOPoolHandler               *current_;
+		int                           wakefd_;
+
+		bool isRegistered_unl(IIOPoolHandler *h);
+		void dispatch(IIOPoolHandler *h, bool timeout);
+		int  runTimers();
+
+		CWorker(const CWorker &);
+		CWorker & operator=(const CWorker &);
+
+	protected:
+		virtual void *threadBody();
+
+	public:
+		CWorker();
+
+		unsigned getLoad();
+
+		void addFd(int fd, IIOPoolHandler *h);
+		void addTimer(IIOPoolHandler *h, const CTimeout &period);
+		void remove(int fd, IIOPoolHandler *h);
+
+		virtual ~CWorker();
+	};
+
+	std::vector<CWorker *> workers_;
+
+	static CMtx     mtx_;
+	static CIOPool *thePool_;
+	static unsigned numWorkers_;
+
+	CIOPool(unsigned numWorkers);
+
+	CWorker *leastLoaded();
+
+	CIOPool(const CIOPool &);
+	CIOPool & operator=(const CIOPool &);
+
+public:
+	// the pool is created (and its workers started)
+	// when first used and lives until the process exits.
+	static CIOPool *getPool();
+
+	// must be called before the pool is created;
+	// throws otherwise.
+	static void     setNumWorkers(unsigned n);
+	static unsigned getNumWorkers();
+
+	// returns the number of workers if the pool exists, 0 otherwise
+	static unsigned getNumWorkersRunning();
+
+	// Register a file descriptor (or a timer) with the
+	// least-loaded worker; returns the worker.
+	// A handler must be removed from the worker before
+	// it is destroyed.
+	CWorker *addFd(int fd, IIOPoolHandler *h);
+	CWorker *addTimer(IIOPoolHandler *h, const CTimeout &period);
+
+	// Once 'remove()' returns the handler is not executing and
+	// won't be called again. May be called from within a handler.
+	// Static (and not touching the pool's lock) so that it is safe
+	// to use from destructors which run at process exit.
+	static void remove(CWorker *w, int fd, IIOPoolHandler *h)
+	{
+		w->remove( fd, h );
+	}
+
+	typedef CWorker *Worker;
+};
+
+typedef CIOPool::Worker IOPoolWorker;
+
+#endif
@@ -0,0 +1,467 @@
+ //@C Copyright Notice
+ //@C ================
+ //@C This file is part of CPSW. It is subject to the license terms in the LICENSE.txt
+ //@C file found in the top-level directory of this distribution and at
+ //@C https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html.
+ //@C
+ //@C No part of CPSW, including this file, may be copied, modified, propagated, or
+ //@C distributed except according to the terms contained in the LICENSE.txt file.
+
+#include <cpsw_io_uring.h>
+#include <cpsw_stdio.h>
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#endif
+#endif
+
+// multishot receive and synchronous cancellation appeared
+// together (linux 6.0)
+#if defined(IORING_RECV_MULTISHOT) && defined(__NR_io_uring_setup)
+#define HAVE_IO_URING
+#endif
+
+//#define IO_URING_DEBUG
+
+#ifdef HAVE_IO_URING
+
+static int
+sys_io_uring_enter(int fd, unsigned toSubmit, unsigned minComplete, unsigned flags)
+{
+	return syscall( __NR_io_uring_enter, fd, toSubmit, minComplete, flags, NULL, 0 );
+}
+
+static int
+sys_io_uring_register(int fd, unsigned opcode, void *arg, unsigned nArgs)
+{
+	return syscall( __NR_io_uring_register, fd, opcode, arg, nArgs );
+}
+
+CIOUring::CIOUring(unsigned entries)
+: fd_            ( -1         ),
+  sqRing_        ( MAP_FAILED ),
+  sqRingSz_      ( 0          ),
+  cqRing_        ( MAP_FAILED ),
+  cqRingSz_      ( 0          ),
+  sqes_          ( MAP_FAILED ),
+  sqesSz_        ( 0          ),
+  toSubmit_      ( 0          ),
+  bufRing_       ( MAP_FAILED ),
+  bufRingSz_     ( 0          ),
+  bufRingEntries_( 0          ),
+  bufCapa_       ( 0          ),
+  bufTail_       ( 0          )
+{
+struct io_uring_params p;
+int                    err;
+
+	memset( &p, 0, sizeof(p) );
+
+	if ( (fd_ = syscall( __NR_io_uring_setup, entries, &p )) < 0 ) {
+		throw IOUringUnavailable( "io_uring_setup", errno );
+	}
+
+	sqRingSz_ = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+	cqRingSz_ = p.cq_off.cqes  + p.cq_entries * sizeof(struct io_uring_cqe);
+
+	if ( ( p.features & IORING_FEAT_SINGLE_MMAP ) ) {
+		if ( cqRingSz_ > sqRingSz_ )
+			sqRingSz_ = cqRingSz_;
+		cqRingSz_ = 0;
+	}
+
+	sqRing_ = mmap( NULL, sqRingSz_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQ_RING );
+	if ( MAP_FAILED == sqRing_ ) {
+		goto bail;
+	}
+	if ( cqRingSz_ ) {
+		cqRing_ = mmap( NULL, cqRingSz_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_CQ_RING );
+		if ( MAP_FAILED == cqRing_ ) {
+			goto bail;
+		}
+	}
+
+	sqesSz_ = p.sq_entries * sizeof(struct io_uring_sqe);
+	sqes_   = mmap( NULL, sqesSz_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQES );
+	if ( MAP_FAILED == sqes_ ) {
+		goto bail;
+	}
+
+	{
+	uint8_t *sq = (uint8_t*)sqRing_;
+	uint8_t *cq = (uint8_t*)( cqRingSz_ ? cqRing_ : sqRing_ );
+
+		sqEntries_ = p.sq_entries;
+		sqHead_    = (unsigned*)( sq + p.sq_off.head         );
+		sqTail_    = (unsigned*)( sq + p.sq_off.tail         );
+		sqMask_    = (unsigned*)( sq + p.sq_off.ring_mask    );
+		sqArray_   = (unsigned*)( sq + p.sq_off.array        );
+		cqHead_    = (unsigned*)( cq + p.cq_off.head         );
+		cqTail_    = (unsigned*)( cq + p.cq_off.tail         );
+		cqMask_    = (unsigned*)( cq + p.cq_off.ring_mask    );
+		cqes_      = (void*)    ( cq + p.cq_off.cqes         );
+		sqeTail_   = *sqTail_;
+	}
+
+#ifdef IO_URING_DEBUG
+	fprintf(CPSW::fDbg(), "io_uring: %u SQ entries, %u CQ entries, features 0x%x\n", p.sq_entries, p.cq_entries, p.features);
+#endif
+	return;
+
+bail:
+	err = errno;
+	release();
+	throw IOUringUnavailable( "io_uring: mmap", err );
+}
+
+CIOUring::~CIOUring()
+{
+	release();
+}
+
+void
+CIOUring::release()
+{
+	// closing the ring cancels whatever is still pending; the
+	// user should 'cancelAll()' first if buffers are provided.
+	if ( fd_ >= 0 ) {
+		close( fd_ );
+		fd_ = -1;
+	}
+	if ( MAP_FAILED != sqes_ ) {
+		munmap( sqes_, sqesSz_ );
+		sqes_ = MAP_FAILED;
+	}
+	if ( MAP_FAILED != cqRing_ ) {
+		munmap( cqRing_, cqRingSz_ );
+		cqRing_ = MAP_FAILED;
+	}
+	if ( MAP_FAILED != sqRing_ ) {
+		munmap( sqRing_, sqRingSz_ );
+		sqRing_ = MAP_FAILED;
+	}
+	if ( MAP_FAILED != bufRing_ ) {
+		munmap( bufRing_, bufRingSz_ );
+		bufRing_ = MAP_FAILED;
+	}
+}
+
+void *
+CIOUring::getSqe()
+{
+unsigned             head = __atomic_load_n( sqHead_, __ATOMIC_ACQUIRE );
+unsigned             idx;
+struct io_uring_sqe *sqe;
+
+	if ( sqeTail_ - head >= sqEntries_ ) {
+		return NULL;
+	}
+	idx  = sqeTail_ & *sqMask_;
+	sqe  = (struct io_uring_sqe*)sqes_ + idx;
+	memset( sqe, 0, sizeof(*sqe) );
+	sqArray_[idx] = idx;
+	sqeTail_++;
+	toSubmit_++;
+	return sqe;
+}
+
+unsigned
+CIOUring::getSqSpace()
+{
+	return sqEntries_ - ( sqeTail_ - __atomic_load_n( sqHead_, __ATOMIC_ACQUIRE ) );
+}
+
+void
+CIOUring::provide(unsigned bid)
+{
+// don't use 'io_uring_buf_ring::bufs'; in C++ the flexible array (which
+// overlays the ring's 'tail') is declared in a way that shifts it.
+struct io_uring_buf *b = (struct io_uring_buf*)bufRing_ + ( bufTail_ & ( bufRingEntries_ - 1 ) );
+
+	bufs_[bid] = IBuf::getBuf( bufCapa_ );
+	b->addr    = (uintptr_t)bufs_[bid]->getPayload();
+	b->len     = bufs_[bid]->getAvail();
+	b->bid     = bid;
+	bufTail_++;
+}
+
+void
+CIOUring::setupBuffers(unsigned nbufs, size_t capa)
+{
+struct io_uring_buf_reg reg;
+unsigned                bid;
+
+	if ( 0 == nbufs || ( nbufs & ( nbufs - 1 ) ) || nbufs > 32768 ) {
+		throw InvalidArgError("CIOUring::setupBuffers: number of buffers must be a power of two");
+	}
+	if ( MAP_FAILED != bufRing_ ) {
+		throw InternalError("CIOUring::setupBuffers: buffers already set up");
+	}
+
+	bufRingSz_ = nbufs * sizeof(struct io_uring_buf);
+	bufRing_   = mmap( NULL, bufRingSz_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
+	if ( MAP_FAILED == bufRing_ ) {
+		throw InternalError("CIOUring: mmap (buffer ring)", errno);
+	}
+
+	memset( &reg, 0, sizeof(reg) );
+	reg.ring_addr    = (uintptr_t)bufRing_;
+	reg.ring_entries = nbufs;
+	reg.bgid         = 0;
+	if ( sys_io_uring_register( fd_, IORING_REGISTER_PBUF_RING, &reg, 1 ) ) {
+		throw IOUringUnavailable("io_uring: IORING_REGISTER_PBUF_RING", errno);
+	}
+
+	bufRingEntries_ = nbufs;
+	bufCapa_        = capa;
+	bufs_.resize( nbufs );
+	for ( bid = 0; bid < nbufs; bid++ ) {
+		provide( bid );
+	}
+	__atomic_store_n( &((struct io_uring_buf_ring*)bufRing_)->tail, bufTail_, __ATOMIC_RELEASE );
+}
+
+void
+CIOUring::prepRecvMultishot(int sd, uint64_t userData)
+{
+struct io_uring_sqe *sqe;
+
+	if ( ! bufRingEntries_ ) {
+		throw InternalError("CIOUring::prepRecvMultishot: no buffers provided");
+	}
+
+	while ( ! (sqe = (struct io_uring_sqe*)getSqe()) ) {
+		// SQ full; flush
+		submit( 0 );
+	}
+
+	sqe->opcode    = IORING_OP_RECV;
+	sqe->fd        = sd;
+	sqe->flags     = IOSQE_BUFFER_SELECT;
+	sqe->buf_group = 0;
+	sqe->ioprio    = IORING_RECV_MULTISHOT;
+	sqe->user_data = userData;
+}
+
+bool
+CIOUring::prepSendmsg(int sd, const struct msghdr *msg, uint64_t userData, bool link)
+{
+struct io_uring_sqe *sqe = (struct io_uring_sqe*)getSqe();
+
+	if ( ! sqe ) {
+		return false;
+	}
+
+	sqe->opcode    = IORING_OP_SENDMSG;
+	sqe->fd        = sd;
+	sqe->addr      = (uintptr_t)msg;
+	sqe->len       = 1;
+	sqe->flags     = link ? IOSQE_IO_LINK : 0;
+	sqe->user_data = userData;
+	return true;
+}
+
+int
+CIOUring::submit(unsigned waitNr)
+{
+int rval, ot, err;
+
+	__atomic_store_n( sqTail_, sqeTail_, __ATOMIC_RELEASE );
+
+	do {
+		if ( waitNr ) {
+			// a blocking 'io_uring_enter' is no cancellation point
+			pthread_setcanceltype( PTHREAD_CANCEL_ASYNCHRONOUS, &ot );
+		}
+		rval = sys_io_uring_enter( fd_, toSubmit_, waitNr, waitNr ? IORING_ENTER_GETEVENTS : 0 );
+		err  = errno;
+		if ( waitNr ) {
+			pthread_setcanceltype( ot, NULL );
+		}
+	} while ( rval < 0 && EINTR == err );
+
+	if ( rval < 0 ) {
+		return -err;
+	}
+
+	toSubmit_ -= (unsigned)rval < toSubmit_ ? (unsigned)rval : toSubmit_;
+
+	return rval;
+}
+
+bool
+CIOUring::getCqe(Cqe *cqe)
+{
+unsigned             head = *cqHead_;
+struct io_uring_cqe *c;
+
+	if ( head == __atomic_load_n( cqTail_, __ATOMIC_ACQUIRE ) ) {
+		return false;
+	}
+
+	c              = (struct io_uring_cqe*)cqes_ + ( head & *cqMask_ );
+	cqe->userData_ = c->user_data;
+	cqe->res_      = c->res;
+	cqe->flags_    = c->flags;
+	cqe->bid_      = ( c->flags & IORING_CQE_F_BUFFER ) ? (int)( c->flags >> IORING_CQE_BUFFER_SHIFT ) : -1;
+	cqe->more_     = !!( c->flags & IORING_CQE_F_MORE );
+
+	__atomic_store_n( cqHead_, head + 1, __ATOMIC_RELEASE );
+
+	return true;
+}
+
+Buf
+CIOUring::takeBuf(int bid, size_t len)
+{
+Buf rval;
+
+	if ( bid < 0 || (unsigned)bid >= bufRingEntries_ ) {
+		throw InternalError("CIOUring::takeBuf: invalid buffer ID");
+	}
+	rval = bufs_[bid];
+	rval->setSize( len );
+	// hand a fresh one to the kernel
+	provide( bid );
+	__atomic_store_n( &((struct io_uring_buf_ring*)bufRing_)->tail, bufTail_, __ATOMIC_RELEASE );
+	return rval;
+}
+
+void
+CIOUring::cancelAll(int sd)
+{
+struct io_uring_sync_cancel_reg reg;
+Cqe                             cqe;
+
+	memset( &reg, 0, sizeof(reg) );
+	reg.fd              = sd;
+	reg.flags           = IORING_ASYNC_CANCEL_FD | IORING_ASYNC_CANCEL_ALL;
+	reg.timeout.tv_sec  = -1;
+	reg.timeout.tv_nsec = -1;
+	// ENOENT if nothing was pending
+	sys_io_uring_register( fd_, IORING_REGISTER_SYNC_CANCEL, &reg, 1 );
+
+	// discard the completions
+	while ( getCqe( &cqe ) )
+		;
+}
+
+#else
+
+CIOUring::CIOUring(unsigned entries)
+{
+	throw IOUringUnavailable("io_uring not supported by this build", ENOSYS);
+}
+
+CIOUring::~CIOUring()
+{
+}
+
+#define NOTSUP() throw InternalError("CIOUring: not supported")
+
+void     CIOUring::setupBuffers(unsigned nbufs, size_t capa)                                    { NOTSUP(); }
+void     CIOUring::prepRecvMultishot(int sd, uint64_t userData)                                 { NOTSUP(); }
+bool     CIOUring::prepSendmsg(int sd, const struct msghdr *msg, uint64_t userData, bool link)  { NOTSUP(); }
+unsigned CIOUring::getSqSpace()                                                                 { NOTSUP(); }
+int      CIOUring::submit(unsigned waitNr)                                                      { NOTSUP(); }
+bool     CIOUring::getCqe(Cqe *cqe)                                                             { NOTSUP(); }
+Buf      CIOUring::takeBuf(int bid, size_t len)                                                 { NOTSUP(); }
+void     CIOUring::cancelAll(int sd)                                                            { NOTSUP(); }
+
+#endif
+
+bool
+CIOUring::isSupported()
+{
+static int supported = -1;
+
+	if ( supported < 0 ) {
+		try {
+			CIOUring probe( 1 );
+			supported = 1;
+		} catch ( IOUringUnavailable & ) {
+			supported = 0;
+		}
+	}
+	return supported > 0;
+}
+
+void
+CIOUring::recvLoop(CIOUring **ring_p, int sd, unsigned nbufs, size_t capa, IRecvHandler *h, const char *who)
+{
+CIOUring *ring;
+Cqe       cqe;
+int       st;
+bool      arm, first = true;
+
+	if ( (ring = *ring_p) ) {
+		// restarted; get rid of what a cancelled thread left behind
+		ring->cancelAll( sd );
+		h->setActive( false );
+		*ring_p = NULL;
+		delete ring;
+	}
+
+	try {
+		*ring_p = new CIOUring( 4 );
+		(*ring_p)->setupBuffers( nbufs, capa );
+	} catch ( IOUringUnavailable &e ) {
+		fprintf(CPSW::fErr(), "WARNING: %s: io_uring unavailable (%s); falling back\n", who, e.getInfo().c_str());
+		delete *ring_p;
+		*ring_p = NULL;
+		return;
+	}
+
+	ring = *ring_p;
+	arm  = true;
+
+	while ( 1 ) {
+		if ( arm ) {
+			ring->prepRecvMultishot( sd, 0 );
+			arm = false;
+		}
+
+		if ( (st = ring->submit( 1 )) < 0 ) {
+			h->submitFailed( -st );
+			continue;
+		}
+		h->submitted();
+
+		while ( ring->getCqe( &cqe ) ) {
+			if ( cqe.res_ < 0 ) {
+				if ( first && ( -EINVAL == cqe.res_ || -EOPNOTSUPP == cqe.res_ ) ) {
+					// nothing consumed yet; safe to switch
+					fprintf(CPSW::fErr(), "WARNING: %s: io_uring multishot recv not supported (%s); falling back\n", who, strerror( -cqe.res_ ));
+					ring->cancelAll( sd );
+					*ring_p = NULL;
+					delete ring;
+					return;
+				}
+				// ENOBUFS: we were too slow replenishing buffers
+				if ( -ENOBUFS != cqe.res_ ) {
+					h->recvFailed( -cqe.res_ );
+				}
+			} else if ( cqe.bid_ >= 0 ) {
+				if ( first ) {
+					h->setActive( true );
+					first = false;
+				}
+				h->received( ring->takeBuf( cqe.bid_, cqe.res_ ), cqe.res_ );
+			} else if ( 0 == cqe.res_ ) {
+				h->closed();
+			}
+			if ( ! cqe.more_ ) {
+				// multishot terminated (e.g., out of buffers)
+				arm = true;
+			}
+		}
+	}
+}
@@ -0,0 +1,162 @@
+ //@C Copyright Notice
+ //@C ================
+ //@C This file is part of CPSW. It is subject to the license terms in the LICENSE.txt
+ //@C file found in the top-level directory of this distribution and at
+ //@C https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html.
+ //@C
+ //@C No part of CPSW, including this file, may be copied, modified, propagated, or
+ //@C distributed except according to the terms contained in the LICENSE.txt file.
+
+#ifndef CPSW_IO_URING_H
+#define CPSW_IO_URING_H
+
+#include <cpsw_buf.h>
+#include <cpsw_error.h>
+
+#include <stdint.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+
+#include <vector>
+
+// Minimal io_uring wrapper (raw syscalls; liburing is not required).
+//
+// A ring is meant to be used by a single thread (or under a lock);
+// only the operations CPSW needs are provided:
+//  - multishot 'recv' into buffers from the CPSW pool which are
+//    handed to the kernel with a 'provided buffer ring'.
+//  - batches of (linked) 'sendmsg' operations submitted with
+//    a single system call.
+//
+// The constructor throws an IOUringUnavailable error if the kernel
+// (or the headers CPSW was built with) lack the necessary support;
+// callers are expected to fall back to plain system calls.
+
+class IOUringUnavailable : public ErrnoError {
+public:
+	IOUringUnavailable(const char *s, int err)
+	: ErrnoError( s, err, typeName() )
+	{
+	}
+	// every subclass MUST implement 'clone'
+	virtual CPSWErrorHdl clone() { return cpsw::make_shared<CPSWError>(*this); }
+	// every subclass MUST implement 'throwMe'
+	virtual void throwMe() { throw *this; }
+	virtual const char *typeName() const { return "IOUringUnavailable"; }
+};
+
+class CIOUring {
+public:
+	// a completion
+	struct Cqe {
+		uint64_t userData_;
+		int32_t  res_;
+		uint32_t flags_;
+		// index of the (provided) buffer that was filled or -1
+		int      bid_;
+		// more completions of a multishot operation follow
+		bool     more_;
+	};
+
+	// what 'recvLoop' does with completions
+	class IRecvHandler {
+	public:
+		// io_uring is (true) / no longer (false) in use
+		virtual void setActive(bool active)     = 0;
+		// 'submit' returned
+		virtual void submitted()                {}
+		// 'submit' failed (errno 'err'); throw to terminate the loop
+		virtual void submitFailed(int err)      = 0;
+		// 'len' octets were received into 'buf'
+		virtual void received(Buf buf, size_t len) = 0;
+		// 'recv' failed (errno 'err'; ENOBUFS is not reported)
+		virtual void recvFailed(int err)        = 0;
+		// 'recv' returned 0 without a buffer (end of stream)
+		virtual void closed()                   {}
+		virtual ~IRecvHandler() {}
+	};
+
+private:
+	int                    fd_;
+	void                  *sqRing_;
+	size_t                 sqRingSz_;
+	void                  *cqRing_;
+	size_t                 cqRingSz_;
+	void                  *sqes_;
+	size_t                 sqesSz_;
+	unsigned               sqEntries_;
+	unsigned              *sqHead_;
+	unsigned              *sqTail_;
+	unsigned              *sqMask_;
+	unsigned              *sqArray_;
+	unsigned               sqeTail_;
+	unsigned               toSubmit_;
+	unsigned              *cqHead_;
+	unsigned              *cqTail_;
+	unsigned              *cqMask_;
+	void                  *cqes_;
+	// provided buffers
+	void                  *bufRing_;
+	size_t                 bufRingSz_;
+	unsigned               bufRingEntries_;
+	size_t                 bufCapa_;
+	std::vector<Buf>       bufs_;
+	uint16_t               bufTail_;
+
+	void *getSqe();
+
+	void  provide(unsigned bid);
+
+	void  release();
+
+	CIOUring(const CIOUring &);
+	CIOUring & operator=(const CIOUring&);
+
+public:
+	// 'entries' is rounded up to a power of two by the kernel
+	CIOUring(unsigned entries);
+
+	// Provide 'nbufs' buffers (each with a capacity of at least 'capa')
+	// for multishot receive. 'nbufs' must be a power of two.
+	virtual void     setupBuffers(unsigned nbufs, size_t capa);
+
+	// Start a multishot receive on 'sd' (requires 'setupBuffers()').
+	virtual void     prepRecvMultishot(int sd, uint64_t userData);
+
+	// Queue a 'sendmsg'. Linked operations are executed in order
+	// and the ones following a failed operation fail with -ECANCELED.
+	// Returns false if the submission queue is full.
+	virtual bool     prepSendmsg(int sd, const struct msghdr *msg, uint64_t userData, bool link);
+
+	virtual unsigned getSqSpace();
+
+	// Submit what was queued and wait for 'waitNr' completions.
+	// The wait is a cancellation point. Returns a negative 'errno'
+	// on error.
+	virtual int      submit(unsigned waitNr = 0);
+
+	// Fetch the next completion; returns false if there is none.
+	virtual bool     getCqe(Cqe *cqe);
+
+	// Take a filled buffer (the ring's slot is refilled from the pool).
+	virtual Buf      takeBuf(int bid, size_t len);
+
+	// Cancel all operations on 'sd' and wait for them to complete.
+	virtual void     cancelAll(int sd);
+
+	// whether io_uring can be used (probed once)
+	static  bool     isSupported();
+
+	// Receive from 'sd' with a multishot 'recv' into 'nbufs' buffers of
+	// 'capa' octets and hand the completions to 'h'; the operation is
+	// re-armed whenever the kernel terminates it. The ring is kept in
+	// '*ring_p' so that a restarted thread can clean up after the one
+	// that was cancelled. Returns (only) if io_uring or multishot 'recv'
+	// are unavailable (a warning prefixed with 'who' is printed) and
+	// the caller should fall back to plain system calls.
+	static  void     recvLoop(CIOUring **ring_p, int sd, unsigned nbufs, size_t capa, IRecvHandler *h, const char *who);
+
+	virtual ~CIOUring();
+};
+
+#endif
@@ -135,6 +135,11 @@ CWriteArgs nargs = *args;
 	}
 	nargs.off_ += this->offset_ + (*node)->idxf_ * getStride();
 
+	// see comment in 'read' above
+	if ( to > (*node)->idxf_ && nargs.aio_ ) {
+		nargs.aio_ = IAsyncIOParallelCompletion::create( nargs.aio_ );
+	}
+
 #ifdef MMIODEV_DEBUG
 	fprintf(CPSW::fDbg(), "MMIO write; iterating from %d -> %d\n", (*node)->idxf_, to);
 #endif
@@ -17,6 +17,7 @@
 
 #include <cpsw_comm_addr.h>
 #include <cpsw_srp_addr.h>
+#include <cpsw_io_pool.h>
 
 #include <cpsw_yaml.h>
 #include <cpsw_stdio.h>
@@ -28,7 +29,10 @@
 CNetIODevImpl::CNetIODevImpl(Key &k, const char *name, const char *ip)
 : CDevImpl       (k, name),
   ip_str_        (ip ? ip : "ANY"),
-  rssi_bridge_ip_( INADDR_NONE )
+  rssi_bridge_ip_( INADDR_NONE ),
+  io_pool_       ( false       ),
+  have_io_pool_size_( false    ),
+  io_pool_size_  ( 0           )
 {
 	socks_proxy_.version = SOCKS_VERSION_NONE;
 	if ( INADDR_NONE == ( d_ip_ = ip ? inet_addr( ip ) : INADDR_ANY ) ) {
@@ -38,13 +42,17 @@ CNetIODevImpl::CNetIODevImpl(Key &k, const char *name, const char *ip)
 
 CNetIODevImpl::CNetIODevImpl(Key &k, YamlState &ypath)
 : CDevImpl       (k, ypath     ),
-  rssi_bridge_ip_( INADDR_NONE )
+  rssi_bridge_ip_( INADDR_NONE ),
+  io_pool_       ( false       ),
+  have_io_pool_size_( false    ),
+  io_pool_size_  ( 0           )
 {
 union {
 	struct sockaddr    sa;
 	struct sockaddr_in sin;
 }               addr;
 int             err;
+unsigned        poolSize;
 
 	socks_proxy_.version = SOCKS_VERSION_NONE;
 
@@ -76,6 +84,13 @@ int             err;
 		}
 		rssi_bridge_ip_ = addr.sin.sin_addr.s_addr;
 	}
+	readNode(ypath, YAML_KEY_ioPool, &io_pool_);
+	if ( readNode(ypath, YAML_KEY_ioPoolSize, &poolSize) ) {
+		// process-wide; all devices must agree
+		setIOPoolSize( poolSize );
+		have_io_pool_size_ = true;
+		io_pool_size_      = poolSize;
+	}
 }
 
 void
@@ -89,6 +104,14 @@ CNetIODevImpl::dumpYamlPart(YAML::Node & node) const
 	if ( rssi_bridge_str_.length() > 0 ) {
 		writeNode(node, YAML_KEY_rssiBridge, rssi_bridge_str_);
 	}
+	if ( io_pool_ ) {
+		writeNode(node, YAML_KEY_ioPool, io_pool_);
+	}
+	// the pool size is not a property of the device; only reproduce
+	// what was configured here (not the size of the running pool)
+	if ( have_io_pool_size_ ) {
+		writeNode(node, YAML_KEY_ioPoolSize, io_pool_size_);
+	}
 }
 
 void CNetIODevImpl::dump(FILE *f) const
@@ -130,6 +153,10 @@ std::vector<ProtoPort> myPorts;
 		throw ConfigurationError("CNetIODev: unexpected SOCKS proxy");
 	}
 
+	if ( hasIOPool() ) {
+		bldr->setUdpIOPool( true );
+	}
+
 	getPorts( &myPorts );
 
 ProtoPort              port = bldr->build( myPorts );
@@ -242,6 +269,16 @@ NetIODev INetIODev::create(const char *name, const char *ipaddr)
 	return CShObj::create<NetIODevImpl>(name, ipaddr);
 }
 
+void INetIODev::setIOPoolSize(unsigned n)
+{
+	CIOPool::setNumWorkers( n );
+}
+
+unsigned INetIODev::getIOPoolSize()
+{
+	return CIOPool::getNumWorkers();
+}
+
 
 void CNetIODevImpl::setLocked()
 {
@@ -27,6 +27,11 @@ private:
 	std::string      socks_proxy_str_;
 	uint32_t         rssi_bridge_ip_;
 	std::string      rssi_bridge_str_;
+	bool             io_pool_;
+	// the (process-wide) I/O pool size, if it was
+	// defined by this device's YAML node
+	bool             have_io_pool_size_;
+	unsigned         io_pool_size_;
 protected:
 	CNetIODevImpl(const CNetIODevImpl &orig, Key &k)
 	: CDevImpl        ( orig, k               ),
@@ -35,7 +40,10 @@ protected:
 	  socks_proxy_    ( orig.socks_proxy_     ),
 	  socks_proxy_str_( orig.socks_proxy_str_ ),
 	  rssi_bridge_ip_ ( orig.rssi_bridge_ip_  ),
-	  rssi_bridge_str_( orig.rssi_bridge_str_ )
+	  rssi_bridge_str_( orig.rssi_bridge_str_ ),
+	  io_pool_        ( orig.io_pool_         ),
+	  have_io_pool_size_( orig.have_io_pool_size_ ),
+	  io_pool_size_     ( orig.io_pool_size_      )
 	{
 		/* The real work is in cloning the protocols -  which is not supported */
 	}
@@ -61,6 +69,9 @@ public:
 
 	virtual uint32_t    getRssiBridgeIp()        const { return rssi_bridge_ip_; }
 
+	virtual void        useIOPool(bool v)              { io_pool_ = v;    }
+	virtual bool        hasIOPool()              const { return io_pool_; }
+
 	virtual const LibSocksProxy &getSocksProxy() const { return socks_proxy_; }
 
 	virtual CNetIODevImpl *clone(Key &k) { return new CNetIODevImpl( *this, k ); }
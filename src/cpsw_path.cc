@@ -144,22 +144,16 @@ public:
 
 	virtual void        explore(IPathVisitor *) const;
 
-	virtual uint64_t    processYamlConfig(YAML::Node &, bool) const;
+	virtual uint64_t    processYamlConfig(YAML::Node &, bool, CConfigCtxt *) const;
 
-	virtual uint64_t    dumpConfigToYaml(YAML::Node &node)    const
-	{
-		return processYamlConfig( node, true );
-	}
+	virtual uint64_t    dumpConfigToYaml(YAML::Node &node, bool prefetch = false) const;
 
-	virtual uint64_t    loadConfigFromYaml(YAML::Node &node)  const
-	{
-		return processYamlConfig( node, false );
-	}
+	virtual uint64_t    loadConfigFromYaml(YAML::Node &node, bool posted = false)  const;
 
-	virtual uint64_t    loadConfigFromYamlFile(const char* filename, const char *incdir = 0) const
+	virtual uint64_t    loadConfigFromYamlFile(const char* filename, const char *incdir = 0, bool posted = false) const
 	{
 	YAML::Node conf( CYamlFieldFactoryBase::loadPreprocessedYamlFile( filename, incdir, false ) );
-		return loadConfigFromYaml( conf );
+		return loadConfigFromYaml( conf, posted );
 	}
 
 	virtual ~CPathImpl();
@@ -751,16 +745,48 @@ CPathImpl::explore_r(struct explorer_ctxt *ctxt)
 }
 
 uint64_t
-CPathImpl::processYamlConfig(YAML::Node &template_node, bool doDump) const
+CPathImpl::processYamlConfig(YAML::Node &template_node, bool doDump, CConfigCtxt *ctxt) const
 {
 	if ( empty() ) {
 		if ( ! originDev_ ) {
 			throw InvalidPathError("dumpConfigToYaml() called on an empty Path");
 		}
-		return originDev_->processYamlConfig( clone(), template_node, doDump );
+		return originDev_->processYamlConfig( clone(), template_node, doDump, ctxt );
 	} else {
-		return back().c_p_->getEntryImpl()->processYamlConfig( clone(), template_node, doDump );
+		return back().c_p_->getEntryImpl()->processYamlConfig( clone(), template_node, doDump, ctxt );
+	}
+}
+
+uint64_t
+CPathImpl::loadConfigFromYaml(YAML::Node &node, bool posted) const
+{
+	if ( posted ) {
+		CConfigLoadCtxt ctxt;
+		uint64_t        rval = processYamlConfig( node, false, &ctxt );
+		// final barrier
+		ctxt.barrier();
+		return rval;
+	}
+	return processYamlConfig( node, false, 0 );
+}
+
+uint64_t
+CPathImpl::dumpConfigToYaml(YAML::Node &node, bool prefetch) const
+{
+	if ( prefetch ) {
+		CConfigDumpCtxt ctxt;
+		{
+		// first pass; issue reads. Work on a copy of the template
+		// since processing may modify it.
+		YAML::Node      scratch;
+			if ( node && ! node.IsNull() )
+				scratch = YAML::Clone( node );
+			processYamlConfig( scratch, true, &ctxt );
+		}
+		ctxt.replay();
+		return processYamlConfig( node, true, &ctxt );
 	}
+	return processYamlConfig( node, true, 0 );
 }
 
 bool CompositePathIterator::validConcatenation(ConstPath p)
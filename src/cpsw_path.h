@@ -22,6 +22,8 @@ typedef shared_ptr<IAddress> Address;
 class CDevImpl;
 typedef shared_ptr<const CDevImpl> ConstDevImpl;
 
+class CConfigCtxt;
+
 struct PathEntry {
 	Address  c_p_;
 	shared_ptr<void> address_pvt_; // address may attach context to be used by read/write
@@ -87,6 +89,9 @@ public:
 	virtual ConstDevImpl originAsDevImpl() const = 0;
 	virtual ConstDevImpl parentAsDevImpl() const = 0;
 
+	// 'ctxt' (may be NULL) collects posted writes when loading
+	virtual uint64_t     processYamlConfig(YAML::Node &, bool doDump, CConfigCtxt *ctxt) const = 0;
+
 	static  IPathImpl   *toPathImpl(Path p);
 
 };
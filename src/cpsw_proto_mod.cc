@@ -11,6 +11,8 @@
 #include <cpsw_proto_mod.h>
 #include <cpsw_stdio.h>
 
+using cpsw::dynamic_pointer_cast;
+
 //#define PROTO_MOD_DEBUG
 
 void
@@ -270,6 +272,12 @@ CPortImpl::addAtPort(ProtoMod downstream)
 	if ( ! downstream_.expired() )
 		throw ConfigurationError("Already have a downstream module");
 	downstream_ = downstream;
+	{
+	shared_ptr<CInlineSink> sink = dynamic_pointer_cast<CInlineSink>( downstream );
+		if ( sink && sink->acceptInline() ) {
+			inlineSink_ = sink;
+		}
+	}
 	downstream->attach( getSelfAsProtoPort()->open() );
 }
 
@@ -304,6 +312,15 @@ CPortImpl::pushDownstream(BufChain bc, const CTimeout *rel_timeout)
 	if ( ! isOpen() )
 		return true;
 
+	{
+	shared_ptr<CInlineSink> sink = inlineSink_.lock();
+		if ( sink ) {
+			// run-to-completion; the downstream module
+			// has no thread and processes 'bc' right here
+			return sink->inlineInput( bc, rel_timeout );
+		}
+	}
+
 	if ( outputQueue_ ) {
 		bool rval;
 		if ( !rel_timeout || rel_timeout->isIndefinite() ) {
@@ -307,6 +307,11 @@ public:
 	virtual void modStartupOnce()                      = 0;
 	virtual void modShutdownOnce()                     = 0;
 
+	// Non-blocking: receive and process whatever input is
+	// pending on the caller's thread (for low-latency busy-
+	// polling). Returns true if anything was processed.
+	virtual bool pollInput()                           = 0;
+
 	virtual const char *getName() const                = 0;
 
 	virtual ~IProtoMod() {}
@@ -340,9 +345,65 @@ public:
 	friend class CloseManager;
 };
 
+// Protocol modules which are able to process their input
+// on the thread of the upstream module ('run-to-completion')
+// instead of popping it from the upstream queue with a thread
+// of their own.
+// The upstream port decides when the module is attached
+// (addAtPort()) whether input is delivered inline; a module
+// must not start its input thread if 'isInline()'.
+class CInlineSink {
+private:
+	bool wantInline_;
+	bool inline_;
+
+public:
+	CInlineSink()
+	: wantInline_( false ),
+	  inline_    ( false )
+	{
+	}
+
+	// must be set before the module is attached
+	virtual void setRunToCompletion(bool v)
+	{
+		wantInline_ = v;
+	}
+
+	virtual bool getRunToCompletion() const
+	{
+		return wantInline_;
+	}
+
+	// called by an upstream port which supports
+	// inline delivery; returns 'true' if the module
+	// agrees to be fed by 'inlineInput()'.
+	virtual bool acceptInline()
+	{
+		return ( inline_ = wantInline_ );
+	}
+
+	virtual bool isInline() const
+	{
+		return inline_;
+	}
+
+	// process 'bc' on the caller's thread; semantics
+	// of the return value and 'rel_timeout' are the
+	// same as for CPortImpl::pushDownstream().
+	// NOTE: may be executed by multiple threads concurrently
+	//       (UDP with more than one RX thread).
+	virtual bool inlineInput(BufChain bc, const CTimeout *rel_timeout) = 0;
+
+	virtual ~CInlineSink()
+	{
+	}
+};
+
 class CPortImpl : public IPortImpl {
 private:
 	weak_ptr< ProtoMod::element_type > downstream_;
+	weak_ptr< CInlineSink            > inlineSink_;
 	BufQueue                           outputQueue_;
 	unsigned                           depth_;
 
@@ -423,6 +484,12 @@ public:
 	virtual void modStartupOnce();
 	virtual void modShutdownOnce();
 
+	// modules with a thread (or queue) of their own
+	// cannot process input on the caller's thread
+	virtual bool pollInput()
+	{
+		return false;
+	}
 };
 
 class CProtoModImpl : public CProtoModBase {
@@ -17,7 +17,7 @@
 
 // Protocol demultiplexer with a max. of 256 'virtual-channels'
 
-template <typename PORT> class CProtoModByteMux : public CShObj, public CProtoModImpl, public CRunnable {
+template <typename PORT> class CProtoModByteMux : public CShObj, public CProtoModImpl, public CRunnable, public CInlineSink {
 
 public:
 	const static int DEST_MIN = 0;   // the code relies on 'dest' occupying 1 byte
@@ -88,6 +88,7 @@ public:
 		fprintf(f,"%s:\n", getName());
 		fprintf(f,"  # virtual channels in use: %u\n", getNumPortsUsed());
 		fprintf(f,"  Thread Priority          : %d\n", getPrio());
+		fprintf(f,"  Run-to-completion        : %c\n", isInline() ? 'Y' : 'N');
 		for ( slot = 0; slot < sizeof(downstream_)/sizeof(downstream_[0]); slot++ ) {
 			PORT p = downstream_[slot].lock();
 			if ( p )
@@ -137,6 +138,21 @@ public:
 		return NULL;
 	}
 
+	// run-to-completion: demultiplex on the upstream module's thread
+	virtual bool inlineInput(BufChain bc, const CTimeout *rel_timeout)
+	{
+		return pushDown( bc, rel_timeout );
+	}
+
+	// when run-to-completion, whatever the upstream module
+	// receives on the caller's thread is demultiplexed there, too
+	virtual bool pollInput()
+	{
+	ProtoMod up;
+		if ( ! isInline() || ! (up = getUpstreamProtoMod()) )
+			return false;
+		return up->pollInput();
+	}
 
 	virtual PORT findPort(int dest)
 	{
@@ -149,7 +165,8 @@ public:
 
 	virtual void modStartup()
 	{
-		threadStart();
+		if ( ! isInline() )
+			threadStart();
 	}
 
 	virtual void modShutdown()
@@ -244,6 +261,11 @@ public:
 		return owner_;
 	}
 
+	OwnerType getOwner() const
+	{
+		return owner_;
+	}
+
 	virtual void dumpInfo(FILE *f)
 	{
 		fprintf(f,"  Port@Dest %d (0x%02x):\n", getDest(), getDest());
@@ -113,12 +113,16 @@ int prio = getPrio();
 	if ( prio != IProtoStackBuilder::DFLT_THREAD_PRIORITY ) {
 		writeNode(parms, YAML_KEY_threadPriority, prio);
 	}
+	if ( getRunToCompletion() ) {
+		writeNode(parms, YAML_KEY_runToCompletion, true);
+	}
 	writeNode(node, YAML_KEY_depack, parms);
 }
 
 void CProtoModDepack::modStartup()
 {
-	threadStart();
+	if ( ! isInline() )
+		threadStart();
 }
 
 void CProtoModDepack::modShutdown()
@@ -209,6 +213,34 @@ CTimeout del;
 	return NULL;
 }
 
+// Run-to-completion: reassemble on the upstream module's thread.
+// Since there is nobody waiting for the oldest frame's timeout
+// it is only checked when the next fragment arrives.
+bool CProtoModDepack::inlineInput(BufChain bufch, const CTimeout *rel_timeout)
+{
+CMtx::lg guard( &inlineMtx_ );
+
+	if ( CFrame::NO_FRAME != oldestFrame_ ) {
+		CFrame *frame = &frameWin_[ toFrameIdx( oldestFrame_ ) ];
+
+		if ( frame->running_ && ! frame->timeout_.isIndefinite() ) {
+			CTimeout now;
+
+			clock_gettime( CLOCK_REALTIME, &now.tv_ );
+
+			if ( frame->timeout_ < now ) {
+				releaseOldestFrame( false );
+				timedOutFrames_++;
+			}
+		}
+	}
+
+	processBuffer( bufch );
+	releaseFrames( true );
+
+	return true;
+}
+
 void CProtoModDepack::frameSync(CAxisFrameHeader *hdr_p)
 {
 	// brute force for now...
@@ -643,6 +675,7 @@ void CProtoModDepack::dumpInfo(FILE *f)
 	fprintf(f,"CProtoModDepack:\n");
 	fprintf(f,"  Frame Window Size: %4d, Frag Window Size: %4d\n", frameWinSize_, fragWinSize_);
 	fprintf(f,"  Timeout          : %4ld.%09lds\n", timeout_.tv_.tv_sec, timeout_.tv_.tv_nsec);
+	fprintf(f,"  Run-to-completion:    %c\n", isInline() ? 'Y' : 'N');
 	fprintf(f,"  **Good Fragments Accepted     **: %8d\n", fragsAccepted_);
 	fprintf(f,"  **Good Frames Accepted        **: %8d\n", framesAccepted_);
 	fprintf(f,"  Frames dropped due to bad header: %8d\n", badHeaderDrops_);
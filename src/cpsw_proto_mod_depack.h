@@ -15,6 +15,7 @@
 #include <cpsw_api_user.h>
 #include <cpsw_proto_mod.h>
 #include <cpsw_thread.h>
+#include <cpsw_mutex.h>
 #include <cpsw_proto_depack.h>
 
 #include <pthread.h>
@@ -64,7 +65,7 @@ protected:
 	friend class CProtoModDepack;
 };
 
-class CProtoModDepack : public CProtoMod, public CRunnable {
+class CProtoModDepack : public CProtoMod, public CRunnable, public CInlineSink {
 private:
 	unsigned badHeaderDrops_;
 	unsigned oldFrameDrops_;
@@ -91,6 +92,9 @@ private:
 
 	CAxisFrameHeader::CAxisFrameNoAllocator frameIdGen_;
 
+	// serializes inline input from multiple upstream threads
+	CMtx     inlineMtx_;
+
 protected:
 	unsigned frameWinSize_;
 	unsigned fragWinSize_;
@@ -104,6 +108,8 @@ protected:
 
 	virtual void* threadBody();
 
+	virtual bool inlineInput(BufChain, const CTimeout *rel_timeout);
+
 	virtual void modStartup();
 	virtual void modShutdown();
 
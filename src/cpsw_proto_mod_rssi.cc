@@ -106,6 +106,12 @@ const CRssiConfigParams *config = getConfigParams();
 	if( deflts.forcedSegsMax_    != config->forcedSegsMax_    ) {
 		writeNode(parms, YAML_KEY_maxSegmentSize, config->forcedSegsMax_ );
 	}
+	if( deflts.selectiveAck_     != config->selectiveAck_     ) {
+		writeNode(parms, YAML_KEY_selectiveAck, config->selectiveAck_ );
+	}
+	if( deflts.adaptiveRex_      != config->adaptiveRex_      ) {
+		writeNode(parms, YAML_KEY_adaptiveRetransmissionTimeout, config->adaptiveRex_ );
+	}
 
 	writeNode(node, YAML_KEY_RSSI, parms );
 }
@@ -269,5 +275,8 @@ unsigned myMTU = peerSgsMX_;
 int
 CProtoModRssi::getRxMTU()
 {
-	return getUpstreamDoor()->getMTU();
+unsigned mtu = getUpstreamDoor()->getMTU();
+	// UDP receives into jumbo-frame sized buffers; larger
+	// segments would be truncated (e.g., on loopback)
+	return mtu < IBuf::CAPA_ETH_JUM ? mtu : IBuf::CAPA_ETH_JUM;
 }
@@ -17,19 +17,23 @@
 #define VC_OFF_V2 3 // v2 is little endian
 #define VC_OFF_V1 4 // v1 is big endian
 
-BufChain CSRPPort::processOutput(BufChain *bcp)
+unsigned CProtoModSRPMux::getVCOffset(INetIODev::ProtocolVersion protoVersion)
 {
-unsigned off = VC_OFF_V2;
-BufChain bc  = *bcp;
-
-	switch ( getProtoVersion() ) {
-		case IProtoStackBuilder::SRP_UDP_V1: off = VC_OFF_V1; break;
-		case IProtoStackBuilder::SRP_UDP_V2: off = VC_OFF_V2; break;
-		case IProtoStackBuilder::SRP_UDP_V3: off = VC_OFF_V3; break;
+	switch ( protoVersion ) {
+		case IProtoStackBuilder::SRP_UDP_V1: return VC_OFF_V1;
+		case IProtoStackBuilder::SRP_UDP_V2: return VC_OFF_V2;
+		case IProtoStackBuilder::SRP_UDP_V3: return VC_OFF_V3;
 
 		default:
-		throw InternalError("CSRPPort::processOutput -- unknown protocol version");
+		break;
 	}
+	throw InternalError("CProtoModSRPMux::getVCOffset -- unknown protocol version");
+}
+
+BufChain CSRPPort::processOutput(BufChain *bcp)
+{
+unsigned off = CProtoModSRPMux::getVCOffset( getProtoVersion() );
+BufChain bc  = *bcp;
 
 	if ( bc->getSize() <= off ) {
 		throw InternalError("CSRPPort::processOutput -- message too small");
@@ -63,16 +67,7 @@ SRPPort CProtoModSRPMux::newPort(int dest, unsigned queueDepth)
 int CProtoModSRPMux::extractDest(BufChain bc)
 {
 uint8_t  vc;
-unsigned off = VC_OFF_V2;
-
-	switch ( getProtoVersion() ) {
-		case IProtoStackBuilder::SRP_UDP_V1: off = VC_OFF_V1; break;
-		case IProtoStackBuilder::SRP_UDP_V2: off = VC_OFF_V2; break;
-		case IProtoStackBuilder::SRP_UDP_V3: off = VC_OFF_V3; break;
-
-		default:
-		throw InternalError("CSRPPort::processOutput -- unknown protocol version");
-	}
+unsigned off = getVCOffset( getProtoVersion() );
 
 	if ( bc->getSize() <= off ) {
 		return DEST_MIN-1;
@@ -112,6 +107,8 @@ YAML::Node parms;
 
 	writeNode(parms, YAML_KEY_virtualChannel, getDest());
 	writeNode(parms, YAML_KEY_outQueueDepth,  queueDepth_);
+	if ( getOwner()->getRunToCompletion() )
+		writeNode(parms, YAML_KEY_runToCompletion, true);
 
 	writeNode(node, YAML_KEY_SRPMux, parms);
 }
@@ -57,6 +57,8 @@ public:
 
 	virtual int extractDest(BufChain);
 
+	// byte offset of the virtual channel in a message
+	static unsigned getVCOffset(INetIODev::ProtocolVersion protoVersion);
 
 	virtual INetIODev::ProtocolVersion getProtoVersion()
 	{
@@ -28,8 +28,6 @@
 //#define TCP_DEBUG
 //#define TCP_DEBUG_STRM
 
-#define NBUFS_MAX 8
-
 static void xfer(
 	const char   *nm,
 	ssize_t     (*op)(int, const struct iovec*, int),
@@ -44,127 +42,290 @@ ssize_t xfr;
 		if ( xfr <= 0 ) {
 			throw InternalError( std::string("TCP: ") + std::string(nm) + std::string(" error: "), errno );
 		}
-		while ( (size_t)xfr >= iop->iov_len ) {
+		while ( niovs > 0 && (size_t)xfr >= iop->iov_len ) {
 			xfr    -= iop->iov_len;
 			len    -= iop->iov_len;
 			iop++;
 			niovs--;
 		}
+		if ( 0 == niovs )
+			break;
 		iop->iov_len -= xfr;
 		iop->iov_base = reinterpret_cast<void*>( reinterpret_cast<uintptr_t>( iop->iov_base ) + xfr );
 		len    -= xfr;
 	}
 }
 
-void * CProtoModTcp::CRxHandlerThread::threadBody()
+void CProtoModTcp::CRxHandlerThread::deliver(Buf buf, uint32_t len)
 {
-	ssize_t          got,siz,cap;
-	std::vector<Buf> bufs;
-	unsigned         idx, i;
-
-	struct iovec     iov[NBUFS_MAX];
-	unsigned         niovs;
+	BufChain bufch = IBufChain::create();
 
-	uint32_t         len;
+	buf->setSize( len );
+	bufch->addAtTail( buf );
 
-	for ( niovs = 0, cap = 0; niovs<NBUFS_MAX && cap < (ssize_t)IBuf::CAPA_ETH_JUM; niovs++ ) {
-		bufs.push_back( IBuf::getBuf( IBuf::CAPA_ETH_BIG ) );
-		iov[niovs].iov_base = bufs[niovs]->getPayload();
-		cap += (iov[niovs].iov_len  = bufs[niovs]->getAvail());
-	}
+	deliver( bufch, len );
+}
 
-	while ( 1 ) {
-		uint8_t      *p;
+void CProtoModTcp::CRxHandlerThread::deliver(BufChain bufch, uint32_t len)
+{
+	nDgrams_.fetch_add(1,   cpsw::memory_order_relaxed);
+	nOctets_.fetch_add(len, cpsw::memory_order_relaxed);
 
 #ifdef TCP_DEBUG
-		fprintf(CPSW::fDbg(), "TCP -- waiting for data\n");
+	{
+		uint8_t  *p = bufch->getHead()->getPayload();
+#ifdef TCP_DEBUG_STRM
+		unsigned fram = (p[1]<<4) | (p[0]>>4);
+		unsigned frag = (p[4]<<16) | (p[3] << 8) | p[2];
+		fprintf(CPSW::fDbg(), "TCP: fram %d[%d]\n", fram, frag);
+#else
+		int      i;
+		fprintf(CPSW::fDbg(), "TCP got %d data: ",(int)len);
+		for ( i=0; i< (len < 20 ? len : 20); i++ )
+			fprintf(CPSW::fDbg(), "%02x ", p[i]);
+		fprintf(CPSW::fDbg(), "\n");
+#endif
+	}
 #endif
 
-		siz = sizeof(len);
-		p   = reinterpret_cast<uint8_t*>( &len );
-		while ( siz > 0 ) {
-			if ( (got = ::read(sd_, p, siz)) <= 0 )
-				throw InternalError("TCP reading length: ", errno);
-			p   += got;
-			siz -= got;
-		}
+#ifdef TCP_DEBUG
+	bool st=
+#endif
 
-		len = ntohl(len);
+		owner_->pushDown( bufch, &TIMEOUT_INDEFINITE );
 
 #ifdef TCP_DEBUG
-		fprintf(CPSW::fDbg(), "TCP RX -- got length: %" PRId32 "\n", len);
+		if ( st )
+			fprintf(CPSW::fDbg(), " (pushdown SUCC)\n");
+		else
+			fprintf(CPSW::fDbg(), " (pushdown DROP)\n");
 #endif
+}
 
-		siz = len;
-		idx = 0;
-		while ( siz > 0 ) {
-			if ( idx == niovs )
-				throw InternalError("Too many TCP fragments");
-			if ( (size_t)siz >= iov[idx].iov_len ) {
-				siz -= iov[idx].iov_len;
-			} else {
-				iov[idx].iov_len = siz;
-				siz = 0;
-			}
-			idx++;
-		}
-			
-		xfer("readv()", ::readv, sd_, iov, idx, len);
+// max. size of a frame (frames which don't fit a slab are
+// received into a chain of slabs)
+#define FRAME_SLABS_MAX 16
+#define FRAME_MAX       (FRAME_SLABS_MAX * IBuf::CAPA_SLAB)
 
-		nDgrams_.fetch_add(1,   cpsw::memory_order_relaxed);
-		nOctets_.fetch_add(len, cpsw::memory_order_relaxed);
+// number (power of two) and size of buffers provided to the RX ring
+#define URING_RX_BUFS 16
+#define URING_RX_CAPA IBuf::CAPA_ETH_JUM
 
-		BufChain bufch = IBufChain::create();
+void CProtoModTcp::CRxHandlerThread::uringLoop()
+{
+	hdrGot_   = 0;
+	frameLen_ = 0;
+	frameGot_ = 0;
+	frame_.reset();
 
-		for ( i=0; i<idx; i++ ) {
-			bufs[i]->setSize( iov[i].iov_len );
-#ifdef TCP_DEBUG
-			if ( i == 1 ) {
-				uint8_t  *p = bufs[i]->getPayload();
-#ifdef TCP_DEBUG_STRM
-				unsigned fram = (p[1]<<4) | (p[0]>>4);
-				unsigned frag = (p[4]<<16) | (p[3] << 8) | p[2];
-				fprintf(CPSW::fDbg(), "TCP: fram %d[%d]\n", fram, frag);
-#else
-				int      i;
-				fprintf(CPSW::fDbg(), "TCP got %d data: ",(int)len);
-				for ( i=0; i< (len < 20 ? len : 20); i++ )
-					fprintf(CPSW::fDbg(), "%02x ", p[i]);
-				fprintf(CPSW::fDbg(), "\n");
-#endif
+	CIOUring::recvLoop( &ring_, sd_, URING_RX_BUFS, URING_RX_CAPA, this, "cpsw_proto_mod_tcp" );
+}
+
+void CProtoModTcp::CRxHandlerThread::setActive(bool active)
+{
+	uringActive_.store( active, cpsw::memory_order_relaxed );
+}
+
+void CProtoModTcp::CRxHandlerThread::submitted()
+{
+	nRxCalls_.fetch_add(1, cpsw::memory_order_relaxed);
+}
+
+void CProtoModTcp::CRxHandlerThread::submitFailed(int err)
+{
+	throw InternalError("TCP: io_uring_enter: ", err);
+}
+
+void CProtoModTcp::CRxHandlerThread::recvFailed(int err)
+{
+	throw InternalError("TCP reading (io_uring): ", err);
+}
+
+void CProtoModTcp::CRxHandlerThread::closed()
+{
+	throw InternalError("TCP reading (io_uring): connection closed", ECONNRESET);
+}
+
+// the stream arrives in arbitrary chunks; reassemble
+// length headers and frames
+void CProtoModTcp::CRxHandlerThread::received(Buf chunk, size_t got)
+{
+const uint8_t *p    = chunk->getPayload();
+size_t         left = got;
+size_t         n;
+
+	if ( 0 == got ) {
+		closed();
+	}
+
+	while ( left > 0 ) {
+		if ( 0 == hdrGot_ && left >= sizeof(len_) ) {
+			memcpy( &len_, p, sizeof(len_) );
+			frameLen_ = ntohl( len_ );
+			if ( left - sizeof(len_) >= frameLen_ ) {
+				// complete frame; no need to copy
+				deliver( chunk->slice( p + sizeof(len_) - chunk->getPayload(), frameLen_ ), frameLen_ );
+				p    += sizeof(len_) + frameLen_;
+				left -= sizeof(len_) + frameLen_;
+				continue;
+			}
+		}
+		if ( hdrGot_ < sizeof(len_) ) {
+			n = sizeof(len_) - hdrGot_ < left ? sizeof(len_) - hdrGot_ : left;
+			memcpy( reinterpret_cast<uint8_t*>( &len_ ) + hdrGot_, p, n );
+			hdrGot_ += n;
+			p       += n;
+			left    -= n;
+			if ( hdrGot_ < sizeof(len_) ) {
+				continue;
 			}
+			frameLen_ = ntohl( len_ );
+#ifdef TCP_DEBUG
+			fprintf(CPSW::fDbg(), "TCP RX -- got length: %" PRId32 "\n", frameLen_);
 #endif
+			if ( frameLen_ > FRAME_MAX )
+				throw InternalError("TCP frame too big");
+			frame_    = IBufChain::create();
+			frameGot_ = 0;
+		} else {
+			n = frameLen_ - frameGot_ < left ? frameLen_ - frameGot_ : left;
+			// frames bigger than a slab span several buffers
+			frame_->insert( const_cast<uint8_t*>( p ), frameGot_, n, frameLen_ < IBuf::CAPA_SLAB ? frameLen_ : IBuf::CAPA_SLAB );
+			frameGot_ += n;
+			p         += n;
+			left      -= n;
+		}
+		if ( frameGot_ == frameLen_ ) {
+			deliver( frame_, frameLen_ );
+			frame_.reset();
+			hdrGot_ = 0;
+		}
+	}
+}
 
-			bufch->addAtTail( bufs[i] );
+// Read as much as is available into a slab and slice the
+// length-prefixed frames out of it without copying.
+void * CProtoModTcp::CRxHandlerThread::threadBody()
+{
+	ssize_t          got;
+	Buf              slab;
+	Buf              buf;
+	BufChain         frame;
+	uint8_t         *base = 0;
+	size_t           capa = 0;
+	size_t           off  = 0;   // start of the first unprocessed frame
+	size_t           end  = 0;   // end of valid data in slab
+	size_t           need;
+	size_t           left, n;
+	bool             fresh = true;
+	struct iovec     iov[FRAME_SLABS_MAX];
+	unsigned         niovs;
+
+	uint32_t         len;
 
-			// get new buffers
-			bufs[i] = IBuf::getBuf( IBuf::CAPA_ETH_BIG );
-			iov[i].iov_base = bufs[i]->getPayload();
-			iov[i].iov_len  = bufs[i]->getAvail();
+	if ( uring_ ) {
+		uringLoop();
+	}
+
+	while ( 1 ) {
+
+		if ( fresh ) {
+			// carry a partial frame over into a fresh slab;
+			// frames which are complete were sliced already.
+			buf  = IBuf::getBuf( IBuf::CAPA_SLAB );
+			left = end - off;
+			if ( left > 0 ) {
+				memcpy( buf->getPayload(), base + off, left );
+			}
+			slab = buf;
+			base = slab->getPayload();
+			capa = slab->getAvail();
+			off   = 0;
+			end   = left;
+			fresh = false;
 		}
 
 #ifdef TCP_DEBUG
-		bool st=
+		fprintf(CPSW::fDbg(), "TCP -- waiting for data\n");
 #endif
 
-			owner_->pushDown( bufch, &TIMEOUT_INDEFINITE );
+		if ( (got = ::read(sd_, base + end, capa - end)) <= 0 )
+			throw InternalError("TCP reading: ", errno);
+
+		nRxCalls_.fetch_add(1, cpsw::memory_order_relaxed);
+
+		end += got;
+		slab->setSize( end );
+
+		while ( end - off >= sizeof(len) ) {
+			memcpy( &len, base + off, sizeof(len) );
+			len  = ntohl(len);
+			need = sizeof(len) + len;
 
 #ifdef TCP_DEBUG
-			if ( st )
-				fprintf(CPSW::fDbg(), " (pushdown SUCC)\n");
-			else
-				fprintf(CPSW::fDbg(), " (pushdown DROP)\n");
+			fprintf(CPSW::fDbg(), "TCP RX -- got length: %" PRId32 "\n", len);
 #endif
 
+			if ( end - off >= need ) {
+				deliver( slab->slice( off + sizeof(len), len ), len );
+				off += need;
+				continue;
+			}
+
+			if ( need > capa ) {
+				// does not fit a slab; read the rest directly
+				// into a chain of slabs
+				if ( len > FRAME_MAX )
+					throw InternalError("TCP frame too big");
+				frame = IBufChain::create();
+				for ( niovs = 0, left = len; left > 0; niovs++ ) {
+					buf = frame->createAtTail( IBuf::CAPA_SLAB );
+					n   = buf->getAvail() < left ? buf->getAvail() : left;
+					buf->setSize( n );
+					iov[niovs].iov_base = buf->getPayload();
+					iov[niovs].iov_len  = n;
+					left               -= n;
+				}
+				// the part we have already is smaller than a slab
+				left = end - off - sizeof(len);
+				memcpy( iov[0].iov_base, base + off + sizeof(len), left );
+				iov[0].iov_base = reinterpret_cast<uint8_t*>( iov[0].iov_base ) + left;
+				iov[0].iov_len -= left;
+
+				xfer("readv()", ::readv, sd_, iov, niovs, len - left);
+
+				nRxCalls_.fetch_add(1, cpsw::memory_order_relaxed);
+
+				deliver( frame, len );
+				frame.reset();
+				off = end;
+			} else if ( off + need > capa ) {
+				// straddles the end of this slab
+				fresh = true;
+			}
+			break;
+		}
+
+		if ( end == capa ) {
+			fresh = true;
+		}
 	}
 	return NULL;
 }
 
-CProtoModTcp::CRxHandlerThread::CRxHandlerThread(const char *name, int threadPriority, int sd, CProtoModTcp *owner)
+CProtoModTcp::CRxHandlerThread::CRxHandlerThread(const char *name, int threadPriority, int sd, CProtoModTcp *owner, bool uring)
 : CRunnable(name, threadPriority),
   sd_(sd),
   nOctets_(0),
   nDgrams_(0),
+  nRxCalls_(0),
+  uring_(uring),
+  ring_(NULL),
+  uringActive_(false),
+  len_(0),
+  hdrGot_(0),
+  frameLen_(0),
+  frameGot_(0),
   owner_(owner)
 {
 }
@@ -174,11 +335,29 @@ CProtoModTcp::CRxHandlerThread::CRxHandlerThread(CRxHandlerThread &orig, int sd,
   sd_(sd),
   nOctets_(0),
   nDgrams_(0),
+  nRxCalls_(0),
+  uring_(orig.uring_),
+  ring_(NULL),
+  uringActive_(false),
+  len_(0),
+  hdrGot_(0),
+  frameLen_(0),
+  frameGot_(0),
   owner_(owner)
 {
 }
 
-void CProtoModTcp::createThread(int threadPriority)
+CProtoModTcp::CRxHandlerThread::~CRxHandlerThread()
+{
+	threadStop();
+	if ( ring_ ) {
+		// the kernel must be done with the buffers
+		ring_->cancelAll( sd_ );
+		delete ring_;
+	}
+}
+
+void CProtoModTcp::createThread(int threadPriority, bool ioUring)
 {
 	// might be called by the copy constructor
 	if ( rxHandler_ ) {
@@ -186,7 +365,7 @@ void CProtoModTcp::createThread(int threadPriority)
 		rxHandler_ = NULL;
 	}
 
-	rxHandler_ = new CRxHandlerThread("TCP RX Handler (TCP protocol module)", threadPriority, sd_.getSd(), this );
+	rxHandler_ = new CRxHandlerThread("TCP RX Handler (TCP protocol module)", threadPriority, sd_.getSd(), this, ioUring );
 }
 
 void CProtoModTcp::modStartup()
@@ -207,7 +386,8 @@ CProtoModTcp::CProtoModTcp(
 	unsigned                  depth,
 	int                       threadPriority,
 	const LibSocksProxy      *proxy,
-	const struct sockaddr_in *via
+	const struct sockaddr_in *via,
+	bool                      ioUring
 )
 :CProtoMod(k, depth),
  dest_     (*dest               ),
@@ -218,7 +398,7 @@ CProtoModTcp::CProtoModTcp(
  rxHandler_(NULL                )
 {
 	sd_.init( &via_, 0, false );
-	createThread( threadPriority );
+	createThread( threadPriority, ioUring );
 }
 
 void
@@ -231,6 +411,9 @@ int prio = rxHandler_->getPrio();
 	if ( prio != IProtoStackBuilder::DFLT_THREAD_PRIORITY ) {
 		writeNode(tcpParms, YAML_KEY_threadPriority, prio);
 	}
+	if ( rxHandler_->wantIOUring() ) {
+		writeNode(tcpParms, YAML_KEY_ioUring, true);
+	}
 	writeNode(node, YAML_KEY_TCP, tcpParms);
 }
 
@@ -243,7 +426,7 @@ CProtoModTcp::CProtoModTcp(CProtoModTcp &orig, Key &k)
  nTxDgrams_(0)
 {
 	sd_.init( &via_, 0, false );
-	createThread( orig.rxHandler_->getPrio() );
+	createThread( orig.rxHandler_->getPrio(), orig.rxHandler_->wantIOUring() );
 }
 
 uint64_t CProtoModTcp::getNumRxOctets()
@@ -256,6 +439,16 @@ uint64_t CProtoModTcp::getNumRxDgrams()
 	return rxHandler_ ? rxHandler_->getNumDgrams() : 0;
 }
 
+uint64_t CProtoModTcp::getNumRxCalls()
+{
+	return rxHandler_ ? rxHandler_->getNumRxCalls() : 0;
+}
+
+bool CProtoModTcp::hasIOUringRx()
+{
+	return rxHandler_ && rxHandler_->hasIOUring();
+}
+
 CProtoModTcp::~CProtoModTcp()
 {
 	if ( rxHandler_ )
@@ -271,10 +464,13 @@ void CProtoModTcp::dumpInfo(FILE *f)
 	fprintf(f,"CProtoModTcp:\n");
 	fprintf(f,"  Peer port : %15u\n",    getDestPort());
 	fprintf(f,"  ThreadPrio: %15d\n",    rxHandler_->getPrio());
+	fprintf(f,"  io_uring  :               %c\n", hasIOUringRx() ? 'Y' : 'N');
 	fprintf(f,"  #TX Octets: %15" PRIu64 "\n", getNumTxOctets());
 	fprintf(f,"  #TX DGRAMs: %15" PRIu64 "\n", getNumTxDgrams());
 	fprintf(f,"  #RX Octets: %15" PRIu64 "\n", getNumRxOctets());
 	fprintf(f,"  #RX DGRAMs: %15" PRIu64 "\n", getNumRxDgrams());
+	fprintf(f,"  #RX calls : %15" PRIu64 "\n", getNumRxCalls());
+	fprintf(f,"  RX dg/call: %15.2f\n",   getNumRxCalls() ? (double)getNumRxDgrams()/(double)getNumRxCalls() : 0.0);
 }
 
 bool CProtoModTcp::doPush(BufChain bc, bool wait, const CTimeout *timeout, bool abs_timeout)
@@ -16,6 +16,7 @@
 #include <cpsw_sock.h>
 #include <cpsw_mutex.h>
 #include <cpsw_compat.h>
+#include <cpsw_io_uring.h>
 
 #include <arpa/inet.h>
 #include <netinet/in.h>
@@ -26,16 +27,28 @@ class CProtoModTcp;
 typedef shared_ptr<CProtoModTcp> ProtoModTcp;
 
 // TCP transport for framed traffic. Frames are prepended a 32-bit
-// 'length' header in network byte order.
+// 'length' header in network byte order. Received frames which are
+// bigger than a slab are delivered as a chain of slabs (up to ~1MB).
 
 class CProtoModTcp : public CProtoMod {
 protected:
 
-	class CRxHandlerThread : public CRunnable {
+	class CRxHandlerThread : public CRunnable, public CIOUring::IRecvHandler {
 		private:
 			int              sd_;
 			atomic<uint64_t> nOctets_;
 			atomic<uint64_t> nDgrams_;
+			atomic<uint64_t> nRxCalls_;
+			// receive with io_uring (multishot) if possible
+			bool             uring_;
+			CIOUring        *ring_;
+			atomic<bool>     uringActive_;
+			// io_uring frame reassembly
+			uint32_t         len_;
+			unsigned         hdrGot_;
+			BufChain         frame_;
+			uint32_t         frameLen_;
+			uint32_t         frameGot_;
 		public:
 			// cannot use smart pointer here because CProtoModUdp's
 			// constructor creates the threads (and a smart ptr is
@@ -48,14 +61,32 @@ protected:
 
 			virtual void* threadBody();
 
+			virtual void  deliver(Buf buf, uint32_t len);
+
+			virtual void  deliver(BufChain bufch, uint32_t len);
+
+			// returns (only) if io_uring cannot be used
+			virtual void  uringLoop();
+
+			// CIOUring::IRecvHandler
+			virtual void  setActive(bool active);
+			virtual void  submitted();
+			virtual void  submitFailed(int err);
+			virtual void  received(Buf chunk, size_t got);
+			virtual void  recvFailed(int err);
+			virtual void  closed();
+
 		public:
-			CRxHandlerThread(const char *name, int threadPriority, int sd, CProtoModTcp *owner);
+			CRxHandlerThread(const char *name, int threadPriority, int sd, CProtoModTcp *owner, bool uring = false);
 			CRxHandlerThread(CRxHandlerThread &orig, int sd, CProtoModTcp *owner);
 
 			virtual uint64_t getNumOctets() { return nOctets_.load( cpsw::memory_order_relaxed ); }
 			virtual uint64_t getNumDgrams() { return nDgrams_.load( cpsw::memory_order_relaxed ); }
+			virtual uint64_t getNumRxCalls(){ return nRxCalls_.load( cpsw::memory_order_relaxed ); }
+			virtual bool     hasIOUring()   { return uringActive_.load( cpsw::memory_order_relaxed ); }
+			virtual bool     wantIOUring()  { return uring_; }
 
-			virtual ~CRxHandlerThread() { threadStop(); }
+			virtual ~CRxHandlerThread();
 	};
 
 private:
@@ -69,7 +100,7 @@ private:
 protected:
 	CRxHandlerThread  *rxHandler_;
 
-	void createThread(int threadPriority);
+	void createThread(int threadPriority, bool ioUring);
 
 	virtual bool doPush(BufChain bc, bool wait, const CTimeout *timeout, bool abs_timeout);
 
@@ -92,7 +123,9 @@ public:
 		unsigned                  depth,
 		int                       threadPriority,
 		const LibSocksProxy      *proxy,
-		const struct sockaddr_in *via
+		const struct sockaddr_in *via,
+		// receive with io_uring; falls back to read() if unavailable
+		bool                      ioUring = false
 	);
 
 	CProtoModTcp(CProtoModTcp &orig, Key &k);
@@ -120,6 +153,8 @@ public:
 	virtual uint64_t getNumTxDgrams() { return nTxDgrams_.load( cpsw::memory_order_relaxed ); }
 	virtual uint64_t getNumRxOctets();
 	virtual uint64_t getNumRxDgrams();
+	virtual uint64_t getNumRxCalls();
+	virtual bool     hasIOUringRx();
 	virtual void modStartup();
 	virtual void modShutdown();
 
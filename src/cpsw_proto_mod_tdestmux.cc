@@ -84,6 +84,8 @@ YAML::Node parms;
 	writeNode(parms, YAML_KEY_stripHeader  , stripHeader_   );
 	writeNode(parms, YAML_KEY_outQueueDepth, getQueueDepth());
 	writeNode(parms, YAML_KEY_TDEST        , getDest()      );
+	if ( getOwner()->getRunToCompletion() )
+		writeNode(parms, YAML_KEY_runToCompletion, true);
 
 	writeNode(node, YAML_KEY_TDESTMux, parms);
 }
@@ -127,6 +127,14 @@ public:
 
 	virtual int extractDest(BufChain);
 
+	// the ports keep per-TDEST reassembly state which must not
+	// be entered by multiple (upstream) threads; always use our
+	// own thread.
+	virtual bool acceptInline()
+	{
+		return false;
+	}
+
 	virtual CProtoModTDestMux2 *clone(Key k)
 	{
 		return new CProtoModTDestMux2( *this, k );
@@ -17,8 +17,17 @@
 #include <cpsw_stdio.h>
 
 #include <errno.h>
+#include <limits.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <time.h>
 #include <sys/select.h>
 #include <sys/uio.h>
+#include <sys/socket.h>
+#include <netinet/udp.h>
+#include <string.h>
+#include <algorithm>
 
 #include <stdio.h>
 
@@ -27,6 +36,17 @@
 //#define UDP_DEBUG
 //#define UDP_DEBUG_STRM
 
+// older headers may lack these
+#ifndef SOL_UDP
+#define SOL_UDP     17
+#endif
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103
+#endif
+#ifndef UDP_GRO
+#define UDP_GRO     104
+#endif
+
 CUdpHandlerThread::CUdpHandlerThread(
 	const char         *name,
 	int                 threadPriority,
@@ -45,122 +65,351 @@ CUdpHandlerThread::CUdpHandlerThread(CUdpHandlerThread &orig, struct sockaddr_in
 	sd_.init( dest, me_p, false );
 }
 
-#define NBUFS_MAX 8
+// GSO packets are limited to 64 segments by (older) kernels
+#define GSO_SEGS_MAX  64
+#define GSO_SIZE_MAX  (65535 - 8 - 60)
 
-void * CProtoModUdp::CUdpRxHandlerThread::threadBody()
+void CProtoModUdp::CUdpRxHandlerThread::enableGro()
 {
-	ssize_t          got,siz,cap;
-	std::vector<Buf> bufs;
-	unsigned         idx;
-
-	struct iovec     iov[NBUFS_MAX];
-	int              niovs;
+int on = 1;
+	if ( gro_ ) {
+		if ( ::setsockopt( sd_.getSd(), SOL_UDP, UDP_GRO, &on, sizeof(on) ) ) {
+			fprintf(CPSW::fErr(), "WARNING: cpsw_proto_mod_udp: UDP_GRO not supported (%s); falling back\n", strerror(errno));
+			gro_ = false;
+		}
+	}
+}
 
-	for ( niovs = 0, cap = 0; niovs<NBUFS_MAX && cap < (ssize_t)IBuf::CAPA_ETH_JUM; niovs++ ) {
-		bufs.push_back( IBuf::getBuf( IBuf::CAPA_ETH_BIG ) );
-		iov[niovs].iov_base = bufs[niovs]->getPayload();
-		cap += (iov[niovs].iov_len  = bufs[niovs]->getAvail());
+// Post a single contiguous buffer for the next message: a jumbo buffer
+// or - with GRO - a slab which holds an entire coalesced packet.
+void CProtoModUdp::CUdpRxHandlerThread::post(Buf *buf_p, struct iovec *iov)
+{
+	if ( gro_ ) {
+		*buf_p = IBuf::getBuf( IBuf::CAPA_SLAB );
+	} else {
+		*buf_p = IBuf::getBuf( IBuf::CAPA_ETH_JUM );
 	}
+	iov->iov_base = (*buf_p)->getPayload();
+	iov->iov_len  = (*buf_p)->getAvail();
+}
 
-	while ( 1 ) {
+void CProtoModUdp::CUdpRxHandlerThread::deliver(Buf buf, ssize_t tot, ssize_t gso)
+{
+ssize_t  seg, off;
+unsigned nsegs;
 
-#ifdef UDP_DEBUG
-		fprintf(CPSW::fDbg(), "UDP -- waiting for data\n");
-#endif
-		got = ::readv( sd_.getSd(), iov, niovs );
-		if ( got < 0 ) {
-			perror("rx thread");
-			sleep(10);
-			continue;
+	buf->setSize( tot );
+
+	off   = 0;
+	nsegs = 0;
+	while ( off < tot ) {
+		BufChain bufch = IBufChain::create();
+
+		seg = tot - off < gso ? tot - off : gso;
+
+		if ( gso == tot ) {
+			// hand the buffer over
+			bufch->addAtTail( buf );
+		} else {
+			// segments of a GRO packet are views of the slab
+			bufch->addAtTail( buf->slice( off, seg ) );
 		}
-		nDgrams_.fetch_add(1,   cpsw::memory_order_relaxed);
-		nOctets_.fetch_add(got, cpsw::memory_order_relaxed);
 
-		if ( got > 0 ) {
+		off += seg;
+		nsegs++;
+
 #ifdef UDP_DEBUG
+		{
+		unsigned  i;
+		uint8_t   b[4];
+		unsigned  l = bufch->getSize() < sizeof(b) ? bufch->getSize() : sizeof(b);
 #ifdef UDP_DEBUG_STRM
-			unsigned fram, frag;
+		unsigned  fram, frag;
 #endif
+			bufch->extract( b, 0, l );
+			fprintf(CPSW::fDbg(), "UDP data: ");
+			for ( i=0; i<l; i++ )
+				fprintf(CPSW::fDbg(), "%02x ", b[i]);
+			fprintf(CPSW::fDbg(), "\n");
+			fprintf(CPSW::fDbg(), "UDP got %d", (int)bufch->getSize());
+#ifdef UDP_DEBUG_STRM
+			fram = (b[1]<<4) | (b[0]>>4);
+			frag = (b[4]<<16) | (b[3] << 8) | b[2];
+			fprintf(CPSW::fDbg(), " fram # %4d, frag # %4d", fram, frag);
+#endif
+		}
 #endif
-			BufChain bufch = IBufChain::create();
 
-			siz = got;
-			idx = 0;
-			while ( siz > 0 ) {
-				if ( siz < (cap = bufs[idx]->getAvail()) ) {
-					cap = siz;
-				}
-				bufs[idx]->setSize( cap );
+	bool st=
+		// do NOT wait indefinitely
+		// could be that the queue is full with
+		// retry replies they will only discover
+		// next time they care about reading from
+		// this VC...
+		owner_->pushDown( bufch, &TIMEOUT_NONE );
+
 #ifdef UDP_DEBUG
-				if ( idx == 0 ) {
-					int      i;
-					uint8_t  *p = bufs[idx]->getPayload();
-#ifdef UDP_DEBUG_STRM
-					fram = (p[1]<<4) | (p[0]>>4);
-					frag = (p[4]<<16) | (p[3] << 8) | p[2];
-#endif
-					fprintf(CPSW::fDbg(), "UDP data: ");
-					for ( i=0; i< (got < 4 ? got : 4); i++ )
-						fprintf(CPSW::fDbg(), "%02x ", p[i]);
-					fprintf(CPSW::fDbg(), "\n");
-				}
+		if ( st )
+			fprintf(CPSW::fDbg(), " (pushdown SUCC)\n");
+		else
+			fprintf(CPSW::fDbg(), " (pushdown DROP)\n");
 #endif
 
-				bufch->addAtTail( bufs[idx] );
+		if ( st ) {
+			nRxDrop_.fetch_add(1,   cpsw::memory_order_relaxed);
+		}
+	}
 
-				// get new buffers
-				bufs[idx] = IBuf::getBuf( IBuf::CAPA_ETH_BIG );
-				iov[idx].iov_base = bufs[idx]->getPayload();
-				iov[idx].iov_len  = bufs[idx]->getAvail();
-				idx++;
-				siz -= cap;
-			}
+	nDgrams_.fetch_add(nsegs, cpsw::memory_order_relaxed);
+
+	if ( gso != tot ) {
+		nGroSegs_.fetch_add(nsegs, cpsw::memory_order_relaxed);
+	}
+}
+
+int CProtoModUdp::CUdpRxHandlerThread::receive(int flags)
+{
+	ssize_t          tot;
+	int              got, msg, gso;
+	struct cmsghdr  *cmsg;
+	const size_t     CTRL_SIZE = CMSG_SPACE( sizeof(int) );
 
-		bool st=
-			// do NOT wait indefinitely
-			// could be that the queue is full with
-			// retry replies they will only discover
-			// next time they care about reading from
-			// this VC...
-			owner_->pushDown( bufch, &TIMEOUT_NONE );
+	if ( bufs_.empty() ) {
+		// first time around
+		bufs_.resize( batch_ );
+		iovs_.resize( batch_ );
+		msgs_.resize( batch_ );
+		ctrl_.resize( batch_ * CTRL_SIZE / sizeof(uint64_t) + 1 );
+		for ( msg = 0; msg < (int)batch_; msg++ ) {
+			memset( &msgs_[msg], 0, sizeof(msgs_[msg]) );
+			msgs_[msg].msg_hdr.msg_iov    = &iovs_[msg];
+			msgs_[msg].msg_hdr.msg_iovlen = 1;
+			post( &bufs_[msg], &iovs_[msg] );
+		}
+	}
+
+	if ( gro_ ) {
+		for ( msg = 0; msg < (int)batch_; msg++ ) {
+			msgs_[msg].msg_hdr.msg_control    = (char*)&ctrl_[0] + msg * CTRL_SIZE;
+			msgs_[msg].msg_hdr.msg_controllen = CTRL_SIZE;
+		}
+	}
 
 #ifdef UDP_DEBUG
-			fprintf(CPSW::fDbg(), "UDP got %d", (int)got);
-#ifdef UDP_DEBUG_STRM
-			fprintf(CPSW::fDbg(), " fram # %4d, frag # %4d", fram, frag);
-#endif
-			if ( st )
-				fprintf(CPSW::fDbg(), " (pushdown SUCC)\n");
-			else
-				fprintf(CPSW::fDbg(), " (pushdown DROP)\n");
+	fprintf(CPSW::fDbg(), "UDP -- waiting for data\n");
 #endif
+	got = ::recvmmsg( sd_.getSd(), &msgs_[0], batch_, flags, NULL );
+	if ( got < 0 ) {
+		return got;
+	}
+	nRxCalls_.fetch_add(1,   cpsw::memory_order_relaxed);
+
+	for ( msg = 0; msg < got; msg++ ) {
 
-			if ( st ) {
-				nRxDrop_.fetch_add(1,   cpsw::memory_order_relaxed);
+		tot = msgs_[msg].msg_len;
+
+		nOctets_.fetch_add(tot, cpsw::memory_order_relaxed);
+
+		// a GRO packet carries the segment size
+		gso = 0;
+		if ( gro_ ) {
+			for ( cmsg = CMSG_FIRSTHDR( &msgs_[msg].msg_hdr ); cmsg; cmsg = CMSG_NXTHDR( &msgs_[msg].msg_hdr, cmsg ) ) {
+				if ( SOL_UDP == cmsg->cmsg_level && UDP_GRO == cmsg->cmsg_type ) {
+					memcpy( &gso, CMSG_DATA( cmsg ), sizeof(gso) );
+				}
 			}
 		}
+		if ( gso <= 0 || gso >= tot ) {
+			// a plain datagram
+			gso = tot;
+		}
+
+		if ( msgs_[msg].msg_hdr.msg_flags & MSG_TRUNC ) {
+			// didn't fit; only complete segments can be delivered
+			tot = gso < tot ? tot - tot % gso : 0;
+		}
+
 #ifdef UDP_DEBUG
-		else {
+		if ( 0 == tot ) {
 			fprintf(CPSW::fDbg(), "UDP got ZERO\n");
 		}
 #endif
+
+		deliver( bufs_[msg], tot, gso );
+
+		// replace what was consumed
+		post( &bufs_[msg], &iovs_[msg] );
+	}
+	return got;
+}
+
+// number of buffers provided to a RX ring (power of two)
+#define URING_RX_BUFS_MIN 16
+
+void CProtoModUdp::CUdpRxHandlerThread::uringLoop()
+{
+unsigned nbufs;
+
+	for ( nbufs = URING_RX_BUFS_MIN; nbufs < 2*batch_; nbufs <<= 1 )
+		;
+
+	// every datagram lands in a buffer of its own which
+	// the kernel picks from those we provided
+	CIOUring::recvLoop( &ring_, sd_.getSd(), nbufs, IBuf::CAPA_ETH_JUM, this, "cpsw_proto_mod_udp" );
+}
+
+void CProtoModUdp::CUdpRxHandlerThread::setActive(bool active)
+{
+	uringActive_.store( active, cpsw::memory_order_relaxed );
+}
+
+void CProtoModUdp::CUdpRxHandlerThread::submitted()
+{
+	nRxCalls_.fetch_add(1, cpsw::memory_order_relaxed);
+}
+
+void CProtoModUdp::CUdpRxHandlerThread::submitFailed(int err)
+{
+	errno = err;
+	perror("rx thread (io_uring_enter)");
+	sleep(10);
+}
+
+void CProtoModUdp::CUdpRxHandlerThread::received(Buf buf, size_t got)
+{
+	nOctets_.fetch_add(got, cpsw::memory_order_relaxed);
+	deliver( buf, got, got );
+}
+
+void CProtoModUdp::CUdpRxHandlerThread::recvFailed(int err)
+{
+	errno = err;
+	perror("rx thread (io_uring recv)");
+}
+
+void * CProtoModUdp::CUdpRxHandlerThread::threadBody()
+{
+cpu_set_t cpus;
+int       err;
+
+	if ( cpu_ >= 0 ) {
+		CPU_ZERO( &cpus );
+		CPU_SET( cpu_, &cpus );
+		if ( (err = pthread_setaffinity_np( pthread_self(), sizeof(cpus), &cpus )) ) {
+			fprintf(CPSW::fErr(), "WARNING: cpsw_proto_mod_udp: unable to pin RX thread to CPU %d (%s)\n", cpu_, strerror(err));
+		}
+	}
+
+	if ( uring_ && ! gro_ ) {
+		// plain 'recv' does not report the GRO segment size
+		uringLoop();
+	}
+
+	while ( 1 ) {
+		// block for the first datagram; pick up whatever else is
+		// already queued without waiting
+		if ( receive( MSG_WAITFORONE ) < 0 ) {
+			perror("rx thread");
+			sleep(10);
+		}
 	}
 	return NULL;
 }
 
+void CProtoModUdp::CUdpRxHandlerThread::setBusyPoll(unsigned us)
+{
+#ifdef SO_BUSY_POLL
+int val = us;
+	// raising the value above 'net.core.busy_read' requires CAP_NET_ADMIN
+	if ( ::setsockopt( sd_.getSd(), SOL_SOCKET, SO_BUSY_POLL, &val, sizeof(val) ) ) {
+		fprintf(CPSW::fErr(), "WARNING: cpsw_proto_mod_udp: SO_BUSY_POLL not permitted (%s); polling the socket only\n", strerror(errno));
+	}
+#endif
+}
+
+unsigned CProtoModUdp::CUdpRxHandlerThread::setRcvBuf(unsigned bytes)
+{
+int       val;
+socklen_t sl = sizeof(val);
+
+	if ( ::getsockopt( sd_.getSd(), SOL_SOCKET, SO_RCVBUF, &val, &sl ) ) {
+		throw InternalError("getsockopt(SO_RCVBUF) failed", errno);
+	}
+	// linux reports twice the requested size (bookkeeping overhead)
+	if ( (unsigned)val/2 >= bytes ) {
+		return val/2;
+	}
+	val = bytes;
+	// silently clipped to 'net.core.rmem_max'
+	if ( ::setsockopt( sd_.getSd(), SOL_SOCKET, SO_RCVBUF, &val, sizeof(val) ) ) {
+		throw InternalError("setsockopt(SO_RCVBUF) failed", errno);
+	}
+	sl = sizeof(val);
+	if ( ::getsockopt( sd_.getSd(), SOL_SOCKET, SO_RCVBUF, &val, &sl ) ) {
+		throw InternalError("getsockopt(SO_RCVBUF) failed", errno);
+	}
+	return val/2;
+}
+
+bool CProtoModUdp::CUdpRxHandlerThread::poll()
+{
+Buf     buf;
+ssize_t got;
+
+	if ( gro_ ) {
+		// plain 'recv' does not report the GRO segment size
+		return false;
+	}
+
+	buf = IBuf::getBuf( IBuf::CAPA_ETH_JUM );
+
+	if ( (got = ::recv( sd_.getSd(), buf->getPayload(), buf->getAvail(), MSG_DONTWAIT )) < 0 ) {
+		return false;
+	}
+
+	nRxCalls_.fetch_add(1,   cpsw::memory_order_relaxed);
+	nPolled_.fetch_add(1,    cpsw::memory_order_relaxed);
+	nOctets_.fetch_add(got,  cpsw::memory_order_relaxed);
+
+	deliver( buf, got, got );
+
+	return true;
+}
+
+void CProtoModUdp::CUdpRxHandlerThread::handleInput()
+{
+	// level-triggered; the pool calls us again if more is queued
+	if ( receive( MSG_DONTWAIT ) < 0 && EAGAIN != errno && EWOULDBLOCK != errno && EINTR != errno ) {
+		perror("rx handler (I/O pool)");
+	}
+}
+
 CProtoModUdp::CUdpRxHandlerThread::CUdpRxHandlerThread(
 	const char         *name,
 	int                 threadPriority,
 	struct sockaddr_in *dest,
 	struct sockaddr_in *me,
-	CProtoModUdp       *owner
+	CProtoModUdp       *owner,
+	unsigned            batch,
+	bool                gro,
+	bool                uring
 )
 : CUdpHandlerThread(name, threadPriority, dest, me),
   nOctets_(0),
   nDgrams_(0),
   nRxDrop_(0),
+  nRxCalls_(0),
+  nGroSegs_(0),
+  nPolled_(0),
+  batch_(batch ? batch : 1),
+  gro_(gro),
+  uring_(uring),
+  ring_(NULL),
+  uringActive_(false),
+  cpu_(-1),
   owner_(owner)
 {
+	enableGro();
 }
 
 CProtoModUdp::CUdpRxHandlerThread::CUdpRxHandlerThread(CUdpRxHandlerThread &orig, struct sockaddr_in *dest, struct sockaddr_in *me, CProtoModUdp *owner)
@@ -168,8 +417,36 @@ CProtoModUdp::CUdpRxHandlerThread::CUdpRxHandlerThread(CUdpRxHandlerThread &orig
   nOctets_(0),
   nDgrams_(0),
   nRxDrop_(0),
+  nRxCalls_(0),
+  nGroSegs_(0),
+  nPolled_(0),
+  batch_(orig.batch_),
+  gro_(orig.gro_),
+  uring_(orig.uring_),
+  ring_(NULL),
+  uringActive_(false),
+  cpu_(orig.cpu_),
   owner_(owner)
 {
+	enableGro();
+}
+
+CProtoModUdp::CUdpRxHandlerThread::~CUdpRxHandlerThread()
+{
+	threadStop();
+	if ( ring_ ) {
+		// the kernel must be done with the buffers
+		ring_->cancelAll( sd_.getSd() );
+		delete ring_;
+	}
+}
+
+void CUdpPeerPollerThread::handleTimeout()
+{
+uint8_t buf[4];
+	if ( ::write( sd_.getSd(), buf, 0 ) < 0 ) {
+		perror("poller (write)");
+	}
 }
 
 void * CUdpPeerPollerThread::threadBody()
@@ -199,6 +476,56 @@ CUdpPeerPollerThread::CUdpPeerPollerThread(CUdpPeerPollerThread &orig, struct so
 {
 }
 
+CProtoModUdp::CUdpTxFlusherThread::CUdpTxFlusherThread(const char *name, int threadPriority, CProtoModUdp *owner)
+: CRunnable(name, threadPriority),
+  owner_(owner)
+{
+}
+
+void * CProtoModUdp::CUdpTxFlusherThread::threadBody()
+{
+CTimeout deadline;
+CTimeout now;
+bool     err = false;
+int      ost;
+
+	while ( 1 ) {
+		{
+			owner_->txMtx_.l();
+			pthread_cleanup_push( CCond::pthread_mutex_unlock_wrapper, (void*)owner_->txMtx_.getp() );
+
+			// a flush in progress picks up anything pushed meanwhile
+			while ( owner_->txPend_.empty() || owner_->txBusy_ ) {
+				if ( pthread_cond_wait( owner_->txCond_.getp(), owner_->txMtx_.getp() ) ) {
+					err = true;
+					goto bail;
+				}
+			}
+			deadline = owner_->txDeadline_;
+bail:
+			pthread_cleanup_pop( 1 ); // unlocks txMtx_
+		}
+
+		if ( err )
+			throw CondWaitFailed();
+
+		clock_nanosleep( CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline.tv_, 0 );
+
+		// don't leave 'txBusy_' set if cancelled while sending
+		pthread_setcancelstate( PTHREAD_CANCEL_DISABLE, &ost );
+		{
+		CMtx::lg guard( &owner_->txMtx_ );
+			clock_gettime( CLOCK_MONOTONIC, &now.tv_ );
+			// the batch might have been sent (and a new one started) while we slept
+			if ( ! owner_->txPend_.empty() && ! owner_->txBusy_ && ! (now < owner_->txDeadline_) ) {
+				owner_->flushTx_unl( true, NULL );
+			}
+		}
+		pthread_setcancelstate( ost, NULL );
+	}
+	return NULL;
+}
+
 void CProtoModUdp::createThreads(unsigned nRxThreads, int pollSeconds)
 {
 	unsigned i;
@@ -216,35 +543,95 @@ void CProtoModUdp::createThreads(unsigned nRxThreads, int pollSeconds)
 	// might be called by the copy constructor
 	rxHandlers_.clear();
 
+	for ( i=0; i<sizeof(shardOf_)/sizeof(shardOf_[0]); i++ ) {
+		shardOf_[i].store( -1 );
+	}
+
 	for ( i=0; i<nRxThreads; i++ ) {
-		rxHandlers_.push_back( new CUdpRxHandlerThread("UDP RX Handler (UDP protocol module)", threadPriority_, &dest_, &me, this ) );
+		struct sockaddr_in mine = me;
+		if ( i > 0 && shardKeyOff_ >= 0 ) {
+			// a source port of its own; the peer replies to it.
+			// The first shard shares the port with 'tx_' (where
+			// unsolicited traffic, e.g., streams, is received).
+			mine.sin_port = 0;
+		}
+		rxHandlers_.push_back( new CUdpRxHandlerThread("UDP RX Handler (UDP protocol module)", threadPriority_, &dest_, &mine, this, rxBatch_, offload_, ioUring_ ) );
+		if ( shardKeyOff_ >= 0 ) {
+			long ncpus = sysconf( _SC_NPROCESSORS_ONLN );
+			rxHandlers_[i]->setCpu( ncpus > 0 ? i % ncpus : 0 );
+		}
 	}
 
 	// maybe setting the threadPriority failed?
 	if ( nRxThreads ) {
 		threadPriority_ = rxHandlers_[0]->getPrio();
 	}
+
+	txFlusher_ = NULL;
+	if ( txBatch_ > 1 && txBatchUs_ > 0 ) {
+		txFlusher_ = new CUdpTxFlusherThread("UDP TX Flusher (UDP protocol module)", threadPriority_, this);
+	}
 }
 
 void CProtoModUdp::modStartup()
 {
 unsigned i;
-	if ( poller_ )
-		poller_->threadStart();
-	for ( i=0; i<rxHandlers_.size(); i++ ) {
-		rxHandlers_[i]->threadStart();
+	if ( ioPool_ ) {
+		CIOPool *pool = CIOPool::getPool();
+		if ( poller_ ) {
+			// the thread polls right away, too
+			poller_->handleTimeout();
+			pollWorker_ = pool->addTimer( poller_, CTimeout( (uint64_t)poller_->getPollSecs() * 1000000 ) );
+		}
+		for ( i=0; i<rxHandlers_.size(); i++ ) {
+			rxWorkers_.push_back( pool->addFd( rxHandlers_[i]->getSd(), rxHandlers_[i] ) );
+		}
+	} else {
+		if ( poller_ )
+			poller_->threadStart();
+		for ( i=0; i<rxHandlers_.size(); i++ ) {
+			rxHandlers_[i]->threadStart();
+		}
+	}
+	if ( txFlusher_ )
+		txFlusher_->threadStart();
+}
+
+void CProtoModUdp::poolRemove()
+{
+unsigned i;
+	if ( pollWorker_ ) {
+		CIOPool::remove( pollWorker_, -1, poller_ );
+		pollWorker_ = NULL;
+	}
+	for ( i=0; i<rxWorkers_.size(); i++ ) {
+		CIOPool::remove( rxWorkers_[i], rxHandlers_[i]->getSd(), rxHandlers_[i] );
 	}
+	rxWorkers_.clear();
 }
 
 void CProtoModUdp::modShutdown()
 {
 unsigned i;
+	poolRemove();
+
 	if ( poller_ )
 		poller_->threadStop();
 
 	for ( i=0; i<rxHandlers_.size(); i++ ) {
 		rxHandlers_[i]->threadStop();
 	}
+
+	if ( txFlusher_ ) {
+		txFlusher_->threadStop();
+	}
+
+	{
+	CMtx::lg guard( &txMtx_ );
+		// send what is still lingering
+		if ( ! txBusy_ && ! txPend_.empty() )
+			flushTx_unl( false, NULL );
+	}
 }
 
 CProtoModUdp::CProtoModUdp(
@@ -253,16 +640,44 @@ CProtoModUdp::CProtoModUdp(
 	unsigned            depth,
 	int                 threadPriority,
 	unsigned            nRxThreads,
-	int                 pollSecs
+	int                 pollSecs,
+	unsigned            rxBatch,
+	unsigned            txBatch,
+	unsigned            txBatchUs,
+	bool                offload,
+	bool                ioPool,
+	bool                ioUring,
+	int                 shardKeyOff
 )
 :CProtoMod(k, depth),
  dest_(*dest),
  nTxOctets_(0),
  nTxDgrams_(0),
  threadPriority_(threadPriority),
- poller_( NULL )
+ rxBatch_(rxBatch ? rxBatch : 1),
+ txBatch_(txBatch ? txBatch : 1),
+ txBatchUs_(txBatchUs),
+ txMtx_("UDP TX"),
+ txBusy_(false),
+ nTxCalls_(0),
+ offload_(offload),
+ gso_(false),
+ gsoSegMax_(0),
+ nTxGsoSegs_(0),
+ ioPool_(ioPool),
+ pollWorker_( NULL ),
+ ioUring_(ioUring),
+ txRing_( NULL ),
+ shardKeyOff_(shardKeyOff),
+ nextShard_(0),
+ shardMtx_("UDP shards"),
+ rcvBuf_(0),
+ poller_( NULL ),
+ txFlusher_( NULL )
 {
 	tx_.init( dest, 0, true );
+	probeGso();
+	createTxRing();
 	createThreads( nRxThreads, pollSecs );
 }
 
@@ -274,6 +689,19 @@ CProtoModUdp::dumpYaml(YAML::Node &node) const
 	writeNode(udpParms, YAML_KEY_outQueueDepth, getQueueDepth()   );
 	writeNode(udpParms, YAML_KEY_numRxThreads,  rxHandlers_.size());
 	writeNode(udpParms, YAML_KEY_pollSecs,      poller_ ? poller_->getPollSecs() : 0);
+	writeNode(udpParms, YAML_KEY_rxBatchSize,   rxBatch_          );
+	writeNode(udpParms, YAML_KEY_txBatchSize,   txBatch_          );
+	writeNode(udpParms, YAML_KEY_txBatchUS,     txBatchUs_        );
+	writeNode(udpParms, YAML_KEY_segmentOffload, offload_         );
+	if ( ioPool_ ) {
+		writeNode(udpParms, YAML_KEY_ioPool,     ioPool_          );
+	}
+	if ( ioUring_ ) {
+		writeNode(udpParms, YAML_KEY_ioUring,    ioUring_         );
+	}
+	if ( shardKeyOff_ >= 0 ) {
+		writeNode(udpParms, YAML_KEY_shardedRx,  true             );
+	}
 	if ( threadPriority_ != IProtoStackBuilder::DFLT_THREAD_PRIORITY ) {
 		writeNode(udpParms, YAML_KEY_threadPriority,  threadPriority_);
 	}
@@ -287,9 +715,30 @@ CProtoModUdp::CProtoModUdp(CProtoModUdp &orig, Key &k)
  nTxOctets_(0),
  nTxDgrams_(0),
  threadPriority_(orig.threadPriority_),
- poller_(orig.poller_)
+ rxBatch_(orig.rxBatch_),
+ txBatch_(orig.txBatch_),
+ txBatchUs_(orig.txBatchUs_),
+ txMtx_("UDP TX"),
+ txBusy_(false),
+ nTxCalls_(0),
+ offload_(orig.offload_),
+ gso_(false),
+ gsoSegMax_(0),
+ nTxGsoSegs_(0),
+ ioPool_(orig.ioPool_),
+ pollWorker_(NULL),
+ ioUring_(orig.ioUring_),
+ txRing_(NULL),
+ shardKeyOff_(orig.shardKeyOff_),
+ nextShard_(0),
+ shardMtx_("UDP shards"),
+ rcvBuf_(0),
+ poller_(orig.poller_),
+ txFlusher_(NULL)
 {
 	tx_.init( &dest_, 0, true );
+	probeGso();
+	createTxRing();
 	createThreads( orig.rxHandlers_.size(), -1 );
 }
 
@@ -313,6 +762,92 @@ uint64_t rval = 0;
 	return rval;
 }
 
+uint64_t CProtoModUdp::getNumShardRxDgrams(unsigned shard)
+{
+	if ( shard >= rxHandlers_.size() )
+		throw InvalidArgError("CProtoModUdp::getNumShardRxDgrams: no such shard");
+	return rxHandlers_[shard]->getNumDgrams();
+}
+
+uint64_t CProtoModUdp::getNumRxCalls()
+{
+unsigned i;
+uint64_t rval = 0;
+
+	for ( i=0; i<rxHandlers_.size(); i++ )
+		rval += rxHandlers_[i]->getNumRxCalls();
+	return rval;
+}
+
+uint64_t CProtoModUdp::getNumRxGroSegs()
+{
+unsigned i;
+uint64_t rval = 0;
+
+	for ( i=0; i<rxHandlers_.size(); i++ )
+		rval += rxHandlers_[i]->getNumGroSegs();
+	return rval;
+}
+
+uint64_t CProtoModUdp::getNumRxPolled()
+{
+unsigned i;
+uint64_t rval = 0;
+
+	for ( i=0; i<rxHandlers_.size(); i++ )
+		rval += rxHandlers_[i]->getNumPolled();
+	return rval;
+}
+
+void CProtoModUdp::setBusyPollUS(uint64_t us)
+{
+unsigned i;
+
+	if ( us > INT_MAX ) {
+		us = INT_MAX;
+	}
+	for ( i=0; i<rxHandlers_.size(); i++ )
+		rxHandlers_[i]->setBusyPoll( us );
+}
+
+void CProtoModUdp::setRcvBufSize(unsigned bytes)
+{
+unsigned i, got;
+
+	rcvBuf_ = 0;
+	for ( i=0; i<rxHandlers_.size(); i++ ) {
+		got = rxHandlers_[i]->setRcvBuf( bytes );
+		if ( 0 == rcvBuf_ || got < rcvBuf_ )
+			rcvBuf_ = got;
+	}
+	if ( rcvBuf_ < bytes ) {
+		fprintf(CPSW::fErr(), "WARNING: cpsw_proto_mod_udp: RX socket buffer limited to %u bytes (%u requested); consider raising 'net.core.rmem_max'\n", rcvBuf_, bytes);
+	}
+}
+
+bool CProtoModUdp::pollInput()
+{
+unsigned i;
+bool     rval = false;
+
+	// with sharded RX the reply may arrive on any of the sockets
+	for ( i=0; i<rxHandlers_.size(); i++ ) {
+		if ( rxHandlers_[i]->poll() )
+			rval = true;
+	}
+	return rval;
+}
+
+bool CProtoModUdp::hasGro()
+{
+	return rxHandlers_.size() > 0 && rxHandlers_[0]->hasGro();
+}
+
+bool CProtoModUdp::hasIOUringRx()
+{
+	return rxHandlers_.size() > 0 && rxHandlers_[0]->hasIOUring();
+}
+
 uint64_t CProtoModUdp::getNumRxDrops()
 {
 unsigned i;
@@ -327,10 +862,16 @@ uint64_t rval = 0;
 CProtoModUdp::~CProtoModUdp()
 {
 unsigned i;
+	// in case they never shut down
+	poolRemove();
 	for ( i=0; i<rxHandlers_.size(); i++ )
 		delete rxHandlers_[i];
 	if ( poller_ )
 		delete poller_;
+	if ( txFlusher_ )
+		delete txFlusher_;
+	if ( txRing_ )
+		delete txRing_;
 }
 
 void CProtoModUdp::dumpInfo(FILE *f)
@@ -342,21 +883,92 @@ void CProtoModUdp::dumpInfo(FILE *f)
 	fprintf(f,"  Peer port : %15u\n",    getDestPort());
 	fprintf(f,"  RX Threads: %15lu\n",   (unsigned long)rxHandlers_.size());
 	fprintf(f,"  ThreadPrio: %15d\n",    threadPriority_);
+	fprintf(f,"  RX Batch  : %15u\n",    rxBatch_);
+	fprintf(f,"  TX Batch  : %15u\n",    txBatch_);
+	fprintf(f,"  TX Linger : %15u us\n", txBatchUs_);
+	fprintf(f,"  GSO / GRO :             %c/%c\n", hasGso() ? 'Y' : 'N', hasGro() ? 'Y' : 'N');
 	fprintf(f,"  Has Poller:               %c\n", poller_ ? 'Y' : 'N');
+	fprintf(f,"  I/O Pool  :               %c\n", ioPool_ ? 'Y' : 'N');
+	fprintf(f,"  io_uring  :             %c/%c\n", hasIOUringRx() ? 'Y' : 'N', hasIOUringTx() ? 'Y' : 'N');
+	if ( isSharded() ) {
+		fprintf(f,"  RX shards : %15u (key @ byte %d)\n", (unsigned)rxHandlers_.size(), shardKeyOff_);
+		for ( unsigned i = 0; i < rxHandlers_.size(); i++ ) {
+			fprintf(f,"  #RX DG[%2u]: %15" PRIu64 "\n", i, getNumShardRxDgrams( i ));
+		}
+	} else {
+		fprintf(f,"  RX shards :               N\n");
+	}
+	if ( getRcvBufSize() ) {
+		fprintf(f,"  RX sockbuf: %15u\n", getRcvBufSize());
+	}
 	fprintf(f,"  #TX Octets: %15" PRIu64 "\n", getNumTxOctets());
 	fprintf(f,"  #TX DGRAMs: %15" PRIu64 "\n", getNumTxDgrams());
+	fprintf(f,"  #TX calls : %15" PRIu64 "\n", getNumTxCalls());
+	fprintf(f,"  #TX GSO sg: %15" PRIu64 "\n", getNumTxGsoSegs());
 	fprintf(f,"  #RX Octets: %15" PRIu64 "\n", getNumRxOctets());
 	fprintf(f,"  #RX DGRAMs: %15" PRIu64 "\n", getNumRxDgrams());
+	fprintf(f,"  #RX calls : %15" PRIu64 "\n", getNumRxCalls());
+	fprintf(f,"  #RX GRO sg: %15" PRIu64 "\n", getNumRxGroSegs());
+	fprintf(f,"  #RX polled: %15" PRIu64 "\n", getNumRxPolled());
+	fprintf(f,"  TX dg/call: %15.2f\n",   getNumTxCalls() ? (double)getNumTxDgrams()/(double)getNumTxCalls() : 0.0);
+	fprintf(f,"  RX dg/call: %15.2f\n",   getNumRxCalls() ? (double)getNumRxDgrams()/(double)getNumRxCalls() : 0.0);
 	fprintf(f,"  #RX droppd: %15" PRIu64 "\n", getNumRxDrops() );
 }
 
-bool CProtoModUdp::doPush(BufChain bc, bool wait, const CTimeout *timeout, bool abs_timeout)
+static unsigned totalLen(BufChain *bcs, unsigned n)
 {
-fd_set         fds;
-int            selres, sndres;
+unsigned tot = 0;
+	while ( n > 0 )
+		tot += bcs[--n]->getLen();
+	return tot;
+}
+
+union CGsoCtrl {
+	char           buf_[ CMSG_SPACE( sizeof(uint16_t) ) ];
+	struct cmsghdr align_;
+};
+
+// wait (at most 'timeout'; NULL: indefinitely) for 'sd' to become writable
+static bool waitWritable(int sd, const CTimeout *timeout)
+{
+fd_set fds;
+int    selres;
+
+	FD_ZERO( &fds );
+
+	FD_SET( sd, &fds );
+
+	// use pselect: does't modify the timeout and it's a timespec
+	selres = ::pselect( sd + 1, NULL, &fds, NULL, timeout ? &timeout->tv_ : NULL, NULL );
+	if ( selres < 0  ) {
+		perror("::pselect() - dropping message due to error");
+		return false;
+	}
+	if ( selres == 0 ) {
+#ifdef UDP_DEBUG
+		fprintf(CPSW::fDbg(), "UDP doPush -- pselect timeout\n");
+#endif
+		// TIMEOUT
+		return false;
+	}
+	return true;
+}
+
+bool CProtoModUdp::sendDgrams(BufChain *bcs, unsigned n, bool wait, const CTimeout *timeout, int sd)
+{
+int            sndres;
 Buf            b;
-struct iovec   iov[bc->getLen()];
-unsigned       nios;
+unsigned       nios, tot, msg, nmsgs, i, k;
+size_t         siz, seg, len;
+bool           gso = n > 1 && gso_.load( cpsw::memory_order_relaxed );
+struct iovec   iov[totalLen( bcs, n )];
+struct mmsghdr msgs[n];
+unsigned       first[n + 1];
+CGsoCtrl       ctrl[n];
+struct cmsghdr *cmsg;
+bool           timed = wait && timeout && ! timeout->isIndefinite();
+CTimeout       deadline, now, left;
+int            flags;
 
 	// there could be two models for sending a chain of buffers:
 	// a) the chain describes a gather list (one UDP message assembled from chain)
@@ -364,49 +976,114 @@ unsigned       nios;
 	// We follow a) here...
 	// If they were to fragment a large frame they have to push each
 	// fragment individually.
+	//
+	// With GSO a run of equally-sized datagrams (the last one may be
+	// shorter) is handed to the kernel as a single message which is
+	// segmented further down the stack.
 
-	nTxDgrams_.fetch_add( 1, cpsw::memory_order_relaxed );
-	nTxOctets_.fetch_add( bc->getSize(), cpsw::memory_order_relaxed );
-
-	for (nios=0, b=bc->getHead(); nios<bc->getLen(); nios++, b=b->getNext()) {
-		iov[nios].iov_base = b->getPayload();
-		iov[nios].iov_len  = b->getSize();
+	for ( tot=0, msg=0, i=0; i<n; msg++ ) {
+		memset( &msgs[msg], 0, sizeof(msgs[msg]) );
+		msgs[msg].msg_hdr.msg_iov = &iov[tot];
+		first[msg] = i;
+		seg        = bcs[i]->getSize();
+		for ( len = 0, k = 0; i < n; i++, k++ ) {
+			siz = bcs[i]->getSize();
+			if ( k > 0 && (    ! gso
+			                || 0 == siz
+			                || siz > seg
+			                || seg > gsoSegMax_
+			                || len + siz > GSO_SIZE_MAX
+			                || k >= GSO_SEGS_MAX
+			                || len != k * seg ) ) {
+				break;
+			}
+			for (nios=0, b=bcs[i]->getHead(); nios<bcs[i]->getLen(); nios++, b=b->getNext()) {
+				iov[tot].iov_base = b->getPayload();
+				iov[tot].iov_len  = b->getSize();
+				tot++;
+			}
+			len += siz;
+		}
+		msgs[msg].msg_hdr.msg_iovlen = &iov[tot] - msgs[msg].msg_hdr.msg_iov;
+		if ( k > 1 ) {
+			msgs[msg].msg_hdr.msg_control    = ctrl[msg].buf_;
+			msgs[msg].msg_hdr.msg_controllen = sizeof(ctrl[msg].buf_);
+			cmsg                             = CMSG_FIRSTHDR( &msgs[msg].msg_hdr );
+			cmsg->cmsg_level                 = SOL_UDP;
+			cmsg->cmsg_type                  = UDP_SEGMENT;
+			cmsg->cmsg_len                   = CMSG_LEN( sizeof(uint16_t) );
+			*(uint16_t*)CMSG_DATA( cmsg )    = seg;
+		}
 	}
+	nmsgs        = msg;
+	first[nmsgs] = n;
 
 	if ( wait ) {
-		FD_ZERO( &fds );
-
-		FD_SET( tx_.getSd(), &fds );
-
-		// use pselect: does't modify the timeout and it's a timespec
-		selres = ::pselect( tx_.getSd() + 1, NULL, &fds, NULL, !timeout || timeout->isIndefinite() ? NULL : &timeout->tv_, NULL );
-		if ( selres < 0  ) {
-			perror("::pselect() - dropping message due to error");
-			return false;
+		if ( timed ) {
+			clock_gettime( CLOCK_MONOTONIC, &deadline.tv_ );
+			deadline += *timeout;
 		}
-		if ( selres == 0 ) {
-#ifdef UDP_DEBUG
-			fprintf(CPSW::fDbg(), "UDP doPush -- pselect timeout\n");
-#endif
-			// TIMEOUT
+		if ( ! waitWritable( sd, timed ? timeout : NULL ) )
 			return false;
-		}
 	}
 
-	sndres = writev( tx_.getSd(), iov, nios );
+	for ( msg = 0; msg < nmsgs; msg += sndres ) {
+		nTxCalls_.fetch_add( 1, cpsw::memory_order_relaxed );
+		// the sockets are blocking; when waiting don't block beyond
+		// the timeout (EAGAIN is handled below), otherwise block
+		// until the kernel accepts the datagrams (like a plain write)
+		flags = wait ? MSG_DONTWAIT : 0;
+		if ( 1 == n ) {
+			sndres = ::sendmsg( sd, &msgs[0].msg_hdr, flags ) < 0 ? -1 : 1;
+		} else {
+			// the socket may accept only part of the batch
+			if ( txRing_ ) {
+				sndres = uringSendmmsg( sd, &msgs[msg], nmsgs - msg );
+			} else {
+				sndres = ::sendmmsg( sd, &msgs[msg], nmsgs - msg, flags );
+			}
+		}
 
-	if ( sndres < 0 ) {
-		perror("::writev() - dropping message due to error");
+		if ( sndres < 0 ) {
+			if ( wait && ( EAGAIN == errno || EWOULDBLOCK == errno ) ) {
+				// the socket buffer filled up (possibly after part of
+				// the batch was accepted); wait for the remainder of
+				// the timeout and resume with 'msg'.
+				if ( timed ) {
+					clock_gettime( CLOCK_MONOTONIC, &now.tv_ );
+					if ( ! (now < deadline) )
+						return false;
+					left = deadline - now;
+				}
+				if ( ! waitWritable( sd, timed ? &left : NULL ) )
+					return false;
+				sndres = 0;
+				continue;
+			}
+			if (    first[msg + 1] - first[msg] > 1
+			     && ( EIO == errno || EINVAL == errno || EOPNOTSUPP == errno || ENOPROTOOPT == errno ) ) {
+				// GSO rejected (e.g., by the device); don't try again
+				fprintf(CPSW::fErr(), "WARNING: cpsw_proto_mod_udp: UDP GSO send failed (%s); falling back\n", strerror(errno));
+				gso_.store( false, cpsw::memory_order_relaxed );
+				return sendDgrams( bcs + first[msg], n - first[msg], false, timeout, sd );
+			}
+			perror( 1 == n ? "::writev() - dropping message due to error" : "::sendmmsg() - dropping messages due to error" );
 #ifdef UDP_DEBUG
 // this could help debugging the occasinal EPERM I get here...
 #warning FIXME
 abort();
 #endif
-		return false;
+			return false;
+		}
+
+		for ( k = msg; k < msg + sndres; k++ ) {
+			if ( first[k + 1] - first[k] > 1 )
+				nTxGsoSegs_.fetch_add( first[k + 1] - first[k], cpsw::memory_order_relaxed );
+		}
 	}
 
 #ifdef UDP_DEBUG
-	fprintf(CPSW::fDbg(), "UDP doPush -- wrote %d:", sndres);
+	fprintf(CPSW::fDbg(), "UDP doPush -- wrote %u dgrams in %u msgs; first:", n, nmsgs);
 	for ( unsigned i=0; i < (iov[0].iov_len < 4 ? iov[0].iov_len : 4); i++ )
 		fprintf(CPSW::fDbg(), " %02x", ((unsigned char*)iov[0].iov_base)[i]);
 	fprintf(CPSW::fDbg(), "\n");
@@ -414,6 +1091,205 @@ abort();
 	return true;
 }
 
+void CProtoModUdp::createTxRing()
+{
+	txRing_ = NULL;
+	// only batches benefit; a lone datagram is still written directly
+	if ( ioUring_ && txBatch_ > 1 ) {
+		try {
+			txRing_ = new CIOUring( txBatch_ );
+		} catch ( IOUringUnavailable &e ) {
+			fprintf(CPSW::fErr(), "WARNING: cpsw_proto_mod_udp: io_uring unavailable (%s); falling back\n", e.getInfo().c_str());
+		}
+	}
+}
+
+void CProtoModUdp::probeGso()
+{
+int       val;
+socklen_t len = sizeof(val);
+int       mtu;
+
+	gsoSegMax_ = 0;
+	if ( offload_ ) {
+		if ( ::getsockopt( tx_.getSd(), SOL_UDP, UDP_SEGMENT, &val, &len ) ) {
+			fprintf(CPSW::fErr(), "WARNING: cpsw_proto_mod_udp: UDP_SEGMENT not supported (%s); falling back\n", strerror(errno));
+		} else {
+			// segments must not exceed the MTU
+			mtu        = tx_.getMTU() - 60 - 8;
+			gsoSegMax_ = mtu > 0 ? mtu : 0;
+		}
+	}
+	gso_.store( gsoSegMax_ > 0, cpsw::memory_order_relaxed );
+}
+
+int CProtoModUdp::uringSendmmsg(int sd, struct mmsghdr *msgs, unsigned n)
+{
+CIOUring::Cqe cqe;
+unsigned      i, got, space;
+unsigned      failed = n;
+int           err    = 0;
+int           st;
+
+	space = txRing_->getSqSpace();
+	if ( n > space )
+		n = space;
+
+	// linked; executed in order and everything after
+	// a failure is cancelled (similar to sendmmsg)
+	for ( i = 0; i < n; i++ ) {
+		txRing_->prepSendmsg( sd, &msgs[i].msg_hdr, i, i < n - 1 );
+	}
+
+	for ( got = 0; got < n; ) {
+		// a single syscall submits and waits for the entire batch
+		if ( (st = txRing_->submit( n - got )) < 0 ) {
+			errno = -st;
+			return -1;
+		}
+		while ( got < n && txRing_->getCqe( &cqe ) ) {
+			got++;
+			if ( cqe.res_ < 0 ) {
+				if ( cqe.userData_ < failed ) {
+					failed = cqe.userData_;
+					err    = -cqe.res_;
+				}
+			} else {
+				msgs[cqe.userData_].msg_len = cqe.res_;
+			}
+		}
+	}
+
+	if ( 0 == failed ) {
+		errno = err;
+		return -1;
+	}
+	return failed;
+}
+
+void CProtoModUdp::flushTx_unl(bool wait, const CTimeout *timeout)
+{
+std::vector<BufChain>  batch;
+std::vector<bool>      oks;
+unsigned               i, k, n;
+int                    sd;
+bool                   ok;
+
+	txBusy_ = true;
+	// keep sending until no more datagrams arrive; whoever pushes
+	// while we are busy just appends to 'txPend_' (and waits for
+	// us to report the result)
+	while ( ! txPend_.empty() ) {
+		batch.swap( txPend_ );
+		txSendSt_.swap( txPendSt_ );
+		oks.assign( batch.size(), false );
+		txMtx_.u();
+		for ( i = 0; i < batch.size(); i += n ) {
+			// a syscall serves a single socket
+			sd = txSd( batch[i] );
+			for ( n = 1; n < txBatch_ && i + n < batch.size() && sd == txSd( batch[i + n] ); n++ )
+				;
+			ok = sendDgrams( &batch[i], n, wait, timeout, sd );
+			for ( k = i; k < i + n; k++ ) {
+				oks[k] = ok;
+			}
+		}
+		batch.clear();
+		// statuses are only touched under the mutex; their
+		// owners may withdraw them (see doPush())
+		txMtx_.l();
+		for ( k = 0; k < txSendSt_.size(); k++ ) {
+			if ( txSendSt_[k] ) {
+				txSendSt_[k]->ok_   = oks[k];
+				txSendSt_[k]->done_ = true;
+			}
+		}
+		txSendSt_.clear();
+		pthread_cond_broadcast( txDoneCond_.getp() );
+	}
+	txBusy_ = false;
+}
+
+int CProtoModUdp::txSd(BufChain bc)
+{
+uint8_t key;
+int     shard;
+
+	if ( shardKeyOff_ < 0 || rxHandlers_.size() < 2 || bc->getSize() <= (size_t)shardKeyOff_ ) {
+		return tx_.getSd();
+	}
+	bc->extract( &key, shardKeyOff_, sizeof(key) );
+	if ( (shard = shardOf_[key].load( cpsw::memory_order_acquire )) < 0 ) {
+		CMtx::lg guard( &shardMtx_ );
+		if ( (shard = shardOf_[key].load( cpsw::memory_order_relaxed )) < 0 ) {
+			// first datagram with this key; it sticks to the
+			// shard assigned now (which keeps it in order)
+			shard = nextShard_++ % rxHandlers_.size();
+			shardOf_[key].store( shard, cpsw::memory_order_release );
+		}
+	}
+	return rxHandlers_[ shard ]->getSd();
+}
+
+bool CProtoModUdp::doPush(BufChain bc, bool wait, const CTimeout *timeout, bool abs_timeout)
+{
+TxStatus st;
+int      ost, err;
+
+	nTxDgrams_.fetch_add( 1, cpsw::memory_order_relaxed );
+	nTxOctets_.fetch_add( bc->getSize(), cpsw::memory_order_relaxed );
+
+	if ( txBatch_ <= 1 ) {
+		return sendDgrams( &bc, 1, wait, timeout, txSd( bc ) );
+	}
+
+	st.done_ = false;
+	st.ok_   = false;
+
+	{
+	CMtx::lg guard( &txMtx_ );
+
+		txPend_.push_back( bc );
+		txPendSt_.push_back( NULL );
+
+		if ( txBusy_ ) {
+			// the thread currently flushing sends this one, too;
+			// wait for the outcome. The flush is bounded by its
+			// initiator's timeout; don't leave a dangling status
+			// behind if cancelled.
+			txPendSt_.back() = &st;
+			pthread_setcancelstate( PTHREAD_CANCEL_DISABLE, &ost );
+			while ( ! st.done_ ) {
+				if ( (err = pthread_cond_wait( txDoneCond_.getp(), txMtx_.getp() )) ) {
+					// nobody must report to 'st' once we are gone
+					std::replace( txPendSt_.begin(), txPendSt_.end(), &st, (TxStatus*)NULL );
+					std::replace( txSendSt_.begin(), txSendSt_.end(), &st, (TxStatus*)NULL );
+					pthread_setcancelstate( ost, NULL );
+					throw InternalError("CProtoModUdp: pthread_cond_wait failed", err);
+				}
+			}
+			pthread_setcancelstate( ost, NULL );
+			return st.ok_;
+		}
+
+		if ( txFlusher_ && txPend_.size() < txBatch_ ) {
+			// let the batch linger; the flusher sends it once the budget expires
+			if ( 1 == txPend_.size() ) {
+				clock_gettime( CLOCK_MONOTONIC, &txDeadline_.tv_ );
+				txDeadline_ += CTimeout( txBatchUs_ );
+				pthread_cond_signal( txCond_.getp() );
+			}
+			return true;
+		}
+
+		// nobody is sending; do it ourselves without adding latency
+		// (and report the outcome of our own datagram only)
+		txPendSt_.back() = &st;
+		flushTx_unl( wait, timeout );
+		return st.ok_;
+	}
+}
+
 int CProtoModUdp::iMatch(ProtoPortMatchParams *cmp)
 {
 	cmp->udpDestPort_.handledBy_ = getProtoMod();
@@ -15,6 +15,10 @@
 #include <cpsw_thread.h>
 #include <cpsw_sock.h>
 #include <cpsw_compat.h>
+#include <cpsw_mutex.h>
+#include <cpsw_condvar.h>
+#include <cpsw_io_pool.h>
+#include <cpsw_io_uring.h>
 
 #include <arpa/inet.h>
 #include <netinet/in.h>
@@ -36,13 +40,18 @@ public:
 		sd_.getMyAddr( addr_p );
 	}
 
+	virtual int  getSd() const
+	{
+		return sd_.getSd();
+	}
+
 	CUdpHandlerThread(const char *name, int threadPriority, struct sockaddr_in *dest, struct sockaddr_in *me_p = NULL);
 	CUdpHandlerThread(CUdpHandlerThread &orig, struct sockaddr_in *dest, struct sockaddr_in *me_p);
 
 	virtual ~CUdpHandlerThread() {}
 };
 
-class CUdpPeerPollerThread : public CUdpHandlerThread {
+class CUdpPeerPollerThread : public CUdpHandlerThread, public IIOPoolHandler {
 private:
 	unsigned pollSecs_;
 
@@ -51,6 +60,10 @@ protected:
 	virtual void* threadBody();
 
 public:
+	// when served by the I/O pool: poll once per timer period
+	virtual void handleInput()   {}
+	virtual void handleTimeout();
+
 	CUdpPeerPollerThread(const char *name, struct sockaddr_in *dest, struct sockaddr_in *me = NULL, unsigned pollSecs = 60);
 	CUdpPeerPollerThread(CUdpPeerPollerThread &orig, struct sockaddr_in *dest, struct sockaddr_in *me);
 
@@ -65,11 +78,30 @@ public:
 class CProtoModUdp : public CProtoMod {
 protected:
 
-	class CUdpRxHandlerThread : public CUdpHandlerThread {
+	class CUdpRxHandlerThread : public CUdpHandlerThread, public IIOPoolHandler, public CIOUring::IRecvHandler {
 		private:
 			atomic<uint64_t> nOctets_;
 			atomic<uint64_t> nDgrams_;
 			atomic<uint64_t> nRxDrop_;
+			atomic<uint64_t> nRxCalls_;
+			atomic<uint64_t> nGroSegs_;
+			atomic<uint64_t> nPolled_;
+			// max. number of datagrams received by a single syscall
+			unsigned         batch_;
+			// receive coalesced (GRO) packets
+			bool             gro_;
+			// 'batch_' buffers (each large enough for a jumbo datagram
+			// or a GRO packet) are posted to a single recvmmsg() call
+			std::vector<Buf>            bufs_;
+			std::vector<struct iovec>   iovs_;
+			std::vector<struct mmsghdr> msgs_;
+			std::vector<uint64_t>       ctrl_;
+			// receive with io_uring (multishot) if possible
+			bool                        uring_;
+			CIOUring                   *ring_;
+			atomic<bool>                uringActive_;
+			// CPU the thread is pinned to (< 0: not pinned)
+			int                         cpu_;
 		public:
 			// cannot use smart pointer here because CProtoModUdp's
 			// constructor creates the threads (and a smart ptr is
@@ -82,15 +114,77 @@ protected:
 
 			virtual void* threadBody();
 
+			virtual void     enableGro();
+
+			virtual void     post(Buf *buf_p, struct iovec *iov);
+
+			// one recvmmsg() call; returns its result
+			virtual int      receive(int flags);
+
+			// hand 'tot' bytes in 'buf' (GRO packet with segments
+			// of 'gso' bytes or a single datagram) to the owner
+			virtual void     deliver(Buf buf, ssize_t tot, ssize_t gso);
+
+			// returns (only) if io_uring cannot be used
+			virtual void     uringLoop();
+
+			// CIOUring::IRecvHandler
+			virtual void     setActive(bool active);
+			virtual void     submitted();
+			virtual void     submitFailed(int err);
+			virtual void     received(Buf buf, size_t got);
+			virtual void     recvFailed(int err);
+
 		public:
-			CUdpRxHandlerThread(const char *name, int threadPriority, struct sockaddr_in *dest, struct sockaddr_in *me, CProtoModUdp *owner);
+			CUdpRxHandlerThread(const char *name, int threadPriority, struct sockaddr_in *dest, struct sockaddr_in *me, CProtoModUdp *owner, unsigned batch = 1, bool gro = false, bool uring = false);
 			CUdpRxHandlerThread(CUdpRxHandlerThread &orig, struct sockaddr_in *dest, struct sockaddr_in *me, CProtoModUdp *owner);
 
 			virtual uint64_t getNumOctets() { return nOctets_.load( cpsw::memory_order_relaxed ); }
 			virtual uint64_t getNumDgrams() { return nDgrams_.load( cpsw::memory_order_relaxed ); }
 			virtual uint64_t getNumRxDrop() { return nRxDrop_.load( cpsw::memory_order_relaxed ); }
+			virtual uint64_t getNumRxCalls(){ return nRxCalls_.load( cpsw::memory_order_relaxed ); }
+			virtual uint64_t getNumGroSegs(){ return nGroSegs_.load( cpsw::memory_order_relaxed ); }
+			virtual uint64_t getNumPolled() { return nPolled_.load( cpsw::memory_order_relaxed ); }
+			virtual bool     hasGro()       { return gro_; }
+			virtual bool     hasIOUring()   { return uringActive_.load( cpsw::memory_order_relaxed ); }
+
+			// effective when the thread is started next
+			virtual void     setCpu(int cpu) { cpu_ = cpu;  }
+			virtual int      getCpu()        { return cpu_; }
+
+			// let a blocking receive busy-poll the device queue
+			// for up to 'us' microseconds (SO_BUSY_POLL)
+			virtual void     setBusyPoll(unsigned us);
+
+			// request a socket receive buffer of (at least)
+			// 'bytes'; returns what the kernel granted
+			virtual unsigned setRcvBuf(unsigned bytes);
+
+			// receive a single datagram on the caller's thread (never
+			// blocks); may run concurrently with the RX thread.
+			// Returns true if a datagram was delivered.
+			virtual bool     poll();
+
+			// when served by the I/O pool (never blocks)
+			virtual void     handleInput();
+			virtual void     handleTimeout() {}
+
+			virtual ~CUdpRxHandlerThread();
+	};
+
+	// flushes a pending TX batch once the latency budget expires
+	class CUdpTxFlusherThread : public CRunnable {
+		private:
+			CProtoModUdp   *owner_;
+
+		protected:
 
-			virtual ~CUdpRxHandlerThread() { threadStop(); }
+			virtual void* threadBody();
+
+		public:
+			CUdpTxFlusherThread(const char *name, int threadPriority, CProtoModUdp *owner);
+
+			virtual ~CUdpTxFlusherThread() { threadStop(); }
 	};
 
 private:
@@ -99,12 +193,80 @@ private:
 	atomic<uint64_t>   nTxOctets_;
 	atomic<uint64_t>   nTxDgrams_;
 	int                threadPriority_;
+	unsigned           rxBatch_;
+	// TX batching; datagrams pushed while a batch is being
+	// sent (or while the batch lingers for 'txBatchUs_') are
+	// submitted together, up to 'txBatch_' per syscall.
+	unsigned              txBatch_;
+	unsigned              txBatchUs_;
+	CMtx                  txMtx_;
+	CCond                 txCond_;
+	std::vector<BufChain> txPend_;
+	// pushers which append to 'txPend_' while a flush is in progress
+	// wait for the outcome; parallel to 'txPend_' (NULL: nobody waits)
+	struct TxStatus {
+		bool done_;
+		bool ok_;
+	};
+	std::vector<TxStatus*> txPendSt_;
+	// same for the batch currently being sent by the flushing thread
+	std::vector<TxStatus*> txSendSt_;
+	CCond                 txDoneCond_;
+	CTimeout              txDeadline_;
+	bool                  txBusy_;
+	atomic<uint64_t>      nTxCalls_;
+	// segmentation offload (GSO on TX, GRO on RX) requested
+	bool                  offload_;
+	atomic<bool>          gso_;
+	unsigned              gsoSegMax_;
+	atomic<uint64_t>      nTxGsoSegs_;
+	// RX sockets and poller are served by the process-wide I/O
+	// pool rather than by dedicated threads
+	bool                       ioPool_;
+	std::vector<IOPoolWorker>  rxWorkers_;
+	IOPoolWorker               pollWorker_;
+	// io_uring backend requested; TX batches are submitted
+	// to 'txRing_' (serialized by 'txBusy_')
+	bool                       ioUring_;
+	CIOUring                  *txRing_;
+	// every RX thread owns a socket with a source port of its own
+	// (a 'shard'); a datagram is sent through the shard selected by
+	// the key byte at 'shardKeyOff_' (< 0: not sharded)
+	int                        shardKeyOff_;
+	// shard of every key value (< 0: not assigned yet); keys are
+	// assigned round-robin in the order in which they are first
+	// sent so that a few distinct keys (e.g., SRP VCs) are spread
+	// evenly no matter which bits they differ in.
+	atomic<int>                shardOf_[256];
+	unsigned                   nextShard_;
+	CMtx                       shardMtx_;
+	// smallest RX socket buffer granted (0: system default)
+	unsigned                   rcvBuf_;
 protected:
 	std::vector< CUdpRxHandlerThread * > rxHandlers_;
 	CUdpPeerPollerThread                 *poller_;
+	CUdpTxFlusherThread                  *txFlusher_;
 
 	void createThreads(unsigned nRxThreads, int pollSeconds);
 
+	void probeGso();
+
+	void createTxRing();
+
+	void poolRemove();
+
+	// same semantics as sendmmsg()
+	virtual int uringSendmmsg(int sd, struct mmsghdr *msgs, unsigned n);
+
+	// socket 'bc' is to be sent through
+	virtual int txSd(BufChain bc);
+
+	virtual bool sendDgrams(BufChain *bcs, unsigned n, bool wait, const CTimeout *timeout, int sd);
+
+	// must be called with 'txMtx_' held and no other flush in progress;
+	// the outcome is reported to the pushers' status (if any)
+	virtual void flushTx_unl(bool wait, const CTimeout *timeout);
+
 	virtual bool doPush(BufChain bc, bool wait, const CTimeout *timeout, bool abs_timeout);
 
 	virtual bool push(BufChain bc, const CTimeout *timeout, bool abs_timeout)
@@ -120,8 +282,24 @@ protected:
 	virtual int iMatch(ProtoPortMatchParams *cmp);
 
 public:
-	// negative or zero 'pollSecs' avoids creating a poller thread
-	CProtoModUdp(Key &k, struct sockaddr_in *dest, unsigned depth, int threadPriority, unsigned nRxThreads = 1, int pollSecs = 4);
+	// negative or zero 'pollSecs' avoids creating a poller thread;
+	// every RX thread receives up to 'rxBatch' datagrams per syscall.
+	// Up to 'txBatch' datagrams are sent per syscall; a nonzero 'txBatchUs'
+	// lets an incomplete batch linger for at most that many microseconds.
+	// 'offload' sends equally-sized datagrams of a batch as a single GSO
+	// packet and accepts GRO packets on RX (if the kernel supports it).
+	// With 'ioPool' the 'nRxThreads' sockets and the poller are handed
+	// to the shared I/O pool (see cpsw_io_pool.h) instead of being
+	// served by threads of their own ('threadPriority' is then ignored).
+	// 'ioUring' receives with multishot io_uring operations into pool
+	// buffers and submits TX batches to a ring; falls back to plain
+	// system calls if io_uring is unavailable (or with GRO / 'ioPool'
+	// on RX).
+	// A non-negative 'shardKeyOff' shards the RX sockets (see above);
+	// the byte at this offset (e.g., the SRP virtual channel) selects
+	// the shard so that all traffic with the same key is handled by
+	// the same (pinned) RX thread and stays in order.
+	CProtoModUdp(Key &k, struct sockaddr_in *dest, unsigned depth, int threadPriority, unsigned nRxThreads = 1, int pollSecs = 4, unsigned rxBatch = 1, unsigned txBatch = 1, unsigned txBatchUs = 0, bool offload = false, bool ioPool = false, bool ioUring = false, int shardKeyOff = -1);
 
 	CProtoModUdp(CProtoModUdp &orig, Key &k);
 
@@ -144,9 +322,35 @@ public:
 
 	virtual uint64_t getNumTxOctets() { return nTxOctets_.load( cpsw::memory_order_relaxed ); }
 	virtual uint64_t getNumTxDgrams() { return nTxDgrams_.load( cpsw::memory_order_relaxed ); }
+	virtual uint64_t getNumTxCalls()  { return nTxCalls_.load( cpsw::memory_order_relaxed );  }
+	virtual uint64_t getNumTxGsoSegs(){ return nTxGsoSegs_.load( cpsw::memory_order_relaxed );}
+	virtual bool     hasGso()         { return gso_.load( cpsw::memory_order_relaxed );       }
+	virtual bool     hasGro();
+	virtual bool     hasIOPool()      { return ioPool_; }
+	virtual bool     hasIOUringRx();
+	virtual bool     hasIOUringTx()   { return !! txRing_; }
+	virtual bool     isSharded()      { return shardKeyOff_ >= 0; }
 	virtual uint64_t getNumRxOctets();
 	virtual uint64_t getNumRxDgrams();
 	virtual uint64_t getNumRxDrops();
+	virtual uint64_t getNumRxCalls();
+	virtual uint64_t getNumRxGroSegs();
+	virtual uint64_t getNumRxPolled();
+	virtual unsigned getNumRxShards() { return rxHandlers_.size(); }
+	// datagrams received by a single shard (RX thread)
+	virtual uint64_t getNumShardRxDgrams(unsigned shard);
+
+	// enable SO_BUSY_POLL on the RX sockets
+	virtual void setBusyPollUS(uint64_t us);
+
+	// enlarge the RX socket buffers to hold (at least) 'bytes';
+	// they are never shrunk below the system default
+	virtual void setRcvBufSize(unsigned bytes);
+	virtual unsigned getRcvBufSize() { return rcvBuf_; }
+
+	// receive from the RX sockets on the caller's thread
+	virtual bool pollInput();
+
 	virtual void modStartup();
 	virtual void modShutdown();
 
@@ -44,14 +44,27 @@ class CProtoStackBuilder : public IProtoStackBuilder {
 		uint64_t                   SRPTimeoutUS_;
 		int                        SRPDynTimeout_;
 		unsigned                   SRPRetryCount_;
+		unsigned                   SRPMaxOutstanding_;
+		unsigned                   SRPPipelineDepth_;
+		bool                       SRPShadowCache_;
+		unsigned                   SRPHedgeBudget_;
+		uint64_t                   SRPBusyPollUS_;
 		SRPWriteMode               SRPDefaultWriteMode_;
 		TransportProto             Xprt_;
 		unsigned                   XprtPort_;
 		unsigned                   XprtOutQueueDepth_;
         int                        UdpThreadPriority_;
 		unsigned                   UdpNumRxThreads_;
+		unsigned                   UdpRxBatchSize_;
+		unsigned                   UdpTxBatchSize_;
+		unsigned                   UdpTxBatchUS_;
+		bool                       UdpSegmentOffload_;
+		bool                       UdpIOPool_;
+		bool                       UdpIOUring_;
+		bool                       UdpShardedRx_;
 		int                        UdpPollSecs_;
         int                        TcpThreadPriority_;
+		bool                       TcpIOUring_;
 		bool                       hasRssi_;
         int                        RssiThreadPriority_;
 		int                        hasDepack_;
@@ -60,16 +73,19 @@ class CProtoStackBuilder : public IProtoStackBuilder {
 		unsigned                   DepackLdFrameWinSize_;
 		unsigned                   DepackLdFragWinSize_;
 		int                        DepackThreadPriority_;
+		bool                       DepackRunToCompletion_;
 		int                        hasSRPMux_;
 		unsigned                   SRPMuxVirtualChannel_;
 		unsigned                   SRPMuxOutQueueDepth_;
 		int                        SRPMuxThreadPriority_;
+		bool                       SRPMuxRunToCompletion_;
 		bool                       hasTDestMux_;
 		unsigned                   TDestMuxTDEST_;
 		int                        TDestMuxStripHeader_;
 		unsigned                   TDestMuxOutQueueDepth_;
 		unsigned                   TDestMuxInpQueueDepth_;
 		int                        TDestMuxThreadPriority_;
+		bool                       TDestMuxRunToCompletion_;
 		in_addr_t                  IPAddr_;
 		struct LibSocksProxy       socksProxy_;
 		in_addr_t                  rssiBridgeIPAddr_;
@@ -82,14 +98,27 @@ class CProtoStackBuilder : public IProtoStackBuilder {
 			SRPTimeoutUS_           = 0;
 			SRPDynTimeout_          = -1;
 			SRPRetryCount_          = -1;
+			SRPMaxOutstanding_      = 0;
+			SRPPipelineDepth_       = 0;
+			SRPShadowCache_         = false;
+			SRPHedgeBudget_         = 0;
+			SRPBusyPollUS_          = 0;
 			SRPDefaultWriteMode_    = UNSP;
 			Xprt_                   = UDP;
 			XprtPort_               = 8192;
 			XprtOutQueueDepth_      = 0;
 			UdpThreadPriority_      = IProtoStackBuilder::DFLT_THREAD_PRIORITY;
 			UdpNumRxThreads_        = 0;
+			UdpRxBatchSize_         = 0;
+			UdpTxBatchSize_         = 0;
+			UdpTxBatchUS_           = 0;
+			UdpSegmentOffload_      = false;
+			UdpIOPool_              = false;
+			UdpIOUring_             = false;
+			UdpShardedRx_           = false;
 			UdpPollSecs_            = -1;
 			TcpThreadPriority_      = IProtoStackBuilder::DFLT_THREAD_PRIORITY;
+			TcpIOUring_             = false;
 			hasRssi_                = false;
 			hasDepack_              = -1;
 			depackProto_            = DEPACKETIZER_V0;
@@ -98,16 +127,19 @@ class CProtoStackBuilder : public IProtoStackBuilder {
 			DepackLdFrameWinSize_   = 0;
 			DepackLdFragWinSize_    = 0;
 			DepackThreadPriority_   = IProtoStackBuilder::DFLT_THREAD_PRIORITY;
+			DepackRunToCompletion_  = false;
 			hasSRPMux_              = -1;
 			SRPMuxOutQueueDepth_    = 0;
 			SRPMuxVirtualChannel_   = 0;
 			SRPMuxThreadPriority_   = IProtoStackBuilder::DFLT_THREAD_PRIORITY;
+			SRPMuxRunToCompletion_  = false;
 			hasTDestMux_            = false;
 			TDestMuxTDEST_          = 0;
 			TDestMuxStripHeader_    = -1;
 			TDestMuxOutQueueDepth_  = 0;
 			TDestMuxInpQueueDepth_  = 0;
 			TDestMuxThreadPriority_ = IProtoStackBuilder::DFLT_THREAD_PRIORITY;
+			TDestMuxRunToCompletion_= false;
 			IPAddr_                 = INADDR_NONE;
 			rssiBridgeIPAddr_       = INADDR_NONE;
 			socksProxy_.version     = SOCKS_VERSION_NONE;
@@ -219,6 +251,66 @@ class CProtoStackBuilder : public IProtoStackBuilder {
 			return SRPRetryCount_;
 		}
 
+		virtual void            setSRPMaxOutstanding(unsigned v)
+		{
+			if ( v > 1024 )
+				throw InvalidArgError("Requested SRP max. outstanding transactions too large");
+			SRPMaxOutstanding_ = v;
+		}
+
+		virtual unsigned        getSRPMaxOutstanding()
+		{
+			if ( 0 == SRPMaxOutstanding_ )
+				return 1;
+			return SRPMaxOutstanding_;
+		}
+
+		virtual void            setSRPPipelineDepth(unsigned v)
+		{
+			if ( v > 64 )
+				throw InvalidArgError("Requested SRP pipeline depth too large");
+			SRPPipelineDepth_ = v;
+		}
+
+		virtual unsigned        getSRPPipelineDepth()
+		{
+			if ( 0 == SRPPipelineDepth_ )
+				return 4;
+			return SRPPipelineDepth_;
+		}
+
+		virtual void            useSRPShadowCache(bool v)
+		{
+			SRPShadowCache_ = v;
+		}
+
+		virtual bool            hasSRPShadowCache()
+		{
+			return SRPShadowCache_;
+		}
+
+		virtual void            setSRPHedgeBudget(unsigned v)
+		{
+			if ( v > 100 )
+				throw InvalidArgError("Requested SRP hedge budget (percent) too large");
+			SRPHedgeBudget_ = v;
+		}
+
+		virtual unsigned        getSRPHedgeBudget()
+		{
+			return SRPHedgeBudget_;
+		}
+
+		virtual void            setSRPBusyPollUS(uint64_t v)
+		{
+			SRPBusyPollUS_ = v;
+		}
+
+		virtual uint64_t        getSRPBusyPollUS()
+		{
+			return SRPBusyPollUS_;
+		}
+
 		virtual bool            hasUdp()
 		{
 			return getUdpPort() != 0;
@@ -282,6 +374,16 @@ class CProtoStackBuilder : public IProtoStackBuilder {
 			return TcpThreadPriority_;
 		}
 
+		virtual void            setTcpIOUring(bool v)
+		{
+			TcpIOUring_ = v;
+		}
+
+		virtual bool            getTcpIOUring()
+		{
+			return TcpIOUring_;
+		}
+
 		virtual void            setUdpThreadPriority(int prio)
 		{
 			UdpThreadPriority_ = prio;
@@ -318,8 +420,13 @@ class CProtoStackBuilder : public IProtoStackBuilder {
 
 		virtual unsigned        getUdpOutQueueDepth()
 		{
-			if ( 0 == XprtOutQueueDepth_ )
+		unsigned rssiWin;
+			if ( 0 == XprtOutQueueDepth_ ) {
+				// RSSI must be able to queue a full window
+				if ( hasRssiAndUdp() && (rssiWin = (1 << rssiConfig_.ldMaxUnackedSegs_)) > 10 )
+					return rssiWin;
 				return 10;
+			}
 			return XprtOutQueueDepth_;
 		}
 
@@ -343,6 +450,84 @@ class CProtoStackBuilder : public IProtoStackBuilder {
 			return UdpNumRxThreads_;
 		}
 
+		virtual void            setUdpRxBatchSize(unsigned v)
+		{
+			if ( v > 1024 )
+				throw InvalidArgError("UDP RX batch size too large");
+			UdpRxBatchSize_ = v;
+		}
+
+		virtual unsigned        getUdpRxBatchSize()
+		{
+			if ( 0 == UdpRxBatchSize_ )
+				return 1;
+			return UdpRxBatchSize_;
+		}
+
+		virtual void            setUdpTxBatchSize(unsigned v)
+		{
+			if ( v > 1024 )
+				throw InvalidArgError("UDP TX batch size too large");
+			UdpTxBatchSize_ = v;
+		}
+
+		virtual unsigned        getUdpTxBatchSize()
+		{
+			if ( 0 == UdpTxBatchSize_ )
+				return 1;
+			return UdpTxBatchSize_;
+		}
+
+		virtual void            setUdpTxBatchUS(unsigned v)
+		{
+			UdpTxBatchUS_ = v;
+		}
+
+		virtual unsigned        getUdpTxBatchUS()
+		{
+			return UdpTxBatchUS_;
+		}
+
+		virtual void            setUdpSegmentOffload(bool v)
+		{
+			UdpSegmentOffload_ = v;
+		}
+
+		virtual bool            getUdpSegmentOffload()
+		{
+			return UdpSegmentOffload_;
+		}
+
+		virtual void            setUdpIOPool(bool v)
+		{
+			UdpIOPool_ = v;
+		}
+
+		virtual bool            getUdpIOPool()
+		{
+			return UdpIOPool_;
+		}
+
+		virtual void            setUdpIOUring(bool v)
+		{
+			UdpIOUring_ = v;
+		}
+
+		virtual bool            getUdpIOUring()
+		{
+			return UdpIOUring_;
+		}
+
+		virtual void            setUdpShardedRx(bool v)
+		{
+			UdpShardedRx_ = v;
+		}
+
+		virtual bool            getUdpShardedRx()
+		{
+			return UdpShardedRx_;
+		}
+
 		virtual void            setUdpPollSecs(int v)
 		{
 			UdpPollSecs_ = v;
@@ -432,6 +617,16 @@ class CProtoStackBuilder : public IProtoStackBuilder {
 			return hasDepack() ? DepackThreadPriority_ : IProtoStackBuilder::NO_THREAD_PRIORITY;
 		}
 
+		virtual void            setDepackRunToCompletion(bool v)
+		{
+			DepackRunToCompletion_ = v;
+		}
+
+		virtual bool            getDepackRunToCompletion()
+		{
+			return DepackRunToCompletion_;
+		}
+
 		virtual void            setDepackLdFrameWinSize(unsigned v)
 		{
 			if ( v > 10 )
@@ -513,6 +708,16 @@ class CProtoStackBuilder : public IProtoStackBuilder {
 			return hasSRPMux() ? SRPMuxThreadPriority_ : IProtoStackBuilder::NO_THREAD_PRIORITY;
 		}
 
+		virtual void            setSRPMuxRunToCompletion(bool v)
+		{
+			SRPMuxRunToCompletion_ = v;
+		}
+
+		virtual bool            getSRPMuxRunToCompletion()
+		{
+			return SRPMuxRunToCompletion_;
+		}
+
 
 		virtual void            useTDestMux(bool v)
 		{
@@ -593,6 +798,16 @@ class CProtoStackBuilder : public IProtoStackBuilder {
 			return hasTDestMux() ? TDestMuxThreadPriority_ : IProtoStackBuilder::NO_THREAD_PRIORITY;
 		}
 
+		virtual void            setTDestMuxRunToCompletion(bool v)
+		{
+			TDestMuxRunToCompletion_ = v;
+		}
+
+		virtual bool            getTDestMuxRunToCompletion()
+		{
+			return TDestMuxRunToCompletion_;
+		}
+
 		virtual shared_ptr<CProtoStackBuilder> cloneInternal()
 		{
 			return cpsw::make_shared<CProtoStackBuilder>( *this );
@@ -661,6 +876,17 @@ WriteMode                  writeMode;
 				useSRPDynTimeout( b );
 			if ( readNode(nn, YAML_KEY_retryCount, &u) )
 				setSRPRetryCount( u );
+			if ( readNode(nn, YAML_KEY_maxOutstanding, &u) )
+				setSRPMaxOutstanding( u );
+			if ( readNode(nn, YAML_KEY_pipelineDepth, &u) )
+				setSRPPipelineDepth( u );
+			if ( readNode(nn, YAML_KEY_shadowCache, &b) )
+				useSRPShadowCache( b );
+			if ( readNode(nn, YAML_KEY_hedgeBudget, &u) )
+				setSRPHedgeBudget( u );
+			u64 = getSRPBusyPollUS();
+			if ( readNode(nn, YAML_KEY_busyPollUS, &u64) )
+				setSRPBusyPollUS( u64 );
 			if ( readNode(nn, YAML_KEY_defaultWriteMode, &writeMode) )
 			{
 				if ( hasSRPMux_ < 0 || UNSP == SRPDefaultWriteMode_ ) {
@@ -681,6 +907,8 @@ WriteMode                  writeMode;
 					setTcpOutQueueDepth( u );
 				if ( readNode(nn, YAML_KEY_threadPriority, &i) )
 					setTcpThreadPriority( i );
+				if ( readNode(nn, YAML_KEY_ioUring, &b) )
+					setTcpIOUring( b );
 			}
 		}
 	}
@@ -695,6 +923,20 @@ WriteMode                  writeMode;
 					setUdpOutQueueDepth( u );
 				if ( readNode(nn, YAML_KEY_numRxThreads, &u) )
 					setUdpNumRxThreads( u );
+				if ( readNode(nn, YAML_KEY_rxBatchSize, &u) )
+					setUdpRxBatchSize( u );
+				if ( readNode(nn, YAML_KEY_txBatchSize, &u) )
+					setUdpTxBatchSize( u );
+				if ( readNode(nn, YAML_KEY_txBatchUS, &u) )
+					setUdpTxBatchUS( u );
+				if ( readNode(nn, YAML_KEY_segmentOffload, &b) )
+					setUdpSegmentOffload( b );
+				if ( readNode(nn, YAML_KEY_ioPool, &b) )
+					setUdpIOPool( b );
+				if ( readNode(nn, YAML_KEY_ioUring, &b) )
+					setUdpIOUring( b );
+				if ( readNode(nn, YAML_KEY_shardedRx, &b) )
+					setUdpShardedRx( b );
 				// initialize i to silence rhel compiler warning
 				// about potentially un-initialized 'i'
 				i = getUdpPollSecs();
@@ -748,6 +990,12 @@ WriteMode                  writeMode;
 			if ( readNode(nn, YAML_KEY_maxSegmentSize,          &u) ) {
 				rssiConfig_.forcedSegsMax_     = u;
 			}
+			if ( readNode(nn, YAML_KEY_selectiveAck,            &b) ) {
+				rssiConfig_.selectiveAck_      = b;
+			}
+			if ( readNode(nn, YAML_KEY_adaptiveRetransmissionTimeout, &b) ) {
+				rssiConfig_.adaptiveRex_       = b;
+			}
 		}
 	}
 	{
@@ -766,6 +1014,8 @@ WriteMode                  writeMode;
 				setDepackLdFragWinSize( u );
 			if ( readNode(nn, YAML_KEY_threadPriority, &i) )
 				setDepackThreadPriority( i );
+			if ( readNode(nn, YAML_KEY_runToCompletion, &b) )
+				setDepackRunToCompletion( b );
 			if ( readNode(nn, YAML_KEY_instantiate, &b) )
 				useDepack( b );
 		}
@@ -781,6 +1031,8 @@ WriteMode                  writeMode;
 				setSRPMuxOutQueueDepth( u );
 			if ( readNode(nn, YAML_KEY_threadPriority, &i) )
 				setSRPMuxThreadPriority( i );
+			if ( readNode(nn, YAML_KEY_runToCompletion, &b) )
+				setSRPMuxRunToCompletion( b );
 			if ( readNode(nn, YAML_KEY_instantiate, &b) )
 				useSRPMux( b );
 			if ( readNode(nn, YAML_KEY_defaultWriteMode, &writeMode) )
@@ -805,6 +1057,8 @@ WriteMode                  writeMode;
 				setTDestMuxInpQueueDepth( u );
 			if ( readNode(nn, YAML_KEY_threadPriority, &i) )
 				setTDestMuxThreadPriority( i );
+			if ( readNode(nn, YAML_KEY_runToCompletion, &b) )
+				setTDestMuxRunToCompletion( b );
 			if ( readNode(nn, YAML_KEY_instantiate, &b) )
 				useTDestMux( b );
 		}
@@ -1020,13 +1274,45 @@ bool                           hasSRP = IProtoStackBuilder::SRP_UDP_NONE != bldr
 		dst.sin_addr.s_addr = bldr->getIPAddr();
 
 		if ( bldr->hasUdp() ) {
+			int shardKeyOff = -1;
+
+			if ( bldr->getUdpShardedRx() ) {
+				// replies are received by the socket the request was sent
+				// from; shard by SRP virtual channel. Other protocols need
+				// a single source port (e.g., RSSI) or are unsolicited.
+				if ( bldr->hasSRPMux() && ! bldr->hasTDestMux() && ! bldr->hasRssi() ) {
+					shardKeyOff = CProtoModSRPMux::getVCOffset( bldr->getSRPVersion() );
+				} else {
+					fprintf(CPSW::fErr(), "WARNING: UDP 'shardedRx' requires SRP without TDEST demux or RSSI -- IGNORED\n");
+				}
+			}
+
 			// Note: transport module MUST have a queue if RSSI is used
-			rval = CShObj::create< ProtoModUdp >( &dst,
+			ProtoModUdp udpMod = CShObj::create< ProtoModUdp >( &dst,
 			                                       bldr->getUdpOutQueueDepth(),
 			                                       bldr->getUdpThreadPriority(),
 			                                       bldr->getUdpNumRxThreads(),
-			                                       bldr->getUdpPollSecs()
+			                                       bldr->getUdpPollSecs(),
+			                                       bldr->getUdpRxBatchSize(),
+			                                       bldr->getUdpTxBatchSize(),
+			                                       bldr->getUdpTxBatchUS(),
+			                                       bldr->getUdpSegmentOffload(),
+			                                       bldr->getUdpIOPool(),
+			                                       bldr->getUdpIOUring(),
+			                                       shardKeyOff
 			);
+			if ( bldr->getSRPBusyPollUS() ) {
+				udpMod->setBusyPollUS( bldr->getSRPBusyPollUS() );
+			}
+			if ( bldr->hasRssiAndUdp() ) {
+				// let the socket absorb a full RSSI window of
+				// (up to jumbo-sized) segments
+				unsigned segSize = udpMod->getMTU();
+				if ( segSize > IBuf::CAPA_ETH_JUM )
+					segSize = IBuf::CAPA_ETH_JUM;
+				udpMod->setRcvBufSize( (1 << bldr->getRssiConfigParams()->ldMaxUnackedSegs_) * segSize );
+			}
+			rval = udpMod;
 		} else {
 			struct sockaddr_in via = dst;
 
@@ -1066,7 +1352,8 @@ bool                           hasSRP = IProtoStackBuilder::SRP_UDP_NONE != bldr
 			                                      bldr->getTcpOutQueueDepth(),
 			                                      bldr->getTcpThreadPriority(),
 			                                      bldr->getSocksProxy(),
-			                                      &via
+			                                      &via,
+			                                      bldr->getTcpIOUring()
 			);
 		}
 
@@ -1096,6 +1383,7 @@ bool                           hasSRP = IProtoStackBuilder::SRP_UDP_NONE != bldr
 			                                bldr->getDepackLdFragWinSize(),
 			                                CTimeout(),
 			                                bldr->getDepackThreadPriority());
+			depackMod->setRunToCompletion( bldr->getDepackRunToCompletion() );
 			rval->addAtPort( depackMod );
 			rval = depackMod;
 		}
@@ -1126,6 +1414,7 @@ bool                           hasSRP = IProtoStackBuilder::SRP_UDP_NONE != bldr
 				}
 #endif
 				v0 = CShObj::create< ProtoModTDestMux  >( bldr->getTDestMuxThreadPriority() );
+				v0->setRunToCompletion( bldr->getTDestMuxRunToCompletion() );
 				rval->addAtPort( v0 );
 			}
 		} else {
@@ -1185,12 +1474,17 @@ bool                           hasSRP = IProtoStackBuilder::SRP_UDP_NONE != bldr
 			}
 #endif
 			srpMuxMod   = CShObj::create< ProtoModSRPMux >( bldr->getSRPVersion(), bldr->getSRPMuxThreadPriority() );
+			// a busy-polling requester can only process its reply inline
+			// if the demultiplexer does not have a thread of its own
+			srpMuxMod->setRunToCompletion( bldr->getSRPMuxRunToCompletion() || bldr->getSRPBusyPollUS() );
 			rval->addAtPort( srpMuxMod );
 		}
 		// reserve enough queue depth - must potentially hold replies to synchronous retries
-		// until the synchronous reader comes along for the next time!
+		// (of all outstanding transactions and pipelined chunks) until the synchronous
+		// reader comes along for the next time!
 		unsigned retryCount = bldr->getSRPRetryCount() & 0xffff; // undocumented hack to test byte-resolution access
-		rval = srpMuxMod->createPort( bldr->getSRPMuxVirtualChannel(), 2 * (retryCount + 1) );
+		unsigned inFlight   = bldr->getSRPMaxOutstanding() * bldr->getSRPPipelineDepth();
+		rval = srpMuxMod->createPort( bldr->getSRPMuxVirtualChannel(), 2 * (retryCount + 1) * inFlight );
 #ifdef PSBLDR_DEBUG
 		if ( cpsw_psbldr_debug > 0 ) {
 			fprintf(CPSW::fDbg(), "  creating SRP mux port\n");
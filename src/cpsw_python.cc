@@ -212,8 +212,21 @@ IScalVal_RO_getVal(IScalVal_RO *val, int fromIdx, int toIdx, bool forceNumeric)
 	return ctxt.complete( 0 ).release();
 }
 
+template <typename T>
+static unsigned
+setValMaybeAsync(IScalVal *val, AsyncIO aio, T *p, unsigned nelms, IndexRange *rng)
+{
+	return aio ? val->setVal( aio, p, nelms, rng ) : val->setVal( p, nelms, rng );
+}
+
+static unsigned
+setValMaybeAsync(IScalVal *val, AsyncIO aio, uint64_t v, IndexRange *rng)
+{
+	return aio ? val->setVal( aio, v, rng ) : val->setVal( v, rng );
+}
+
 unsigned
-IScalVal_setVal(IScalVal *val, PyObject *op, int from, int to)
+IScalVal_setVal(IScalVal *val, PyObject *op, int from, int to, AsyncIO aio)
 {
 Py_buffer  view;
 IndexRange rng(from, to);
@@ -255,16 +268,16 @@ bool enumScalar = false;
 		if        ( view.itemsize == sizeof(uint8_t ) ) {
 			uint8_t *bufp = reinterpret_cast<uint8_t*>(view.buf);
 			// set same value to all elements ?
-			return 1==nelms ? val->setVal( (uint64_t)*bufp ) : val->setVal( bufp, nelms, &rng );
+			return 1==nelms ? setValMaybeAsync( val, aio, (uint64_t)*bufp, 0 ) : setValMaybeAsync( val, aio, bufp, nelms, &rng );
 		} else if ( view.itemsize == sizeof(uint16_t) ) {
 			uint16_t *bufp = reinterpret_cast<uint16_t*>(view.buf);
-			return 1==nelms ? val->setVal( (uint64_t)*bufp ) : val->setVal( bufp, nelms, &rng );
+			return 1==nelms ? setValMaybeAsync( val, aio, (uint64_t)*bufp, 0 ) : setValMaybeAsync( val, aio, bufp, nelms, &rng );
 		} else if ( view.itemsize == sizeof(uint32_t) ) {
 			uint32_t *bufp = reinterpret_cast<uint32_t*>(view.buf);
-			return 1==nelms ? val->setVal( (uint64_t)*bufp ) : val->setVal( bufp, nelms, &rng );
+			return 1==nelms ? setValMaybeAsync( val, aio, (uint64_t)*bufp, 0 ) : setValMaybeAsync( val, aio, bufp, nelms, &rng );
 		} else if ( view.itemsize == sizeof(uint64_t) ) {
 			uint64_t *bufp = reinterpret_cast<uint64_t*>(view.buf);
-			return 1==nelms ? val->setVal( (uint64_t)*bufp ) : val->setVal( bufp, nelms, &rng );
+			return 1==nelms ? setValMaybeAsync( val, aio, (uint64_t)*bufp, 0 ) : setValMaybeAsync( val, aio, bufp, nelms, &rng );
 		}
 		}
 
@@ -292,7 +305,7 @@ bool enumScalar = false;
 		}
 		{
 			GILUnlocker allowThreadingWhileWaiting;
-			return val->setVal( num64, &rng );
+			return setValMaybeAsync( val, aio, num64, &rng );
 		}
 	}
 
@@ -314,6 +327,12 @@ bool enumScalar = false;
 			if ( ! str ) {
 				throw InvalidArgError("IScalVal_setVal: Unable to convert string to ASCII");
 			}
+			if ( aio ) {
+				// there is no asynchronous string interface; map here
+				uint64_t num64 = val->getEnum()->map( str ).second;
+				GILUnlocker allowThreadingWhileWaiting;
+				return val->setVal( aio, num64, &rng );
+			}
 			{
 				GILUnlocker allowThreadingWhileWaiting;
 				return val->setVal( str, &rng );
@@ -349,6 +368,16 @@ bool enumScalar = false;
 				}
 				vcstr.push_back( str   );
 			}
+			if ( aio ) {
+				// there is no asynchronous string interface; map here
+				Enum                  enm = val->getEnum();
+				std::vector<uint64_t> v64;
+				for ( unsigned i = 0; i < nelms; ++i ) {
+					v64.push_back( enm->map( vcstr[i] ).second );
+				}
+				GILUnlocker allowThreadingWhileWaiting;
+				return val->setVal( aio, &v64[0], nelms, &rng );
+			}
 			{
 				GILUnlocker allowThreadingWhileWaiting;
 				return val->setVal( &vcstr[0], nelms, &rng );
@@ -374,7 +403,7 @@ bool enumScalar = false;
 		}
 		{
 		GILUnlocker allowThreadingWhileWaiting;
-		return val->setVal( &v64[0], nelms, &rng );
+		return setValMaybeAsync( val, aio, &v64[0], nelms, &rng );
 		}
 	}
 }
@@ -398,7 +427,7 @@ IDoubleVal_RO_getVal(IDoubleVal_RO *val, int fromIdx, int toIdx)
 
 
 unsigned
-IDoubleVal_setVal(IDoubleVal *val, PyObject *op, int from, int to)
+IDoubleVal_setVal(IDoubleVal *val, PyObject *op, int from, int to, AsyncIO aio)
 {
 IndexRange rng(from, to);
 
@@ -407,8 +436,9 @@ IndexRange rng(from, to);
 
 	if ( ! PySequence_Check( op ) ) {
 		// a single string (attempt to set enum) is also a sequence
+		double d = xtractDouble( op );
 		GILUnlocker allowThreadingWhileWaiting;
-		return val->setVal( xtractDouble( op ), &rng );
+		return aio ? val->setVal( aio, d, &rng ) : val->setVal( d, &rng );
 	}
 
 	unsigned nelms = PySequence_Length( op );
@@ -420,7 +450,7 @@ IndexRange rng(from, to);
 	}
 	{
 	GILUnlocker allowThreadingWhileWaiting;
-	return val->setVal( &v64[0], nelms, &rng );
+	return aio ? val->setVal( aio, &v64[0], nelms, &rng ) : val->setVal( &v64[0], nelms, &rng );
 	}
 }
 
@@ -468,6 +498,50 @@ Py_buffer view;
 	}
 }
 
+template <typename T>
+static void
+dictSet(PyUniqueObj &d, const char *key, T val)
+{
+PyUniqueObj v( val );
+	if ( ! v || PyDict_SetItemString( d.get(), key, v.get() ) ) {
+		throw InternalError("Unable to populate python dict");
+	}
+}
+
+PyObject *
+ISRPStats_getLatency(const ISRPStats *stats, int channel)
+{
+ISRPStats::Latency l;
+PyUniqueObj        d( PyDict_New() );
+
+	if ( channel != ISRPStats::SYNCHRONOUS && channel != ISRPStats::ASYNCHRONOUS ) {
+		throw InvalidArgError("Invalid channel (must be SYNCHRONOUS or ASYNCHRONOUS)");
+	}
+
+	l = stats->getLatency( (ISRPStats::Channel)channel );
+
+	dictSet( d, "count",  l.count_  );
+	dictSet( d, "avgUs",  l.avgUs_  );
+	dictSet( d, "p50Us",  l.p50Us_  );
+	dictSet( d, "p99Us",  l.p99Us_  );
+	dictSet( d, "p999Us", l.p999Us_ );
+	dictSet( d, "maxUs",  l.maxUs_  );
+
+	return d.release();
+}
+
+std::string
+ISRPStats_dumpYamlString(const ISRPStats *stats)
+{
+YAML::Node    node;
+YAML::Emitter emit;
+
+	stats->dumpYaml( node );
+	emit << node;
+
+	return std::string( emit.c_str() ) + "\n";
+}
+
 PyUniqueObj::PyUniqueObj( PyListObj &o )
 : up_( o.up_.release() )
 {
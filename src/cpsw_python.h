@@ -281,11 +281,12 @@ IScalVal_RO_getVal(IScalVal_RO *val, PyObject *o, int from = -1, int to = -1);
 PyObject *
 IScalVal_RO_getVal(IScalVal_RO *val, int fromIdx = -1, int toIdx = -1, bool forceNumeric = false);
 
+// if 'aio' is non-NULL then the values are written asynchronously
 unsigned
-IScalVal_setVal(IScalVal *val, PyObject *op, int from = -1, int to = -1);
+IScalVal_setVal(IScalVal *val, PyObject *op, int from = -1, int to = -1, AsyncIO aio = AsyncIO());
 
 unsigned
-IDoubleVal_setVal(IDoubleVal *val, PyObject *op, int from = -1, int to = -1);
+IDoubleVal_setVal(IDoubleVal *val, PyObject *op, int from = -1, int to = -1, AsyncIO aio = AsyncIO());
 
 PyObject *
 IDoubleVal_RO_getVal(IDoubleVal_RO *val, int from = -1, int to = -1);
@@ -297,6 +298,13 @@ IStream_read(IStream *val, PyObject *op, int64_t timeoutUs, uint64_t offset);
 int64_t
 IStream_write(IStream *val, PyObject *op, int64_t timeoutUs);
 
+// returns a dict with the summary of a round-trip time histogram
+PyObject *
+ISRPStats_getLatency(const ISRPStats *stats, int channel = ISRPStats::SYNCHRONOUS);
+
+std::string
+ISRPStats_dumpYamlString(const ISRPStats *stats);
+
 template <typename T, typename LT>
 class CGetValWrapperContextTmpl {
 private:
@@ -328,7 +336,8 @@ public:
 
 	virtual T complete(CPSWError *err)
 	{
-		if ( err ) {
+		// NONE: a write operation; there is no result
+		if ( err || NONE == type_ ) {
 			T rval;
 			return rval;
 		}
@@ -428,6 +437,20 @@ public:
 		}
 	}
 
+	virtual unsigned issueSetVal(IScalVal *val, PyObject *op, int from, int to, AsyncIO aio)
+	{
+		type_  = NONE;
+		nelms_ = 0;
+		return IScalVal_setVal( val, op, from, to, aio );
+	}
+
+	virtual unsigned issueSetVal(IDoubleVal *val, PyObject *op, int from, int to, AsyncIO aio)
+	{
+		type_  = NONE;
+		nelms_ = 0;
+		return IDoubleVal_setVal( val, op, from, to, aio );
+	}
+
 	CGetValWrapperContextTmpl()
 	: type_ ( NONE ),
 	  nelms_( 0    ),
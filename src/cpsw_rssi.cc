@@ -74,6 +74,10 @@ CRssi::CRssi(
   unOrderedSegs_ ( defaults_.ldMaxUnackedSegs_       )
 {
 	conID_ = (uint32_t)time(NULL);
+	eack_  = false;
+	rto_   = rexTO_;
+	haveRtt_ = false;
+	srttUS_  = rttVarUS_ = 0;
 	::memset( &stats_, 0, sizeof(stats_) );
 
 	closedReopenDelay_.tv_nsec = 0;
@@ -86,8 +90,14 @@ CRssi::CRssi(
 
 void CRssi::processAckNumber(uint8_t flags, SeqNo ackNo)
 {
-int acked;
+int      acked;
+CTimeout sent, now;
 	if ( (flags & RssiHeader::FLG_ACK) ) {
+		// ACK of a segment sent exactly once yields an RTT sample
+		if ( defaults_.adaptiveRex_ && unAckedSegs_.getSendTime( ackNo, &sent ) ) {
+			eventSet_->getAbsTime( &now );
+			processRttSample( now < sent ? 0 : (now - sent).getUs() );
+		}
 		if ( (acked = unAckedSegs_.ack( ackNo )) > 0 ) {
 			numRex_ = 0;
 			stats_.numSegsAckedByPeer_ += acked;
@@ -110,6 +120,79 @@ int acked;
 	}
 }
 
+// RFC 6298 estimator (alpha = 1/8, beta = 1/4)
+void CRssi::processRttSample(uint64_t us)
+{
+uint64_t diff;
+
+	if ( ! haveRtt_ ) {
+		srttUS_   = us;
+		rttVarUS_ = us/2;
+		haveRtt_  = true;
+	} else {
+		diff      = srttUS_ > us ? srttUS_ - us : us - srttUS_;
+		rttVarUS_ = (3*rttVarUS_ + diff)/4;
+		srttUS_   = (7*srttUS_   + us  )/8;
+	}
+	stats_.rttSamples_++;
+
+	// a valid sample also undoes any backoff
+	computeRexTimeout();
+}
+
+void CRssi::computeRexTimeout()
+{
+uint64_t var = 4*rttVarUS_;
+uint64_t lo, hi, us;
+
+	if ( ! defaults_.adaptiveRex_ || ! haveRtt_ ) {
+		rto_ = rexTO_;
+		return;
+	}
+
+	if ( var < units_ )
+		var = units_;
+	us = srttUS_ + var;
+
+	// the peer may hold back its ACK for up to 'cakTO_'; don't
+	// retransmit before that (spurious retransmissions).
+	lo = cakTO_.getUs() + units_;
+	hi = REX_BACKOFF_MAX * rexTO_.getUs();
+	if ( us < lo )
+		us = lo;
+	if ( us > hi )
+		us = hi;
+	rto_ = CTimeout( us );
+}
+
+// on timeout: double the retransmission timeout until the next
+// valid RTT sample
+void CRssi::backoffRexTimeout()
+{
+uint64_t us = 2*rto_.getUs();
+uint64_t hi = REX_BACKOFF_MAX * rexTO_.getUs();
+
+	if ( ! defaults_.adaptiveRex_ )
+		return;
+	rto_ = CTimeout( us > hi ? hi : us );
+}
+
+void CRssi::processEackNumbers(RssiEackHeader &hdr)
+{
+unsigned i, n = hdr.getNumEacks();
+	stats_.eacksRcvd_++;
+	for ( i=0; i<n; i++ ) {
+		if ( unAckedSegs_.eack( hdr.getEack( i ) ) > 0 ) {
+			stats_.numSegsEackedByPeer_++;
+		}
+	}
+#ifdef RSSI_DEBUG
+	if ( cpsw_rssi_debug > 1 ) {
+		fprintf(CPSW::fDbg(),"%s: got EACK (%d entries)\n", getName(), n);
+	}
+#endif
+}
+
 void CRssi::handleRxEvent(IIntEventSource *src)
 {
 #ifdef RSSI_DEBUG
@@ -145,10 +228,13 @@ void CRssi::resetNegotiableParams()
 	units_   = timerUnits_;
 	unitExp_ = timerUnitExp_;
 	rexTO_   = CTimeout( defaults_.rexTimeoutUS_    );
+	rto_     = rexTO_;
+	haveRtt_ = false;
 	cakTO_   = CTimeout( defaults_.cumAckTimeoutUS_ );
 	setNulTimeout( defaults_.nulTimeoutUS_ );
 	rexMX_   = defaults_.rexMax_;
 	cakMX_   = defaults_.cumAckMax_;
+	eack_    = false;
 }
 
 void CRssi::close()
@@ -241,7 +327,7 @@ void CRssi::armRexAndNulTimer()
 		eventSet_->getAbsTime( &now );
 
 		if ( ! peerBSY_ ) {
-			rexTimer()->arm_abs( now + rexTO_ );
+			rexTimer()->arm_abs( now + rto_ );
 #ifdef RSSI_DEBUG
 			if ( cpsw_rssi_debug > 2 ) {
 				fprintf(CPSW::fDbg(),"%s: REX timer armed (state %s)\n", getName(), state_->getName());
@@ -262,8 +348,11 @@ void CRssi::armRexAndNulTimer()
 
 void CRssi::sendBufAndKeepForRetransmission(BufChain b)
 {
+CTimeout now;
+
 	sendBuf( b, false );
-	unAckedSegs_.push( b );
+	eventSet_->getAbsTime( &now );
+	unAckedSegs_.push( b, now );
 	armRexAndNulTimer();
 
 	unAckedSegs_.dump();
@@ -301,6 +390,52 @@ RssiHeader hdr( b->getPayload(), b->getAvail(), false, RssiHeader::SET );
 #endif
 }
 
+// acknowledge the segments we hold beyond a gap
+// so that the peer only retransmits what is missing
+void CRssi::sendEACK()
+{
+SeqNo          seqs[RssiEackHeader::MAX_EACKS];
+unsigned       n  = unOrderedSegs_.getOutOfOrder( seqs, sizeof(seqs)/sizeof(seqs[0]) - 1 );
+BufChain       bc;
+Buf            b;
+
+	if ( 0 == n ) {
+		sendACK();
+		return;
+	}
+
+	// header length must be even; repeat the last entry
+	if ( (n & 1) ) {
+		seqs[n] = seqs[n-1];
+		n++;
+	}
+
+	bc = IBufChain::create();
+	b  = bc->createAtHead( IBuf::CAPA_ETH_HDR );
+
+	RssiEackHeader hdr( b->getPayload(), b->getAvail(), false, RssiHeader::SET, n );
+
+	hdr.setFlags( RssiHeader::FLG_ACK | RssiHeader::FLG_EAC );
+	hdr.setSeqNo( lastSeqSent_ + 1 );
+	while ( n > 0 ) {
+		n--;
+		hdr.setEack( n, seqs[n] );
+	}
+
+	b->setSize( hdr.getHSize() );
+
+	stats_.eacksSent_++;
+
+	// EACK is never retransmitted
+	sendBuf( bc, false );
+
+#ifdef RSSI_DEBUG
+	if ( cpsw_rssi_debug > 1 ) {
+		fprintf(CPSW::fDbg(),"%s: sent EACK %d (%d entries)\n", getName(), lastSeqSent_ + 1, hdr.getNumEacks());
+	}
+#endif
+}
+
 void CRssi::sendRST()
 {
 BufChain   bc = IBufChain::create();
@@ -375,6 +510,9 @@ int           maxSegSize;
 	flags = RssiSynHeader::XFL_ONE;
 	if ( addChecksum_ )
 		flags |= RssiSynHeader::XFL_CHK;
+	// client proposes selective ACKs, server confirms
+	if ( isServer_ ? eack_ : defaults_.selectiveAck_ )
+		flags |= RssiSynHeader::XFL_EAK;
 
 	synHdr.setXflgs( flags                         );
 	synHdr.setVersn( RssiSynHeader::RSSI_VERSION_1 );
@@ -445,6 +583,7 @@ int           maxSegSize;
 void CRssi::processRetransmissionTimeout()
 {
 	stats_.rexTimeouts_++;
+	backoffRexTimeout();
 #ifdef RSSI_DEBUG
 	if ( cpsw_rssi_debug > 2 ) {
 		fprintf(CPSW::fDbg(),"%s: RexTimer expired\n", getName());
@@ -570,6 +709,16 @@ void CRssi::dumpStats(FILE *f)
 	fprintf(f ,"  # segments delivered to usr: %12u\n", stats_.numSegsGivenToUser_);
 	fprintf(f ,"  # RX segs with BSY asserted: %12u\n", stats_.busyFlagsCountedRx_);
 	fprintf(f ,"  # TX segs with BSY asserted: %12u\n", stats_.busyFlagsCountedTx_);
+	fprintf(f ,"  Selective ACKs negotiated  : %12c\n", eack_ ? 'Y' : 'N'         );
+	fprintf(f ,"  # EACKs sent               : %12u\n", stats_.eacksSent_         );
+	fprintf(f ,"  # EACKs received           : %12u\n", stats_.eacksRcvd_         );
+	fprintf(f ,"  # segments EACKed by peer  : %12u\n", stats_.numSegsEackedByPeer_);
+	fprintf(f ,"  # retrans. skipped (EACKed): %12u\n", stats_.rexSkipped_        );
+	fprintf(f ,"  Adaptive retrans. timeout  : %12c\n", defaults_.adaptiveRex_ ? 'Y' : 'N');
+	fprintf(f ,"  Smoothed RTT               : %12" PRIu64 "us\n", getSRTTUs()    );
+	fprintf(f ,"  RTT variation              : %12" PRIu64 "us\n", getRTTVarUs()  );
+	fprintf(f ,"  Retransmission timeout     : %12" PRIu64 "us\n", getRexTimeoutUs());
+	fprintf(f ,"  # RTT samples              : %12u\n", stats_.rttSamples_        );
 }
 
 void CRssi::RingBuf::dump()
@@ -663,6 +812,11 @@ unsigned i, u;
 		unAckedSegs_.resize( peerOssMX_ );
 	}
 
+	// selective ACKs are only used if both sides want them; this
+	// is independent of 'acceptNegotiated' (a peer which does not
+	// know about them never sets the flag).
+	eack_ = defaults_.selectiveAck_ && !! (synHdr.getXflgs() & RssiSynHeader::XFL_EAK);
+
 	if ( acceptNegotiated ) {
 
 		// accept server's parameters
@@ -685,6 +839,8 @@ unsigned i, u;
 
 	}
 
+	computeRexTimeout();
+
 #ifdef RSSI_DEBUG
 	if ( cpsw_rssi_debug > 0 ) {
 		fprintf(CPSW::fDbg(), "RSSI Negotiated parms      : %s\n", acceptNegotiated ? "proposed by peer" : "enforced by us" );
@@ -694,6 +850,7 @@ unsigned i, u;
 		fprintf(CPSW::fDbg(), "RSSI           NULL timeout: %" PRIu64 "us\n", getNulTimeout());
 		fprintf(CPSW::fDbg(), "RSSI max. # retransmissions: %u\n"           , rexMX_        );
 		fprintf(CPSW::fDbg(), "RSSI        cumulative ACKs: %u\n"           , cakMX_        );
+		fprintf(CPSW::fDbg(), "RSSI         selective ACKs: %c\n"           , eack_ ? 'Y' : 'N');
 	}
 #endif
 
@@ -701,8 +858,10 @@ unsigned i, u;
 
 const CRssiConfigParams & CRssiConfigParams::assertValid() const
 {
-	if ( ldMaxUnackedSegs_        >= 8     )
-		throw ConfigurationError("RSSI parameter 'ldMaxUnackedSegs' out too big");
+	// sequence numbers are 8 bits; with selective ACKs the
+	// window must not exceed half the sequence space
+	if ( ldMaxUnackedSegs_        >  LD_MAX_UNACKED_SEGS_MAX )
+		throw ConfigurationError("RSSI parameter 'ldMaxUnackedSegs' out too big (max. 7)");
 	if ( rexTimeoutUS_/UNIT_US_DFLT    >= 65536 )
 		throw ConfigurationError("RSSI parameter 'retransmissionTimeoutUS' out too big");
 	if ( cumAckTimeoutUS_/UNIT_US_DFLT >= 65536 )
@@ -129,6 +129,7 @@ struct CRssiConfigParams {
 	 * (some of them) are negotiated with the peer (as per RUDP spec).
 	 */
 	static const uint8_t  LD_MAX_UNACKED_SEGS_DFLT =    4;
+	static const uint8_t  LD_MAX_UNACKED_SEGS_MAX  =    7; // 128 segments
 	static const unsigned         QUEUE_DEPTH_DFLT =    0;
 	static const unsigned             UNIT_US_DFLT = 1000;
 	static const uint64_t      REX_TIMEOUT_US_DFLT =  100*(uint64_t)UNIT_US_DFLT; // ms
@@ -138,6 +139,8 @@ struct CRssiConfigParams {
 	static const uint8_t              CAK_MAX_DFLT =    5;
 	static const unsigned             SGS_MAX_DFLT =    0;
 	static const unsigned         UNIT_US_EXP_DFLT =    3; // value used by server; must match UNIT_US (i.e., UNIT_US = 10^-UNIT_US_EXP)
+	static const bool           SELECTIVE_ACK_DFLT = true; // only used if the peer agrees
+	static const bool           ADAPTIVE_REX_DFLT  = true; // derive rex timeout from measured RTT
 
 	uint8_t      ldMaxUnackedSegs_;
 	unsigned     outQueueDepth_;
@@ -148,6 +151,8 @@ struct CRssiConfigParams {
 	uint8_t      rexMax_;
 	uint8_t      cumAckMax_;
 	unsigned     forcedSegsMax_;
+	bool         selectiveAck_;
+	bool         adaptiveRex_;
 
 	CRssiConfigParams(
 		uint8_t      ldMaxUnackedSegs = LD_MAX_UNACKED_SEGS_DFLT,
@@ -158,7 +163,9 @@ struct CRssiConfigParams {
 		uint64_t     nulTimeoutUS     = NUL_TIMEOUT_US_DFLT,
 		uint8_t      rexMax           = REX_MAX_DFLT,
 		uint8_t      cumAckMax        = CAK_MAX_DFLT,
-		unsigned     forcedSegsMax    = SGS_MAX_DFLT
+		unsigned     forcedSegsMax    = SGS_MAX_DFLT,
+		bool         selectiveAck     = SELECTIVE_ACK_DFLT,
+		bool         adaptiveRex      = ADAPTIVE_REX_DFLT
 	)
 	:
 		ldMaxUnackedSegs_( ldMaxUnackedSegs ),
@@ -169,7 +176,9 @@ struct CRssiConfigParams {
 		nulTimeoutUS_    ( nulTimeoutUS     ),
 		rexMax_          ( rexMax           ),
 		cumAckMax_       ( cumAckMax        ),
-		forcedSegsMax_   ( forcedSegsMax    )
+		forcedSegsMax_   ( forcedSegsMax    ),
+		selectiveAck_    ( selectiveAck     ),
+		adaptiveRex_     ( adaptiveRex      )
 	{}
 
 	const CRssiConfigParams & assertValid() const;
@@ -208,6 +217,7 @@ public:
 	static const uint8_t  MAX_CUMLTD_ACK_N    = CRssiConfigParams::CAK_MAX_DFLT;
 
 	static const uint16_t MAX_SEGMENT_SIZE    = 1500 - 20 - 8 - 8; // - IP - UDP - RSSI
+	static const unsigned REX_BACKOFF_MAX     = 8; // adaptive rex timeout <= 8 x negotiated one
 
 private:
 	CRssiConfigParams defaults_;
@@ -236,6 +246,20 @@ public:
 
 	virtual void dumpStats(FILE *);
 
+	// RTT estimate (0 until measured) and current
+	// retransmission timeout of this connection
+	virtual uint64_t getSRTTUs()        { return haveRtt_ ? srttUS_   : 0; }
+	virtual uint64_t getRTTVarUs()      { return haveRtt_ ? rttVarUS_ : 0; }
+	virtual uint64_t getRexTimeoutUs()  { return rto_.getUs();             }
+	virtual unsigned getNumRttSamples() { return stats_.rttSamples_;       }
+
+	// selective ACKs: negotiated with the peer (for the current
+	// connection), EACKs exchanged and retransmissions saved
+	virtual bool     hasSelectiveAck()    { return eack_;                  }
+	virtual unsigned getNumEacksSent()    { return stats_.eacksSent_;      }
+	virtual unsigned getNumEacksRcvd()    { return stats_.eacksRcvd_;      }
+	virtual unsigned getNumRexSkipped()   { return stats_.rexSkipped_;     }
+
 protected:
 
 	typedef uint8_t SeqNo;
@@ -310,13 +334,23 @@ protected:
 	class RingBuf : public BufBase {
 	private:
 		BufIdx wp_;
+		// segments the peer acknowledged selectively (EACK);
+		// they are kept until cumulatively ACKed but not
+		// retransmitted.
+		std::vector<bool> eacked_;
+		// time of (first) transmission; indefinite once a
+		// segment is retransmitted since its ACK is ambiguous
+		// then (Karn)
+		std::vector<CTimeout> sent_;
 
 		friend class iterator;
 
 	public:
 		RingBuf(unsigned ldsz)
 		: BufBase(ldsz),
-		  wp_(rp_)
+		  wp_(rp_),
+		  eacked_(capa_),
+		  sent_(capa_)
 		{}
 
 		void dump();
@@ -349,6 +383,17 @@ protected:
 					return BufChain();
 				return rb_->buf_.at( (idx_ & rb_->msk_) );
 			}
+
+			bool isEacked()
+			{
+				return idx_ != rb_->wp_ && rb_->eacked_[ idx_ & rb_->msk_ ];
+			}
+
+			void setRetransmitted()
+			{
+				if ( idx_ != rb_->wp_ )
+					rb_->sent_[ idx_ & rb_->msk_ ].setIndefinite();
+			}
 		};
 
 		iterator begin()
@@ -378,7 +423,44 @@ protected:
 			return cumAck;
 		}
 
-		void push(BufChain b)
+		// returns 1 if an outstanding segment was newly
+		// EACKed, 0 if it already was and -1 if 'seqNo' is
+		// not outstanding.
+		int eack(SeqNo seqNo)
+		{
+		SeqNo  off = seqNo - oldest_;
+		BufIdx idx;
+
+			if ( off >= getSize() )
+				return -1;
+
+			idx = (rp_ + off) & msk_;
+			if ( eacked_[idx] )
+				return 0;
+			eacked_[idx] = true;
+			return 1;
+		}
+
+		// time of transmission of outstanding segment 'seqNo';
+		// returns false if unknown or ambiguous, i.e., if this
+		// or any older outstanding segment was retransmitted
+		// (the cumulative ACK was held up by the recovery).
+		bool getSendTime(SeqNo seqNo, CTimeout *when)
+		{
+		SeqNo off = seqNo - oldest_;
+		SeqNo i;
+
+			if ( off >= getSize() )
+				return false;
+			for ( i=0; i<=off; i++ ) {
+				if ( sent_[ (rp_ + i) & msk_ ].isIndefinite() )
+					return false;
+			}
+			*when = sent_[ (rp_ + off) & msk_ ];
+			return true;
+		}
+
+		void push(BufChain b, const CTimeout &sent = CTimeout())
 		{
 		unsigned widx = wp_ & msk_;
 			if ( getSize() > capa_ ) {
@@ -387,7 +469,9 @@ protected:
 				// transmits
 				throw InternalError("RingBuf Overflow");
 			}
-			buf_[ widx ] = b;
+			buf_[ widx ]    = b;
+			eacked_[ widx ] = false;
+			sent_[ widx ]   = sent;
 			wp_++;
 		}
 
@@ -405,6 +489,8 @@ protected:
 			rp_  = wp_ = 0;
 			msk_ = capa_ - 1;
 			buf_.resize( capa_ );
+			eacked_.resize( capa_ );
+			sent_.resize( capa_ );
 			seed( tmpo );
 			for ( i=0; i<sz; i++ )
 				push( tmp[i] );
@@ -448,6 +534,46 @@ protected:
 			return (getOldest() - 1) & 0xff;
 		}
 
+		bool isHeld(SeqNo off)
+		{
+			return !! buf_[ (off + rp_) & msk_ ];
+		}
+
+		// whether 'seqNo' is held beyond a gap
+		bool isOutOfOrder(SeqNo seqNo)
+		{
+		SeqNo off = seqNo - oldest_;
+		SeqNo i;
+			if ( off >= lim_ || ! isHeld( off ) )
+				return false;
+			for ( i=0; i<off; i++ ) {
+				if ( ! isHeld( i ) )
+					return true;
+			}
+			return false;
+		}
+
+		bool hasOutOfOrder()
+		{
+		SeqNo dummy;
+			return getOutOfOrder( &dummy, 1 ) > 0;
+		}
+
+		// sequence numbers of (at most 'max') segments held
+		// beyond a gap
+		unsigned getOutOfOrder(SeqNo *seqNos, unsigned max)
+		{
+		unsigned off, n = 0;
+		bool     gap    = false;
+			for ( off = 0; off < lim_ && n < max; off++ ) {
+				if ( ! isHeld( off ) )
+					gap = true;
+				else if ( gap )
+					seqNos[n++] = oldest_ + off;
+			}
+			return n;
+		}
+
 		void purge()
 		{
 		unsigned i;
@@ -593,10 +719,16 @@ private:
 protected:
 
 	CTimeout rexTO_, cakTO_, nulTO_;
+	// adaptive retransmission timeout (RFC 6298); 'rto_' is
+	// what the REX timer uses. It starts out as 'rexTO_'.
+	CTimeout rto_;
+	bool     haveRtt_;
+	uint64_t srttUS_, rttVarUS_;
 	unsigned rexMX_;
 	int      cakMX_;
 	uint32_t conID_;
 	unsigned peerOssMX_, peerSgsMX_;
+	bool     eack_;   // selective ACKs negotiated
 	unsigned numRex_;
 	int      numCak_; // may temporarily fall below zero
 	bool     peerBSY_;
@@ -621,9 +753,14 @@ protected:
 	void sendBuf(BufChain, bool);
 	void armRexAndNulTimer();
 	void processAckNumber(uint8_t, SeqNo);
+	void processEackNumbers(RssiEackHeader &);
+	void processRttSample(uint64_t us);
+	void computeRexTimeout();
+	void backoffRexTimeout();
 
 	void sendSYN(bool do_ack);
 	void sendACK();
+	void sendEACK();
 	bool sendNUL();
 	void sendRST();
 	void sendDAT(BufChain);
@@ -647,6 +784,11 @@ protected:
 		unsigned busyFlagsCountedRx_;
 		unsigned busyFlagsCountedTx_;
 		unsigned busyDeassertRex_;
+		unsigned eacksSent_;
+		unsigned eacksRcvd_;
+		unsigned numSegsEackedByPeer_;
+		unsigned rexSkipped_;
+		unsigned rttSamples_;
 	} stats_;
 
 
@@ -75,7 +75,28 @@ RssiSynHeader::RssiSynHeader(uint8_t *buf, size_t bufsz, bool computeChksum, MOD
 		chkOk_ = true;
 	}
 }
-	
+
+RssiEackHeader::RssiEackHeader(uint8_t *buf, size_t bufsz, bool computeChksum, MODE initMode, unsigned nEacks)
+: RssiHeader(buf, bufsz, false, (SET == initMode ? getEackHSize( nEacks ) : (uint8_t)0 ) )
+{
+	if ( SET != initMode ) {
+		if ( getHSize() < minHeaderSize() ) {
+			throw BadHeader("EACK header too short");
+		}
+	} else if ( nEacks < 1 || nEacks > MAX_EACKS ) {
+		throw BadHeader("invalid number of EACKs");
+	}
+	if ( computeChksum ) {
+		if ( SET == initMode ) {
+			chkOk_ = false;
+		} else {
+			chkOk_ = ( cs() == 0 );
+		}
+	} else {
+		chkOk_ = true;
+	}
+}
+
 uint8_t RssiHeader::getHSize(uint8_t protoVersion)
 {
 	if ( RssiSynHeader::RSSI_VERSION_1 != protoVersion )
@@ -88,11 +109,12 @@ void RssiHeader::dump(FILE *f, int hasPayload)
 char      pld = hasPayload > 0 ? 'P' : hasPayload < 0 ? '?' : '-';
 uint8_t flags = getFlags();
 
-		fprintf(f,"SEQ %d, ACK %d [%c%c%c%c%c%c]",
+		fprintf(f,"SEQ %d, ACK %d [%c%c%c%c%c%c%c]",
 			getSeqNo(),
 			getAckNo(),
 			(flags & RssiHeader::FLG_SYN) ? 'S':'-',
 			(flags & RssiHeader::FLG_ACK) ? 'A':'-',
+			(flags & RssiHeader::FLG_EAC) ? 'E':'-',
 			(flags & RssiHeader::FLG_BSY) ? 'B':'-',
 			(flags & RssiHeader::FLG_RST) ? 'R':'-',
 			(flags & RssiHeader::FLG_NUL) ? 'N':'-',
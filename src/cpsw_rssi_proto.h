@@ -118,6 +118,11 @@ public:
 		return (getFlags() & ~FLG_BSY) == FLG_ACK;
 	}
 
+	bool isPureEack()
+	{
+		return (getFlags() & ~FLG_BSY) == (FLG_ACK | FLG_EAC);
+	}
+
 	// hasPayload: > 0 yes, == 0 no, < 0 unknown
 	void dump(FILE *f, int hasPayload = -1);
 
@@ -153,6 +158,12 @@ public:
 class RssiSynHeader : public RssiHeader {
 public:
 
+	// CPSW extension: selective (EACK) acknowledgements supported.
+	// Bit 1 is reserved in the SYN header of other RSSI
+	// implementations; the firmware servers ignore it (they
+	// neither set nor echo it and do not reject the SYN), so
+	// EACK stays off with them.
+	const static uint8_t XFL_EAK = (1<<1);
 	const static uint8_t XFL_CHK = (1<<2);
 	const static uint8_t XFL_ONE = (1<<3);
 
@@ -206,4 +217,29 @@ public:
 	virtual ~RssiSynHeader() {}
 };
 
+// EACK: ACK header followed by the sequence numbers of segments
+// which were received out of order (the list is padded to an even
+// length by repeating the last entry).
+class RssiEackHeader : public RssiHeader {
+public:
+	const static unsigned EACK_OFF  =   4;
+	// fits a CAPA_ETH_HDR buffer
+	const static unsigned MAX_EACKS = 120;
+
+	unsigned getNumEacks()          { return getHSize() - EACK_OFF - 2; }
+	uint8_t  getEack(unsigned i)    { return buf_[EACK_OFF + i];        }
+	void     setEack(unsigned i, uint8_t v) { buf_[EACK_OFF + i] = v;   }
+
+	static uint8_t getEackHSize(unsigned nEacks)
+	{
+		return (EACK_OFF + nEacks + 2 + 1) & ~1;
+	}
+
+	// in SET mode the header has room for 'nEacks' entries (which
+	// the caller fills in)
+	RssiEackHeader(uint8_t *buf, size_t bufsz, bool computeChksum, MODE initMode, unsigned nEacks = 1);
+
+	virtual ~RssiEackHeader() {}
+};
+
 #endif
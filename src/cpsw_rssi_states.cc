@@ -128,6 +128,7 @@ void CRssi::NOTCLOSED::handleRxEvent(CRssi *context, IIntEventSource *src)
 BufChain bc;
 uint8_t  flags;
 bool     hasPayload;
+bool     eackNow    = false;
 
 	if ( ! (bc = context->tryPopUpstream()) ) {
 		fprintf(CPSW::fErr(), "%s: SRC pending %d\n", context->getName(), src->isPending());
@@ -197,6 +198,12 @@ bool     hasPayload;
 		// clean out our outgoing buffer
 		context->processAckNumber( hdr.getFlags(), hdr.getAckNo() );
 
+		// mark segments the peer holds already (beyond a gap)
+		if ( (flags & RssiHeader::FLG_EAC) && context->eack_ ) {
+			RssiEackHeader eackHdr( b->getPayload(), b->getSize(), false /* already verified */, RssiHeader::READ );
+			context->processEackNumbers( eackHdr );
+		}
+
 		// cache the busy flag (header no longer valid further down);
 		bool peerNowBSY = !! (hdr.getFlags() & RssiHeader::FLG_BSY);
 
@@ -215,11 +222,17 @@ bool     hasPayload;
 				// AFTER THIS SEQUENCE OF OPERATIONS WE NO LONGER OWN THE BUFFER
 				// NOR THE INCLUDED HEADER, I.E., MUST CACHE HEADER VALUES USED
 				// THEREAFTER!
+				SeqNo seqNo  = hdr.getSeqNo();
+				// a segment which fills a gap is ACKed right
+				// away, too (the peer waits for it)
+				bool  hadGap = context->eack_ && context->unOrderedSegs_.hasOutOfOrder();
 				b.reset();
-				context->unOrderedSegs_.store( hdr.getSeqNo(), bc );
+				context->unOrderedSegs_.store( seqNo, bc );
 
 				drainReassembleBuffer( context );
 
+				eackNow = hadGap || ( context->eack_ && context->unOrderedSegs_.isOutOfOrder( seqNo ) );
+
 			} else {
 				// should not happen if the peer respects our max. unacked window
 				// but still could as a result of retransmissions...
@@ -256,7 +269,16 @@ bool     hasPayload;
 
 		// do we have to ACK this one?
 		++context->numCak_;
-		if ( context->numCak_ > context->cakMX_ ) {
+		if ( eackNow ) {
+			// tell the peer right away what we got so it
+			// retransmits only the missing segments
+			context->sendEACK();
+#ifdef RSSI_DEBUG
+			if (cpsw_rssi_debug > 1 ) {
+				fprintf(CPSW::fDbg(),"%s: segment out of order or filling gap; sent (E)ACK (state %s)\n", context->getName(), getName());
+			}
+#endif
+		} else if ( context->numCak_ > context->cakMX_ ) {
 			BufChain b1 = hasBufToSend(context);
 			if ( b1 )
 				context->sendDAT( b1 );
@@ -392,7 +414,7 @@ bool CRssi::CLNT_WAIT_SYN_ACK::handleSYN(CRssi *context, RssiSynHeader &synHdr)
 bool CRssi::NOTCLOSED::handleOTH(CRssi *context, RssiHeader &hdr, bool hasPayload)
 {
 
-	if ( hdr.isPureAck() && ! hasPayload ) {
+	if ( (hdr.isPureAck() || hdr.isPureEack()) && ! hasPayload ) {
 		// pure ACK uses LAST seq no;
 		// whereas 'canAccept()' below expects the next one.
 
@@ -449,7 +471,14 @@ void CRssi::NOTCLOSED::processRetransmissionTimeout(CRssi *context)
 
 	if ( (bc = *it) ) {
 		do {
+			if ( it.isEacked() ) {
+				// peer has it already
+				context->stats_.rexSkipped_++;
+				continue;
+			}
 			context->stats_.rexSegments_++;
+			// no RTT sample from this one
+			it.setRetransmitted();
 #ifdef RSSI_DEBUG
 			if (cpsw_rssi_debug > 2 ) {
 				fprintf(CPSW::fDbg(),"%s: retransmitting (state %s)\n", getName(), context->getName());
@@ -0,0 +1,466 @@
+ //@C Copyright Notice
+ //@C ================
+ //@C This file is part of CPSW. It is subject to the license terms in the LICENSE.txt
+ //@C file found in the top-level directory of this distribution and at
+ //@C https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html.
+ //@C
+ //@C No part of CPSW, including this file, may be copied, modified, propagated, or
+ //@C distributed except according to the terms contained in the LICENSE.txt file.
+
+#include <cpsw_shadow_cache.h>
+#include <cpsw_srp_addr.h>
+#include <cpsw_path.h>
+#include <cpsw_error.h>
+#include <string.h>
+#include <vector>
+
+#define __STDC_FORMAT_MACROS
+#include <inttypes.h>
+
+//#define SHADOW_CACHE_DEBUG
+
+using cpsw::dynamic_pointer_cast;
+
+CShadowCache::Page::Page()
+{
+	memset( flags_, 0, sizeof(flags_) );
+}
+
+CShadowCache::CShadowCache(const IWriter *writer)
+: writer_( writer        ),
+  mtx_   ( "SHADOWCACHE" ),
+  epoch_ ( 0             ),
+  hits_  ( 0             ),
+  misses_( 0             )
+{
+}
+
+CShadowCache::~CShadowCache()
+{
+Pages::iterator it;
+	for ( it = pages_.begin(); it != pages_.end(); ++it ) {
+		delete it->second;
+	}
+}
+
+CShadowCache::Page *
+CShadowCache::getPage(uint64_t pgno, bool alloc)
+{
+Pages::iterator it = pages_.find( pgno );
+
+	if ( it != pages_.end() )
+		return it->second;
+
+	if ( ! alloc )
+		return 0;
+
+	Page *pg = new Page();
+	pages_[ pgno ] = pg;
+	return pg;
+}
+
+bool
+CShadowCache::read(uint8_t *dst, uint64_t off, unsigned nbytes, uint64_t *epoch_p)
+{
+CMtx::lg GUARD( &mtx_ );
+uint64_t end = off + nbytes;
+uint64_t o;
+unsigned pgo, l, i;
+Page    *pg;
+
+	// verify that all bytes are valid before copying anything
+	for ( o = off; o < end; o += l ) {
+		pgo = o & (PAGE_SIZE - 1);
+		l   = PAGE_SIZE - pgo;
+		if ( l > end - o )
+			l = end - o;
+		if ( ! (pg = getPage( o >> PAGE_SHIFT, false )) )
+			goto miss;
+		for ( i = 0; i < l; i++ ) {
+			if ( ! (pg->flags_[pgo + i] & VALID) )
+				goto miss;
+		}
+	}
+
+	for ( o = off; o < end; o += l ) {
+		pgo = o & (PAGE_SIZE - 1);
+		l   = PAGE_SIZE - pgo;
+		if ( l > end - o )
+			l = end - o;
+		pg  = getPage( o >> PAGE_SHIFT, false );
+		memcpy( dst, pg->data_ + pgo, l );
+		dst += l;
+	}
+
+	hits_++;
+	return true;
+
+miss:
+	misses_++;
+	*epoch_p = epoch_;
+	return false;
+}
+
+void
+CShadowCache::fill(uint8_t *buf, uint64_t off, unsigned nbytes, uint64_t epoch)
+{
+CMtx::lg GUARD( &mtx_ );
+uint64_t end   = off + nbytes;
+bool     store = ( epoch == epoch_ );
+uint64_t o;
+unsigned pgo, l, i;
+Page    *pg;
+
+	for ( o = off; o < end; o += l, buf += l ) {
+		pgo = o & (PAGE_SIZE - 1);
+		l   = PAGE_SIZE - pgo;
+		if ( l > end - o )
+			l = end - o;
+		if ( ! (pg = getPage( o >> PAGE_SHIFT, store )) )
+			continue;
+		for ( i = 0; i < l; i++ ) {
+			if ( (pg->flags_[pgo + i] & DIRTY) ) {
+				// the device does not have this data yet
+				buf[i] = pg->data_[pgo + i];
+			} else if ( store ) {
+				pg->data_ [pgo + i] = buf[i];
+				pg->flags_[pgo + i] = VALID;
+			}
+		}
+	}
+}
+
+void
+CShadowCache::update(const uint8_t *src, uint64_t off, unsigned nbytes, uint8_t msk1, uint8_t mskn)
+{
+CMtx::lg GUARD( &mtx_ );
+uint64_t end = off + nbytes;
+uint64_t o;
+unsigned pgo, l, i;
+uint8_t  msk;
+Page    *pg;
+
+	if ( 1 == nbytes ) {
+		msk1 |= mskn;
+		mskn  = msk1;
+	}
+
+	for ( o = off; o < end; o += l, src += l ) {
+		pgo = o & (PAGE_SIZE - 1);
+		l   = PAGE_SIZE - pgo;
+		if ( l > end - o )
+			l = end - o;
+		pg  = getPage( o >> PAGE_SHIFT, true );
+		for ( i = 0; i < l; i++ ) {
+			if      ( o + i == off     ) msk = msk1;
+			else if ( o + i == end - 1 ) msk = mskn;
+			else                         msk = 0;
+
+			if ( msk ) {
+				if ( ! (pg->flags_[pgo + i] & VALID) )
+					continue;
+				pg->data_[pgo + i] = (pg->data_[pgo + i] & msk) | (src[i] & ~msk);
+			} else {
+				pg->data_[pgo + i] = src[i];
+			}
+			// the device has the merged value (possibly including
+			// bits which are still dirty); those are written again
+			// on 'flush' which is harmless.
+			pg->flags_[pgo + i] = VALID;
+		}
+	}
+
+	epoch_++;
+}
+
+bool
+CShadowCache::writeBack(const uint8_t *src, uint64_t off, unsigned nbytes, uint8_t msk1, uint8_t mskn)
+{
+CMtx::lg GUARD( &mtx_ );
+uint64_t end = off + nbytes;
+uint64_t o;
+unsigned pgo, l, i;
+uint8_t  msk;
+Page    *pg;
+
+	if ( 1 == nbytes ) {
+		msk1 |= mskn;
+		mskn  = msk1;
+	}
+
+	// bits can only be merged into valid bytes
+	if ( msk1 ) {
+		pg = getPage( off >> PAGE_SHIFT, false );
+		if ( ! pg || ! (pg->flags_[off & (PAGE_SIZE - 1)] & VALID) )
+			return false;
+	}
+	if ( mskn ) {
+		pg = getPage( (end - 1) >> PAGE_SHIFT, false );
+		if ( ! pg || ! (pg->flags_[(end - 1) & (PAGE_SIZE - 1)] & VALID) )
+			return false;
+	}
+
+	for ( o = off; o < end; o += l, src += l ) {
+		pgo = o & (PAGE_SIZE - 1);
+		l   = PAGE_SIZE - pgo;
+		if ( l > end - o )
+			l = end - o;
+		pg  = getPage( o >> PAGE_SHIFT, true );
+		for ( i = 0; i < l; i++ ) {
+			if      ( o + i == off     ) msk = msk1;
+			else if ( o + i == end - 1 ) msk = mskn;
+			else                         msk = 0;
+
+			pg->data_ [pgo + i] = (pg->data_[pgo + i] & msk) | (src[i] & ~msk);
+			pg->flags_[pgo + i] = VALID | DIRTY;
+		}
+	}
+
+	epoch_++;
+	return true;
+}
+
+void
+CShadowCache::invalidate(uint64_t off, unsigned nbytes)
+{
+CMtx::lg GUARD( &mtx_ );
+uint64_t end = off + nbytes;
+uint64_t o;
+unsigned pgo, l;
+Page    *pg;
+
+	for ( o = off; o < end; o += l ) {
+		pgo = o & (PAGE_SIZE - 1);
+		l   = PAGE_SIZE - pgo;
+		if ( l > end - o )
+			l = end - o;
+		if ( (pg = getPage( o >> PAGE_SHIFT, false )) )
+			memset( pg->flags_ + pgo, 0, l );
+	}
+
+	epoch_++;
+}
+
+void
+CShadowCache::invalidate()
+{
+CMtx::lg GUARD( &mtx_ );
+Pages::iterator it;
+
+	for ( it = pages_.begin(); it != pages_.end(); ++it ) {
+		delete it->second;
+	}
+	pages_.clear();
+
+	epoch_++;
+}
+
+void
+CShadowCache::redirty(uint64_t off, unsigned nbytes)
+{
+CMtx::lg GUARD( &mtx_ );
+uint64_t end = off + nbytes;
+uint64_t o;
+unsigned pgo, l, i;
+Page    *pg;
+
+	for ( o = off; o < end; o += l ) {
+		pgo = o & (PAGE_SIZE - 1);
+		l   = PAGE_SIZE - pgo;
+		if ( l > end - o )
+			l = end - o;
+		if ( ! (pg = getPage( o >> PAGE_SHIFT, false )) )
+			continue;
+		for ( i = 0; i < l; i++ ) {
+			if ( (pg->flags_[pgo + i] & VALID) )
+				pg->flags_[pgo + i] |= DIRTY;
+		}
+	}
+}
+
+uint64_t
+CShadowCache::flush()
+{
+std::vector< std::pair<uint64_t, std::vector<uint8_t> > > runs;
+Pages::iterator                                           it;
+unsigned                                                  i, j;
+uint64_t                                                  rval = 0;
+
+	{
+	CMtx::lg GUARD( &mtx_ );
+
+		// collect runs of dirty bytes; runs extending across
+		// a page boundary are merged.
+		for ( it = pages_.begin(); it != pages_.end(); ++it ) {
+			Page    *pg   = it->second;
+			uint64_t base = it->first << PAGE_SHIFT;
+			for ( i = 0; i < PAGE_SIZE; i = j ) {
+				if ( ! (pg->flags_[i] & DIRTY) ) {
+					j = i + 1;
+					continue;
+				}
+				for ( j = i + 1; j < PAGE_SIZE && (pg->flags_[j] & DIRTY); j++ )
+					;
+				if ( runs.empty() || runs.back().first + runs.back().second.size() != base + i ) {
+					runs.push_back( std::pair<uint64_t, std::vector<uint8_t> >( base + i, std::vector<uint8_t>() ) );
+				}
+				runs.back().second.insert( runs.back().second.end(), pg->data_ + i, pg->data_ + j );
+				while ( i < j ) {
+					pg->flags_[i++] &= ~DIRTY;
+				}
+			}
+		}
+		// readers which are in progress must not 'fill' the
+		// old contents of the device into these bytes
+		epoch_++;
+	}
+
+	for ( i = 0; i < runs.size(); i++ ) {
+#ifdef SHADOW_CACHE_DEBUG
+		fprintf(CPSW::fDbg(), "Shadow cache: flushing %u bytes @0x%" PRIx64 "\n", (unsigned)runs[i].second.size(), runs[i].first);
+#endif
+		try {
+			rval += writer_->writeToDevice( &runs[i].second[0], runs[i].first, runs[i].second.size() );
+		} catch ( CPSWError & ) {
+			// whatever was not written is still dirty
+			for ( j = i; j < runs.size(); j++ ) {
+				redirty( runs[j].first, runs[j].second.size() );
+			}
+			throw;
+		}
+	}
+
+	return rval;
+}
+
+uint64_t
+CShadowCache::getHits() const
+{
+CMtx::lg GUARD( &mtx_ );
+	return hits_;
+}
+
+uint64_t
+CShadowCache::getMisses() const
+{
+CMtx::lg GUARD( &mtx_ );
+	return misses_;
+}
+
+uint64_t
+CShadowCache::getDirty() const
+{
+CMtx::lg GUARD( &mtx_ );
+Pages::const_iterator it;
+uint64_t              rval = 0;
+unsigned              i;
+
+	for ( it = pages_.begin(); it != pages_.end(); ++it ) {
+		for ( i = 0; i < PAGE_SIZE; i++ ) {
+			if ( (it->second->flags_[i] & DIRTY) )
+				rval++;
+		}
+	}
+	return rval;
+}
+
+void
+CShadowCache::dump(FILE *f) const
+{
+	fprintf(f,"  Shadow cache hits : %8" PRIu64 "\n", getHits());
+	fprintf(f,"  Shadow cache miss : %8" PRIu64 "\n", getMisses());
+	fprintf(f,"  Shadow dirty bytes: %8" PRIu64 "\n", getDirty());
+}
+
+CShadowCacheAsyncIO::CShadowCacheAsyncIO(ShadowCacheImpl cache, uint8_t *dst, uint64_t off, unsigned nbytes, uint64_t epoch, AsyncIO aio)
+: cache_ ( cache  ),
+  dst_   ( dst    ),
+  off_   ( off    ),
+  nbytes_( nbytes ),
+  epoch_ ( epoch  ),
+  aio_   ( aio    )
+{
+}
+
+void
+CShadowCacheAsyncIO::callback(CPSWError *err)
+{
+	if ( err ) {
+		if ( ! dst_ ) {
+			// don't know what the device holds now
+			cache_->invalidate( off_, nbytes_ );
+		}
+	} else if ( dst_ ) {
+		cache_->fill( dst_, off_, nbytes_, epoch_ );
+	}
+	// don't hold on to the user's completion (which could be
+	// a parallel completion that fires when released)
+	AsyncIO aio;
+	aio.swap( aio_ );
+	aio->callback( err );
+}
+
+class CShadowCacheAdapt : public IShadowCache {
+private:
+	Path            p_;
+	ShadowCacheImpl cache_;
+
+	CShadowCacheAdapt(const CShadowCacheAdapt&);
+	CShadowCacheAdapt & operator=(const CShadowCacheAdapt&);
+
+public:
+	CShadowCacheAdapt(ConstPath p, ShadowCacheImpl cache)
+	: p_    ( p->clone() ),
+	  cache_( cache      )
+	{
+		// keep the transport open so we can flush
+		CompositePathIterator it( p_ );
+		Address  a = it->c_p_;
+		a->open( &it );
+	}
+
+	virtual uint64_t flush()
+	{
+		return cache_->flush();
+	}
+
+	virtual void     invalidate()
+	{
+		cache_->invalidate();
+	}
+
+	virtual uint64_t getHits()   const
+	{
+		return cache_->getHits();
+	}
+
+	virtual uint64_t getMisses() const
+	{
+		return cache_->getMisses();
+	}
+
+	virtual uint64_t getDirty()  const
+	{
+		return cache_->getDirty();
+	}
+
+	virtual ~CShadowCacheAdapt()
+	{
+		CompositePathIterator it( p_ );
+		Address  a = it->c_p_;
+		a->close( &it );
+	}
+};
+
+ShadowCache
+IShadowCache::create(ConstPath p)
+{
+ConstSRPAddressImpl srp;
+ShadowCacheImpl     cache;
+
+	if ( ! (srp = CSRPAddressImpl::findTransport( p )) || ! (cache = srp->getShadowCache()) ) {
+		throw InvalidArgError("No shadow cache enabled for this path");
+	}
+
+	return cpsw::make_shared<CShadowCacheAdapt>( p, cache );
+}
@@ -0,0 +1,129 @@
+ //@C Copyright Notice
+ //@C ================
+ //@C This file is part of CPSW. It is subject to the license terms in the LICENSE.txt
+ //@C file found in the top-level directory of this distribution and at
+ //@C https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html.
+ //@C
+ //@C No part of CPSW, including this file, may be copied, modified, propagated, or
+ //@C distributed except according to the terms contained in the LICENSE.txt file.
+
+#ifndef CPSW_SHADOW_CACHE_H
+#define CPSW_SHADOW_CACHE_H
+
+#include <cpsw_api_user.h>
+#include <cpsw_mutex.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <map>
+
+class CShadowCache;
+typedef shared_ptr<CShadowCache> ShadowCacheImpl;
+
+// Sparse copy of a device's address space. Every byte is tracked
+// individually; it is 'valid' if the cache holds the device's
+// contents and 'dirty' if it was modified but not written back yet.
+//
+// The cache does not know anything about cacheability; it is up
+// to the user (i.e., the transport) to only consult it for
+// WT_CACHEABLE and WB_CACHEABLE areas.
+class CShadowCache {
+public:
+	// writes dirty data back to the device
+	class IWriter {
+	public:
+		virtual uint64_t writeToDevice(uint8_t *src, uint64_t off, unsigned nbytes) const = 0;
+		virtual ~IWriter() {}
+	};
+
+private:
+	static const unsigned PAGE_SHIFT = 12;
+	static const unsigned PAGE_SIZE  = (1 << PAGE_SHIFT);
+
+	static const uint8_t  VALID      = 1;
+	static const uint8_t  DIRTY      = 2;
+
+	struct Page {
+		uint8_t data_ [PAGE_SIZE];
+		uint8_t flags_[PAGE_SIZE];
+		Page();
+	};
+
+	typedef std::map<uint64_t, Page *> Pages;
+
+	const IWriter *writer_;
+	mutable CMtx   mtx_;
+	Pages          pages_;
+	// incremented whenever data in the cache are modified
+	uint64_t       epoch_;
+	uint64_t       hits_;
+	uint64_t       misses_;
+
+	Page *getPage(uint64_t pgno, bool alloc);
+
+	// mark bytes dirty again (if they are still valid)
+	void  redirty(uint64_t off, unsigned nbytes);
+
+	CShadowCache(const CShadowCache&);
+	CShadowCache & operator=(const CShadowCache&);
+
+public:
+	CShadowCache(const IWriter *writer);
+
+	// Copy 'nbytes' at 'off' to 'dst' if all of them are valid.
+	// Otherwise, a miss is recorded and the current 'epoch' is
+	// returned; it must be passed to 'fill()' once the data
+	// have been read from the device.
+	bool     read(uint8_t *dst, uint64_t off, unsigned nbytes, uint64_t *epoch_p);
+
+	// Store data read from the device. Dirty bytes are not
+	// overwritten but copied into 'buf'. Nothing is stored if
+	// the cache was modified since 'epoch' (data could be stale).
+	void     fill(uint8_t *buf, uint64_t off, unsigned nbytes, uint64_t epoch);
+
+	// Store data written to the device (write-through). Bits set
+	// in 'msk1'/'mskn' are not modified in the first/last byte;
+	// if the respective byte is not valid then it remains so.
+	void     update(const uint8_t *src, uint64_t off, unsigned nbytes, uint8_t msk1, uint8_t mskn);
+
+	// Store data in the cache only and mark them dirty (write-back).
+	// Returns 'false' if nothing was stored because bits would
+	// have to be merged into bytes which are not valid.
+	bool     writeBack(const uint8_t *src, uint64_t off, unsigned nbytes, uint8_t msk1, uint8_t mskn);
+
+	// Discard a range or everything (dirty data are lost!)
+	void     invalidate(uint64_t off, unsigned nbytes);
+	void     invalidate();
+
+	// Write all dirty data back to the device. Returns
+	// the number of bytes written.
+	uint64_t flush();
+
+	uint64_t getHits()   const;
+	uint64_t getMisses() const;
+	uint64_t getDirty()  const;
+
+	void     dump(FILE *f) const;
+
+	~CShadowCache();
+};
+
+// Asynchronous completion which keeps the cache consistent with
+// an asynchronous read (fill the cache) or write (invalidate if the
+// operation failed) before notifying the user.
+class CShadowCacheAsyncIO : public IAsyncIO {
+private:
+	ShadowCacheImpl cache_;
+	uint8_t        *dst_;
+	uint64_t        off_;
+	unsigned        nbytes_;
+	uint64_t        epoch_;
+	AsyncIO         aio_;
+
+public:
+	// 'dst' is NULL for a write operation
+	CShadowCacheAsyncIO(ShadowCacheImpl cache, uint8_t *dst, uint64_t off, unsigned nbytes, uint64_t epoch, AsyncIO aio);
+
+	virtual void callback(CPSWError *err);
+};
+
+#endif
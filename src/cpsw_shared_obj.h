@@ -263,6 +263,51 @@ public:
 		return postConstruct( p );
 	}
 
+	template <typename T, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6, typename A7, typename A8>
+	static T create(A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6, A7 a7, A8 a8)
+	{
+	Key k;
+	typename T::element_type *p = new typename T::element_type( k, a1, a2, a3, a4, a5, a6, a7, a8 );
+
+		return postConstruct( p );
+	}
+
+	template <typename T, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6, typename A7, typename A8, typename A9>
+	static T create(A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6, A7 a7, A8 a8, A9 a9)
+	{
+	Key k;
+	typename T::element_type *p = new typename T::element_type( k, a1, a2, a3, a4, a5, a6, a7, a8, a9 );
+
+		return postConstruct( p );
+	}
+
+	template <typename T, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6, typename A7, typename A8, typename A9, typename A10>
+	static T create(A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6, A7 a7, A8 a8, A9 a9, A10 a10)
+	{
+	Key k;
+	typename T::element_type *p = new typename T::element_type( k, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10 );
+
+		return postConstruct( p );
+	}
+
+	template <typename T, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6, typename A7, typename A8, typename A9, typename A10, typename A11>
+	static T create(A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6, A7 a7, A8 a8, A9 a9, A10 a10, A11 a11)
+	{
+	Key k;
+	typename T::element_type *p = new typename T::element_type( k, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, a11 );
+
+		return postConstruct( p );
+	}
+
+	template <typename T, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6, typename A7, typename A8, typename A9, typename A10, typename A11, typename A12>
+	static T create(A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6, A7 a7, A8 a8, A9 a9, A10 a10, A11 a11, A12 a12)
+	{
+	Key k;
+	typename T::element_type *p = new typename T::element_type( k, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, a11, a12 );
+
+		return postConstruct( p );
+	}
+
 };
 
 #endif
@@ -0,0 +1,477 @@
+ //@C Copyright Notice
+ //@C ================
+ //@C This file is part of CPSW. It is subject to the license terms in the LICENSE.txt
+ //@C file found in the top-level directory of this distribution and at
+ //@C https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html.
+ //@C
+ //@C No part of CPSW, including this file, may be copied, modified, propagated, or
+ //@C distributed except according to the terms contained in the LICENSE.txt file.
+
+#include <cpsw_api_user.h>
+#include <cpsw_address.h>
+#include <cpsw_mmio_dev.h>
+#include <cpsw_sval.h>
+#include <cpsw_mutex.h>
+#include <cpsw_error.h>
+#include <string.h>
+#include <vector>
+#include <map>
+#include <algorithm>
+
+#define __STDC_FORMAT_MACROS
+#include <inttypes.h>
+
+//#define SNAPSHOT_DEBUG
+
+using cpsw::dynamic_pointer_cast;
+
+// Reading a snapshot works in three steps:
+//
+//  1) when the snapshot is created every leaf underneath the path
+//     is 'read' with a hook which records the transport, offset,
+//     size and cacheability of every elementary read operation
+//     but doesn't do any I/O.
+//  2) The recorded ranges are sorted and merged (per transport)
+//     and read from the device by 'update()'. A gap between two
+//     ranges is only bridged if it lies inside the device which
+//     contains them and if it is not overlapped by any leaf (in
+//     the explored subtree, including leaves which cannot be read
+//     into the snapshot) with read side-effects (a 'barrier').
+//  3) 'getVal()' again reads through a hook which copies data
+//     from the image.
+class CSnapshotImpl : public ISnapshot {
+private:
+	struct Range {
+		uint64_t          off_;
+		uint64_t          nbytes_;
+		IField::Cacheable cacheable_;
+		uint64_t          img_;     // offset into the image
+		// extent of the device containing the range (or
+		// the last range merged into it); empty if unknown
+		uint64_t          devLo_;
+		uint64_t          devHi_;
+
+		Range(uint64_t off, uint64_t nbytes, IField::Cacheable cacheable)
+		: off_      ( off       ),
+		  nbytes_   ( nbytes    ),
+		  cacheable_( cacheable ),
+		  img_      ( 0         ),
+		  devLo_    ( 1         ),
+		  devHi_    ( 0         )
+		{
+		}
+
+		bool devContains(uint64_t lo, uint64_t hi) const
+		{
+			return devLo_ <= lo && hi <= devHi_;
+		}
+
+		bool operator<(const Range &o) const
+		{
+			return off_ < o.off_;
+		}
+	};
+
+	// CReadArgs::nbytes_ is 'unsigned'; larger ranges are read in
+	// pieces of this size (which preserves the alignment).
+	static const uint64_t MAX_READ = (uint64_t)1 << 31;
+
+	typedef std::vector<Range>                         Ranges;
+	typedef std::map<const CAddressImpl *, Ranges>     XprtRanges;
+
+	class CRecorder : public IReadHook {
+	private:
+		XprtRanges *ranges_;
+		Range       dev_;
+	public:
+		CRecorder(XprtRanges *ranges)
+		: ranges_( ranges ),
+		  dev_   ( 0, 0, IField::UNKNOWN_CACHEABLE )
+		{
+		}
+
+		// device extent of the leaf being recorded
+		void setDev(const Range &dev)
+		{
+			dev_ = dev;
+		}
+
+		virtual uint64_t read(const CAddressImpl *xprt, CReadArgs *args)
+		{
+		Range r( args->off_, args->nbytes_, args->cacheable_ );
+			r.devLo_ = dev_.devLo_;
+			r.devHi_ = dev_.devHi_;
+			(*ranges_)[xprt].push_back( r );
+			if ( args->dst_ )
+				memset( args->dst_, 0, args->nbytes_ );
+			return args->nbytes_;
+		}
+	};
+
+	class CPlayer : public IReadHook {
+	private:
+		const CSnapshotImpl *snap_;
+	public:
+		CPlayer(const CSnapshotImpl *snap)
+		: snap_( snap )
+		{
+		}
+
+		virtual uint64_t read(const CAddressImpl *xprt, CReadArgs *args)
+		{
+			return snap_->copyOut( xprt, args );
+		}
+	};
+
+	std::vector<ScalVal_RO> vals_;
+	XprtRanges              ranges_;
+	std::vector<uint8_t>    img_;
+	unsigned                numReads_;
+	uint64_t                numBytes_;
+	mutable CMtx            mtx_;
+
+	CSnapshotImpl(const CSnapshotImpl&);
+	CSnapshotImpl & operator=(const CSnapshotImpl&);
+
+	bool     collect(ConstPath p, XprtRanges *barriers);
+	void     merge(unsigned gapTolerance, XprtRanges *barriers);
+
+	static const CAddressImpl *locate(ConstPath p, Range *r);
+	static bool                blocked(const Ranges &barriers, uint64_t lo, uint64_t hi);
+
+	uint64_t copyOut(const CAddressImpl *xprt, CReadArgs *args) const;
+
+	static ScalVal_ROAdapt getAdapt(ScalVal_RO val);
+
+public:
+	CSnapshotImpl(ConstPath p, unsigned gapTolerance);
+
+	virtual void       update();
+
+	virtual unsigned   getNumScalVals() const
+	{
+		return vals_.size();
+	}
+
+	virtual ScalVal_RO getScalVal(unsigned idx) const
+	{
+		if ( idx >= vals_.size() )
+			throw InvalidArgError("Snapshot: ScalVal index out of range");
+		return vals_[idx];
+	}
+
+	virtual unsigned   getVal(ScalVal_RO val, uint64_t *p, unsigned nelms, IndexRange *range);
+	virtual unsigned   getVal(ScalVal_RO val, CString  *p, unsigned nelms, IndexRange *range);
+
+	virtual unsigned   getNumReads() const
+	{
+		return numReads_;
+	}
+
+	virtual uint64_t   getNumBytes() const
+	{
+		return numBytes_;
+	}
+};
+
+CSnapshotImpl::CSnapshotImpl(ConstPath p, unsigned gapTolerance)
+: numReads_( 0          ),
+  numBytes_( 0          ),
+  mtx_     ( "SNAPSHOT" )
+{
+XprtRanges barriers;
+
+	// don't bridge gaps if a barrier cannot be located
+	if ( ! collect( p, &barriers ) )
+		gapTolerance = 0;
+	merge( gapTolerance, &barriers );
+}
+
+// Find the transport of the leaf at the tail of 'p' and compute the
+// range it covers (all elements) as seen by the transport as well as
+// the extent of the device containing the leaf. Returns NULL if 'p'
+// does not reach the transport (the device extent is left empty).
+const CAddressImpl *
+CSnapshotImpl::locate(ConstPath p, Range *r)
+{
+Path                               q = p->clone();
+shared_ptr<const CAddressImpl>     a = dynamic_pointer_cast<const CAddressImpl>( q->tail() );
+shared_ptr<const CMMIOAddressImpl> m;
+uint64_t                           lo, hi;
+bool                               inDev = false;
+
+	if ( ! a )
+		return NULL;
+
+	lo            = 0;
+	hi            = a->getEntryImpl()->getSize();
+	r->cacheable_ = a->getEntryImpl()->getCacheable();
+
+	while ( (m = dynamic_pointer_cast<const CMMIOAddressImpl>( a )) ) {
+		lo += m->getOffset() + q->getTailFrom() * m->getStride();
+		hi += m->getOffset() + q->getTailTo()   * m->getStride();
+		if ( inDev ) {
+			r->devLo_ += m->getOffset() + q->getTailFrom() * m->getStride();
+			r->devHi_ += m->getOffset() + q->getTailTo()   * m->getStride();
+		} else {
+			r->devLo_  = 0;
+			r->devHi_  = m->getOwnerAsDevImpl()->getSize();
+			inDev      = true;
+		}
+		q->up();
+		if ( q->empty() || ! (a = dynamic_pointer_cast<const CAddressImpl>( q->tail() )) ) {
+			r->devLo_ = 1;
+			r->devHi_ = 0;
+			return NULL;
+		}
+	}
+
+	r->off_    = lo;
+	r->nbytes_ = hi - lo;
+	if ( ! inDev ) {
+		// attached to the transport directly
+		r->devLo_ = lo;
+		r->devHi_ = hi;
+	}
+	return a.get();
+}
+
+// whether any barrier overlaps [lo, hi)
+bool
+CSnapshotImpl::blocked(const Ranges &barriers, uint64_t lo, uint64_t hi)
+{
+Ranges::const_iterator it;
+
+	// barriers are sorted and disjoint; only the last one starting
+	// before 'hi' may overlap
+	it = std::lower_bound( barriers.begin(), barriers.end(), Range( hi, 0, IField::UNKNOWN_CACHEABLE ) );
+	if ( it == barriers.begin() )
+		return false;
+	--it;
+	return it->off_ + it->nbytes_ > lo;
+}
+
+// Returns false if a barrier could not be located.
+bool
+CSnapshotImpl::collect(ConstPath p, XprtRanges *barriers)
+{
+class CVisitor : public IPathVisitor {
+private:
+	std::vector<ScalVal_RO> *vals_;
+	std::vector<Range>      *devs_;
+	XprtRanges              *barriers_;
+public:
+	bool                     located_;
+
+	CVisitor(std::vector<ScalVal_RO> *vals, std::vector<Range> *devs, XprtRanges *barriers)
+	: vals_    ( vals     ),
+	  devs_    ( devs     ),
+	  barriers_( barriers ),
+	  located_ ( true     )
+	{
+	}
+
+	virtual bool visitPre(ConstPath here)
+	{
+		if ( ! here->empty() && ! here->tail()->isHub() ) {
+			Range               r( 0, 0, IField::UNKNOWN_CACHEABLE );
+			const CAddressImpl *xprt = locate( here, &r );
+
+			// only leaves which may not be read speculatively
+			// prevent bridging a gap
+			if ( r.cacheable_ < IField::WT_CACHEABLE ) {
+				if ( xprt )
+					(*barriers_)[xprt].push_back( r );
+				else
+					located_ = false;
+			}
+			try {
+				vals_->push_back( IScalVal_RO::create( here ) );
+				devs_->push_back( r );
+			} catch ( InterfaceNotImplementedError & ) {
+				// not readable as an integer; skip
+			}
+		}
+		return true;
+	}
+
+	virtual void visitPost(ConstPath here)
+	{
+	}
+};
+
+std::vector<Range>                devs;
+CVisitor                          visitor( &vals_, &devs, barriers );
+CRecorder                         recorder( &ranges_ );
+unsigned                          i;
+
+	p->explore( &visitor );
+
+	for ( i = 0; i < vals_.size(); i++ ) {
+		unsigned              nelms = vals_[i]->getNelms();
+		// the transfer size does not depend on the
+		// destination type (wide fields are truncated)
+		std::vector<uint64_t> buf( nelms );
+		recorder.setDev( devs[i] );
+		getAdapt( vals_[i] )->getVal( &recorder, &buf[0], nelms );
+	}
+
+	return visitor.located_;
+}
+
+void
+CSnapshotImpl::merge(unsigned gapTolerance, XprtRanges *barriers)
+{
+XprtRanges::iterator xit;
+Ranges::iterator     rit;
+uint64_t             imgsz = 0;
+
+	// sort the barriers and coalesce overlapping ones
+	for ( xit = barriers->begin(); xit != barriers->end(); ++xit ) {
+		Ranges &b = xit->second;
+		Ranges  merged;
+
+		std::sort( b.begin(), b.end() );
+
+		for ( rit = b.begin(); rit != b.end(); ++rit ) {
+			if ( ! merged.empty() && rit->off_ <= merged.back().off_ + merged.back().nbytes_ ) {
+				Range &l = merged.back();
+				if ( rit->off_ + rit->nbytes_ > l.off_ + l.nbytes_ )
+					l.nbytes_ = rit->off_ + rit->nbytes_ - l.off_;
+				continue;
+			}
+			merged.push_back( *rit );
+		}
+
+		b.swap( merged );
+	}
+
+	for ( xit = ranges_.begin(); xit != ranges_.end(); ++xit ) {
+		Ranges &r = xit->second;
+		Ranges &b = (*barriers)[ xit->first ];
+		Ranges  merged;
+
+		std::sort( r.begin(), r.end() );
+
+		for ( rit = r.begin(); rit != r.end(); ++rit ) {
+			if ( ! merged.empty() ) {
+				Range    &l   = merged.back();
+				uint64_t  end = l.off_ + l.nbytes_;
+				// overlapping/adjacent ranges are always merged (no extra
+				// bytes are read); bridging a gap requires both sides to
+				// be free of read side-effects and the gap to lie inside
+				// their devices without overlapping any barrier.
+				if (    rit->off_ <= end
+				     || (    rit->off_ - end <= gapTolerance
+				          && l.cacheable_    >= IField::WT_CACHEABLE
+				          && rit->cacheable_ >= IField::WT_CACHEABLE
+				          && l.devContains( end, rit->off_ )
+				          && rit->devContains( end, rit->off_ )
+				          && ! blocked( b, end, rit->off_ ) ) ) {
+					if ( rit->off_ + rit->nbytes_ > end ) {
+						l.nbytes_ = rit->off_ + rit->nbytes_ - l.off_;
+						l.devLo_  = rit->devLo_;
+						l.devHi_  = rit->devHi_;
+					}
+					if ( rit->cacheable_ < l.cacheable_ )
+						l.cacheable_ = rit->cacheable_;
+					continue;
+				}
+			}
+			merged.push_back( *rit );
+		}
+
+		for ( rit = merged.begin(); rit != merged.end(); ++rit ) {
+			rit->img_  = imgsz;
+			imgsz     += rit->nbytes_;
+			numReads_ += (rit->nbytes_ + MAX_READ - 1) / MAX_READ;
+#ifdef SNAPSHOT_DEBUG
+			fprintf(CPSW::fDbg(), "Snapshot range: %s @0x%" PRIx64 ", %" PRIu64 " bytes\n", xit->first->getName(), rit->off_, rit->nbytes_);
+#endif
+		}
+
+		r.swap( merged );
+	}
+
+	numBytes_ = imgsz;
+	img_.resize( imgsz );
+}
+
+void
+CSnapshotImpl::update()
+{
+XprtRanges::const_iterator xit;
+Ranges::const_iterator     rit;
+CMtx::lg                   guard( &mtx_ );
+
+	for ( xit = ranges_.begin(); xit != ranges_.end(); ++xit ) {
+		for ( rit = xit->second.begin(); rit != xit->second.end(); ++rit ) {
+			uint64_t done, n;
+			for ( done = 0; done < rit->nbytes_; done += n ) {
+				CReadArgs args;
+				if ( (n = rit->nbytes_ - done) > MAX_READ )
+					n = MAX_READ;
+				args.cacheable_ = rit->cacheable_;
+				args.dst_       = &img_[ rit->img_ + done ];
+				args.off_       = rit->off_ + done;
+				args.nbytes_    = (unsigned)n;
+				// large transfers are chunked and pipelined by the transport
+				xit->first->read( &args );
+			}
+		}
+	}
+}
+
+uint64_t
+CSnapshotImpl::copyOut(const CAddressImpl *xprt, CReadArgs *args) const
+{
+XprtRanges::const_iterator xit = ranges_.find( xprt );
+Ranges::const_iterator     rit;
+
+	if ( xit != ranges_.end() ) {
+		// first range starting after 'off'
+		rit = std::upper_bound( xit->second.begin(), xit->second.end(), Range( args->off_, 0, IField::UNKNOWN_CACHEABLE ) );
+		if ( rit != xit->second.begin() ) {
+			--rit;
+			if ( args->off_ + args->nbytes_ <= rit->off_ + rit->nbytes_ ) {
+				if ( args->dst_ )
+					memcpy( args->dst_, &img_[ rit->img_ + (args->off_ - rit->off_) ], args->nbytes_ );
+				return args->nbytes_;
+			}
+		}
+	}
+	throw InvalidArgError("Snapshot: ScalVal not covered by this snapshot");
+}
+
+ScalVal_ROAdapt
+CSnapshotImpl::getAdapt(ScalVal_RO val)
+{
+ScalVal_ROAdapt adapt = dynamic_pointer_cast<ScalVal_ROAdapt::element_type>( val );
+	if ( ! adapt )
+		throw InvalidArgError("Snapshot: unsupported ScalVal implementation");
+	return adapt;
+}
+
+unsigned
+CSnapshotImpl::getVal(ScalVal_RO val, uint64_t *p, unsigned nelms, IndexRange *range)
+{
+CPlayer  player( this );
+CMtx::lg guard( &mtx_ );
+	return getAdapt( val )->getVal( &player, p, nelms, range );
+}
+
+unsigned
+CSnapshotImpl::getVal(ScalVal_RO val, CString *p, unsigned nelms, IndexRange *range)
+{
+CPlayer  player( this );
+CMtx::lg guard( &mtx_ );
+	return getAdapt( val )->getVal( &player, p, nelms, range );
+}
+
+Snapshot
+ISnapshot::create(ConstPath p, unsigned gapTolerance)
+{
+	if ( p->empty() )
+		throw InvalidPathError("<EMPTY>");
+	return cpsw::make_shared<CSnapshotImpl>( p, gapTolerance );
+}
@@ -20,6 +20,7 @@
 #include <cpsw_stdio.h>
 
 #include <cpsw_yaml.h>
+#include <cpsw_path.h>
 
 using cpsw::dynamic_pointer_cast;
 
@@ -40,6 +41,10 @@ using cpsw::dynamic_pointer_cast;
 
 #define SRPWRDALGNMSK ((sizeof(SRPWord) - 1))
 
+// Unmatched replies to any of the last LATE_REPLY_HORIZON
+// transactions are counted as 'late'; other ones as 'TID mismatch'.
+#define LATE_REPLY_HORIZON 65536
+
 static bool hasRssi(ProtoPort stack)
 {
 ProtoPortMatchParams cmp;
@@ -54,6 +59,24 @@ ProtoPortMatchParams cmp;
 	return cmp.requestedMatches() == cmp.findMatches( stack );
 }
 
+// Hedged reads:
+// number of round-trip time samples required before reads are hedged
+#define HEDGE_MIN_SAMPLES 100
+// number of samples after which the hedge delay (p99) is re-evaluated
+#define HEDGE_REFRESH     128
+// max. number of hedges the budget may accumulate (in units of reads)
+#define HEDGE_BURST        10
+// max. exponent of the retry backoff
+#define BACKOFF_MAX_LD      4
+
+// number of TID bits used by the SRP mux at the top of 'stack'
+static unsigned tidNumBits(ProtoPort stack)
+{
+ProtoModSRPMux srpMuxMod( dynamic_pointer_cast<ProtoModSRPMux::element_type>( stack->getProtoMod() ) );
+	// missing mux is reported by the constructor
+	return srpMuxMod ? srpMuxMod->getTidNumBits() : 32;
+}
+
 CSRPAsyncHandler::CSRPAsyncHandler(AsyncIOTransactionManager xactMgr, CSRPAddressImpl *srp)
 : CRunnable("SRP Async Handler"),
   xactMgr_ ( xactMgr           ),
@@ -86,20 +109,250 @@ CSRPAsyncHandler::threadBody()
 
 		uint32_t tid_bits = srp_->extractTid( rchn );
 
-		xactMgr_->complete( rchn, tid_bits );
+		if ( xactMgr_->complete( rchn, tid_bits ) ) {
+			srp_->unmatchedReply( tid_bits );
+		}
 	}
 	return 0;
 }
 
 
+CSRPWindow::CSRPWindow(unsigned size)
+: slots_  ( size ? size : 1 ),
+  nBusy_  ( 0               ),
+  reading_( false           )
+{
+}
+
+CSRPWindow::Slot
+CSRPWindow::acquire()
+{
+CMtx::lg guard( &mtx_ );
+int      err;
+unsigned i;
+
+	while ( nBusy_ >= slots_.size() ) {
+		if ( (err = pthread_cond_wait( cond_.getp(), mtx_.getp() )) ) {
+			throw InternalError("CSRPWindow: pthread_cond_wait failed", err);
+		}
+	}
+
+	for ( i = 0; slots_[i].busy_; i++ )
+		/* nothing else to do */;
+
+	slots_[i].busy_ = true;
+	nBusy_++;
+
+	return &slots_[i];
+}
+
+CSRPWindow::Slot
+CSRPWindow::tryAcquire()
+{
+CMtx::lg guard( &mtx_ );
+unsigned i;
+
+	if ( nBusy_ >= slots_.size() ) {
+		return 0;
+	}
+
+	for ( i = 0; slots_[i].busy_; i++ )
+		/* nothing else to do */;
+
+	slots_[i].busy_ = true;
+	nBusy_++;
+
+	return &slots_[i];
+}
+
+void
+CSRPWindow::release(Slot slot)
+{
+CMtx::lg guard( &mtx_ );
+int      err;
+
+	slot->busy_ = false;
+	slot->reply_.reset();
+	nBusy_--;
+
+	if ( (err = pthread_cond_broadcast( cond_.getp() )) ) {
+		throw InternalError("CSRPWindow: pthread_cond_broadcast failed", err);
+	}
+}
+
+CSRPWindow::SlotSet::SlotSet(CSRPWindow *win, unsigned max)
+: win_( win )
+{
+Slot slot;
+
+	slots_.push_back( win->acquire() );
+	while ( slots_.size() < max && (slot = win->tryAcquire()) ) {
+		slots_.push_back( slot );
+	}
+}
+
+CSRPWindow::SlotSet::~SlotSet()
+{
+unsigned i;
+	for ( i = 0; i < slots_.size(); i++ ) {
+		win_->release( slots_[i] );
+	}
+}
+
+CSRPWriteGate::CSRPWriteGate()
+: mtx_        ( "SRPWGATE" ),
+  nWriters_   ( 0          ),
+  nRMWWaiting_( 0          ),
+  rmw_        ( false      )
+{
+}
+
+void
+CSRPWriteGate::enter(bool rmw)
+{
+CMtx::lg guard( &mtx_ );
+int      err;
+
+	if ( rmw ) {
+		nRMWWaiting_++;
+		while ( rmw_ || nWriters_ > 0 ) {
+			if ( (err = pthread_cond_wait( cond_.getp(), mtx_.getp() )) ) {
+				nRMWWaiting_--;
+				throw InternalError("CSRPWriteGate: pthread_cond_wait failed", err);
+			}
+		}
+		nRMWWaiting_--;
+		rmw_ = true;
+	} else {
+		// don't let a stream of writes starve an RMW
+		while ( rmw_ || nRMWWaiting_ > 0 ) {
+			if ( (err = pthread_cond_wait( cond_.getp(), mtx_.getp() )) ) {
+				throw InternalError("CSRPWriteGate: pthread_cond_wait failed", err);
+			}
+		}
+		nWriters_++;
+	}
+}
+
+void
+CSRPWriteGate::leave(bool rmw)
+{
+CMtx::lg guard( &mtx_ );
+int      err;
+
+	if ( rmw ) {
+		rmw_ = false;
+	} else {
+		nWriters_--;
+	}
+	if ( (err = pthread_cond_broadcast( cond_.getp() )) ) {
+		throw InternalError("CSRPWriteGate: pthread_cond_broadcast failed", err);
+	}
+}
+
+void
+CSRPWindow::arm(Slot slot, uint32_t tid)
+{
+CMtx::lg guard( &mtx_ );
+
+	slot->tid_    = tid;
+	slot->hedged_ = false;
+	slot->reply_.reset();
+}
+
+void
+CSRPWindow::hedge(Slot slot, uint32_t tid)
+{
+CMtx::lg guard( &mtx_ );
+
+	slot->hedgeTid_ = tid;
+	slot->hedged_   = true;
+}
+
+void
+CSRPWindow::dispatch_unl(const CSRPAddressImpl *srp, BufChain rchn)
+{
+uint32_t tidBits = srp->extractTid( rchn );
+unsigned i;
+
+	for ( i = 0; i < slots_.size(); i++ ) {
+		if ( ! slots_[i].busy_ || slots_[i].reply_ )
+			continue;
+		if (    srp->tidMatch( tidBits, slots_[i].tid_ )
+		     || ( slots_[i].hedged_ && srp->tidMatch( tidBits, slots_[i].hedgeTid_ ) ) ) {
+			slots_[i].reply_ = rchn;
+			return;
+		}
+	}
+	// late reply to a retried transaction or to somebody who gave up
+	srp->unmatchedReply( tidBits );
+}
+
+BufChain
+CSRPWindow::wait(const CSRPAddressImpl *srp, ProtoDoor door, Slot slot, const CTimeout *abs_timeout)
+{
+CMtx::lg guard( &mtx_ );
+BufChain rchn;
+int      err;
+
+	while ( ! slot->reply_ ) {
+		if ( ! reading_ ) {
+			// nobody is reading from the door; take over
+			reading_ = true;
+			mtx_.u();
+			try {
+				if ( ! (rchn = srp->busyPoll( door, abs_timeout )) ) {
+					rchn = door->pop( abs_timeout, IProtoPort::ABS_TIMEOUT );
+				}
+			} catch ( ... ) {
+				mtx_.l();
+				reading_ = false;
+				pthread_cond_broadcast( cond_.getp() );
+				throw;
+			}
+			mtx_.l();
+			reading_ = false;
+			// wake up the recipient and let somebody else read
+			if ( (err = pthread_cond_broadcast( cond_.getp() )) ) {
+				throw InternalError("CSRPWindow: pthread_cond_broadcast failed", err);
+			}
+			if ( ! rchn ) {
+				// timed out
+				break;
+			}
+			dispatch_unl( srp, rchn );
+			rchn.reset();
+		} else {
+			err = pthread_cond_timedwait( cond_.getp(), mtx_.getp(), &abs_timeout->tv_ );
+			if ( ETIMEDOUT == err ) {
+				break;
+			}
+			if ( err ) {
+				throw InternalError("CSRPWindow: pthread_cond_timedwait failed", err);
+			}
+		}
+	}
+
+	rchn.swap( slot->reply_ );
+
+	return rchn;
+}
+
 CSRPAddressImpl::CSRPAddressImpl(AKey key, ProtoStackBuilder bldr, ProtoPort stack)
 : CCommAddressImpl( key, stack                                                                     ),
   protoVersion_   ( bldr->getSRPVersion()                                                          ),
   usrTimeout_     ( bldr->getSRPTimeoutUS()                                                        ),
   dynTimeout_     ( usrTimeout_                                                                    ),
   useDynTimeout_  ( bldr->hasSRPDynTimeout()                                                       ),
+  dynTimeoutMtx_  ( "SRPDYNTO"                                                                     ),
   retryCnt_       ( bldr->getSRPRetryCount() & 0xffff /* undocumented hack to test byte-resolution access */ ),
-  nRetries_       ( 0                                                                              ),
+  maxOutstanding_ ( bldr->getSRPMaxOutstanding()                                                   ),
+  pipelineDepth_  ( bldr->getSRPPipelineDepth()                                                    ),
+  hedgeBudget_    ( bldr->getSRPHedgeBudget()                                                      ),
+  hedgeCredit_    ( 0                                                                              ),
+  hedgeDelay_     ( 0                                                                              ),
+  hedgeDelayAt_   ( 0                                                                              ),
+  busyPollUS_     ( bldr->getSRPBusyPollUS()                                                       ),
   nWrites_        ( 0                                                                              ),
   nReads_         ( 0                                                                              ),
   vc_             ( bldr->getSRPMuxVirtualChannel()                                                ),
@@ -112,8 +365,9 @@ CSRPAddressImpl::CSRPAddressImpl(AKey key, ProtoStackBuilder bldr, ProtoPort sta
   maxWordsTx_     ( 0                                                                              ),
   defaultWriteMode_( bldr->getSRPDefaultWriteMode()
                    ),
-  asyncXactMgr_   ( IAsyncIOTransactionManager::create( usrTimeout_.getUs() )                      ),
+  asyncXactMgr_   ( IAsyncIOTransactionManager::create( usrTimeout_.getUs(), tidNumBits( stack ) ) ),
   asyncIOHandler_ ( asyncXactMgr_, this                                                            ),
+  window_         ( maxOutstanding_ * pipelineDepth_                                               ),
   mutex_          ( CMtx::AttrRecursive(), "SRPADDR"                                               )
 {
 ProtoModSRPMux       srpMuxMod( dynamic_pointer_cast<ProtoModSRPMux::element_type>( stack->getProtoMod() ) );
@@ -138,6 +392,10 @@ int                  nbits;
 	tidMsk_ = (nbits > 31 ? 0xffffffff : ( (1<<nbits) - 1 ) ) << srpMuxMod->getTidLsb();
 
 	asyncIOPort_ = srpMuxMod->createPort( vc_ | 0x80, bldr->getSRPMuxOutQueueDepth() );
+
+	if ( bldr->hasSRPShadowCache() ) {
+		shadow_ = cpsw::make_shared<CShadowCache>( this );
+	}
 }
 
 void
@@ -189,6 +447,11 @@ CSRPAddressImpl::dumpYamlPart(YAML::Node &node) const
 	writeNode(srpParms, YAML_KEY_timeoutUS       , usrTimeout_.getUs());
 	writeNode(srpParms, YAML_KEY_dynTimeout      , useDynTimeout_     );
 	writeNode(srpParms, YAML_KEY_retryCount      , retryCnt_          );
+	writeNode(srpParms, YAML_KEY_maxOutstanding  , maxOutstanding_    );
+	writeNode(srpParms, YAML_KEY_pipelineDepth   , pipelineDepth_     );
+	writeNode(srpParms, YAML_KEY_shadowCache     , !!shadow_          );
+	writeNode(srpParms, YAML_KEY_hedgeBudget     , hedgeBudget_       );
+	writeNode(srpParms, YAML_KEY_busyPollUS      , busyPollUS_.getUs());
 	writeNode(srpParms, YAML_KEY_defaultWriteMode, defaultWriteMode_  );
 	writeNode(node, YAML_KEY_SRP, srpParms);
 }
@@ -261,7 +524,289 @@ struct timespec now;
 
 #define PROTO_VERS_3     3
 
-static CFreeList<CSRPAsyncReadTransaction, CAsyncIOTransaction> srpReadTransactionPool;
+static CFreeList<CSRPAsyncReadTransaction, CAsyncIOTransaction>  srpReadTransactionPool;
+static CFreeList<CSRPAsyncWriteTransaction, CAsyncIOTransaction> srpWriteTransactionPool;
+
+// A large block transfer which is broken up into chunks;
+// up to 'depth' chunks are in flight (each one held by
+// an 'entry').
+class CSRPPipelinedOp {
+private:
+	uint8_t  *buf_;
+	uint64_t  off_;
+	unsigned  nbytes_;
+	unsigned  first_;
+	unsigned  chunk_;
+
+public:
+	// 'chunkBytes' must be word-aligned; the first chunk is shortened
+	// by 'headbytes' so that all subsequent ones are aligned.
+	CSRPPipelinedOp(uint8_t *buf, uint64_t off, unsigned nbytes, unsigned headbytes, unsigned chunkBytes)
+	: buf_   ( buf                     ),
+	  off_   ( off                     ),
+	  nbytes_( nbytes                  ),
+	  first_ ( chunkBytes - headbytes  ),
+	  chunk_ ( chunkBytes              )
+	{
+	}
+
+	unsigned getNBytes() const
+	{
+		return nbytes_;
+	}
+
+	unsigned getNChunks() const
+	{
+		return nbytes_ <= first_ ? 1 : 1 + (nbytes_ - first_ + chunk_ - 1)/chunk_;
+	}
+
+	unsigned getChunkPos(unsigned chunk) const
+	{
+		return chunk ? first_ + (chunk - 1)*chunk_ : 0;
+	}
+
+	unsigned getChunkLen(unsigned chunk) const
+	{
+	unsigned pos = getChunkPos( chunk );
+	unsigned len = chunk ? chunk_ : first_;
+		return pos + len > nbytes_ ? nbytes_ - pos : len;
+	}
+
+	uint8_t *getChunkBuf(unsigned chunk) const
+	{
+		return buf_ + getChunkPos( chunk );
+	}
+
+	uint64_t getChunkOff(unsigned chunk) const
+	{
+		return off_ + getChunkPos( chunk );
+	}
+
+	// set up 'entry' for transferring 'chunk'; returns the TID
+	virtual uint32_t start(unsigned entry, unsigned chunk) = 0;
+	// (re-)send the request held by 'entry'
+	virtual void     post(unsigned entry)                  = 0;
+	virtual void     complete(unsigned entry, BufChain)    = 0;
+
+	virtual ~CSRPPipelinedOp()
+	{
+	}
+};
+
+class CSRPPipelinedRead : public CSRPPipelinedOp {
+private:
+	const CSRPAddressImpl              *srp_;
+	ProtoDoor                           door_;
+	unsigned                            mtu_;
+	std::vector<CSRPReadTransaction*>   xacts_;
+
+public:
+	CSRPPipelinedRead(const CSRPAddressImpl *srp, ProtoDoor door, unsigned mtu, unsigned depth, uint8_t *dst, uint64_t off, unsigned sbytes, unsigned headbytes, unsigned chunkBytes)
+	: CSRPPipelinedOp( dst, off, sbytes, headbytes, chunkBytes ),
+	  srp_           ( srp                                     ),
+	  door_          ( door                                    ),
+	  mtu_           ( mtu                                     ),
+	  xacts_         ( depth, 0                                )
+	{
+	}
+
+	virtual uint32_t start(unsigned entry, unsigned chunk)
+	{
+		if ( ! xacts_[entry] ) {
+			xacts_[entry] = new CSRPReadTransaction( srp_, getChunkBuf( chunk ), getChunkOff( chunk ), getChunkLen( chunk ) );
+		} else {
+			xacts_[entry]->reset( srp_, getChunkBuf( chunk ), getChunkOff( chunk ), getChunkLen( chunk ) );
+		}
+		return xacts_[entry]->getTid();
+	}
+
+	virtual void post(unsigned entry)
+	{
+		xacts_[entry]->post( door_, mtu_ );
+	}
+
+	virtual void complete(unsigned entry, BufChain rchn)
+	{
+		xacts_[entry]->complete( rchn );
+	}
+
+	virtual ~CSRPPipelinedRead()
+	{
+	unsigned i;
+		for ( i = 0; i < xacts_.size(); i++ ) {
+			delete xacts_[i];
+		}
+	}
+};
+
+// Only plain writes (word-aligned or byte-resolution; no
+// read-modify-write) are pipelined.
+class CSRPPipelinedWrite : public CSRPPipelinedOp {
+private:
+	struct CEntry {
+		SRPWord               xbuf_[5];
+		IOVec                 iov_[3];
+		unsigned              iovlen_;
+		int                   iov_pld_;
+		int                   toput_;
+		CSRPWriteTransaction *xact_;
+	};
+
+	const CSRPAddressImpl  *srp_;
+	std::vector<CEntry>     entries_;
+	SRPWord                 zero_;
+	SRPWord                 pad_;
+
+public:
+	CSRPPipelinedWrite(const CSRPAddressImpl *srp, unsigned depth, uint8_t *src, uint64_t off, unsigned dbytes, unsigned chunkBytes)
+	: CSRPPipelinedOp( src, off, dbytes, 0, chunkBytes ),
+	  srp_           ( srp                             ),
+	  entries_       ( depth                           ),
+	  zero_          ( 0                               ),
+	  pad_           ( 0                               )
+	{
+	unsigned i;
+		for ( i = 0; i < entries_.size(); i++ ) {
+			entries_[i].xact_ = 0;
+		}
+	}
+
+	virtual uint32_t start(unsigned entry, unsigned chunk)
+	{
+	CEntry   &e      = entries_[entry];
+	unsigned  len    = getChunkLen( chunk );
+	unsigned  nWords = (len + sizeof(SRPWord) - 1)/sizeof(SRPWord);
+	unsigned  i      = 0;
+
+		if ( ! e.xact_ ) {
+			e.xact_ = new CSRPWriteTransaction( srp_, nWords, srp_->getWriteReplyHdrWords() );
+		} else {
+			e.xact_->reset( srp_, nWords, srp_->getWriteReplyHdrWords() );
+		}
+
+		e.iov_[i].iov_base = e.xbuf_;
+		e.iov_[i].iov_len  = sizeof(SRPWord) * srp_->buildWriteHdr( e.xbuf_, e.xact_->getTid(), getChunkOff( chunk ), len, nWords, false );
+		i++;
+
+		e.iov_[i].iov_base = getChunkBuf( chunk );
+		e.iov_[i].iov_len  = len;
+		// V1 payload is swapped when copied to the transmit buffer
+		e.iov_pld_         = srp_->needsPayloadSwap() ? i : -1;
+		e.toput_           = len;
+		i++;
+
+		if ( srp_->getProtoVersion() < IProtoStackBuilder::SRP_UDP_V3 ) {
+			e.iov_[i].iov_base = &zero_;
+			e.iov_[i].iov_len  = sizeof(SRPWord);
+			i++;
+		} else if ( len & SRPWRDALGNMSK ) {
+			e.iov_[i].iov_base = &pad_;
+			e.iov_[i].iov_len  = sizeof(SRPWord) - (len & SRPWRDALGNMSK);
+			i++;
+		}
+
+		e.iovlen_ = i;
+
+		return e.xact_->getTid();
+	}
+
+	virtual void post(unsigned entry)
+	{
+	CEntry &e = entries_[entry];
+		srp_->door_->push( srp_->assembleXBuf( e.iov_, e.iovlen_, e.iov_pld_, e.toput_ ), 0, IProtoPort::REL_TIMEOUT );
+	}
+
+	virtual void complete(unsigned entry, BufChain rchn)
+	{
+		entries_[entry].xact_->complete( rchn );
+	}
+
+	virtual ~CSRPPipelinedWrite()
+	{
+	unsigned i;
+		for ( i = 0; i < entries_.size(); i++ ) {
+			delete entries_[i].xact_;
+		}
+	}
+};
+
+static void postChunk(CSRPPipelinedOp *op, unsigned entry, struct timespec *then)
+{
+	if ( clock_gettime(CLOCK_REALTIME, then) ) {
+		throw IOError("clock_gettime(then) failed", errno);
+	}
+	op->post( entry );
+}
+
+uint64_t
+CSRPAddressImpl::pipeline_unlocked(CSRPPipelinedOp *op) const
+{
+CSRPWindow::SlotSet          slots( &window_, pipelineDepth_ );
+unsigned                     depth   = slots.size();
+unsigned                     nChunks = op->getNChunks();
+std::vector<unsigned>        attempt( depth, 0 );
+std::vector<struct timespec> then( depth );
+unsigned                     nxt, done, e;
+BufChain                     rchn;
+
+#ifdef SRPADDR_DEBUG
+	fprintf(CPSW::fDbg(), "SRP pipeline_unlocked %d chunks, depth %d\n", nChunks, depth);
+#endif
+
+	for ( nxt = 0; nxt < depth && nxt < nChunks; nxt++ ) {
+		window_.arm( slots[nxt], op->start( nxt, nxt ) );
+		postChunk( op, nxt, &then[nxt] );
+	}
+
+	for ( done = 0; done < nChunks; ) {
+		// Chunks are collected in order, i.e., chunk 'done' is held
+		// by entry 'done % depth'. Replies to subsequent chunks which
+		// arrive meanwhile are stashed in their window slots.
+		e = done % depth;
+
+		if ( ! (rchn = awaitReply( slots[e], &then[e], backoff( attempt[e] ) )) ) {
+			retryDynTimeout();
+			if ( ++attempt[e] > retryCnt_ ) {
+				stats_.incTimeouts();
+				resetDynTimeout();
+				throw IOError("No response -- timeout");
+			}
+			// only resend the missing chunk
+			postChunk( op, e, &then[e] );
+			continue;
+		}
+
+		op->complete( e, rchn );
+
+		done++;
+
+		if ( nxt < nChunks ) {
+			window_.arm( slots[e], op->start( e, nxt ) );
+			attempt[e] = 0;
+			postChunk( op, e, &then[e] );
+			nxt++;
+		}
+	}
+
+	return op->getNBytes();
+}
+
+uint64_t
+CSRPAddressImpl::readPipelined_unlocked(uint8_t *dst, uint64_t off, unsigned sbytes) const
+{
+unsigned          headbytes = (byteResolution_ ? 0 : (off & SRPWRDALGNMSK) );
+CSRPPipelinedRead op( this, door_, mtu_, pipelineDepth_, dst, off, sbytes, headbytes, maxWordsRx_*sizeof(SRPWord) );
+
+	return pipeline_unlocked( &op );
+}
+
+uint64_t
+CSRPAddressImpl::writePipelined_unlocked(uint8_t *src, uint64_t off, unsigned dbytes) const
+{
+CSRPPipelinedWrite op( this, pipelineDepth_, src, off, dbytes, maxWordsTx_*sizeof(SRPWord) );
+
+	return pipeline_unlocked( &op );
+}
 
 uint32_t
 CSRPAddressImpl::extractTid(BufChain rchn) const
@@ -279,6 +824,28 @@ unsigned tidOff = getProtoVersion() == IProtoStackBuilder::SRP_UDP_V2 ? 0 : 4;
 	return toTid( msgTid );
 }
 
+void
+CSRPAddressImpl::unmatchedReply(uint32_t tidBits) const
+{
+// TIDs are issued in sequence; a reply to one of the last
+// 'horizon' transactions is considered late, anything else
+// (including TIDs we have not issued yet) was never ours.
+uint32_t horizon = (tidMsk_ / tidLsb_) / 2 + 1;
+uint32_t age     = toTid( tid_.load() - tidBits ) / tidLsb_;
+
+	if ( horizon > LATE_REPLY_HORIZON )
+		horizon = LATE_REPLY_HORIZON;
+
+	if ( age < horizon ) {
+		stats_.incLateReplies();
+	} else {
+		stats_.incTidMismatches();
+	}
+#ifdef SRPADDR_DEBUG
+	fprintf(CPSW::fDbg(), "SRP: unmatched reply (TID 0x%08" PRIx32 ", %" PRIu32 " transactions ago)\n", tidBits, age);
+#endif
+}
+
 uint64_t CSRPAddressImpl::readBlk_unlocked(IField::Cacheable cacheable, uint8_t *dst, uint64_t off, unsigned sbytes, AsyncIO aio) const
 {
 SRPAsyncReadTransaction xact = srpReadTransactionPool.alloc();
@@ -308,58 +875,232 @@ struct timespec retry_then;
 		return 0;
 
 	CSRPReadTransaction xact( this, dst, off, sbytes );
+	// speculative duplicate; posted with a new TID
+	CSRPReadTransaction hxact( 0, 0, 0, 0 );
+	CTimeout            hedgeDelay;
+	bool                mayHedge = getHedgeDelay( &hedgeDelay );
+	struct timespec     hthen;
+	bool                hedgeWon;
+
+	CSRPWindow::SlotGuard slot( &window_ );
+
+	window_.arm( slot.get(), xact.getTid() );
 
 	unsigned attempt = 0;
 
 	do {
-		uint32_t tidBits;
 		BufChain rchn;
 
 		xact.post( door_, mtu_ );
 
-		struct timespec then, now;
+		struct timespec then;
 		if ( clock_gettime(CLOCK_REALTIME, &then) ) {
 			throw IOError("clock_gettime(then) failed", errno);
 		}
 
-		do {
+		if ( mayHedge ) {
+			CTimeout abst  = getAbsTimeout();
+			CTimeout habst = door_->getAbsTimeoutPop( &hedgeDelay );
+
+			// hedge at most once per read; replies to either
+			// request are accepted (also on later attempts)
+			mayHedge = false;
+
+			if ( ! (rchn = window_.wait( this, door_, slot.get(), &habst )) ) {
+				if ( takeHedgeCredit() ) {
+					hxact.reset( this, dst, off, sbytes );
+					window_.hedge( slot.get(), hxact.getTid() );
+					hxact.post( door_, mtu_ );
+					if ( clock_gettime(CLOCK_REALTIME, &hthen) ) {
+						throw IOError("clock_gettime(then) failed", errno);
+					}
+					stats_.incHedges();
+				}
+				rchn = window_.wait( this, door_, slot.get(), &abst );
+			}
+			hedgeWon = rchn && hxact.getSRP() && tidMatch( extractTid( rchn ), hxact.getTid() );
+			if ( rchn ) {
+				// record what the network delivered
+				recordRndTrip( hedgeWon ? &hthen : &then );
+			}
+		} else {
+			rchn     = awaitReply( slot.get(), &then, backoff( attempt ) );
+			hedgeWon = rchn && hxact.getSRP() && tidMatch( extractTid( rchn ), hxact.getTid() );
+		}
 
-			rchn = door_->pop( dynTimeout_.getp(), IProtoPort::REL_TIMEOUT );
-			if ( ! rchn ) {
+		if ( ! rchn ) {
 #ifdef SRPADDR_DEBUG
-				time_retry( &retry_then, attempt, "READ", door_ );
+			time_retry( &retry_then, attempt, "READ", door_ );
 #endif
-				goto retry;
-			}
+			retryDynTimeout();
+			continue;
+		}
+
+		if ( hedgeWon ) {
+			stats_.incHedgeWins();
+			hxact.complete( rchn );
+		} else {
+			xact.complete( rchn );
+		}
+
+		return sbytes;
+
+	} while ( ++attempt <= retryCnt_ );
+
+	stats_.incTimeouts();
+	resetDynTimeout();
+
+	throw IOError("No response -- timeout");
+}
+
+CTimeout
+CSRPAddressImpl::getAbsTimeout(unsigned backoff) const
+{
+CMtx::lg guard( &dynTimeoutMtx_ );
+CTimeout rel( dynTimeout_.get().getUs() << backoff );
+
+	return door_->getAbsTimeoutPop( &rel );
+}
+
+void
+CSRPAddressImpl::recordRndTrip(const struct timespec *then) const
+{
+struct timespec now;
+
+	if ( clock_gettime(CLOCK_REALTIME, &now) ) {
+		throw IOError("clock_gettime(now) failed", errno);
+	}
+	stats_.recordRndTrip( ISRPStats::SYNCHRONOUS, &now, then );
+	if ( useDynTimeout_ ) {
+		CMtx::lg guard( &dynTimeoutMtx_ );
+		dynTimeout_.update( &now, then );
+	}
+}
+
+BufChain
+CSRPAddressImpl::busyPoll(ProtoDoor door, const CTimeout *abs_timeout) const
+{
+BufChain rchn;
+ProtoMod mod;
+CTimeout until;
+bool     polled = false;
+
+	if ( busyPollUS_.isNone() ) {
+		return rchn;
+	}
+
+	mod   = door->getProtoMod();
+	until = door->getAbsTimeoutPop( &busyPollUS_ );
+	if ( *abs_timeout < until ) {
+		until = *abs_timeout;
+	}
+
+	do {
+		if ( (rchn = door->tryPop()) ) {
+			// only count replies we received ourselves; a reply
+			// may also have been queued by the RX thread
+			if ( polled )
+				stats_.incBusyPollHits();
+			break;
+		}
+		// if the transport can be polled (run-to-completion all the way
+		// up) then the reply is processed right here; otherwise we just
+		// spin on the queue and save the wakeup.
+		polled = mod->pollInput();
+	} while ( door->getAbsTimeoutPop( &TIMEOUT_NONE ) < until );
+
+	return rchn;
+}
+
+BufChain
+CSRPAddressImpl::awaitReply(CSRPWindow::Slot slot, const struct timespec *then, unsigned backoff) const
+{
+CTimeout        abst = getAbsTimeout( backoff );
+BufChain        rchn;
+
+	rchn = window_.wait( this, door_, slot, &abst );
+
+	if ( rchn ) {
+		recordRndTrip( then );
+	}
+
+	return rchn;
+}
+
+void
+CSRPAddressImpl::retryDynTimeout() const
+{
+	// with hedging enabled retries back off exponentially
+	// (see 'backoff()') instead of inflating the timeout
+	// for everybody
+	if ( useDynTimeout_ && ! hedgeBudget_ ) {
+		CMtx::lg guard( &dynTimeoutMtx_ );
+		dynTimeout_.relax();
+	}
+	stats_.incRetries();
+}
+
+unsigned
+CSRPAddressImpl::backoff(unsigned attempt) const
+{
+	if ( ! hedgeBudget_ )
+		return 0;
+	return attempt < BACKOFF_MAX_LD ? attempt : BACKOFF_MAX_LD;
+}
 
-			if ( clock_gettime(CLOCK_REALTIME, &now) ) {
-				throw IOError("clock_gettime(now) failed", errno);
-			}
+bool
+CSRPAddressImpl::getHedgeDelay(CTimeout *delay) const
+{
+CMtx::lg guard( &dynTimeoutMtx_ );
+uint64_t cnt;
 
-			tidBits = extractTid( rchn );
+	if ( ! hedgeBudget_ )
+		return false;
 
-		} while ( ! tidMatch( tidBits , xact.getTid() ) );
+	hedgeCredit_ += hedgeBudget_;
+	if ( hedgeCredit_ > HEDGE_BURST * 100 )
+		hedgeCredit_ = HEDGE_BURST * 100;
 
-		if ( useDynTimeout_ )
-			dynTimeout_.update( &now, &then );
+	cnt = stats_.getCount( ISRPStats::SYNCHRONOUS );
+	if ( cnt < HEDGE_MIN_SAMPLES )
+		return false;
 
-		xact.complete( rchn );
+	// refresh the estimate periodically (or after the statistics were reset)
+	if ( cnt < hedgeDelayAt_ || cnt - hedgeDelayAt_ >= HEDGE_REFRESH || 0 == hedgeDelayAt_ ) {
+		hedgeDelay_.set( (uint64_t)stats_.getLatency( ISRPStats::SYNCHRONOUS ).p99Us_ + 1 );
+		hedgeDelayAt_ = cnt;
+	}
 
-		return sbytes;
+	// no point hedging if the timeout expires first
+	if ( ! (hedgeDelay_ < dynTimeout_.get()) )
+		return false;
 
-retry:
-		if ( useDynTimeout_ )
-			dynTimeout_.relax();
-		nRetries_++;
+	*delay = hedgeDelay_;
 
-	} while ( ++attempt <= retryCnt_ );
+	return true;
+}
 
-	if ( useDynTimeout_ )
-		dynTimeout_.reset( usrTimeout_ );
+bool
+CSRPAddressImpl::takeHedgeCredit() const
+{
+CMtx::lg guard( &dynTimeoutMtx_ );
 
-	throw IOError("No response -- timeout");
+	if ( hedgeCredit_ < 100 ) {
+		stats_.incHedgesThrottled();
+		return false;
+	}
+	hedgeCredit_ -= 100;
+	return true;
 }
 
+void
+CSRPAddressImpl::resetDynTimeout() const
+{
+	if ( useDynTimeout_ ) {
+		CMtx::lg guard( &dynTimeoutMtx_ );
+		dynTimeout_.reset( usrTimeout_ );
+	}
+}
 
 int
 CSRPAddressImpl::open (CompositePathIterator *node)
@@ -398,6 +1139,60 @@ int rval = CAddressImpl::close( node );
 
 uint64_t CSRPAddressImpl::read(CReadArgs *args) const
 {
+uint64_t rval;
+uint64_t epoch    = 0;
+bool     shadowed;
+
+	if ( args->nbytes_ == 0 )
+		return 0;
+
+	shadowed = shadow_ && args->dst_ && args->cacheable_ >= IField::WT_CACHEABLE;
+
+	if ( shadowed ) {
+		if ( shadow_->read( args->dst_, args->off_, args->nbytes_, &epoch ) ) {
+			if ( args->aio_ ) {
+				args->aio_->callback( 0 );
+			}
+			return args->nbytes_;
+		}
+		if ( args->aio_ ) {
+			// fill the cache once the data arrive
+			args->aio_ = cpsw::make_shared<CShadowCacheAsyncIO>( shadow_, args->dst_, args->off_, args->nbytes_, epoch, args->aio_ );
+		}
+	}
+
+	rval = readUncached( args );
+
+	if ( shadowed && ! args->aio_ ) {
+		shadow_->fill( args->dst_, args->off_, args->nbytes_, epoch );
+	}
+
+	return rval;
+}
+
+uint64_t CSRPAddressImpl::readUncached(CReadArgs *args) const
+{
+uint64_t rval;
+
+	if ( args->aio_ ) {
+		args->aio_ =  IAsyncIOParallelCompletion::create( args->aio_ );
+	}
+
+	if ( args->aio_ || isSerialized() ) {
+		CMtx::lg GUARD( &mutex_ );
+		rval = readChunks_unlocked( args );
+	} else {
+		// synchronous transactions of multiple threads may be outstanding
+		rval = readChunks_unlocked( args );
+	}
+
+	nReads_++;
+
+	return rval;
+}
+
+uint64_t CSRPAddressImpl::readChunks_unlocked(CReadArgs *args) const
+{
 uint64_t rval            = 0;
 unsigned headbytes       = (byteResolution_ ? 0 : (args->off_ & SRPWRDALGNMSK) );
 uint64_t off             = args->off_;
@@ -407,41 +1202,32 @@ unsigned sbytes          = args->nbytes_;
 unsigned totbytes;
 unsigned nWords;
 
-	if ( sbytes == 0 )
-		return 0;
-
 	totbytes = headbytes + sbytes;
 	nWords   = (totbytes + sizeof(SRPWord) - 1)/sizeof(SRPWord);
 
-	if ( args->aio_ ) {
-		args->aio_ =  IAsyncIOParallelCompletion::create( args->aio_ );
+	if ( ! args->aio_ && nWords > maxWordsRx_ && pipelineDepth_ > 1 ) {
+		return readPipelined_unlocked( dst, off, sbytes );
 	}
 
-	{
-	CMtx::lg GUARD( &mutex_ );
-
-		while ( nWords > maxWordsRx_ ) {
-			int nbytes = maxWordsRx_*4 - headbytes;
-			if ( args->aio_ ) {
-				rval   += readBlk_unlocked(args->cacheable_, dst, off, nbytes, args->aio_);
-			} else {
-				rval   += readBlk_unlocked(args->cacheable_, dst, off, nbytes);
-			}
-			nWords -= maxWordsRx_;
-			sbytes -= nbytes;
-			dst    += nbytes;
-			off    += nbytes;
-			headbytes = 0;
-		}
-
+	while ( nWords > maxWordsRx_ ) {
+		int nbytes = maxWordsRx_*4 - headbytes;
 		if ( args->aio_ ) {
-			rval += readBlk_unlocked(args->cacheable_, dst, off, sbytes, args->aio_);
+			rval   += readBlk_unlocked(args->cacheable_, dst, off, nbytes, args->aio_);
 		} else {
-			rval += readBlk_unlocked(args->cacheable_, dst, off, sbytes);
+			rval   += readBlk_unlocked(args->cacheable_, dst, off, nbytes);
 		}
+		nWords -= maxWordsRx_;
+		sbytes -= nbytes;
+		dst    += nbytes;
+		off    += nbytes;
+		headbytes = 0;
 	}
 
-	nReads_++;
+	if ( args->aio_ ) {
+		rval += readBlk_unlocked(args->cacheable_, dst, off, sbytes, args->aio_);
+	} else {
+		rval += readBlk_unlocked(args->cacheable_, dst, off, sbytes);
+	}
 
 	return rval;
 }
@@ -484,14 +1270,52 @@ int      j;
 	return xchn;
 }
 
-uint64_t CSRPAddressImpl::writeBlk_unlocked(IField::Cacheable cacheable, uint8_t *src, uint64_t off, unsigned dbytes, uint8_t msk1, uint8_t mskn) const
+unsigned
+CSRPAddressImpl::buildWriteHdr(SRPWord *xbuf, uint32_t tid, uint64_t off, unsigned totbytes, unsigned nWords, bool posted) const
+{
+unsigned put = 0;
+unsigned j;
+
+	if ( protoVersion_ < IProtoStackBuilder::SRP_UDP_V3 ) {
+		if ( protoVersion_ == IProtoStackBuilder::SRP_UDP_V1 ) {
+			xbuf[put++] = vc_ << 24;
+		}
+		xbuf[put++] = tid;
+		xbuf[put++] = ((off >> 2) & 0x3fffffff) | CMD_WRITE;
+	} else {
+		xbuf[put++] = (posted ? CMD_POSTED_WRITE_V3 : CMD_WRITE_V3) | PROTO_VERS_3;
+		xbuf[put++] = tid;
+		xbuf[put++] = ( byteResolution_ ? off : (off & ~(uint64_t)SRPWRDALGNMSK) );
+		xbuf[put++] = off >> 32;
+		xbuf[put++] = ( byteResolution_ ? totbytes : nWords << 2 ) - 1;
+	}
+
+	if ( needsHdrSwap() ) {
+		for ( j=0; j<put; j++ ) {
+			swp32( &xbuf[j] );
+		}
+	}
+
+	return put;
+}
+
+int
+CSRPAddressImpl::getWriteReplyHdrWords() const
+{
+	if ( protoVersion_ < IProtoStackBuilder::SRP_UDP_V3 ) {
+		return protoVersion_ == IProtoStackBuilder::SRP_UDP_V1 ? 4 : 3;
+	}
+	return 6;
+}
+
+uint64_t CSRPAddressImpl::writeBlk_unlocked(IField::Cacheable cacheable, uint8_t *src, uint64_t off, unsigned dbytes, uint8_t msk1, uint8_t mskn, AsyncIO aio) const
 {
 SRPWord  xbuf[5];
 SRPWord  zero = 0;
 SRPWord  pad  = 0;
 uint8_t  first_words[sizeof(SRPWord)*(1+RMW_COLLAPSE_EXTRA_WORDS)];
 uint8_t  last_word[sizeof(SRPWord)];
-int      j, put;
+int      put;
 unsigned i;
 unsigned headbytes       = ( byteResolution_ ? 0 : (off & SRPWRDALGNMSK) );
 unsigned totbytes;
@@ -531,7 +1355,7 @@ int      posted   = (    POSTED        == defaultWriteMode_
 		throw IOError("CSRPAddressImpl: Cannot merge bits/bytes to non-cacheable area");
 	}
 
-	AsyncIO                 aio;
+	AsyncIO                 rdAio;
 	AsyncIOCompletionWaiter wai;
 
 	// Note on merging of posted writes:
@@ -561,7 +1385,7 @@ int      posted   = (    POSTED        == defaultWriteMode_
 			// Since we must synchronize posting the write operation
 			// with
 			wai = IAsyncIOCompletionWaiter::create();
-			aio = IAsyncIOParallelCompletion::create( wai );
+			rdAio = IAsyncIOParallelCompletion::create( wai );
 		}
 	}
 
@@ -597,7 +1421,7 @@ int      posted   = (    POSTED        == defaultWriteMode_
 			firstlen = sizeof(SRPWord);
 		}
 
-		rargs.aio_ = aio;
+		rargs.aio_ = rdAio;
 
 		read(&rargs);
 	}
@@ -623,7 +1447,7 @@ int      posted   = (    POSTED        == defaultWriteMode_
         // must make sure not to hold
         // any ref. to the parallel completion waiter
         // (it won't complete until destroyed!)
-        rargs.aio_.swap(aio);
+        rargs.aio_.swap(rdAio);
 
 		read(&rargs);
 
@@ -677,31 +1501,23 @@ int      posted   = (    POSTED        == defaultWriteMode_
 		last_word[ last_byte  ] = (last_word[ last_byte ] & mskn) | (src[dbytes - 1] & ~mskn);
 	}
 
-	put = 0;
-	tid = getTid();
+	expected = getWriteReplyHdrWords();
 
-	if ( protoVersion_ < IProtoStackBuilder::SRP_UDP_V3 ) {
-		expected    = 3;
-		if ( protoVersion_ == IProtoStackBuilder::SRP_UDP_V1 ) {
-			xbuf[put++] = vc_ << 24;
-			expected++;
-		}
-		xbuf[put++] = tid;
-		xbuf[put++] = ((off >> 2) & 0x3fffffff) | CMD_WRITE;
+	SRPAsyncWriteTransaction axact;
+
+	if ( aio && ! posted ) {
+		// the reply is handled by the asynchronous handler; the
+		// transaction must be tagged with the TID we send
+		axact = srpWriteTransactionPool.alloc();
+		axact->reset( this, nWords, expected );
+		tid   = axact->getTid();
 	} else {
-		xbuf[put++] = (posted ? CMD_POSTED_WRITE_V3 : CMD_WRITE_V3) | PROTO_VERS_3;
-		xbuf[put++] = tid;
-		xbuf[put++] = ( byteResolution_ ? off : (off & ~(uint64_t)SRPWRDALGNMSK) );
-		xbuf[put++] = off >> 32;
-		xbuf[put++] = ( byteResolution_ ? totbytes : nWords << 2 ) - 1;
-		expected    = 6;
+		tid   = getTid();
 	}
 
-	if ( doSwap ) {
-		for ( j=0; j<put; j++ ) {
-			swp32( &xbuf[j] );
-		}
+	put      = buildWriteHdr( xbuf, tid, off, totbytes, nWords, posted );
 
+	if ( doSwap ) {
 		swp32( &zero );
 	}
 
@@ -755,57 +1571,156 @@ int      posted   = (    POSTED        == defaultWriteMode_
 	unsigned attempt = 0;
 	unsigned iovlen  = i;
 
+	if ( posted ) {
+		door_->push( assembleXBuf(iov, iovlen, iov_pld, toput), 0, IProtoPort::REL_TIMEOUT );
+		if ( aio ) {
+			aio->callback( 0 );
+		}
+		return dbytes;
+	}
+
+	if ( axact ) {
+		// the payload is copied into the transmit buffer; the
+		// caller's source buffer is not referenced after this point
+		BufChain xchn = assembleXBuf(iov, iovlen, iov_pld, toput);
+
+		asyncXactMgr_->post( axact, tid, aio );
+
+		// If we are open then the async door must also be open
+		asyncIOHandler_.getDoor()->push( xchn, 0, IProtoPort::REL_TIMEOUT );
+
+		return dbytes;
+	}
+
 	CSRPWriteTransaction xact( this, nWords, expected );
 
+	CSRPWindow::SlotGuard slot( &window_ );
+
+	window_.arm( slot.get(), tid );
+
 	do {
 		BufChain xchn = assembleXBuf(iov, iovlen, iov_pld, toput);
 
 		BufChain rchn;
-		struct timespec then, now;
+		struct timespec then;
 		if ( clock_gettime(CLOCK_REALTIME, &then) ) {
 			throw IOError("clock_gettime(then) failed", errno);
 		}
 
 		door_->push( xchn, 0, IProtoPort::REL_TIMEOUT );
 
-		if ( posted )
-			return dbytes;
-
-		do {
-			rchn = door_->pop( dynTimeout_.getp(), IProtoPort::REL_TIMEOUT );
-			if ( ! rchn ) {
+		if ( ! (rchn = awaitReply( slot.get(), &then, backoff( attempt ) )) ) {
 #ifdef SRPADDR_DEBUG
-				time_retry( &retry_then, attempt, "WRITE", door_ );
+			time_retry( &retry_then, attempt, "WRITE", door_ );
 #endif
-				goto retry;
-			}
-
-			if ( clock_gettime(CLOCK_REALTIME, &now) ) {
-				throw IOError("clock_gettime(now) failed", errno);
-			}
-
-		} while ( ! tidMatch( extractTid( rchn ), tid ) );
-
-		if ( useDynTimeout_ )
-			dynTimeout_.update( &now, &then );
+			retryDynTimeout();
+			continue;
+		}
 
 		xact.complete( rchn );
 
 		return dbytes;
-retry:
-		if ( useDynTimeout_ )
-			dynTimeout_.relax();
-		nRetries_++;
 	} while ( ++attempt <= retryCnt_ );
 
-	if ( useDynTimeout_ )
-		dynTimeout_.reset( usrTimeout_ );
+	stats_.incTimeouts();
+	resetDynTimeout();
 
 	throw IOError("Too many retries");
 }
 
 uint64_t CSRPAddressImpl::write(CWriteArgs *args) const
 {
+uint64_t rval;
+
+	if ( args->nbytes_ == 0 )
+		return 0;
+
+	if ( ! shadow_ || ! args->src_ ) {
+		return writeUncached( args );
+	}
+
+	if (    args->cacheable_ >= IField::WB_CACHEABLE
+	     && shadow_->writeBack( args->src_, args->off_, args->nbytes_, args->msk1_, args->mskn_ ) ) {
+		// deferred until the cache is flushed
+		if ( args->aio_ ) {
+			args->aio_->callback( 0 );
+		}
+		return args->nbytes_;
+	}
+
+	if ( args->aio_ ) {
+		// invalidate if the write fails
+		args->aio_ = cpsw::make_shared<CShadowCacheAsyncIO>( shadow_, (uint8_t*)0, args->off_, args->nbytes_, 0, args->aio_ );
+	}
+
+	try {
+		rval = writeUncached( args );
+	} catch ( CPSWError & ) {
+		shadow_->invalidate( args->off_, args->nbytes_ );
+		throw;
+	}
+
+	if ( args->cacheable_ >= IField::WT_CACHEABLE ) {
+		// any read-modify-write readback has filled the bytes
+		// we merge into (unless it was cached already).
+		shadow_->update( args->src_, args->off_, args->nbytes_, args->msk1_, args->mskn_ );
+	} else {
+		shadow_->invalidate( args->off_, args->nbytes_ );
+	}
+
+	return rval;
+}
+
+uint64_t CSRPAddressImpl::writeToDevice(uint8_t *src, uint64_t off, unsigned nbytes) const
+{
+CWriteArgs args;
+
+	args.cacheable_ = IField::WB_CACHEABLE;
+	args.src_       = src;
+	args.off_       = off;
+	args.nbytes_    = nbytes;
+
+	return writeUncached( &args );
+}
+
+uint64_t CSRPAddressImpl::writeUncached(CWriteArgs *args) const
+{
+uint64_t rval;
+unsigned headbytes       = (byteResolution_ ? 0 : (args->off_ & SRPWRDALGNMSK) );
+unsigned totbytes        = headbytes + args->nbytes_;
+
+	if ( args->nbytes_ == 0 )
+		return 0;
+
+	// read-modify-write operations must not be interleaved with
+	// other threads' transactions
+	bool rmw = headbytes || args->msk1_ || args->mskn_ || ( ! byteResolution_ && (totbytes & SRPWRDALGNMSK) );
+
+	if ( args->aio_ ) {
+		args->aio_ =  IAsyncIOParallelCompletion::create( args->aio_ );
+	}
+
+	if ( isSerialized() ) {
+		CMtx::lg GUARD( &mutex_ );
+		rval = writeChunks_unlocked( args );
+	} else {
+		// plain synchronous writes may be outstanding concurrently
+		// but not while an RMW is in progress (and vice versa)
+		CSRPWriteGate::Guard gate( &writeGate_, rmw );
+		if ( rmw || args->aio_ ) {
+			CMtx::lg GUARD( &mutex_ );
+			rval = writeChunks_unlocked( args );
+		} else {
+			rval = writeChunks_unlocked( args );
+		}
+	}
+
+	nWrites_++;
+	return rval;
+}
+
+uint64_t CSRPAddressImpl::writeChunks_unlocked(CWriteArgs *args) const
+{
 uint64_t rval            = 0;
 unsigned headbytes       = (byteResolution_ ? 0 : (args->off_ & SRPWRDALGNMSK) );
 unsigned dbytes          = args->nbytes_;
@@ -816,20 +1731,25 @@ uint8_t  msk1            = args->msk1_;
 unsigned totbytes;
 unsigned nWords;
 
-	if ( dbytes == 0 )
-		return 0;
-
 	totbytes = headbytes + dbytes;
 	nWords   = (totbytes + sizeof(SRPWord) - 1)/sizeof(SRPWord);
 
-	CMtx::lg GUARD( &mutex_ );
-
 #ifdef SRPADDR_DEBUG
 	fprintf(CPSW::fDbg(), "SRP writeBlk nWordsmaxWordsTx_ %d\n", maxWordsTx_);
 #endif
+	if ( nWords > maxWordsTx_ && pipelineDepth_ > 1 ) {
+		bool posted = (    POSTED        == defaultWriteMode_
+		                && protoVersion_ >= IProtoStackBuilder::SRP_UDP_V3 );
+		bool plain  = ! headbytes && ! msk1 && ! args->mskn_ && ( byteResolution_ || ! (totbytes & SRPWRDALGNMSK) );
+		// posted and asynchronous writes don't wait for replies anyways
+		if ( plain && ! posted && ! args->aio_ ) {
+			return writePipelined_unlocked( src, off, dbytes );
+		}
+	}
+
 	while ( nWords > maxWordsTx_ ) {
 		int nbytes = maxWordsTx_*4 - headbytes;
-		rval += writeBlk_unlocked(args->cacheable_, src, off, nbytes, msk1, 0);
+		rval += writeBlk_unlocked(args->cacheable_, src, off, nbytes, msk1, 0, args->aio_);
 		nWords -= maxWordsTx_;
 		dbytes -= nbytes;
 		src    += nbytes;
@@ -838,11 +1758,9 @@ unsigned nWords;
 		msk1      = 0;
 	}
 
-	rval += writeBlk_unlocked(args->cacheable_, src, off, dbytes, msk1, args->mskn_);
+	rval += writeBlk_unlocked(args->cacheable_, src, off, dbytes, msk1, args->mskn_, args->aio_);
 
-	nWrites_++;
 	return rval;
-
 }
 
 void CSRPAddressImpl::dump(FILE *f) const
@@ -859,11 +1777,22 @@ void CSRPAddressImpl::dump(FILE *f) const
 	fprintf(f,"  avg Roundtrip time: %8" PRIu64 "us\n", dynTimeout_.getAvgRndTrip().getUs());
 	}
 	fprintf(f,"  Retry Limit       : %8u\n",   retryCnt_);
-	fprintf(f,"  # of retried ops  : %8u\n",   nRetries_);
-	fprintf(f,"  # of writes (OK)  : %8u\n",   nWrites_);
-	fprintf(f,"  # of reads  (OK)  : %8u\n",   nReads_);
+	fprintf(f,"  Max. outstanding  : %8u\n",   maxOutstanding_);
+	fprintf(f,"  Pipeline depth    : %8u\n",   pipelineDepth_);
+	if ( hedgeBudget_ ) {
+	fprintf(f,"  Hedge budget      : %8u%%\n",  hedgeBudget_);
+	}
+	if ( ! busyPollUS_.isNone() ) {
+	fprintf(f,"  Busy-poll budget  : %8" PRIu64 "us\n", busyPollUS_.getUs());
+	}
+	fprintf(f,"  # of writes (OK)  : %8u\n",   nWrites_.load());
+	fprintf(f,"  # of reads  (OK)  : %8u\n",   nReads_.load());
 	fprintf(f,"  Virtual Channel   : %8u\n",   vc_);
 	fprintf(f,"  Async Messages    : %8u\n",   asyncIOHandler_.getMsgCount());
+	stats_.dump( f );
+	if ( shadow_ ) {
+		shadow_->dump( f );
+	}
 	CCommAddressImpl::dump(f);
 }
 
@@ -942,3 +1871,171 @@ int64_t  diffus;
 		avgRndTrip_>>AVG_SHFT);
 #endif
 }
+
+CSRPStats::CSRPStats()
+{
+	reset();
+}
+
+void
+CSRPStats::recordRndTrip(ISRPStats::Channel ch, const struct timespec *now, const struct timespec *then)
+{
+int64_t ns = (int64_t)(now->tv_sec - then->tv_sec) * 1000000000LL + (now->tv_nsec - then->tv_nsec);
+
+	// the realtime clock may have been stepped
+	rndTrip_[ch].record( ns < 0 ? 0 : ns );
+}
+
+ISRPStats::Latency
+CSRPStats::getLatency(ISRPStats::Channel ch) const
+{
+CLatencyHistogram::Summary s;
+ISRPStats::Latency         l;
+
+	rndTrip_[ch].summarize( &s );
+
+	l.count_  = s.count_;
+	l.avgUs_  = s.count_ ? (double)s.sumNs_/(double)s.count_/1000.0 : 0.0;
+	l.p50Us_  = (double)s.p50Ns_ /1000.0;
+	l.p99Us_  = (double)s.p99Ns_ /1000.0;
+	l.p999Us_ = (double)s.p999Ns_/1000.0;
+	l.maxUs_  = (double)s.maxNs_ /1000.0;
+
+	return l;
+}
+
+void
+CSRPStats::reset()
+{
+	rndTrip_[ISRPStats::SYNCHRONOUS ].reset();
+	rndTrip_[ISRPStats::ASYNCHRONOUS].reset();
+	retries_.store        ( 0, cpsw::memory_order_relaxed );
+	timeouts_.store       ( 0, cpsw::memory_order_relaxed );
+	lateReplies_.store    ( 0, cpsw::memory_order_relaxed );
+	tidMismatches_.store  ( 0, cpsw::memory_order_relaxed );
+	hedges_.store         ( 0, cpsw::memory_order_relaxed );
+	hedgeWins_.store      ( 0, cpsw::memory_order_relaxed );
+	hedgesThrottled_.store( 0, cpsw::memory_order_relaxed );
+	busyPollHits_.store   ( 0, cpsw::memory_order_relaxed );
+}
+
+static void dumpLatency(YAML::Node &node, const char *fld, const ISRPStats::Latency &l)
+{
+YAML::Node lat;
+	writeNode(lat, "count",  l.count_ );
+	writeNode(lat, "avgUs",  l.avgUs_ );
+	writeNode(lat, "p50Us",  l.p50Us_ );
+	writeNode(lat, "p99Us",  l.p99Us_ );
+	writeNode(lat, "p999Us", l.p999Us_);
+	writeNode(lat, "maxUs",  l.maxUs_ );
+	writeNode(node, fld, lat);
+}
+
+void
+CSRPStats::dumpYaml(YAML::Node &node) const
+{
+	writeNode(node, "retries",         getRetries()        );
+	writeNode(node, "timeouts",        getTimeouts()       );
+	writeNode(node, "lateReplies",     getLateReplies()    );
+	writeNode(node, "tidMismatches",   getTidMismatches()  );
+	writeNode(node, "hedges",          getHedges()         );
+	writeNode(node, "hedgeWins",       getHedgeWins()      );
+	writeNode(node, "hedgesThrottled", getHedgesThrottled());
+	writeNode(node, "busyPollHits",    getBusyPollHits()   );
+	dumpLatency(node, "synchronous",  getLatency( ISRPStats::SYNCHRONOUS  ));
+	dumpLatency(node, "asynchronous", getLatency( ISRPStats::ASYNCHRONOUS ));
+}
+
+void
+CSRPStats::dump(FILE *f) const
+{
+static const char *chnm[] = { "sync ", "async" };
+unsigned           ch;
+
+	fprintf(f,"  # of retried ops  : %8" PRIu64 "\n", getRetries());
+	fprintf(f,"  # of timeouts     : %8" PRIu64 "\n", getTimeouts());
+	fprintf(f,"  # late replies    : %8" PRIu64 "\n", getLateReplies());
+	fprintf(f,"  # TID mismatches  : %8" PRIu64 "\n", getTidMismatches());
+	if ( getHedges() || getHedgesThrottled() ) {
+		fprintf(f,"  # hedged reads    : %8" PRIu64 " (%" PRIu64 " won, %" PRIu64 " throttled)\n",
+			getHedges(), getHedgeWins(), getHedgesThrottled());
+	}
+	if ( getBusyPollHits() ) {
+		fprintf(f,"  # busy-poll hits  : %8" PRIu64 "\n", getBusyPollHits());
+	}
+	for ( ch = ISRPStats::SYNCHRONOUS; ch <= ISRPStats::ASYNCHRONOUS; ch++ ) {
+		ISRPStats::Latency l = getLatency( (ISRPStats::Channel)ch );
+		if ( 0 == l.count_ )
+			continue;
+		fprintf(f,"  RTT %s (us)     : p50 %.1f, p99 %.1f, p999 %.1f, max %.1f (%" PRIu64 " samples)\n",
+			chnm[ch], l.p50Us_, l.p99Us_, l.p999Us_, l.maxUs_, l.count_);
+	}
+}
+
+class CSRPStatsAdapt : public ISRPStats {
+private:
+	shared_ptr<const CSRPAddressImpl> srp_;
+public:
+	CSRPStatsAdapt(shared_ptr<const CSRPAddressImpl> srp)
+	: srp_( srp )
+	{
+	}
+
+	virtual Latency  getLatency(Channel ch) const
+	{
+		if ( ch != SYNCHRONOUS && ch != ASYNCHRONOUS )
+			throw InvalidArgError("SRPStats: invalid channel");
+		return srp_->getStats()->getLatency( ch );
+	}
+
+	virtual uint64_t getRetries()         const { return srp_->getStats()->getRetries();         }
+	virtual uint64_t getTimeouts()        const { return srp_->getStats()->getTimeouts();        }
+	virtual uint64_t getLateReplies()     const { return srp_->getStats()->getLateReplies();     }
+	virtual uint64_t getTidMismatches()   const { return srp_->getStats()->getTidMismatches();   }
+	virtual uint64_t getHedges()          const { return srp_->getStats()->getHedges();          }
+	virtual uint64_t getHedgeWins()       const { return srp_->getStats()->getHedgeWins();       }
+	virtual uint64_t getHedgesThrottled() const { return srp_->getStats()->getHedgesThrottled(); }
+	virtual uint64_t getBusyPollHits()    const { return srp_->getStats()->getBusyPollHits();    }
+	virtual unsigned getVirtualChannel()  const { return srp_->getVC();                          }
+
+	virtual void     reset()
+	{
+		srp_->getStats()->reset();
+	}
+
+	virtual void     dumpYaml(YAML::Node &node) const
+	{
+		writeNode(node, "virtualChannel", getVirtualChannel());
+		srp_->getStats()->dumpYaml( node );
+	}
+};
+
+ConstSRPAddressImpl
+CSRPAddressImpl::findTransport(ConstPath p)
+{
+ConstSRPAddressImpl srp;
+
+	if ( p->empty() )
+		throw InvalidPathError("<EMPTY>");
+
+	CompositePathIterator it( p );
+	while ( ! it.atEnd() ) {
+		if ( (srp = dynamic_pointer_cast<ConstSRPAddressImpl::element_type>( it->c_p_ )) )
+			break;
+		++it;
+	}
+
+	return srp;
+}
+
+SRPStats
+ISRPStats::create(ConstPath p)
+{
+ConstSRPAddressImpl srp;
+
+	if ( ! (srp = CSRPAddressImpl::findTransport( p )) ) {
+		throw InvalidArgError("Path is not routed through a SRP transport");
+	}
+
+	return cpsw::make_shared<CSRPStatsAdapt>( srp );
+}
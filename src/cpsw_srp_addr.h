@@ -13,6 +13,11 @@
 #include <cpsw_comm_addr.h>
 #include <cpsw_thread.h>
 #include <cpsw_async_io.h>
+#include <cpsw_condvar.h>
+#include <cpsw_shadow_cache.h>
+#include <cpsw_histogram.h>
+
+#include <vector>
 
 
 // Dynamical timeout based on round-trip times
@@ -52,7 +57,217 @@ public:
 
 };
 
+// Round-trip time histograms and error counters of a
+// SRP transport; may be updated concurrently without locking.
+class CSRPStats {
+private:
+	CLatencyHistogram              rndTrip_[2]; // indexed by ISRPStats::Channel
+	mutable cpsw::atomic<uint64_t> retries_;
+	mutable cpsw::atomic<uint64_t> timeouts_;
+	mutable cpsw::atomic<uint64_t> lateReplies_;
+	mutable cpsw::atomic<uint64_t> tidMismatches_;
+	mutable cpsw::atomic<uint64_t> hedges_;
+	mutable cpsw::atomic<uint64_t> hedgeWins_;
+	mutable cpsw::atomic<uint64_t> hedgesThrottled_;
+	mutable cpsw::atomic<uint64_t> busyPollHits_;
+
+	CSRPStats(const CSRPStats&);
+	CSRPStats & operator=(const CSRPStats&);
+
+public:
+	CSRPStats();
+
+	void recordRndTrip(ISRPStats::Channel ch, const struct timespec *now, const struct timespec *then);
+
+	void incRetries()         { retries_.fetch_add        ( 1, cpsw::memory_order_relaxed ); }
+	void incTimeouts()        { timeouts_.fetch_add       ( 1, cpsw::memory_order_relaxed ); }
+	void incLateReplies()     { lateReplies_.fetch_add    ( 1, cpsw::memory_order_relaxed ); }
+	void incTidMismatches()   { tidMismatches_.fetch_add  ( 1, cpsw::memory_order_relaxed ); }
+	void incHedges()          { hedges_.fetch_add         ( 1, cpsw::memory_order_relaxed ); }
+	void incHedgeWins()       { hedgeWins_.fetch_add      ( 1, cpsw::memory_order_relaxed ); }
+	void incHedgesThrottled() { hedgesThrottled_.fetch_add( 1, cpsw::memory_order_relaxed ); }
+	void incBusyPollHits()    { busyPollHits_.fetch_add   ( 1, cpsw::memory_order_relaxed ); }
+
+	uint64_t getRetries()         const { return retries_.load        ( cpsw::memory_order_relaxed ); }
+	uint64_t getTimeouts()        const { return timeouts_.load       ( cpsw::memory_order_relaxed ); }
+	uint64_t getLateReplies()     const { return lateReplies_.load    ( cpsw::memory_order_relaxed ); }
+	uint64_t getTidMismatches()   const { return tidMismatches_.load  ( cpsw::memory_order_relaxed ); }
+	uint64_t getHedges()          const { return hedges_.load         ( cpsw::memory_order_relaxed ); }
+	uint64_t getHedgeWins()       const { return hedgeWins_.load      ( cpsw::memory_order_relaxed ); }
+	uint64_t getHedgesThrottled() const { return hedgesThrottled_.load( cpsw::memory_order_relaxed ); }
+	uint64_t getBusyPollHits()    const { return busyPollHits_.load   ( cpsw::memory_order_relaxed ); }
+
+	ISRPStats::Latency getLatency(ISRPStats::Channel ch) const;
+	uint64_t           getCount(ISRPStats::Channel ch)   const { return rndTrip_[ch].getCount(); }
+
+	void reset();
+
+	void dumpYaml(YAML::Node &) const;
+	void dump(FILE *) const;
+};
+
 class CSRPAddressImpl;
+typedef shared_ptr<const CSRPAddressImpl> ConstSRPAddressImpl;
+
+// Window of synchronous transactions which may be outstanding
+// concurrently (issued by different threads). All of them share the
+// synchronous door; the waiters take turns reading from the door
+// and hand every reply over to the waiter with the matching TID.
+class CSRPWindow {
+public:
+	class CSlot {
+	private:
+		uint32_t tid_;
+		uint32_t hedgeTid_;
+		BufChain reply_;
+		bool     busy_;
+		bool     hedged_;
+	public:
+		CSlot()
+		: tid_     ( 0     ),
+		  hedgeTid_( 0     ),
+		  busy_    ( false ),
+		  hedged_  ( false )
+		{
+		}
+
+		friend class CSRPWindow;
+	};
+
+	typedef CSlot *Slot;
+
+	// RAII helper to acquire/release a slot
+	class SlotGuard {
+	private:
+		CSRPWindow *win_;
+		Slot        slot_;
+		SlotGuard(const SlotGuard&);
+		SlotGuard & operator=(const SlotGuard&);
+	public:
+		SlotGuard(CSRPWindow *win)
+		: win_ ( win ),
+		  slot_( win->acquire() )
+		{
+		}
+
+		Slot get() const
+		{
+			return slot_;
+		}
+
+		~SlotGuard()
+		{
+			win_->release( slot_ );
+		}
+	};
+
+	// RAII helper to acquire up to 'max' slots. Only the first
+	// slot is waited for; further ones are taken if available.
+	// Thus, concurrent users never deadlock while each one
+	// holds at least one slot.
+	class SlotSet {
+	private:
+		CSRPWindow         *win_;
+		std::vector<Slot>   slots_;
+		SlotSet(const SlotSet&);
+		SlotSet & operator=(const SlotSet&);
+	public:
+		SlotSet(CSRPWindow *win, unsigned max);
+
+		unsigned size() const
+		{
+			return slots_.size();
+		}
+
+		Slot operator[](unsigned idx) const
+		{
+			return slots_[idx];
+		}
+
+		~SlotSet();
+	};
+
+private:
+	CMtx                mtx_;
+	CCond               cond_;
+	std::vector<CSlot>  slots_;
+	unsigned            nBusy_;
+	bool                reading_;
+
+	CSRPWindow(const CSRPWindow&);
+	CSRPWindow & operator=(const CSRPWindow&);
+
+	void dispatch_unl(const CSRPAddressImpl *, BufChain);
+
+public:
+	CSRPWindow(unsigned size);
+
+	unsigned getSize() const
+	{
+		return slots_.size();
+	}
+
+	// block until the number of outstanding transactions
+	// is below the window size
+	Slot     acquire();
+	// returns NULL if no slot is available
+	Slot     tryAcquire();
+	void     release(Slot);
+
+	// must be armed with the TID before the request is posted
+	void     arm(Slot, uint32_t tid);
+
+	// additionally accept a reply to a speculative duplicate
+	// of the request (which uses a different TID)
+	void     hedge(Slot, uint32_t tid);
+
+	// wait for the reply to the TID 'slot' is armed with;
+	// returns a NULL BufChain on timeout
+	BufChain wait(const CSRPAddressImpl *, ProtoDoor, Slot, const CTimeout *abs_timeout);
+};
+
+// With multiple outstanding transactions plain writes of different
+// threads proceed concurrently. A read-modify-write must exclude them,
+// however, since a write to the same word which hits the device between
+// the readback and the RMW write would be lost.
+class CSRPWriteGate {
+private:
+	CMtx      mtx_;
+	CCond     cond_;
+	unsigned  nWriters_;
+	unsigned  nRMWWaiting_;
+	bool      rmw_;
+
+	CSRPWriteGate(const CSRPWriteGate&);
+	CSRPWriteGate & operator=(const CSRPWriteGate&);
+
+public:
+	CSRPWriteGate();
+
+	// plain writes share the gate; an RMW owns it
+	void enter(bool rmw);
+	void leave(bool rmw);
+
+	class Guard {
+	private:
+		CSRPWriteGate *gate_;
+		bool           rmw_;
+		Guard(const Guard&);
+		Guard & operator=(const Guard&);
+	public:
+		Guard(CSRPWriteGate *gate, bool rmw)
+		: gate_( gate ),
+		  rmw_ ( rmw  )
+		{
+			gate_->enter( rmw_ );
+		}
+
+		~Guard()
+		{
+			gate_->leave( rmw_ );
+		}
+	};
+};
 
 class CSRPAsyncHandler : CRunnable {
 private:
@@ -82,20 +297,32 @@ public:
 	}
 };
 
-class CSRPAddressImpl : public CCommAddressImpl {
+class CSRPPipelinedOp;
+
+class CSRPAddressImpl : public CCommAddressImpl, public CShadowCache::IWriter {
 private:
 	INetIODev::ProtocolVersion protoVersion_;
 	CTimeout                  usrTimeout_;
 	mutable DynTimeout        dynTimeout_;
 	bool                      useDynTimeout_;
+	mutable CMtx              dynTimeoutMtx_;
 	unsigned                  retryCnt_;
-	mutable unsigned          nRetries_;
-	mutable unsigned          nWrites_;
-	mutable unsigned          nReads_;
+	unsigned                  maxOutstanding_;
+	unsigned                  pipelineDepth_;
+	unsigned                  hedgeBudget_;  // percentage of reads which may be hedged
+	mutable unsigned          hedgeCredit_;  // hedgeCredit_, hedgeDelay_, hedgeDelayAt_
+	mutable CTimeout          hedgeDelay_;   // are protected by dynTimeoutMtx_
+	mutable uint64_t          hedgeDelayAt_;
+	CTimeout                  busyPollUS_;
+	mutable cpsw::atomic<unsigned> nWrites_;
+	mutable cpsw::atomic<unsigned> nReads_;
+	// must outlive the async. transaction manager (which
+	// completes pending transactions when it is destroyed)
+	mutable CSRPStats         stats_;
 	uint8_t                   vc_;
 	bool                      needsSwap_;
 	bool                      needsPldSwap_;
-	mutable uint32_t          tid_;
+	mutable cpsw::atomic<uint32_t> tid_;
 	uint32_t                  tidMsk_;
 	uint32_t                  tidLsb_;
 	bool                      byteResolution_;
@@ -105,14 +332,54 @@ private:
 	ProtoPort                 asyncIOPort_;
 	AsyncIOTransactionManager asyncXactMgr_;
 	CSRPAsyncHandler          asyncIOHandler_;
+	mutable CSRPWindow        window_;
+	ShadowCacheImpl           shadow_;
 
 	BufChain         assembleXBuf(struct srp_iovec *iov, unsigned iovlen, int iov_pld, int toput) const;
 
+	// wait for the reply to the transaction 'slot' is armed with and
+	// record the round-trip time. Returns a NULL BufChain on timeout.
+	// The timeout is multiplied by 2^backoff.
+	BufChain         awaitReply(CSRPWindow::Slot slot, const struct timespec *then, unsigned backoff = 0) const;
+	// absolute timeout for a reply to a request posted now
+	CTimeout         getAbsTimeout(unsigned backoff = 0) const;
+	void             recordRndTrip(const struct timespec *then) const;
+	// whether synchronous transactions are serialized by 'mutex_'
+	bool             isSerialized() const { return maxOutstanding_ <= 1; }
+	void             retryDynTimeout() const;
+	void             resetDynTimeout() const;
+	// timeout multiplier (ld) for a retry
+	unsigned         backoff(unsigned attempt) const;
+	// account for a read and obtain the delay after which it may
+	// be hedged; returns false if the read must not be hedged
+	bool             getHedgeDelay(CTimeout *delay) const;
+	// consume hedge budget; returns false if it is exhausted
+	bool             takeHedgeCredit() const;
+	// post the chunks of a large transfer back-to-back and
+	// collect the replies (in any order)
+	uint64_t         pipeline_unlocked(CSRPPipelinedOp *op) const;
+	// assemble the header of a write request (in wire byte-order);
+	// returns the number of header words
+	unsigned         buildWriteHdr(uint32_t *xbuf, uint32_t tid, uint64_t off, unsigned totbytes, unsigned nWords, bool posted) const;
+	// number of words of a write reply not counting the payload
+	int              getWriteReplyHdrWords() const;
+
+	friend class CSRPPipelinedWrite;
+
 protected:
 	mutable CMtx     mutex_;
+	mutable CSRPWriteGate writeGate_;
 	virtual uint64_t readBlk_unlocked(IField::Cacheable cacheable, uint8_t *dst, uint64_t off, unsigned sbytes, AsyncIO aio) const;
 	virtual uint64_t readBlk_unlocked(IField::Cacheable cacheable, uint8_t *dst, uint64_t off, unsigned sbytes) const;
-	virtual uint64_t writeBlk_unlocked(IField::Cacheable cacheable, uint8_t *src, uint64_t off, unsigned dbytes, uint8_t msk1, uint8_t mskn) const;
+	virtual uint64_t writeBlk_unlocked(IField::Cacheable cacheable, uint8_t *src, uint64_t off, unsigned dbytes, uint8_t msk1, uint8_t mskn, AsyncIO aio) const;
+	// break up into chunks the transport can handle
+	virtual uint64_t readChunks_unlocked(CReadArgs *args) const;
+	virtual uint64_t writeChunks_unlocked(CWriteArgs *args) const;
+	virtual uint64_t readPipelined_unlocked(uint8_t *dst, uint64_t off, unsigned sbytes) const;
+	virtual uint64_t writePipelined_unlocked(uint8_t *src, uint64_t off, unsigned dbytes) const;
+	// access the device, bypassing the shadow cache
+	virtual uint64_t readUncached (CReadArgs *args)  const;
+	virtual uint64_t writeUncached(CWriteArgs *args) const;
 
 public:
 	CSRPAddressImpl(AKey key, ProtoStackBuilder, ProtoPort);
@@ -120,8 +387,8 @@ public:
 	CSRPAddressImpl(CSRPAddressImpl &orig, AKey k)
 	: CCommAddressImpl(orig, k),
 	  dynTimeout_(orig.dynTimeout_.get()),
-	  nRetries_(0),
-	  asyncIOHandler_( AsyncIOTransactionManager(), 0 )
+	  asyncIOHandler_( AsyncIOTransactionManager(), 0 ),
+	  window_( 1 )
 	{
 		throw InternalError("Clone not implemented"); /* need to clone mutex, ... */
 	}
@@ -132,6 +399,15 @@ public:
 	virtual uint64_t read (CReadArgs *args)  const;
 	virtual uint64_t write(CWriteArgs *args) const;
 
+	virtual ShadowCacheImpl getShadowCache() const { return shadow_; }
+
+	// the SRP transport which serves the leaf of path 'p' (the
+	// first one encountered walking up toward the origin); NULL
+	// if there is none.
+	static ConstSRPAddressImpl findTransport(ConstPath p);
+
+	virtual uint64_t writeToDevice(uint8_t *src, uint64_t off, unsigned nbytes) const;
+
 	virtual void dump(FILE *f) const;
 
 	virtual void startUp();
@@ -145,16 +421,26 @@ public:
 	virtual unsigned getTimeoutUs()                      const { return usrTimeout_.getUs();               }
 	virtual unsigned getDynTimeoutUs()                   const { return dynTimeout_.get().getUs();         }
 	virtual unsigned getRetryCount()                     const { return retryCnt_;                         }
+	virtual unsigned getMaxOutstanding()                 const { return maxOutstanding_;                   }
+	virtual unsigned getPipelineDepth()                  const { return pipelineDepth_;                    }
 	virtual INetIODev::ProtocolVersion getProtoVersion() const { return protoVersion_;                     }
 	virtual bool     getByteResolution()                 const { return byteResolution_;                   }
 	virtual uint8_t  getVC()                             const { return vc_;                               }
 	virtual uint32_t toTid(uint32_t bits)                const { return bits & tidMsk_;                    }
-	virtual uint32_t getTid()                            const { return toTid( tid_ = (tid_ + tidLsb_) );  }
+	virtual uint32_t getTid()                            const { return toTid( tid_.fetch_add( tidLsb_ ) + tidLsb_ ); }
 	virtual bool     tidMatch(uint32_t a, uint32_t b)    const { return ! ((a ^ b) & tidMsk_);             }
 	virtual bool     needsHdrSwap()                      const { return needsSwap_;                        }
 	virtual bool     needsPayloadSwap()                  const { return needsPldSwap_;                     }
 	virtual void     dumpYamlPart(YAML::Node &) const;
 	virtual uint32_t extractTid(BufChain msg) const;
+	// spin (for at most the busy-poll budget or until 'abs_timeout')
+	// receiving on the caller's thread until a message shows up in
+	// 'door'; returns a NULL BufChain if busy-polling is disabled or
+	// nothing arrived in time.
+	virtual BufChain busyPoll(ProtoDoor door, const CTimeout *abs_timeout) const;
+	// account for a reply which nobody was waiting for
+	virtual void     unmatchedReply(uint32_t tidBits) const;
+	virtual CSRPStats *getStats()                       const { return &stats_;                           }
 };
 
 #endif
@@ -55,9 +55,47 @@ CSRPAsyncReadTransaction::CSRPAsyncReadTransaction(
 {
 }
 
+CSRPAsyncWriteTransaction::CSRPAsyncWriteTransaction(
+		const CAsyncIOTransactionKey &key)
+: CAsyncIOTransaction( key ),
+  CSRPWriteTransaction( 0, 0, 0 )
+{
+}
+
+// record the round-trip time (or the timeout) of an
+// asynchronous transaction
+static void
+asyncDone(const CAsyncIOTransactionNode *xact, const CSRPAddressImpl *srp, BufChain bc)
+{
+struct timespec now;
+
+	if ( ! bc ) {
+		srp->getStats()->incTimeouts();
+	} else if ( 0 == clock_gettime( CLOCK_MONOTONIC, &now ) ) {
+		srp->getStats()->recordRndTrip( ISRPStats::ASYNCHRONOUS, &now, &xact->getPosted().tv_ );
+	}
+}
+
+void
+CSRPAsyncReadTransaction::complete(BufChain bc)
+{
+	asyncDone( this, getSRP(), bc );
+	if ( bc )
+		CSRPReadTransaction::complete( bc );
+}
+
+void
+CSRPAsyncWriteTransaction::complete(BufChain bc)
+{
+	asyncDone( this, getSRP(), bc );
+	if ( bc )
+		CSRPWriteTransaction::complete( bc );
+}
+
 CSRPTransaction::CSRPTransaction(
 	const CSRPAddressImpl *srpAddr
 )
+: srp_( 0 )
 {
 	if ( srpAddr )
 		reset(srpAddr);
@@ -68,6 +106,7 @@ CSRPTransaction::reset(
 	const CSRPAddressImpl *srpAddr
 )
 {
+	srp_      = srpAddr;
 	tid_      = srpAddr->getTid();
 	doSwapV1_ = srpAddr->needsPayloadSwap();
 	doSwap_   = srpAddr->needsHdrSwap();
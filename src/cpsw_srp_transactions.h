@@ -26,6 +26,7 @@ typedef struct srp_iovec {
 
 class CSRPTransaction {
 private:
+	const CSRPAddressImpl *srp_;
 	uint32_t  tid_;
 	bool      doSwapV1_; // V1 sends payload in network byte order. We want to transform to restore
 	                     // the standard AXI layout which is little-endian
@@ -45,6 +46,11 @@ public:
 		return tid_;
 	}
 
+	virtual const CSRPAddressImpl *getSRP() const
+	{
+		return srp_;
+	}
+
 	virtual void complete(BufChain) = 0;
 
 	virtual ~CSRPTransaction()
@@ -87,6 +93,9 @@ public:
 
 };
 
+class CSRPAsyncWriteTransaction;
+typedef shared_ptr<CSRPAsyncWriteTransaction> SRPAsyncWriteTransaction;
+
 class CSRPAsyncReadTransaction;
 typedef shared_ptr<CSRPAsyncReadTransaction> SRPAsyncReadTransaction;
 
@@ -149,12 +158,22 @@ public:
 	CSRPAsyncReadTransaction(
 		const CAsyncIOTransactionKey &key);
 
-	virtual void complete(BufChain bc)
+	// if bc is NULL then a timeout occurred
+	virtual void complete(BufChain bc);
+
+	virtual AsyncIOTransaction getSelfAsAsyncIOTransaction()
 	{
-		// if bc is NULL then a timeout occurred and we don't do anything
-		if ( bc )
-			CSRPReadTransaction::complete(bc);
+		return getSelfAs<AsyncIOTransaction>();
 	}
+};
+
+class CSRPAsyncWriteTransaction : public CAsyncIOTransaction, public CSRPWriteTransaction {
+public:
+	CSRPAsyncWriteTransaction(
+		const CAsyncIOTransactionKey &key);
+
+	// if bc is NULL then a timeout occurred
+	virtual void complete(BufChain bc);
 
 	virtual AsyncIOTransaction getSelfAsAsyncIOTransaction()
 	{
@@ -100,6 +100,13 @@ public:
 		return scalValAdapt->setVal( TmpBuf<EL>::getBufp(), TmpBuf<EL>::getNelms(), r );
 	}
 
+	unsigned setVal(CScalVal_WOAdapt *scalValAdapt, AsyncIO aio, IndexRange *r, VL v)
+	{
+		for ( unsigned i = 0; i< TmpBuf<EL>::getNelms(); i++ )
+			(*this)[i] = (EL)v;
+		return scalValAdapt->setVal( aio, TmpBuf<EL>::getBufp(), TmpBuf<EL>::getNelms(), r );
+	}
+
 	unsigned getVal(CScalVal_ROAdapt *scalValAdapt, VL *v_p, IndexRange *r);
 	unsigned setVal(CScalVal_WOAdapt *scalValAdapt, IndexRange *r, VL *v_p);
 
@@ -938,6 +945,11 @@ ByteOrder          targetEndian = cl->getByteOrder();
 }
 
 unsigned IIntEntryAdapt::getVal(uint8_t *buf, unsigned nelms, unsigned elsz, SlicedPathIterator *it)
+{
+	return getVal( static_cast<IReadHook*>(NULL), buf, nelms, elsz, it );
+}
+
+unsigned IIntEntryAdapt::getVal(IReadHook *hook, uint8_t *buf, unsigned nelms, unsigned elsz, SlicedPathIterator *it)
 {
 Address            cl           = (*it)->c_p_;
 ByteOrder          targetEndian = cl->getByteOrder();
@@ -950,6 +962,7 @@ ByteOrder          targetEndian = cl->getByteOrder();
 
 	args.cacheable_ = ie_->getCacheable();
 	args.off_       = 0;
+	args.hook_      = hook;
 	ctxt.getReadParms( &args );
 
 #ifdef SVAL_DEBUG
@@ -1068,6 +1081,11 @@ unsigned           rval;
 }
 
 unsigned CScalVal_ROAdapt::getVal(CString *strs, unsigned nelms, IndexRange *range)
+{
+	return getVal( static_cast<IReadHook*>(NULL), strs, nelms, range );
+}
+
+unsigned CScalVal_ROAdapt::getVal(IReadHook *hook, CString *strs, unsigned nelms, IndexRange *range)
 {
 SlicedPathIterator it(p_, range);
 unsigned           rval;
@@ -1078,7 +1096,7 @@ unsigned           rval;
 
 	uint8_t *tmpBuf = ctxt.getTmpBuf();
 
-	rval = getVal( tmpBuf, nelms, ctxt.getElsz(), &it );
+	rval = getVal( hook, tmpBuf, nelms, ctxt.getElsz(), &it );
 
 	ctxt.callback( 0 );
 
@@ -1179,6 +1197,20 @@ static void prib(const char *pre, uint8_t *b)
 #endif
 
 unsigned IIntEntryAdapt::setVal(uint8_t *buf, unsigned nelms, unsigned elsz, IndexRange *range)
+{
+	return setVal( AsyncIO(), buf, nelms, elsz, range );
+}
+
+/* NOTE: the data are consumed (i.e., transformed into 'obuf' and/or copied into
+ *       the transport's buffers) before this routine returns, even if the
+ *       write is executed asynchronously. 'obuf' may live on the stack.
+ */
+unsigned IIntEntryAdapt::setVal(AsyncIO aio, uint8_t *buf, unsigned nelms, unsigned elsz, IndexRange *range)
+{
+	return setVal( static_cast<IWriteHook*>(NULL), aio, buf, nelms, elsz, range );
+}
+
+unsigned IIntEntryAdapt::setVal(IWriteHook *hook, AsyncIO aio, uint8_t *buf, unsigned nelms, unsigned elsz, IndexRange *range)
 {
 SlicedPathIterator   it( p_, range );
 Address          cl = it->c_p_;
@@ -1311,6 +1343,8 @@ uint8_t          mskn     = 0x00;
 	args.nbytes_    = dbytes;
 	args.msk1_      = msk1;
 	args.mskn_      = mskn;
+	args.aio_       = aio;
+	args.hook_      = hook;
 
 	cl->write( &it, &args );
 
@@ -1349,6 +1383,21 @@ VALS_BUF_DECL( const char*, const char *, vals, nelms);
 }
 
 unsigned CDoubleVal_WOAdapt::setVal(double *buf, unsigned nelms, IndexRange *range)
+{
+	return setVal( AsyncIO(), buf, nelms, range );
+}
+
+unsigned CDoubleVal_WOAdapt::setVal(AsyncIO aio, double *buf, unsigned nelms, IndexRange *range)
+{
+	return setVal( static_cast<IWriteHook*>(NULL), aio, buf, nelms, range );
+}
+
+unsigned CDoubleVal_WOAdapt::setVal(IWriteHook *hook, double *buf, unsigned nelms, IndexRange *range)
+{
+	return setVal( hook, AsyncIO(), buf, nelms, range );
+}
+
+unsigned CDoubleVal_WOAdapt::setVal(IWriteHook *hook, AsyncIO aio, double *buf, unsigned nelms, IndexRange *range)
 {
 unsigned rval;
 
@@ -1356,24 +1405,29 @@ unsigned rval;
 
 	if ( IScalVal_Base::IEEE_754 == getEncoding() ) {
 		if ( 64 == getSizeBits() ) {
-			rval = IIntEntryAdapt::setVal<double>( buf, nelms, range );
+			rval = IIntEntryAdapt::setVal<double>( hook, aio, buf, nelms, range );
 		} else {
 			TMP_BUF_DECL(float, tmpBuf, nelms );
 			for ( unsigned i=0; i<nelms; i++ ) {
 				tmpBuf[i] = (float)buf[i];
 			}
-			rval = IIntEntryAdapt::setVal<float>( tmpBuf.getBufp(), nelms, range );
+			rval = IIntEntryAdapt::setVal<float>( hook, aio, tmpBuf.getBufp(), nelms, range );
 		}
 	} else {
 		TMP_BUF_DECL(uint64_t, tmpBuf, nelms );
 		dbl2int( tmpBuf.getBufp(), buf, nelms );
-		rval = IIntEntryAdapt::setVal<uint64_t>( tmpBuf.getBufp(), nelms, range );
+		rval = IIntEntryAdapt::setVal<uint64_t>( hook, aio, tmpBuf.getBufp(), nelms, range );
 	}
 
 	return rval;
 }
 
 unsigned CDoubleVal_WOAdapt::setVal(double v, IndexRange *range)
+{
+	return setVal( AsyncIO(), v, range );
+}
+
+unsigned CDoubleVal_WOAdapt::setVal(AsyncIO aio, double v, IndexRange *range)
 {
 TMP_BUF_DECL(uint64_t, buf, nelmsFromIdx( range ) );
 uint64_t         lu;
@@ -1396,26 +1450,31 @@ uint64_t         lu;
 	for ( unsigned i = 0; i < buf.getNelms(); i++ ) {
 		buf[i] = lu;
 	}
-	return IIntEntryAdapt::setVal<uint64_t>( buf.getBufp(), buf.getNelms(), range );
+	return IIntEntryAdapt::setVal<uint64_t>( aio, buf.getBufp(), buf.getNelms(), range );
 }
 
 unsigned CScalVal_WOAdapt::setVal(uint64_t  v, IndexRange *r)
+{
+	return setVal( AsyncIO(), v, r );
+}
+
+unsigned CScalVal_WOAdapt::setVal(AsyncIO aio, uint64_t  v, IndexRange *r)
 {
 unsigned nelms = nelmsFromIdx(r);
 
 	// since writes may be collapsed at a lower layer we simply build an array here
 	if ( getSize() <= sizeof(uint8_t) ) {
 		VALS_BUF_DECL( uint8_t, uint64_t, vals, nelms );
-		return vals.setVal( this, r, v );
+		return vals.setVal( this, aio, r, v );
 	} else if ( getSize() <= sizeof(uint16_t) ) {
 		VALS_BUF_DECL( uint16_t, uint64_t, vals, nelms );
-		return vals.setVal( this, r, v );
+		return vals.setVal( this, aio, r, v );
 	} else if ( getSize() <= sizeof(uint32_t) ) {
 		VALS_BUF_DECL( uint32_t, uint64_t, vals, nelms );
-		return vals.setVal( this, r, v );
+		return vals.setVal( this, aio, r, v );
 	} else {
 		VALS_BUF_DECL( uint64_t, uint64_t, vals, nelms );
-		return vals.setVal( this, r, v );
+		return vals.setVal( this, aio, r, v );
 	}
 }
 
@@ -1424,8 +1483,28 @@ typedef union VU_ {
 	uint64_t u;
 } VU;
 
+// encode values and pass them to 'hook' rather than writing them
+static void
+setValHooked(ConstPath p, IWriteHook *hook, bool isFloat, VU *buf, unsigned nelms)
+{
+	if ( isFloat ) {
+		DoubleVal_WOAdapt val( cpsw::dynamic_pointer_cast<DoubleVal_WOAdapt::element_type>( IDoubleVal::create( p ) ) );
+		val->setVal( hook, &buf[0].d, nelms );
+	} else {
+		ScalVal_WOAdapt   val( cpsw::dynamic_pointer_cast<ScalVal_WOAdapt::element_type>  ( IScalVal::create( p ) ) );
+		val->setVal( hook, &buf[0].u, nelms );
+	}
+}
+
 uint64_t
 CIntEntryImpl::dumpMyConfigToYaml(Path p, YAML::Node &node) const
+{
+	return fetchMyConfigToYaml( p, node, 0 );
+}
+
+// synchronous reads if 'ctxt' is NULL
+uint64_t
+CIntEntryImpl::fetchMyConfigToYaml(Path p, YAML::Node &node, CConfigDumpCtxt *ctxt) const
 {
 	if ( IVal_Base::WO != getMode() ) {
 		ScalVal_Base bas( IScalVal_Base::create( p ) );
@@ -1441,9 +1520,28 @@ CIntEntryImpl::dumpMyConfigToYaml(Path p, YAML::Node &node) const
 		unsigned     got;
 		unsigned     i;
 
-		bool         isFloat;
+		bool         isFloat = (IScalVal_Base::IEEE_754 == getEncoding());
+
+		if ( ctxt && ctxt->isPrefetching() ) {
+			void    *buf;
+			AsyncIO  aio;
+			if ( isFloat ) {
+				DoubleVal_RO val( IDoubleVal_RO::create( p ) );
+				aio = ctxt->prefetch( this, nelms, val, &buf );
+				val->getVal( aio, (double*)buf, nelms, 0 );
+			} else {
+				ScalVal_RO val( IScalVal_RO::create( p ) );
+				aio = ctxt->prefetch( this, nelms, val, &buf );
+				val->getVal( aio, (uint64_t*)buf, nelms, 0 );
+			}
+			// YAML is produced during the second pass
+			node = YAML::Node( YAML::NodeType::Undefined );
+			return 0;
+		}
 
-		if ( (isFloat = (IScalVal_Base::IEEE_754 == getEncoding())) ) {
+		if ( ctxt && ctxt->fetch( this, nelms, &valBuf[0] ) ) {
+			got = nelms;
+		} else if ( isFloat ) {
 			DoubleVal_RO val( IDoubleVal_RO::create( p ) );
 			got = val->getVal( & valBuf[0].d, nelms, 0 );
 		} else {
@@ -1519,7 +1617,15 @@ CIntEntryImpl::dumpMyConfigToYaml(Path p, YAML::Node &node) const
 uint64_t
 CIntEntryImpl::loadMyConfigFromYaml(Path p, YAML::Node &n) const
 {
-unsigned nelms, i;
+	return postMyConfigFromYaml( p, n, 0 );
+}
+
+// synchronous writes if 'ctxt' is NULL
+uint64_t
+CIntEntryImpl::postMyConfigFromYaml(Path p, YAML::Node &n, CConfigLoadCtxt *ctxt) const
+{
+unsigned    nelms, i;
+IWriteHook *hook = ctxt ? ctxt->getWriteHook( p ) : NULL;
 
 	if ( IVal_Base::RO == getMode() ) {
 		throw ConfigurationError("Cannot load configuration into read-only ScalVal");
@@ -1557,8 +1663,8 @@ unsigned nelms, i;
 	bool isFloat = (IScalVal_Base::IEEE_754 == getEncoding());
 
 	if ( n.IsScalar() ) {
-		double   d;
-		uint64_t u;
+		double   d = 0.0;
+		uint64_t u = 0;
 		if ( isFloat ) {
 			d   = n.as<double>();
 		} else if ( enum_ ) {
@@ -1576,12 +1682,27 @@ unsigned nelms, i;
 		} else {
 			u = n.as<uint64_t>();
 		}
-		if ( isFloat ) {
+		if ( hook ) {
+			TMP_BUF_DECL(VU, valBuf, nelmsFromPath );
+			for ( i=0; i<nelmsFromPath; i++ ) {
+				if ( isFloat )
+					valBuf[i].d = d;
+				else
+					valBuf[i].u = u;
+			}
+			setValHooked( p, hook, isFloat, &valBuf[0], nelmsFromPath );
+		} else if ( isFloat ) {
 			DoubleVal val = IDoubleVal::create( p );
-			val->setVal( d );
+			if ( ctxt )
+				val->setVal( ctxt->post( p, n, val ), d );
+			else
+				val->setVal( d );
 		} else {
 			ScalVal val = IScalVal::create( p );
-			val->setVal( u );
+			if ( ctxt )
+				val->setVal( ctxt->post( p, n, val ), u );
+			else
+				val->setVal( u );
 		}
 		nelms = nelmsFromPath;
 	} else {
@@ -1609,12 +1730,20 @@ unsigned nelms, i;
 				valBuf[i].u = YAML::NodeFind(n,i).as<uint64_t>();
 			}
 		}
-		if ( isFloat ) {
+		if ( hook ) {
+			setValHooked( p, hook, isFloat, &valBuf[0], nelms );
+		} else if ( isFloat ) {
 			DoubleVal val = IDoubleVal::create( p );
-			val->setVal( &valBuf[0].d, nelms );
+			if ( ctxt )
+				val->setVal( ctxt->post( p, n, val ), &valBuf[0].d, nelms );
+			else
+				val->setVal( &valBuf[0].d, nelms );
 		} else {
 			ScalVal val = IScalVal::create( p );
-			val->setVal( &valBuf[0].u, nelms );
+			if ( ctxt )
+				val->setVal( ctxt->post( p, n, val ), &valBuf[0].u, nelms );
+			else
+				val->setVal( &valBuf[0].u, nelms );
 		}
 	}
 	return nelms;
@@ -127,7 +127,9 @@ public:
 	virtual void dumpYamlPart(YAML::Node &n) const;
 
 	virtual uint64_t dumpMyConfigToYaml(Path p, YAML::Node &n) const;
+	virtual uint64_t fetchMyConfigToYaml(Path p, YAML::Node &n, CConfigDumpCtxt *ctxt) const;
 	virtual uint64_t loadMyConfigFromYaml(Path p, YAML::Node &n) const;
+	virtual uint64_t postMyConfigFromYaml(Path p, YAML::Node &n, CConfigLoadCtxt *ctxt) const;
 
 	CIntEntryImpl(const CIntEntryImpl &orig, Key &k)
 	:CEntryImpl(orig, k),
@@ -192,6 +194,8 @@ protected:
 
 	virtual unsigned getVal(uint8_t  *, unsigned, unsigned, SlicedPathIterator *it);
 	virtual unsigned getVal(AsyncIO aio, uint8_t  *, unsigned, unsigned, SlicedPathIterator *it);
+	// elementary reads are routed to 'hook' (if non-NULL) instead of the transport
+	virtual unsigned getVal(IReadHook *hook, uint8_t  *, unsigned, unsigned, SlicedPathIterator *it);
 
 	template <typename E> unsigned getVal(E *e, unsigned nelms, IndexRange *r)
 	{
@@ -219,12 +223,25 @@ protected:
 	virtual unsigned checkNelms(unsigned nelms, SlicedPathIterator *it);
 
 	virtual unsigned setVal(uint8_t  *, unsigned, unsigned, IndexRange *r = 0);
+	virtual unsigned setVal(AsyncIO aio, uint8_t  *, unsigned, unsigned, IndexRange *r = 0);
+	// elementary writes are routed to 'hook' (if non-NULL) instead of the transport
+	virtual unsigned setVal(IWriteHook *hook, AsyncIO aio, uint8_t  *, unsigned, unsigned, IndexRange *r);
 
 	template <typename E> unsigned setVal(E *e, unsigned nelms, IndexRange *r)
 	{
 		return setVal( reinterpret_cast<uint8_t*>(e), nelms, sizeof(E), r );
 	}
 
+	template <typename E> unsigned setVal(AsyncIO aio, E *e, unsigned nelms, IndexRange *r)
+	{
+		return setVal(aio, reinterpret_cast<uint8_t*>(e), nelms, sizeof(E), r );
+	}
+
+	template <typename E> unsigned setVal(IWriteHook *hook, AsyncIO aio, E *e, unsigned nelms, IndexRange *r)
+	{
+		return setVal(hook, aio, reinterpret_cast<uint8_t*>(e), nelms, sizeof(E), r );
+	}
+
 };
 
 class CScalVal_ROAdapt : public virtual IScalVal_RO, public virtual IIntEntryAdapt {
@@ -274,6 +291,15 @@ public:
 	virtual unsigned getVal(CString  *p, unsigned n, IndexRange *r=0);
 	virtual unsigned getVal(AsyncIO aio, CString  *p, unsigned n, IndexRange *r=0);
 
+	// obtain the raw data from 'hook' (see CReadArgs) and decode them
+	virtual unsigned getVal(IReadHook *hook, uint64_t *p, unsigned n, IndexRange *r=0)
+	{
+	SlicedPathIterator it(p_, r);
+		return IIntEntryAdapt::getVal(hook, reinterpret_cast<uint8_t*>(p), n, sizeof(*p), &it);
+	}
+
+	virtual unsigned getVal(IReadHook *hook, CString  *p, unsigned n, IndexRange *r=0);
+
 protected:
 	using IIntEntryAdapt::getVal;
 };
@@ -313,10 +339,37 @@ public:
 		return IIntEntryAdapt::setVal<uint8_t> (p,n,r);
 	}
 
+	virtual unsigned setVal(AsyncIO aio, uint64_t *p, unsigned n, IndexRange *r=0)
+	{
+		return IIntEntryAdapt::setVal<uint64_t>(aio, p,n,r);
+	}
+
+	virtual unsigned setVal(AsyncIO aio, uint32_t *p, unsigned n, IndexRange *r=0)
+	{
+		return IIntEntryAdapt::setVal<uint32_t>(aio, p,n,r);
+	}
+
+	virtual unsigned setVal(AsyncIO aio, uint16_t *p, unsigned n, IndexRange *r=0)
+	{
+		return IIntEntryAdapt::setVal<uint16_t>(aio, p,n,r);
+	}
+
+	virtual unsigned setVal(AsyncIO aio, uint8_t  *p, unsigned n, IndexRange *r=0)
+	{
+		return IIntEntryAdapt::setVal<uint8_t> (aio, p,n,r);
+	}
+
+	// encode the values and pass the raw data to 'hook' (see CWriteArgs)
+	virtual unsigned setVal(IWriteHook *hook, uint64_t *p, unsigned n, IndexRange *r=0)
+	{
+		return IIntEntryAdapt::setVal<uint64_t>(hook, AsyncIO(), p,n,r);
+	}
+
 
 	virtual unsigned setVal(const char* *p, unsigned n, IndexRange *r=0);
 
 	virtual unsigned setVal(uint64_t     v, IndexRange *r=0);
+	virtual unsigned setVal(AsyncIO aio, uint64_t v, IndexRange *r=0);
 	virtual unsigned setVal(const char*  v, IndexRange *r=0);
 
 };
@@ -329,7 +382,15 @@ public:
 	virtual void     dbl2dbl(double *dst, unsigned n);
 
 	virtual unsigned setVal(double      *p, unsigned n, IndexRange *r=0);
+	virtual unsigned setVal(AsyncIO aio, double *p, unsigned n, IndexRange *r=0);
 	virtual unsigned setVal(double       v, IndexRange *r=0);
+	virtual unsigned setVal(AsyncIO aio, double v, IndexRange *r=0);
+
+	// encode the values and pass the raw data to 'hook' (see CWriteArgs)
+	virtual unsigned setVal(IWriteHook *hook, double *p, unsigned n, IndexRange *r=0);
+
+protected:
+	virtual unsigned setVal(IWriteHook *hook, AsyncIO aio, double *p, unsigned n, IndexRange *r);
 };
 
 
@@ -18,6 +18,7 @@
 #define YAML_KEY_MERGE  "<<"
 #define YAML_KEY_align  "align"
 #define YAML_KEY_at  "at"
+#define YAML_KEY_busyPollUS  "busyPollUS"
 #define YAML_KEY_byteOrder  "byteOrder"
 #define YAML_KEY_cacheable  "cacheable"
 #define YAML_KEY_children  "children"
@@ -33,7 +34,12 @@
 #define YAML_KEY_entry  "entry"
 #define YAML_KEY_enums  "enums"
 #define YAML_KEY_fileName "fileName"
+#define YAML_KEY_hedgeBudget  "hedgeBudget"
 #define YAML_KEY_instantiate  "instantiate"
+#define YAML_KEY_ioPool  "ioPool"
+#define YAML_KEY_ioPoolSize  "ioPoolSize"
+#define YAML_KEY_ioUring  "ioUring"
+#define YAML_KEY_shardedRx  "shardedRx"
 #define YAML_KEY_ipAddr  "ipAddr"
 #define YAML_KEY_isSigned  "isSigned"
 #define YAML_KEY_ldFragWinSize  "ldFragWinSize"
@@ -41,8 +47,11 @@
 #define YAML_KEY_ldMaxUnackedSegs "ldMaxUnackedSegs"
 #define YAML_KEY_lsBit  "lsBit"
 #define YAML_KEY_maxCumulativeAcks "maxCumulativeAcks"
+#define YAML_KEY_maxOutstanding "maxOutstanding"
 #define YAML_KEY_maxRetransmissions "maxRetransmissions"
 #define YAML_KEY_maxSegmentSize "maxSegmentSize"
+#define YAML_KEY_selectiveAck "selectiveAck"
+#define YAML_KEY_adaptiveRetransmissionTimeout "adaptiveRetransmissionTimeout"
 #define YAML_KEY_mode  "mode"
 #define YAML_KEY_name  "name"
 #define YAML_KEY_nelms  "nelms"
@@ -51,15 +60,20 @@
 #define YAML_KEY_offset  "offset"
 #define YAML_KEY_outQueueDepth  "outQueueDepth"
 #define YAML_KEY_inpQueueDepth  "inpQueueDepth"
+#define YAML_KEY_pipelineDepth "pipelineDepth"
 #define YAML_KEY_pollSecs  "pollSecs"
 #define YAML_KEY_port  "port"
 #define YAML_KEY_protocolVersion  "protocolVersion"
 #define YAML_KEY_retryCount  "retryCount"
 #define YAML_KEY_retransmissionTimeoutUS "retransmissionTimeoutUS"
 #define YAML_KEY_RSSI  "RSSI"
+#define YAML_KEY_rxBatchSize  "rxBatchSize"
 #define YAML_KEY_rssiBridge  "rssiBridge"
+#define YAML_KEY_runToCompletion  "runToCompletion"
 #define YAML_KEY_seekable  "seekable"
+#define YAML_KEY_segmentOffload  "segmentOffload"
 #define YAML_KEY_sequence  "sequence"
+#define YAML_KEY_shadowCache  "shadowCache"
 #define YAML_KEY_singleInterfaceOnly  "singleInterfaceOnly"
 #define YAML_KEY_size  "size"
 #define YAML_KEY_sizeBits  "sizeBits"
@@ -72,6 +86,8 @@
 #define YAML_KEY_TDESTMux  "TDESTMux"
 #define YAML_KEY_threadPriority "threadPriority"
 #define YAML_KEY_timeoutUS  "timeoutUS"
+#define YAML_KEY_txBatchSize  "txBatchSize"
+#define YAML_KEY_txBatchUS  "txBatchUS"
 #define YAML_KEY_UDP  "UDP"
 #define YAML_KEY_TCP  "TCP"
 #define YAML_KEY_value  "value"
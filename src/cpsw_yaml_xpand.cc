@@ -14,6 +14,9 @@
 #include <iostream>
 #include <yaml-cpp/yaml.h>
 
+#define __STDC_FORMAT_MACROS
+#include <inttypes.h>
+
 static void usage(const char *nm)
 {
 	fprintf(stderr,"usage: %s [-hc] [-C config_file] [-L config_file] -r root_node_name\n", nm);
@@ -21,6 +24,7 @@ static void usage(const char *nm)
 	fprintf(stderr,"           -c                   : config dump\n");
 	fprintf(stderr,"           -C <config_file>     : config dump from file\n");
 	fprintf(stderr,"           -L <config_file>     : config load from file\n");
+	fprintf(stderr,"           -P <plan_file>       : compile '-L' config into a plan file (no load)\n");
 	fprintf(stderr,"           -Y <yaml_file>       : load YAML definition from file\n");
 	fprintf(stderr,"           -r <root_node_name>  : node in input YAML file to use for the root node\n");
 	fprintf(stderr,"           -q                   : don't dump expanded YAML, just load.\n");
@@ -38,9 +42,10 @@ const char *confdnam = 0;
 const char *rootname = 0;
 const char *conflnam = 0;
 const char *defflnam = 0;
+const char *planfnam = 0;
 int            quiet = 0;
 int            track = 0;
-	while ( (opt = getopt(argc, argv, "hcC:r:L:Y:qt")) > 0 ) {
+	while ( (opt = getopt(argc, argv, "hcC:r:L:P:Y:qt")) > 0 ) {
 		switch ( opt ) {
 			case 'c':
 				cd = 1;
@@ -55,6 +60,10 @@ int            track = 0;
 				conflnam = optarg;
 			break;
 
+			case 'P':
+				planfnam = optarg;
+			break;
+
 			case 'h':
 				rval = 0;
 				// fall through
@@ -83,6 +92,10 @@ int            track = 0;
 		fprintf(stderr,"Need '-r root_node_name' option\n");
 		return 1;
 	}
+	if ( planfnam && ! conflnam ) {
+		fprintf(stderr,"Need '-L config_file' option to compile a plan\n");
+		return 1;
+	}
 	try {
 		setCPSWVerbosity( "yaml", track );
 		Dev r( defflnam ? IYamlSupport::buildHierarchy(defflnam, rootname) : IYamlSupport::buildHierarchy(std::cin, rootname) );
@@ -92,7 +105,14 @@ int            track = 0;
 			p = IYamlSupport::startHierarchy( r );
 		}
 
-		if ( conflnam ) {
+		if ( planfnam ) {
+			ConfigPlan plan( IConfigPlan::compileYamlFile( p, conflnam ) );
+			plan->save( planfnam );
+			if ( ! quiet ) {
+				printf("Plan: %" PRIu64 " values, %u writes (%" PRIu64 " bytes), %u levels\n",
+				       plan->getNumValues(), plan->getNumWrites(), plan->getNumBytes(), plan->getNumLevels());
+			}
+		} else if ( conflnam ) {
 			YAML::Node conf( YAML::LoadFile( conflnam ) );
 			p->loadConfigFromYaml( conf );
 		}
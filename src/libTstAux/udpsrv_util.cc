@@ -337,6 +337,7 @@ public:
 	virtual void     before(Buf)         { throw InternalError("Not Implemented"); }
 	virtual void     unlink()            { throw InternalError("Not Implemented"); }
 	virtual void     split()             { throw InternalError("Not Implemented"); }
+	virtual Buf      slice(size_t, size_t) { throw InternalError("Not Implemented"); }
 
 	virtual Buf      getNext()           { return Buf(); }
 	virtual Buf      getPrev()           { return Buf(); }
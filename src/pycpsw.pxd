@@ -48,6 +48,7 @@ cdef extern from "cpsw_api_user.h":
   cdef cppclass ICommand
   cdef cppclass IDoubleVal_RO
   cdef cppclass IDoubleVal
+  cdef cppclass ISRPStats
 
 ctypedef const IEntry            CIEntry
 ctypedef const IChild            CIChild
@@ -81,6 +82,7 @@ ctypedef shared_ptr[IStream]                 cc_Stream
 ctypedef shared_ptr[ICommand]                cc_Command
 ctypedef shared_ptr[IDoubleVal_RO]           cc_DoubleVal_RO
 ctypedef shared_ptr[IDoubleVal]              cc_DoubleVal
+ctypedef shared_ptr[ISRPStats]               cc_SRPStats
 
 cdef extern from "cpsw_python.h" namespace "cpsw_python":
   cdef void handleException()
@@ -102,6 +104,9 @@ cdef extern from "cpsw_python.h" namespace "cpsw_python":
   cdef PyObject * IDoubleVal_RO_getVal(IDoubleVal_RO *, int, int)                                  except+handleException
   cdef unsigned   IDoubleVal_setVal(IDoubleVal *, PyObject *, int, int)                            except+handleException
 
+  cdef PyObject * ISRPStats_getLatency(const ISRPStats *, int)                                     except+handleException
+  cdef string     ISRPStats_dumpYamlString(const ISRPStats *)                                      except+handleException
+
 cdef extern from "cpsw_api_user.h":
   cdef cppclass   iterator "Children::element_type::const_iterator":
     iterator     &operator++()           except+;
@@ -244,6 +249,19 @@ cdef extern from "cpsw_api_user.h":
     @staticmethod
     cc_DoubleVal create(cc_Path path)           except+handleException
 
+  cdef cppclass ISRPStats:
+    uint64_t     getRetries()                   except+handleException
+    uint64_t     getTimeouts()                  except+handleException
+    uint64_t     getLateReplies()               except+handleException
+    uint64_t     getTidMismatches()             except+handleException
+    uint64_t     getHedges()                    except+handleException
+    uint64_t     getHedgeWins()                 except+handleException
+    uint64_t     getHedgesThrottled()           except+handleException
+    unsigned     getVirtualChannel()            except+handleException
+    void         reset()                        except+handleException
+    @staticmethod
+    cc_SRPStats  create(cc_ConstPath path)      except+handleException
+
   cdef const char *c_getCPSWVersionString "getCPSWVersionString"()              except+handleException
   cdef int         c_setCPSWVerbosity     "setCPSWVerbosity"(const char *, int) except+handleException
 
@@ -264,6 +282,8 @@ cdef extern from "cpsw_cython.h" namespace "cpsw_python":
     cc_AsyncIO makeShared()                                          except+handleException
     unsigned   issueGetVal(IScalVal_RO*, int, int, bool, cc_AsyncIO) except+handleException
     unsigned   issueGetVal(IDoubleVal_RO *, int, int, cc_AsyncIO)    except+handleException
+    unsigned   issueSetVal(IScalVal*, PyObject *, int, int, cc_AsyncIO)   except+handleException
+    unsigned   issueSetVal(IDoubleVal*, PyObject *, int, int, cc_AsyncIO) except+handleException
 
   cdef c_Node wrap_IYamlFixup_findByName(const c_Node &, const char *, char) except+handleException
 
@@ -506,6 +506,16 @@ this case.
     """
     return IScalVal_setVal( self.wptr.get(), <PyObject*>values, fromIdx, toIdx )
 
+  def setValAsync(self, AsyncIO asyncIO, values, int fromIdx = -1, int toIdx = -1):
+    """
+Write values asynchronously (see 'setVal()' for the arguments). The
+values are consumed before this method returns. The callback is
+executed once the write has been acknowledged (the 'result' passed
+to the callback is 'None') or an error/timeout occurred.
+    """
+    cdef cc_AsyncIO aio = asyncIO.c_AsyncIO.makeShared()
+    return asyncIO.c_AsyncIO.issueSetVal( self.wptr.get(), <PyObject*>values, fromIdx, toIdx, aio );
+
   # Must use the 'p.cptr' (ConstPath) -- since we cannot rely on a non-const being passed!
   @staticmethod
   def create(Path p):
@@ -633,6 +643,13 @@ the single element at 'fromIdx' to be written.
     """
     return IDoubleVal_setVal( self.wptr.get(), <PyObject*>values, fromIdx, toIdx )
 
+  def setValAsync(self, AsyncIO asyncIO, values, int fromIdx = -1, int toIdx = -1):
+    """
+Write values asynchronously -- see 'ScalVal.setValAsync()'.
+    """
+    cdef cc_AsyncIO aio = asyncIO.c_AsyncIO.makeShared()
+    return asyncIO.c_AsyncIO.issueSetVal( self.wptr.get(), <PyObject*>values, fromIdx, toIdx, aio );
+
   # Must use the 'p.cptr' (ConstPath) -- since we cannot rely on a non-const being passed!
   @staticmethod
   def create(Path p):
@@ -761,6 +778,100 @@ NOTE: an InterfaceNotImplementedError exception is thrown if the endpoint does
     po.cmdptr  = static_pointer_cast[ICommand ,ICommand]( obj )
     return po
 
+cdef class SRPStats(NoInit):
+  """
+Round-trip time and error statistics of a SRP transport.
+
+Round-trip times of synchronous and asynchronous transactions
+are recorded in separate log-scale histograms (accurate to ~12%).
+  """
+
+  SYNCHRONOUS  = 0
+  ASYNCHRONOUS = 1
+
+  cdef cc_SRPStats ptr
+
+  def getLatency(self, int channel = 0):
+    """
+Return a dict with the number of samples ('count') and the average,
+median, 99th, 99.9th percentile and maximum round-trip time
+('avgUs', 'p50Us', 'p99Us', 'p999Us', 'maxUs') in micro-seconds
+of the SYNCHRONOUS or ASYNCHRONOUS channel.
+    """
+    po   = ISRPStats_getLatency( self.ptr.get(), channel )
+    rval = <object>po # acquires a ref!
+    Py_XDECREF( po )
+    return rval
+
+  def getRetries(self):
+    """
+Return the number of transactions which were re-sent.
+    """
+    return self.ptr.get().getRetries()
+
+  def getTimeouts(self):
+    """
+Return the number of operations which failed for lack of a reply.
+    """
+    return self.ptr.get().getTimeouts()
+
+  def getLateReplies(self):
+    """
+Return the number of replies which nobody was waiting for anymore.
+    """
+    return self.ptr.get().getLateReplies()
+
+  def getTidMismatches(self):
+    """
+Return the number of replies with a foreign transaction ID.
+    """
+    return self.ptr.get().getTidMismatches()
+
+  def getHedges(self):
+    """
+Return the number of reads which were re-issued speculatively.
+    """
+    return self.ptr.get().getHedges()
+
+  def getHedgeWins(self):
+    """
+Return the number of hedged reads answered by the speculative request.
+    """
+    return self.ptr.get().getHedgeWins()
+
+  def getHedgesThrottled(self):
+    """
+Return the number of reads not hedged because the budget was exhausted.
+    """
+    return self.ptr.get().getHedgesThrottled()
+
+  def getVirtualChannel(self):
+    """
+Return the virtual channel the transport talks to.
+    """
+    return self.ptr.get().getVirtualChannel()
+
+  def reset(self):
+    """
+Clear all histograms and counters.
+    """
+    self.ptr.get().reset()
+
+  def dumpYaml(self):
+    """
+Return all statistics as a string in YAML format.
+    """
+    return ISRPStats_dumpYamlString( self.ptr.get() )
+
+  @staticmethod
+  def create(Path p):
+    """
+Obtain the statistics of the SRP transport 'path' is routed through.
+    """
+    po     = SRPStats(priv__)
+    po.ptr = ISRPStats.create( p.cptr )
+    return po
+
 cdef cppclass CPathVisitor(IPathVisitor):
 
   bool visitPre(self,  cc_ConstPath p):
@@ -869,7 +980,7 @@ if recursion was skipped due to 'visitPre()' returning 'False'.
 
 cdef public class AsyncIO[type CpswPyWrapT_AsyncIO, object CpswPyWrapO_AsyncIO]:
   """
-Callback base class for asynchronous 'getVal' operations. Subclass
+Callback base class for asynchronous 'getVal'/'setVal' operations. Subclass
 must implement a
 
   callback(self, result, status)
@@ -877,6 +988,7 @@ must implement a
 member. This callback is passed the result of the asynchronous
 operation and 'None' if there was an exception caught. In this
 case the exception object is passed as 'status'.
+The result of an asynchronous 'setVal' operation is always 'None'.
   """
 
   cdef CAsyncIO c_AsyncIO
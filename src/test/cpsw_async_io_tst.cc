@@ -2,8 +2,17 @@
 #include <cpsw_async_io.h>
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <vector>
 
+#define NXACT 10000
+#define TID_LSB 8
 
+class TestFailed {};
+
+static std::vector<int> completed;
+static std::vector<int> timedOut;
+static int              replyId;   // id of the transaction the fake reply was meant for
 
 class MyCallback : public CAsyncIOTransaction {
 private:
@@ -28,29 +37,85 @@ public:
 void
 MyCallback::complete(BufChain rchn)
 {
-	printf("Callback (id %i)\n", id);
+	if ( rchn ) {
+		completed[id]++;
+		if ( replyId != id ) {
+			fprintf(stderr,"Transaction %d matched reply for %d\n", id, replyId);
+			throw TestFailed();
+		}
+	} else {
+		timedOut[id]++;
+	}
 }
 
 typedef shared_ptr< CAsyncIOTransactionPool<MyCallback> > Pool;
 
+static IAsyncIOTransactionManager::TID tidOf(int id)
+{
+	return (IAsyncIOTransactionManager::TID)id << TID_LSB;
+}
+
+static BufChain reply(int id)
+{
+	replyId = id;
+	return IBufChain::create();
+}
+
 int
 main(int argc, char **argv)
 {
-AsyncIOTransactionManager mgr = IAsyncIOTransactionManager::create();
+AsyncIOTransactionManager mgr = IAsyncIOTransactionManager::create( 1000000, 24 );
 Pool                     pool = cpsw::make_shared< CAsyncIOTransactionPool<MyCallback> >();
 int                       i;
 
-for ( i = 0; i<2; i++ ) {
-	mgr->post( pool->alloc()->setId(1), 1, AsyncIO() );
-	mgr->post( pool->alloc()->setId(2), 2, AsyncIO() );
-	mgr->post( pool->alloc()->setId(3), 3, AsyncIO() );
+	completed.resize( NXACT );
+	timedOut.resize ( NXACT );
 
-	mgr->complete(BufChain(), 2);
+	for ( i = 0; i < NXACT; i++ ) {
+		mgr->post( pool->alloc()->setId( i ), tidOf( i ), AsyncIO() );
+	}
 
-	sleep(2);
-}
+	// complete odd ones in reverse order
+	for ( i = NXACT - 1; i >= 0; i-- ) {
+		if ( (i & 1) && mgr->complete( reply( i ), tidOf( i ) ) ) {
+			fprintf(stderr,"Transaction %d not found\n", i);
+			throw TestFailed();
+		}
+	}
 
+	// already completed or never posted
+	if ( 0 == mgr->complete( reply( 1 ), tidOf( 1 ) ) || 0 == mgr->complete( reply( 0 ), tidOf( NXACT ) ) ) {
+		fprintf(stderr,"Unexpected match\n");
+		throw TestFailed();
+	}
+
+	// even ones time out
 	sleep(2);
 
+	for ( i = 0; i < NXACT; i++ ) {
+		if ( completed[i] != (i & 1) || timedOut[i] != !(i & 1) ) {
+			fprintf(stderr,"Transaction %d: completed %d, timed out %d\n", i, completed[i], timedOut[i]);
+			throw TestFailed();
+		}
+	}
+
+	// duplicate TIDs are matched oldest first
+	mgr->post( pool->alloc()->setId( 1 ), tidOf( 7 ), AsyncIO() );
+	mgr->post( pool->alloc()->setId( 3 ), tidOf( 7 ), AsyncIO() );
+	mgr->complete( reply( 1 ), tidOf( 7 ) );
+	mgr->complete( reply( 3 ), tidOf( 7 ) );
+	if ( completed[1] != 2 || completed[3] != 2 ) {
+		fprintf(stderr,"Duplicate TIDs not matched in order\n");
+		throw TestFailed();
+	}
+
+	mgr.reset();
+
 	printf("Alloced %d, Free %d\n", pool->getNumAlloced(), pool->getNumFree());
+	if ( pool->getNumAlloced() != pool->getNumFree() ) {
+		fprintf(stderr,"Transactions leaked\n");
+		throw TestFailed();
+	}
+	printf("Test PASSED\n");
+	return 0;
 }
@@ -339,6 +339,65 @@ try {
 		throw TestFailed("insert/extract (offset 55, buf NULL) FAILED");
 	}
 
+	ch0.reset();
+
+	// size classes
+	if (   IBuf::getBuf( IBuf::CAPA_MAX     )->getCapacity() != IBuf::getBuf( IBuf::CAPA_ETH_BIG )->getCapacity()
+		|| IBuf::getBuf( IBuf::CAPA_ETH_JUM )->getAvail()    <  IBuf::CAPA_ETH_JUM
+		|| IBuf::getBuf( IBuf::CAPA_SLAB    )->getAvail()    <  IBuf::CAPA_SLAB ) {
+		throw TestFailed("buffer size classes wrong");
+	}
+
+	// views of a slab
+	{
+	unsigned inUse = IBuf::numBufsInUse();
+	Buf      slab  = IBuf::getBuf( IBuf::CAPA_SLAB );
+	Buf      v0, v1, v2;
+
+		slab->setSize( 3000 );
+		for ( i=0; i<slab->getSize(); i++ )
+			slab->getPayload()[i] = (uint8_t)i;
+
+		v0 = slab->slice(    0, 1000 );
+		v1 = slab->slice( 1000, 1000 );
+		// view of a view
+		v2 = v1->slice( 500, 300 );
+
+		if (   v0->getSize() != 1000 || v1->getSize() != 1000 || v2->getSize() != 300
+		    || v0->getPayload() != slab->getPayload()
+		    || v1->getPayload() != slab->getPayload() + 1000
+		    || v2->getPayload() != slab->getPayload() + 1500
+		    || v1->getHeadroom() != 0 || v1->getAvail() != 0 )
+			throw TestFailed("slice geometry wrong");
+
+		try {
+			slab->slice( 2500, 1000 );
+			throw TestFailed("slice beyond payload not rejected");
+		} catch ( InvalidArgError & ) {
+			// expected
+		}
+
+		// views survive the slab
+		slab.reset();
+		ch0 = IBufChain::create();
+		ch0->addAtTail( v1 );
+		ch0->addAtTail( v2 );
+		v1.reset();
+		v2.reset();
+		uint8_t chk[1300];
+		if ( ch0->extract( chk, 0, sizeof(chk) ) != sizeof(chk) )
+			throw TestFailed("extract from views failed");
+		for ( i=0; i<sizeof(chk); i++ ) {
+			if ( chk[i] != (uint8_t)(i < 1000 ? 1000 + i : 1500 + i - 1000) )
+				throw TestFailed("view data mismatch");
+		}
+		ch0.reset();
+		v0.reset();
+
+		if ( IBuf::numBufsInUse() != inUse )
+			throw TestFailed("slab or views leaked");
+	}
+
 } catch ( CPSWError &e ) {
 	fprintf(stderr,"ERROR: %s\n", e.getInfo().c_str());
 	throw;
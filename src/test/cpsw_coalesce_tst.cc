@@ -0,0 +1,283 @@
+ //@C Copyright Notice
+ //@C ================
+ //@C This file is part of CPSW. It is subject to the license terms in the LICENSE.txt
+ //@C file found in the top-level directory of this distribution and at
+ //@C https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html.
+ //@C
+ //@C No part of CPSW, including this file, may be copied, modified, propagated, or
+ //@C distributed except according to the terms contained in the LICENSE.txt file.
+
+// Verify that accesses to array slices are merged into as few transport
+// operations as the cacheability and bit-merging rules permit (and that
+// the right data end up in the right place).
+//
+// The arrays live in a file (a file-backed MemDev child is the in-tree
+// transport which supports arrays at the address level); a hook counts
+// the elementary operations and forwards them to the transport.
+
+#include <cpsw_api_user.h>
+#include <cpsw_yaml_keydefs.h>
+#include <cpsw_address.h>
+#include <cpsw_sval.h>
+#include <cpsw_obj_cnt.h>
+#include <cpsw_tst_check.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include <fcntl.h>
+
+#define FILESZ 256
+#define FILL   0xaa
+
+class CCounter : public IReadHook, public IWriteHook {
+public:
+	unsigned ops_;
+	uint64_t off_;    // of the last operation
+	uint64_t nbytes_; // of the last operation
+
+	CCounter()
+	: ops_   ( 0 ),
+	  off_   ( 0 ),
+	  nbytes_( 0 )
+	{
+	}
+
+	virtual uint64_t read(const CAddressImpl *xprt, CReadArgs *args)
+	{
+		ops_++;
+		off_    = args->off_;
+		nbytes_ = args->nbytes_;
+		return xprt->read( args );
+	}
+
+	virtual uint64_t write(const CAddressImpl *xprt, CWriteArgs *args)
+	{
+		ops_++;
+		off_    = args->off_;
+		nbytes_ = args->nbytes_;
+		return xprt->write( args );
+	}
+};
+
+static const char *yamlFmt=
+"#schemaversion 3.0.0\n"
+"  root:\n"
+"    " YAML_KEY_class ":   MemDev\n"
+"    " YAML_KEY_size ":    256\n"
+"    " YAML_KEY_children ":\n"
+"%s"
+;
+
+// a 'FILESZ' file filled with 'FILL'
+static void mkFile(const char *fnam)
+{
+uint8_t buf[FILESZ];
+int     fd;
+
+	memset( buf, FILL, sizeof(buf) );
+	if ( (fd = open( fnam, O_RDWR | O_CREAT | O_TRUNC, 0644 )) < 0 ) {
+		throw TestFailed("unable to create file");
+	}
+	if ( sizeof(buf) != write( fd, buf, sizeof(buf) ) ) {
+		close( fd );
+		throw TestFailed("unable to fill file");
+	}
+	close( fd );
+}
+
+static void rdFile(const char *fnam, uint8_t *buf)
+{
+int fd;
+
+	if ( (fd = open( fnam, O_RDONLY )) < 0 ) {
+		throw TestFailed("unable to open file");
+	}
+	if ( FILESZ != read( fd, buf, FILESZ ) ) {
+		close( fd );
+		throw TestFailed("unable to read file");
+	}
+	close( fd );
+}
+
+// field 'name' attached to the MemDev and backed by 'fnam'
+static Path mkArr(const char *fnam, const char *name, unsigned sizeBits, unsigned nelms, const char *cacheable)
+{
+char child[1000];
+char yaml[2000];
+
+	mkFile( fnam );
+	snprintf(child, sizeof(child),
+		"      %s:\n"
+		"        " YAML_KEY_class ":     IntField\n"
+		"        " YAML_KEY_sizeBits ":  %u\n"
+		"        " YAML_KEY_cacheable ": %s\n"
+		"        " YAML_KEY_at ":\n"
+		"          " YAML_KEY_fileName ":  %s\n"
+		"          " YAML_KEY_nelms ":     %u\n"
+		"          " YAML_KEY_byteOrder ": LE\n",
+		name, sizeBits, cacheable, fnam, nelms);
+	snprintf(yaml, sizeof(yaml), yamlFmt, child);
+	return IPath::loadYamlStream( yaml );
+}
+
+// MMIODev with array 'name' (at offset 0) attached to the MemDev and backed by 'fnam'
+static Path mkMMIO(const char *fnam, const char *name, unsigned nelms, unsigned stride)
+{
+char child[1000];
+char yaml[2000];
+
+	mkFile( fnam );
+	snprintf(child, sizeof(child),
+		"      mmio:\n"
+		"        " YAML_KEY_class ":     MMIODev\n"
+		"        " YAML_KEY_size ":      %u\n"
+		"        " YAML_KEY_byteOrder ": LE\n"
+		"        " YAML_KEY_at ":\n"
+		"          " YAML_KEY_fileName ":  %s\n"
+		"        " YAML_KEY_children ":\n"
+		"          %s:\n"
+		"            " YAML_KEY_class ":     IntField\n"
+		"            " YAML_KEY_sizeBits ":  32\n"
+		"            " YAML_KEY_cacheable ": WB_CACHEABLE\n"
+		"            " YAML_KEY_at ":\n"
+		"              " YAML_KEY_offset ":  0\n"
+		"              " YAML_KEY_nelms ":   %u\n"
+		"              " YAML_KEY_stride ":  %u\n",
+		FILESZ, fnam, name, nelms, stride);
+	snprintf(yaml, sizeof(yaml), yamlFmt, child);
+	return IPath::loadYamlStream( yaml );
+}
+
+static ScalValAdapt adapt(ScalVal v)
+{
+ScalValAdapt a = cpsw::dynamic_pointer_cast<ScalValAdapt::element_type>( v );
+	if ( ! a )
+		throw TestFailed("unexpected ScalVal implementation");
+	return a;
+}
+
+static uint64_t le(const uint8_t *p, unsigned nbytes)
+{
+uint64_t v = 0;
+	while ( nbytes-- > 0 )
+		v = (v << 8) | p[nbytes];
+	return v;
+}
+
+// write elements [f..t] (value: 0x100 + index), read them back, verify
+// the operation counts and the file contents. Bytes outside of
+// the elements must retain 'FILL', as must the bits of an element
+// which are not covered by the field.
+static void test(const char *fnam, Path p, unsigned f, unsigned t, unsigned stride, unsigned sizeBits,
+                 unsigned expWrites, unsigned expReads)
+{
+ScalVal               v = IScalVal::create( p );
+unsigned              n = t - f + 1;
+unsigned              eb = (sizeBits + 7) / 8;
+uint64_t              msk = (1ULL << sizeBits) - 1;
+IndexRange            rng( f, t );
+CCounter              wr, rd;
+std::vector<uint64_t> vals( n );
+uint8_t               buf[FILESZ];
+unsigned              i, j;
+
+	for ( i = 0; i < n; i++ )
+		vals[i] = (0x100 + f + i) & msk;
+
+	adapt( v )->setVal( &wr, &vals[0], n, &rng );
+	chk("write operations", wr.ops_, expWrites);
+	if ( 1 == expWrites ) {
+		chk("merged write offset", wr.off_,    f * stride);
+		chk("merged write size",   wr.nbytes_, n * eb);
+	}
+
+	for ( i = 0; i < n; i++ )
+		vals[i] = 0;
+	adapt( v )->getVal( &rd, &vals[0], n, &rng );
+	chk("read operations", rd.ops_, expReads);
+	if ( 1 == expReads ) {
+		chk("merged read offset", rd.off_,    f * stride);
+		chk("merged read size",   rd.nbytes_, n * eb);
+	}
+	for ( i = 0; i < n; i++ )
+		chk("readback", vals[i], (0x100 + f + i) & msk);
+
+	rdFile( fnam, buf );
+	for ( i = 0; i < FILESZ; i += stride ) {
+		unsigned idx = i / stride;
+		if ( idx >= f && idx <= t && i + eb <= FILESZ ) {
+			uint64_t fill = le( buf + i, eb ) & ~msk;
+			chk("element in file",   le( buf + i, eb ) & msk, (0x100 + idx) & msk);
+			chk("unmerged bits",     fill, 0xaaaaaaaaaaaaaaaaULL & ~msk & ((1ULL << (8*eb)) - 1));
+			j = eb;
+		} else {
+			j = 0;
+		}
+		for ( ; j < stride && i + j < FILESZ; j++ ) {
+			chk("untouched byte", buf[i + j], FILL);
+		}
+	}
+}
+
+int main(int argc, char **argv)
+{
+std::string fnam = std::string( argv[0] ) + "_coalesce.bin";
+const char *fn   = fnam.c_str();
+
+try {
+	{
+	// contiguous slice of a cacheable array: one operation each
+	Path p = mkArr( fn, "arr", 32, 16, "WB_CACHEABLE" );
+		test( fn, p->findByName("arr"),  3, 10, 4, 32,  1, 1 );
+	}
+	{
+	// entire array
+	Path p = mkArr( fn, "arr", 32, 16, "WB_CACHEABLE" );
+		test( fn, p->findByName("arr"),  0, 15, 4, 32,  1, 1 );
+	}
+	{
+	// write-through: reads are merged but writes are not
+	Path p = mkArr( fn, "arr", 32, 16, "WT_CACHEABLE" );
+		test( fn, p->findByName("arr"),  2,  9, 4, 32,  8, 1 );
+	}
+	{
+	// not cacheable: element by element
+	Path p = mkArr( fn, "arr", 32,  8, "NOT_CACHEABLE" );
+		test( fn, p->findByName("arr"),  1,  6, 4, 32,  6, 6 );
+	}
+	{
+	// bits must be merged into every element: writes are not merged
+	Path p = mkArr( fn, "bits", 12,  8, "WB_CACHEABLE" );
+		test( fn, p->findByName("bits"), 2,  7, 2, 12,  6, 1 );
+	}
+	{
+	// strided array: element by element
+	Path p = mkMMIO( fn, "strided", 16, 8 );
+		test( fn, p->findByName("mmio/strided"), 4, 11, 8, 32,  8, 8 );
+	}
+	{
+	// dense array in a MMIODev: merged by the MMIODev
+	Path p = mkMMIO( fn, "dense", 16, 4 );
+		test( fn, p->findByName("mmio/dense"),   4, 11, 4, 32,  1, 1 );
+	}
+
+	unlink( fn );
+
+} catch (TestFailed &e) {
+	fprintf(stderr, "Test FAILED: %s\n", e.msg_.c_str());
+	throw;
+} catch (CPSWError &e) {
+	fprintf(stderr, "CPSW Error caught: %s\n", e.getInfo().c_str());
+	throw;
+}
+
+	if ( CpswObjCounter::report(stderr, true) ) {
+		throw TestFailed("Unexpected object count");
+	}
+
+	printf("Test PASSED\n");
+
+	return 0;
+}
@@ -0,0 +1,187 @@
+ //@C Copyright Notice
+ //@C ================
+ //@C This file is part of CPSW. It is subject to the license terms in the LICENSE.txt
+ //@C file found in the top-level directory of this distribution and at
+ //@C https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html.
+ //@C
+ //@C No part of CPSW, including this file, may be copied, modified, propagated, or
+ //@C distributed except according to the terms contained in the LICENSE.txt file.
+
+#include <cpsw_api_user.h>
+#include <cpsw_yaml_keydefs.h>
+#include <cpsw_mem_dev.h>
+#include <cpsw_obj_cnt.h>
+#include <cpsw_tst_check.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <unistd.h>
+#include <yaml-cpp/yaml.h>
+#define __STDC_FORMAT_MACROS
+#include <inttypes.h>
+
+static const char *yamlFmt=
+"#schemaversion 3.0.0\n"
+"  root:\n"
+"    " YAML_KEY_class ":   MemDev\n"
+"    " YAML_KEY_size ":      1024\n"
+"    " YAML_KEY_children ":\n"
+"      mmio:\n"
+"        " YAML_KEY_class ":     MMIODev\n"
+"        " YAML_KEY_size ":      1024\n"
+"        " YAML_KEY_cacheable ": WB_CACHEABLE\n"
+"        " YAML_KEY_at ":\n"
+"          " YAML_KEY_nelms ": 1\n"
+"        " YAML_KEY_children ":\n"
+"          a0:\n"
+"            " YAML_KEY_class ":    IntField\n"
+"            " YAML_KEY_sizeBits ": 32\n"
+"            " YAML_KEY_at ":\n"
+"              " YAML_KEY_offset ": 0\n"
+"          a1:\n"
+"            " YAML_KEY_class ":    IntField\n"
+"            " YAML_KEY_sizeBits ": 32\n"
+"            " YAML_KEY_at ":\n"
+"              " YAML_KEY_offset ": 4\n"
+"          bits:\n"
+"            " YAML_KEY_class ":    IntField\n"
+"            " YAML_KEY_sizeBits ": 4\n"
+"            " YAML_KEY_lsBit ":    4\n"
+"            " YAML_KEY_at ":\n"
+"              " YAML_KEY_offset ": 8\n"
+"          arr:\n"
+"            " YAML_KEY_class ":    IntField\n"
+"            " YAML_KEY_sizeBits ": 32\n"
+"            " YAML_KEY_at ":\n"
+"              " YAML_KEY_offset ": 0x10\n"
+"              " YAML_KEY_nelms ":  4\n"
+"          dbl:\n"
+"            " YAML_KEY_class ":    IntField\n"
+"            " YAML_KEY_sizeBits ": 64\n"
+"            " YAML_KEY_encoding ": IEEE_754\n"
+"            " YAML_KEY_at ":\n"
+"              " YAML_KEY_offset ": 0x20\n"
+"          late:\n"
+"            " YAML_KEY_class ":      IntField\n"
+"            " YAML_KEY_sizeBits ":   32\n"
+"            " YAML_KEY_configPrio ": 2\n"
+"            " YAML_KEY_at ":\n"
+"              " YAML_KEY_offset ": %s\n"
+;
+
+static const char *config =
+"- mmio:\n"
+"  - a0:   0x11111111\n"
+"  - a1:   0x22222222\n"
+"  - bits: 0xa\n"
+"  - arr:  [ 1, 2, 3, 4 ]\n"
+"  - dbl:  8.5\n"
+"  - late: 0x33333333\n"
+;
+
+static Path mkHierarchy(const char *lateOff, uint8_t **bufp)
+{
+char yaml[4000];
+
+	snprintf(yaml, sizeof(yaml), yamlFmt, lateOff);
+
+	Path top = IPath::loadYamlStream( yaml );
+
+	ConstMemDevImpl mem = cpsw::dynamic_pointer_cast<ConstMemDevImpl::element_type>( top->origin() );
+
+	*bufp = mem->getBufp();
+	memset( *bufp, 0, mem->getSize() );
+	// 'bits' must not clobber the lower nibble
+	(*bufp)[8] = 0x05;
+
+	return top;
+}
+
+static uint64_t rd(Path top, const char *name, unsigned idx = 0)
+{
+uint64_t   v[4];
+ScalVal_RO val = IScalVal_RO::create( top->findByName( name ) );
+	val->getVal( v, val->getNelms() );
+	return v[idx];
+}
+
+static void verify(Path top, uint8_t *bufp)
+{
+double d;
+
+	chk("a0",       rd(top, "mmio/a0"),      0x11111111);
+	chk("a1",       rd(top, "mmio/a1"),      0x22222222);
+	chk("bits",     rd(top, "mmio/bits"),    0xa);
+	chk("raw bits", bufp[8],                 0xa5);
+	for ( unsigned i = 0; i < 4; i++ )
+		chk("arr",  rd(top, "mmio/arr", i),  i + 1);
+	IDoubleVal_RO::create( top->findByName("mmio/dbl") )->getVal( &d );
+	chk("dbl",      d == 8.5,                1);
+	chk("late",     rd(top, "mmio/late"),    0x33333333);
+}
+
+int main(int argc, char **argv)
+{
+uint8_t    *bufp;
+std::string fnam = std::string( argv[0] ) + "_plan.bin";
+
+try {
+	{
+	Path       top  = mkHierarchy( "0x40", &bufp );
+	YAML::Node conf = YAML::Load( config );
+	ConfigPlan plan = IConfigPlan::compile( top, conf );
+
+		// nothing must be written while compiling
+		chk("memory after compile", bufp[0], 0);
+
+		chk("values", plan->getNumValues(), 9);
+		chk("levels", plan->getNumLevels(), 2);
+		// a0+a1, bits, arr+dbl, late
+		chk("writes", plan->getNumWrites(), 4);
+		chk("bytes",  plan->getNumBytes(),  8 + 1 + 16 + 8 + 4);
+
+		chk("values applied", plan->apply(), 9);
+		verify( top, bufp );
+
+		unlink( fnam.c_str() );
+		plan->save( fnam.c_str() );
+	}
+
+	{
+	// an identical hierarchy
+	Path       top  = mkHierarchy( "0x40", &bufp );
+	ConfigPlan plan = IConfigPlan::load( top->origin(), fnam.c_str() );
+
+		chk("writes (loaded)", plan->getNumWrites(), 4);
+		plan->apply();
+		verify( top, bufp );
+	}
+
+	{
+	// a different hierarchy
+	Path       top  = mkHierarchy( "0x44", &bufp );
+		try {
+			IConfigPlan::load( top->origin(), fnam.c_str() );
+			throw TestFailed("plan loaded into a different hierarchy");
+		} catch ( InvalidArgError & ) {
+			// expected
+		}
+	}
+
+	unlink( fnam.c_str() );
+
+} catch (TestFailed &e) {
+	fprintf(stderr, "Test FAILED: %s\n", e.msg_.c_str());
+	throw;
+} catch (CPSWError &e) {
+	fprintf(stderr, "CPSW Error caught: %s\n", e.getInfo().c_str());
+	throw;
+}
+
+	if ( CpswObjCounter::report(stderr, true) ) {
+		throw TestFailed("Unexpected object count");
+	}
+
+	printf("Test PASSED\n");
+	return 0;
+}
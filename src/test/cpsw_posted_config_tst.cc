@@ -0,0 +1,166 @@
+ //@C Copyright Notice
+ //@C ================
+ //@C This file is part of CPSW. It is subject to the license terms in the LICENSE.txt
+ //@C file found in the top-level directory of this distribution and at
+ //@C https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html.
+ //@C
+ //@C No part of CPSW, including this file, may be copied, modified, propagated, or
+ //@C distributed except according to the terms contained in the LICENSE.txt file.
+
+// Load a nested configuration with entries of different priority
+// using posted writes and verify that the order of priorities is
+// kept across levels of the hierarchy.
+//
+// The same memory (of udpsrv) is reached via two different transports
+// which are served by different threads; 'late' (priority 2) is the
+// last entry in the subtree of 'a'. 'y' (priority 1) follows in the
+// subtree of 'b' and writes the last element of 'late'. Unless the
+// loader waits for 'late' to complete, 'y' may be overwritten by 'late'.
+
+#include <cpsw_api_user.h>
+#include <cpsw_yaml_keydefs.h>
+#include <cpsw_obj_cnt.h>
+#include <cpsw_tst_check.h>
+#include <stdio.h>
+#include <string.h>
+#include <getopt.h>
+#include <vector>
+#include <yaml-cpp/yaml.h>
+
+#include <udpsrv_regdefs.h>
+
+#define REGS_OFF  0x40000
+#define NELMS     2048
+#define NLOADS    20
+
+static const char *yamlFmt=
+"#schemaversion 3.0.0\n"
+"  root:\n"
+"    " YAML_KEY_class ":   NetIODev\n"
+"    " YAML_KEY_ipAddr ":  \"%s\"\n"
+"    " YAML_KEY_children ":\n"
+"      a:\n"
+"        " YAML_KEY_class ":   MMIODev\n"
+"        " YAML_KEY_size ":    %u\n"
+"        " YAML_KEY_at ":\n"
+"          " YAML_KEY_SRP ":\n"
+"            " YAML_KEY_protocolVersion ": SRP_UDP_V2\n"
+"          " YAML_KEY_RSSI ": ~\n"
+"          " YAML_KEY_UDP ":\n"
+"            " YAML_KEY_port ": %u\n"
+"        " YAML_KEY_children ":\n"
+"          regs:\n"
+"            " YAML_KEY_class ":   MMIODev\n"
+"            " YAML_KEY_size ":    0x4000\n"
+"            " YAML_KEY_at ":\n"
+"              " YAML_KEY_offset ": %u\n"
+"            " YAML_KEY_children ":\n"
+"              early:\n"
+"                " YAML_KEY_class ":    IntField\n"
+"                " YAML_KEY_sizeBits ": 32\n"
+"                " YAML_KEY_at ":\n"
+"                  " YAML_KEY_offset ": 0x2000\n"
+"              late:\n"
+"                " YAML_KEY_class ":      IntField\n"
+"                " YAML_KEY_sizeBits ":   32\n"
+"                " YAML_KEY_configPrio ": 2\n"
+"                " YAML_KEY_at ":\n"
+"                  " YAML_KEY_offset ":   0\n"
+"                  " YAML_KEY_nelms ":    %u\n"
+"      b:\n"
+"        " YAML_KEY_class ":   MMIODev\n"
+"        " YAML_KEY_size ":    %u\n"
+"        " YAML_KEY_at ":\n"
+"          " YAML_KEY_SRP ":\n"
+"            " YAML_KEY_protocolVersion ": SRP_UDP_V3\n"
+"          " YAML_KEY_RSSI ": ~\n"
+"          " YAML_KEY_UDP ":\n"
+"            " YAML_KEY_port ": %u\n"
+"        " YAML_KEY_children ":\n"
+"          regs:\n"
+"            " YAML_KEY_class ":   MMIODev\n"
+"            " YAML_KEY_size ":    0x4000\n"
+"            " YAML_KEY_at ":\n"
+"              " YAML_KEY_offset ": %u\n"
+"            " YAML_KEY_children ":\n"
+"              y:\n"
+"                " YAML_KEY_class ":    IntField\n"
+"                " YAML_KEY_sizeBits ": 32\n"
+"                " YAML_KEY_at ":\n"
+"                  " YAML_KEY_offset ": %u\n"
+;
+
+static const char *configFmt =
+"- a:\n"
+"  - regs:\n"
+"    - early: %u\n"
+"    - late:  %u\n"
+"- b:\n"
+"  - regs:\n"
+"    - y:     %u\n"
+;
+
+int
+main(int argc, char **argv)
+{
+const char *ip_addr = "127.0.0.1";
+unsigned    portA   = 8202; // SRP V2 over RSSI
+unsigned    portB   = 8188; // SRP V3 over RSSI
+int         opt;
+unsigned    i, ld;
+char        yaml[8000];
+char        conf[1000];
+
+	while ( (opt = getopt(argc, argv, "a:")) > 0 ) {
+		switch ( opt ) {
+			case 'a': ip_addr = optarg; break;
+			default:
+				fprintf(stderr,"usage: %s [-a <ip_addr>]\n", argv[0]);
+				return 1;
+		}
+	}
+
+	snprintf(yaml, sizeof(yaml), yamlFmt, ip_addr,
+		MEM_SIZE, portA, REGS_OFF, NELMS,
+		MEM_SIZE, portB, REGS_OFF, (NELMS - 1) * 4);
+
+	try {
+		Path                  top   = IPath::loadYamlStream( yaml );
+		ScalVal_RO            early = IScalVal_RO::create( top->findByName("a/regs/early") );
+		ScalVal_RO            late  = IScalVal_RO::create( top->findByName("a/regs/late")  );
+		ScalVal_RO            y     = IScalVal_RO::create( top->findByName("b/regs/y")     );
+		std::vector<uint64_t> vals( NELMS );
+		uint64_t              v;
+
+		// posted writes are not retried; make sure both
+		// RSSI connections are up before loading.
+		early->getVal( &v );
+		y->getVal( &v );
+
+		for ( ld = 0; ld < NLOADS; ld++ ) {
+			snprintf(conf, sizeof(conf), configFmt, 0x1000 + ld, 0x2000 + ld, 0x3000 + ld);
+			YAML::Node config = YAML::Load( conf );
+
+			chk("values loaded", top->loadConfigFromYaml( config, true ), 2 + NELMS);
+
+			early->getVal( &v );
+			chk("early", v, 0x1000 + ld);
+			late->getVal( &vals[0], NELMS );
+			for ( i = 0; i < NELMS - 1; i++ ) {
+				chk("late", vals[i], 0x2000 + ld);
+			}
+			// 'y' is loaded after 'late'
+			chk("y (overlaps late's last element)", vals[NELMS - 1], 0x3000 + ld);
+		}
+	} catch ( CPSWError &e ) {
+		fprintf(stderr,"CPSW Error caught: %s\n", e.getInfo().c_str());
+		throw;
+	}
+
+	if ( CpswObjCounter::report(stderr) ) {
+		printf("Leaked Objects!\n");
+		throw TestFailed();
+	}
+	printf("Test PASSED\n");
+	return 0;
+}
@@ -0,0 +1,166 @@
+ //@C Copyright Notice
+ //@C ================
+ //@C This file is part of CPSW. It is subject to the license terms in the LICENSE.txt
+ //@C file found in the top-level directory of this distribution and at
+ //@C https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html.
+ //@C
+ //@C No part of CPSW, including this file, may be copied, modified, propagated, or
+ //@C distributed except according to the terms contained in the LICENSE.txt file.
+
+#include <cpsw_api_builder.h>
+#include <string.h>
+#include <stdio.h>
+#include <getopt.h>
+
+#include <udpsrv_regdefs.h>
+
+#include <cpsw_obj_cnt.h>
+#include <cpsw_tst_check.h>
+
+#define __STDC_FORMAT_MACROS
+#include <inttypes.h>
+
+#define REGS_OFF 0x2000
+
+static uint64_t rd(ScalVal_RO v)
+{
+uint64_t val;
+	v->getVal( &val );
+	return val;
+}
+
+static uint64_t rdRaw(ScalVal_RO raw, unsigned idx)
+{
+uint32_t buf[4];
+	raw->getVal( buf, sizeof(buf)/sizeof(buf[0]) );
+	return buf[idx];
+}
+
+int
+main(int argc, char **argv)
+{
+const char *ip_addr = "127.0.0.1";
+unsigned    port    = 8192;
+int         opt;
+uint64_t    misses;
+uint32_t    zeros[4] = { 0, 0, 0, 0 };
+
+	while ( (opt = getopt(argc, argv, "p:a:")) > 0 ) {
+		switch ( opt ) {
+			case 'a': ip_addr = optarg; break;
+			case 'p':
+				if ( 1 != sscanf(optarg, "%i", &port) ) {
+					fprintf(stderr,"ERROR: Unable to scan value for option '-%c'\n", opt);
+					return 1;
+				}
+				break;
+			default:
+				fprintf(stderr,"usage: %s [-a <ip_addr>] [-p <port>]\n", argv[0]);
+				return 1;
+		}
+	}
+
+	{
+	NetIODev root;
+	Dev      top;
+	try {
+		{
+		        root   = INetIODev::create("netio", ip_addr);
+		MMIODev mmio   = IMMIODev::create ("mmio",  MEM_SIZE);
+		MMIODev regs   = IMMIODev::create ("regs",  16, LE);
+		IntField f;
+
+		// inherits WB_CACHEABLE from the container
+		regs->addAtAddress( IIntField::create("wb",   32, false, 0), 0 );
+		regs->addAtAddress( IIntField::create("bits",  8, false, 4), 4 );
+		f = IIntField::create("wt",  32, false, 0);
+		f->setCacheable( IField::WT_CACHEABLE );
+		regs->addAtAddress( f, 8 );
+		// direct view of the device
+		f = IIntField::create("raw", 32, false, 0);
+		f->setCacheable( IField::NOT_CACHEABLE );
+		regs->addAtAddress( f, 0, 4 );
+
+		mmio->addAtAddress( regs, REGS_OFF );
+
+		ProtoStackBuilder pbldr( IProtoStackBuilder::create() );
+
+		pbldr->setSRPVersion( IProtoStackBuilder::SRP_UDP_V2 );
+		pbldr->setUdpPort   (                           port );
+		pbldr->useSRPShadowCache(                       true );
+
+		root->addAtAddress( mmio, pbldr );
+
+		// the transport is not at the end of paths from 'top'
+		        top    = IDev::create("top");
+		top->addAtAddress( root );
+		}
+
+		Path        p     = top->findByName("netio/mmio/regs");
+		ScalVal     wb    = IScalVal::create( p->findByName("wb")   );
+		ScalVal     bits  = IScalVal::create( p->findByName("bits") );
+		ScalVal     wt    = IScalVal::create( p->findByName("wt")   );
+		ScalVal     raw   = IScalVal::create( p->findByName("raw")  );
+		ShadowCache cache = IShadowCache::create( p );
+
+		raw->setVal( zeros, sizeof(zeros)/sizeof(zeros[0]) );
+
+		// write-back: the device is not touched until we flush
+		wb->setVal( 0x12345678 );
+		chk("dirty bytes after WB write",     cache->getDirty(), 4);
+		chk("dirty bytes (path from NetIODev)", IShadowCache::create( root->findByName("mmio/regs/wb") )->getDirty(), 4);
+		chk("device after WB write",          rdRaw(raw, 0), 0);
+		chk("WB readback",                    rd(wb), 0x12345678);
+		chk("hits after WB readback",         cache->getHits(), 1);
+		chk("bytes flushed",                  cache->flush(), 4);
+		chk("dirty bytes after flush",        cache->getDirty(), 0);
+		chk("device after flush",             rdRaw(raw, 0), 0x12345678);
+
+		// the first bit-field write must read the device (the
+		// byte is not cached yet) and is thus written through.
+		bits->setVal( 0xab );
+		chk("device after 1st bit-field write", rdRaw(raw, 1), 0xab0);
+		misses = cache->getMisses();
+		bits->setVal( 0xcd );
+		chk("misses during 2nd bit-field write", cache->getMisses(), misses);
+		chk("device after 2nd bit-field write", rdRaw(raw, 1), 0xab0);
+		chk("bit-field readback",               rd(bits), 0xcd);
+		cache->flush();
+		chk("device after bit-field flush",     rdRaw(raw, 1), 0xcd0);
+
+		// write-through
+		wt->setVal( 0xdeadbeef );
+		chk("device after WT write",          rdRaw(raw, 2), 0xdeadbeef);
+		chk("dirty bytes after WT write",     cache->getDirty(), 0);
+		misses = cache->getMisses();
+		chk("WT readback",                    rd(wt), 0xdeadbeef);
+		chk("misses after WT readback",       cache->getMisses(), misses);
+
+		// refill after invalidation; asynchronously
+		cache->invalidate();
+		raw->setVal( 0xcafe );
+		misses = cache->getMisses();
+		{
+		uint64_t val = 0;
+		TstAIO   aio = cpsw::make_shared<CTstAIO>();
+			wb->getVal( aio, &val );
+			aio->wait();
+			chk("async read errors",           aio->getNumErrors(), 0);
+			chk("async read after invalidate", val, 0xcafe);
+		}
+		chk("misses after invalidate",        cache->getMisses(), misses + 1);
+		chk("sync read after async fill",     rd(wb), 0xcafe);
+		chk("misses after async fill",        cache->getMisses(), misses + 1);
+
+	} catch ( CPSWError &e ) {
+		fprintf(stderr,"CPSW Error caught: %s\n", e.getInfo().c_str());
+		throw e;
+	}
+	}
+	if ( CpswObjCounter::report(stderr) ) {
+		printf("Leaked Objects!\n");
+		throw TestFailed();
+	}
+	printf("Test PASSED\n");
+	return 0;
+}
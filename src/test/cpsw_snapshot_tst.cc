@@ -0,0 +1,209 @@
+ //@C Copyright Notice
+ //@C ================
+ //@C This file is part of CPSW. It is subject to the license terms in the LICENSE.txt
+ //@C file found in the top-level directory of this distribution and at
+ //@C https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html.
+ //@C
+ //@C No part of CPSW, including this file, may be copied, modified, propagated, or
+ //@C distributed except according to the terms contained in the LICENSE.txt file.
+
+#include <cpsw_api_builder.h>
+#include <string.h>
+#include <stdio.h>
+#include <getopt.h>
+
+#include <udpsrv_regdefs.h>
+
+#include <cpsw_obj_cnt.h>
+#include <cpsw_tst_check.h>
+
+#define __STDC_FORMAT_MACROS
+#include <inttypes.h>
+
+#define REGS_OFF 0x4000
+#define NARR     4
+
+static uint64_t snp(Snapshot s, ScalVal_RO v)
+{
+uint64_t val;
+	s->getVal( v, &val );
+	return val;
+}
+
+static void addField(MMIODev d, const char *name, uint64_t off, unsigned bits, int lsb = 0, IField::Cacheable c = IField::UNKNOWN_CACHEABLE, unsigned nelms = 1)
+{
+IntField f = IIntField::create(name, bits, false, lsb);
+	if ( IField::UNKNOWN_CACHEABLE != c )
+		f->setCacheable( c );
+	d->addAtAddress( f, off, nelms );
+}
+
+int
+main(int argc, char **argv)
+{
+const char *ip_addr = "127.0.0.1";
+unsigned    port    = 8192;
+int         opt;
+unsigned    i;
+
+	while ( (opt = getopt(argc, argv, "p:a:")) > 0 ) {
+		switch ( opt ) {
+			case 'a': ip_addr = optarg; break;
+			case 'p':
+				if ( 1 != sscanf(optarg, "%i", &port) ) {
+					fprintf(stderr,"ERROR: Unable to scan value for option '-%c'\n", opt);
+					return 1;
+				}
+				break;
+			default:
+				fprintf(stderr,"usage: %s [-a <ip_addr>] [-p <port>]\n", argv[0]);
+				return 1;
+		}
+	}
+
+	{
+	NetIODev root;
+	try {
+		{
+		        root   = INetIODev::create("netio", ip_addr);
+		MMIODev mmio   = IMMIODev::create ("mmio",  MEM_SIZE);
+		MMIODev regs   = IMMIODev::create ("regs",  0x1010, LE);
+		MMIODev other  = IMMIODev::create ("other", 0x10,   LE);
+		MMIODev hole   = IMMIODev::create ("hole",  0x20,   LE);
+		Field   cmd    = IField::create   ("cmd",   4          );
+
+		addField( regs, "a0",     0x000, 32 );
+		addField( regs, "a1",     0x004, 32 );
+		// 8-byte gap
+		addField( regs, "a2",     0x010, 32 );
+		// adjacent; occupies 2 bytes
+		addField( regs, "bits",   0x014,  8, 4 );
+		addField( regs, "arr",    0x040, 32, 0, IField::WT_CACHEABLE, NARR );
+		addField( regs, "nc0",    0x100, 32, 0, IField::NOT_CACHEABLE );
+		addField( regs, "nc1",    0x104, 32, 0, IField::NOT_CACHEABLE );
+		addField( regs, "far",    0x1000, 32 );
+
+		addField( other, "x",     0x000, 32 );
+
+		addField( hole,  "y0",    0x000, 32 );
+		// not readable into a snapshot, in the gap
+		cmd->setCacheable( IField::NOT_CACHEABLE );
+		hole->addAtAddress( cmd,  0x008 );
+		addField( hole,  "y1",    0x010, 32 );
+
+		mmio->addAtAddress( regs,  REGS_OFF );
+		mmio->addAtAddress( other, REGS_OFF + 0x2000 );
+		mmio->addAtAddress( hole,  REGS_OFF + 0x3000 );
+
+		ProtoStackBuilder pbldr( IProtoStackBuilder::create() );
+
+		pbldr->setSRPVersion( IProtoStackBuilder::SRP_UDP_V2 );
+		pbldr->setUdpPort   (                           port );
+
+		root->addAtAddress( mmio, pbldr );
+		}
+
+		Path     p    = root->findByName("mmio/regs");
+		ScalVal  a0   = IScalVal::create( p->findByName("a0")   );
+		ScalVal  a1   = IScalVal::create( p->findByName("a1")   );
+		ScalVal  a2   = IScalVal::create( p->findByName("a2")   );
+		ScalVal  bits = IScalVal::create( p->findByName("bits") );
+		ScalVal  arr  = IScalVal::create( p->findByName("arr")  );
+		ScalVal  nc0  = IScalVal::create( p->findByName("nc0")  );
+		ScalVal  nc1  = IScalVal::create( p->findByName("nc1")  );
+		ScalVal  far  = IScalVal::create( p->findByName("far")  );
+		ScalVal  x    = IScalVal::create( root->findByName("mmio/other/x") );
+		uint32_t arrv[NARR];
+		uint64_t arrg[NARR];
+
+		a0->setVal  ( 0x11111111 );
+		a1->setVal  ( 0x22222222 );
+		a2->setVal  ( 0x33333333 );
+		bits->setVal( 0xa5       );
+		nc0->setVal ( 0x44444444 );
+		nc1->setVal ( 0x55555555 );
+		far->setVal ( 0x66666666 );
+		for ( i=0; i<NARR; i++ )
+			arrv[i] = 0x1000 + i;
+		arr->setVal( arrv, NARR );
+
+		// [0x000-0x016], [0x040-0x050], [0x100-0x108], [0x1000-0x1004]
+		Snapshot s = ISnapshot::create( p, 32 );
+		chk("number of leaves",               s->getNumScalVals(), 8);
+		chk("number of reads",                s->getNumReads(), 4);
+		chk("number of bytes",                s->getNumBytes(), 0x16 + 0x10 + 8 + 4);
+
+		// no gaps bridged
+		chk("number of reads (no gaps)",      ISnapshot::create( p, 0 )->getNumReads(), 5);
+
+		// non-cacheable registers may not be read speculatively
+		chk("number of reads (large gap)",    ISnapshot::create( p, 0x1000 )->getNumReads(), 3);
+
+		// a leaf which is skipped by the snapshot but must
+		// not be read speculatively is never bridged
+		{
+		Snapshot h = ISnapshot::create( root->findByName("mmio/hole"), 32 );
+		chk("number of leaves (hole)",        h->getNumScalVals(), 2);
+		chk("number of reads (hole)",         h->getNumReads(), 2);
+		chk("number of bytes (hole)",         h->getNumBytes(), 8);
+		}
+
+		// gaps outside of a device are not bridged: regs ([0x000-0x050],
+		// [0x100-0x108], [0x1000-0x1004]), other, hole (2)
+		chk("number of reads (devices)",      ISnapshot::create( root->findByName("mmio"), 0x2000 )->getNumReads(), 6);
+
+		s->update();
+
+		// modify the device behind our back
+		a0->setVal( (uint64_t)0 );
+
+		chk("a0",                             snp(s, a0),   0x11111111);
+		chk("a1",                             snp(s, a1),   0x22222222);
+		chk("a2",                             snp(s, a2),   0x33333333);
+		chk("bits",                           snp(s, bits), 0xa5);
+		chk("nc0",                            snp(s, nc0),  0x44444444);
+		chk("nc1",                            snp(s, nc1),  0x55555555);
+		chk("far",                            snp(s, far),  0x66666666);
+
+		s->getVal( arr, arrg, NARR );
+		for ( i=0; i<NARR; i++ )
+			chk("arr",                        arrg[i], 0x1000 + i);
+
+		{
+		IndexRange rng(3);
+		s->getVal( arr, arrg, 1, &rng );
+		chk("arr[3]",                         arrg[0], 0x1003);
+		}
+
+		{
+		CString str;
+		s->getVal( a2, &str );
+		if ( *str != "858993459" ) {
+			fprintf(stderr,"CString from snapshot: got %s\n", str->c_str());
+			throw TestFailed();
+		}
+		}
+
+		s->update();
+		chk("a0 after update",                snp(s, a0),   0);
+
+		try {
+			snp(s, x);
+			fprintf(stderr,"Decoding a value outside of the snapshot should fail\n");
+			throw TestFailed();
+		} catch ( InvalidArgError & ) {
+			// expected
+		}
+
+	} catch ( CPSWError &e ) {
+		fprintf(stderr,"CPSW Error caught: %s\n", e.getInfo().c_str());
+		throw e;
+	}
+	}
+	if ( CpswObjCounter::report(stderr) ) {
+		printf("Leaked Objects!\n");
+		throw TestFailed();
+	}
+	printf("Test PASSED\n");
+	return 0;
+}
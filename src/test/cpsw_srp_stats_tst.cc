@@ -0,0 +1,254 @@
+ //@C Copyright Notice
+ //@C ================
+ //@C This file is part of CPSW. It is subject to the license terms in the LICENSE.txt
+ //@C file found in the top-level directory of this distribution and at
+ //@C https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html.
+ //@C
+ //@C No part of CPSW, including this file, may be copied, modified, propagated, or
+ //@C distributed except according to the terms contained in the LICENSE.txt file.
+
+#include <cpsw_api_builder.h>
+#include <cpsw_histogram.h>
+#include <string.h>
+#include <stdio.h>
+#include <getopt.h>
+
+#include <udpsrv_regdefs.h>
+
+#include <cpsw_obj_cnt.h>
+#include <cpsw_tst_check.h>
+#include <yaml-cpp/yaml.h>
+
+#define __STDC_FORMAT_MACROS
+#include <inttypes.h>
+
+#define REGS_OFF 0x3000
+#define NREADS   100
+#define NASYNC   10
+#define NHEDGED  2000
+#define BUDGET   5
+
+// percentile 'got' must lie within the bucket width of 'exp'
+static void chkPct(const char *what, uint64_t got, uint64_t exp)
+{
+	if ( got < exp || got > exp + (exp >> CLatencyHistogram::SUB_BITS) ) {
+		fprintf(stderr, "%s: got %" PRIu64 ", expected %" PRIu64 " (+12.5%%)\n", what, got, exp);
+		throw TestFailed();
+	}
+}
+
+static void testHistogram()
+{
+CLatencyHistogram          h;
+CLatencyHistogram::Summary s;
+unsigned                   i;
+
+	for ( i = 0; i < CLatencyHistogram::NBUCKETS; i++ ) {
+		chk("bucket of lower bound", CLatencyHistogram::bucketOf( CLatencyHistogram::lowerBound( i ) ), i);
+		chk("bucket of upper bound", CLatencyHistogram::bucketOf( CLatencyHistogram::upperBound( i ) ), i);
+		if ( i > 0 )
+			chk("buckets contiguous", CLatencyHistogram::lowerBound( i ), CLatencyHistogram::upperBound( i - 1 ) + 1);
+	}
+
+	h.summarize( &s );
+	chk("empty count", s.count_, 0);
+	chk("empty p50",   s.p50Ns_, 0);
+
+	// 1us .. 10ms
+	for ( i = 1; i <= 10000; i++ ) {
+		h.record( (uint64_t)i * 1000 );
+	}
+
+	h.summarize( &s );
+	chk   ("count", s.count_, 10000);
+	chk   ("max",   s.maxNs_, 10000000);
+	chk   ("sum",   s.sumNs_, (uint64_t)10000 * 10001 / 2 * 1000);
+	chkPct("p50",   s.p50Ns_,   5000000);
+	chkPct("p99",   s.p99Ns_,   9900000);
+	chkPct("p999",  s.p999Ns_,  9990000);
+
+	h.reset();
+	h.summarize( &s );
+	chk("count after reset", s.count_, 0);
+	chk("max after reset",   s.maxNs_, 0);
+}
+
+static NetIODev mkDev(const char *ip_addr, unsigned port, unsigned timeoutUs, unsigned retries, unsigned hedgeBudget = 0)
+{
+NetIODev root = INetIODev::create("netio", ip_addr);
+MMIODev  mmio = IMMIODev::create ("mmio",  MEM_SIZE);
+MMIODev  regs = IMMIODev::create ("regs",  0x10, LE);
+
+	regs->addAtAddress( IIntField::create("r", 32), 0 );
+	mmio->addAtAddress( regs, REGS_OFF );
+
+	ProtoStackBuilder pbldr( IProtoStackBuilder::create() );
+
+	pbldr->setSRPVersion   ( IProtoStackBuilder::SRP_UDP_V2 );
+	pbldr->setUdpPort      (                           port );
+	pbldr->setSRPTimeoutUS (                      timeoutUs );
+	pbldr->setSRPRetryCount(                        retries );
+	pbldr->setSRPHedgeBudget(                   hedgeBudget );
+
+	root->addAtAddress( mmio, pbldr );
+
+	return root;
+}
+
+int
+main(int argc, char **argv)
+{
+const char *ip_addr = "127.0.0.1";
+unsigned    port    = 8192;
+int         opt;
+unsigned    i;
+
+	while ( (opt = getopt(argc, argv, "p:a:")) > 0 ) {
+		switch ( opt ) {
+			case 'a': ip_addr = optarg; break;
+			case 'p':
+				if ( 1 != sscanf(optarg, "%i", &port) ) {
+					fprintf(stderr,"ERROR: Unable to scan value for option '-%c'\n", opt);
+					return 1;
+				}
+				break;
+			default:
+				fprintf(stderr,"usage: %s [-a <ip_addr>] [-p <port>]\n", argv[0]);
+				return 1;
+		}
+	}
+
+	testHistogram();
+
+	{
+	try {
+		NetIODev   root  = mkDev( ip_addr, port, 100000, 5 );
+		Dev        top   = IDev::create("top");
+		uint64_t   val;
+
+		// the transport is not at the end of paths from 'top'
+		top->addAtAddress( root );
+
+		ScalVal    r     = IScalVal::create( top->findByName("netio/mmio/regs/r") );
+		SRPStats   stats = ISRPStats::create( top->findByName("netio/mmio/regs/r") );
+		SRPStats   nstat = ISRPStats::create( root->findByName("mmio") );
+
+		// nothing must have been recorded yet
+		chk("initial count", stats->getLatency().count_, 0);
+
+		r->setVal( 0x1234 );
+		for ( i = 0; i < NREADS; i++ ) {
+			r->getVal( &val );
+			chk("readback", val, 0x1234);
+		}
+
+		ISRPStats::Latency l = stats->getLatency( ISRPStats::SYNCHRONOUS );
+		chk("sync count", l.count_, NREADS + 1);
+		chk("sync count (path from NetIODev)", nstat->getLatency( ISRPStats::SYNCHRONOUS ).count_, NREADS + 1);
+		if ( ! (l.p50Us_ > 0.0 && l.p50Us_ <= l.p99Us_ && l.p99Us_ <= l.p999Us_ && l.p999Us_ <= l.maxUs_) ) {
+			fprintf(stderr,"Inconsistent percentiles: p50 %g, p99 %g, p999 %g, max %g\n", l.p50Us_, l.p99Us_, l.p999Us_, l.maxUs_);
+			throw TestFailed();
+		}
+		chk("async count (before)", stats->getLatency( ISRPStats::ASYNCHRONOUS ).count_, 0);
+
+		// udpsrv simulates packet loss; retries and late replies
+		// are expected but no synchronous transaction may have timed out
+		chk("timeouts",       stats->getTimeouts(),      0);
+
+		{
+		uint64_t vals[NASYNC];
+		// async transactions are not retried; udpsrv may drop a
+		// request. Each failed one must have been counted as a timeout.
+		TstAIO   aio = cpsw::make_shared<CTstAIO>( NASYNC );
+			for ( i = 0; i < NASYNC; i++ ) {
+				r->getVal( aio, &vals[i] );
+			}
+			aio->wait();
+			chk("async count",    stats->getLatency( ISRPStats::ASYNCHRONOUS ).count_, NASYNC - aio->getNumErrors());
+			chk("async timeouts", stats->getTimeouts(),                                 aio->getNumErrors());
+		}
+
+		printf("Retries: %" PRIu64 ", late replies: %" PRIu64 ", TID mismatches: %" PRIu64 "\n",
+			stats->getRetries(), stats->getLateReplies(), stats->getTidMismatches());
+
+		{
+		YAML::Node n;
+			stats->dumpYaml( n );
+			chk("YAML sync count", n["synchronous"]["count"].as<uint64_t>(), NREADS + 1);
+			chk("YAML VC",         n["virtualChannel"].as<unsigned>(),     stats->getVirtualChannel());
+		}
+
+		stats->reset();
+		chk("count after reset", stats->getLatency().count_, 0);
+
+		// nobody listening
+		NetIODev   dead  = mkDev( ip_addr, 8100, 5000, 2 );
+		ScalVal_RO d     = IScalVal_RO::create( dead->findByName("mmio/regs/r") );
+		SRPStats   dstat = ISRPStats::create( dead->findByName("mmio") );
+		try {
+			d->getVal( &val );
+			fprintf(stderr,"Read from a dead port should fail\n");
+			throw TestFailed();
+		} catch ( IOError & ) {
+			// expected
+		}
+		chk("dead: retries",  dstat->getRetries(),          3);
+		chk("dead: timeouts", dstat->getTimeouts(),         1);
+		chk("dead: count",    dstat->getLatency().count_,   0);
+
+		{
+		// udpsrv drops packets occasionally; hedging might or
+		// might not kick in but must never exceed its budget
+		NetIODev   hdev  = mkDev( ip_addr, port, 100000, 5, BUDGET );
+		ScalVal    h     = IScalVal::create( hdev->findByName("mmio/regs/r") );
+		SRPStats   hstat = ISRPStats::create( hdev->findByName("mmio") );
+			h->setVal( 0x4321 );
+			for ( i = 0; i < NHEDGED; i++ ) {
+				h->getVal( &val );
+				chk("hedged readback", val, 0x4321);
+			}
+			printf("Hedges: %" PRIu64 ", won: %" PRIu64 ", throttled: %" PRIu64 "\n",
+				hstat->getHedges(), hstat->getHedgeWins(), hstat->getHedgesThrottled());
+			if (    hstat->getHedges()    > NHEDGED * BUDGET / 100
+			     || hstat->getHedgeWins() > hstat->getHedges() ) {
+				fprintf(stderr,"Hedging exceeds budget\n");
+				throw TestFailed();
+			}
+			chk("hedged: timeouts", hstat->getTimeouts(), 0);
+			// nothing is hedged without a budget
+			chk("hedges w/o budget", stats->getHedges(), 0);
+		}
+
+		try {
+			ProtoStackBuilder b( IProtoStackBuilder::create() );
+			b->setSRPHedgeBudget( 101 );
+			fprintf(stderr,"Hedge budget > 100%% should be rejected\n");
+			throw TestFailed();
+		} catch ( InvalidArgError & ) {
+			// expected
+		}
+
+		{
+		MemDev mem = IMemDev::create("mem", 0x10);
+			mem->addAtAddress( IIntField::create("x", 32) );
+			try {
+				ISRPStats::create( mem->findByName("x") );
+				fprintf(stderr,"Stats of a path without SRP transport should not exist\n");
+				throw TestFailed();
+			} catch ( InvalidArgError & ) {
+				// expected
+			}
+		}
+
+	} catch ( CPSWError &e ) {
+		fprintf(stderr,"CPSW Error caught: %s\n", e.getInfo().c_str());
+		throw e;
+	}
+	}
+	if ( CpswObjCounter::report(stderr) ) {
+		printf("Leaked Objects!\n");
+		throw TestFailed();
+	}
+	printf("Test PASSED\n");
+	return 0;
+}
@@ -9,8 +9,12 @@
 
 #include <cpsw_api_builder.h>
 #include <cpsw_mutex.h>
+#include <cpsw_srp_addr.h>
+#include <cpsw_proto_mod_udp.h>
 
 #include <string.h>
+#include <string>
+#include <unistd.h>
 #include <stdio.h>
 #include <stdlib.h>
 #define __STDC_FORMAT_MACROS
@@ -75,14 +79,22 @@ static CMtx mtx_;
 
 CMtx M::mtx_;
 
+// Multiple threads may work on disjoint slices of the same array
+struct TstArg {
+	intptr_t  vc_idx;
+	unsigned  lo, hi;
+	pthread_t tid;
+};
+
 static void* test_thread(void* arg)
 {
 char nm[100];
 int loops = 20;
-intptr_t vc_idx = reinterpret_cast<intptr_t>(arg);
+TstArg  *targ   = static_cast<TstArg*>(arg);
+intptr_t vc_idx = targ->vc_idx;
 void *rval = (void*)-1;
 
-	sprintf(nm, "comm/mmio_vc_%" PRIdPTR "/val", vc_idx);
+	sprintf(nm, "comm/mmio_vc_%" PRIdPTR "/val[%u-%u]", vc_idx, targ->lo, targ->hi);
 	printf("starting test thread %s\n", nm);
 
 	try {
@@ -111,7 +123,7 @@ void *rval = (void*)-1;
 				for ( unsigned i=0; i<myData.getNelms(); i++ ) {
 					M::ELT got, exp;
 					if ( (exp = myData.mem_[loops&1][i]) != (got = myData.mem_[2][i]) ) {
-						printf("@[%d == addr 0x%" PRIxPTR "]: got ", i, REGBASE + REG_ARR_OFF + 4*i + (vc_idx - 1)*sizeof(M::ELT));
+						printf("@[%d == addr 0x%" PRIxPTR "]: got ", i + targ->lo, REGBASE + REG_ARR_OFF + 2*sizeof(M::ELT)*(i + targ->lo) + (vc_idx - 1)*sizeof(M::ELT));
 						printf(xFMT, got);
 						printf(", expected ");
 						printf(xFMT, exp);
@@ -139,6 +151,95 @@ bail:
 	return rval;
 }
 
+// A read-modify-write of a bit-field must not lose a concurrent plain
+// write to the same word: the plain writer stores a counter, the other
+// thread keeps updating a nibble in byte 0 (bits 27..24 of the big-endian
+// word). Whatever the interleaving, the remaining bits must end up
+// holding the writer's last value.
+#define RMW_LOOPS 500
+
+static void* rmw_thread(void* arg)
+{
+ScalVal nib = *static_cast<ScalVal*>(arg);
+uint32_t i;
+	try {
+		for ( i=0; i<RMW_LOOPS; i++ ) {
+			nib->setVal( i & 0xf );
+		}
+	} catch (CPSWError &e) {
+		fprintf(stderr,"CPSW Error in RMW thread: %s\n", e.getInfo().c_str());
+		return (void*)-1;
+	}
+	return (void*)0;
+}
+
+static bool rmw_test(MMIODev mmio)
+{
+pthread_t tid;
+void     *stat;
+uint32_t  i, got;
+
+	IntField wrd = IIntField::create("rmw_wrd", 32, false, 0);
+	IntField nib = IIntField::create("rmw_nib",  4, false, 0);
+	mmio->addAtAddress( wrd, REGBASE + REG_ARR_OFF );
+	mmio->addAtAddress( nib, REGBASE + REG_ARR_OFF );
+
+	ScalVal w = IScalVal::create( IDev::getRootDev()->findByName("comm/mmio_vc_1/rmw_wrd") );
+	ScalVal n = IScalVal::create( IDev::getRootDev()->findByName("comm/mmio_vc_1/rmw_nib") );
+
+	if ( pthread_create( &tid, 0, rmw_thread, &n ) ) {
+		perror("pthread_create failed");
+		return false;
+	}
+	for ( i=1; i<=RMW_LOOPS; i++ ) {
+		w->setVal( i );
+	}
+	if ( pthread_join( tid, &stat ) || stat ) {
+		fprintf(stderr,"RMW thread failed\n");
+		return false;
+	}
+	w->getVal( &got );
+	if ( (got & ~0x0f000000) != RMW_LOOPS ) {
+		fprintf(stderr,"RMW lost a concurrent write: got 0x%08" PRIx32 ", expected 0x%08" PRIx32 " outside of bits 27..24\n", got, (uint32_t)RMW_LOOPS);
+		return false;
+	}
+	return true;
+}
+
+// whether the YAML dump of 'top' mentions 'key'
+static bool dumpHas(Entry top, const char *fnam, const char *key)
+{
+FILE        *f;
+char         buf[1024];
+std::string  yaml;
+size_t       got;
+
+	IYamlSupport::dumpYamlFile( top, fnam, "root" );
+	if ( ! (f = fopen( fnam, "r" )) ) {
+		perror("unable to read YAML dump");
+		throw TestFailed();
+	}
+	while ( (got = fread( buf, 1, sizeof(buf), f )) > 0 )
+		yaml.append( buf, got );
+	fclose( f );
+	unlink( fnam );
+	return std::string::npos != yaml.find( key );
+}
+
+// the UDP module underneath 'p'
+static ProtoModUdp findUdp(ConstPath p)
+{
+ProtoMod    m;
+ProtoModUdp udp;
+
+	for ( m = CSRPAddressImpl::findTransport( p )->getProtoStack()->getProtoMod(); m; m = m->getUpstreamProtoMod() ) {
+		if ( (udp = cpsw::dynamic_pointer_cast<ProtoModUdp::element_type>( m )) )
+			return udp;
+	}
+	fprintf(stderr,"No UDP module found\n");
+	throw TestFailed();
+}
+
 int
 main(int argc, char **argv)
 {
@@ -146,31 +247,45 @@ IProtoStackBuilder::SRPProtoVersion vers = IProtoStackBuilder::SRP_UDP_V2;
 int port = 0;
 int vc1  = 81;
 int vc2  = 17;
-bool have_even = false;
-bool have_odd  = false;
-bool do_even   = true;
-bool do_odd    = true;
 int  ivers     = 2;
+int  maxOut    = 0;
+int  nthreads  = 1;
+int  nstarted  = 0;
+int  i, j;
 int *i_p;
 int  opt;
 int  rval      = 1;
 int  useRssi   = 0;
 int  tDest     = -1;
 int  depack2   = 0;
-
-	while ( (opt = getopt(argc, argv, "hV:p:r2")) > 0 ) {
+int  inl       = 0;
+int  poolSize  = -1;
+int  uring     = 0;
+int  rmw       = 0;
+int  shards    = 0;
+int  busyPoll  = 0;
+
+	while ( (opt = getopt(argc, argv, "hV:p:r2w:n:IP:US:B:M")) > 0 ) {
 		i_p = 0;
 		switch ( opt ) {
 			case 'V': i_p = &ivers; break;
 			case 'p': i_p = &port;  break;
 			case 'r': useRssi = 1;  break;
 			case '2': depack2 = 1;  break;
+			case 'w': i_p = &maxOut;   break;
+			case 'n': i_p = &nthreads; break;
+			case 'I': inl     = 1;  break;
+			case 'P': i_p = &poolSize; break;
+			case 'U': uring   = 1;  break;
+			case 'S': i_p = &shards;   break;
+			case 'B': i_p = &busyPoll; break;
+			case 'M': rmw     = 1;  break;
 			case 'h':
 				rval = 0;
 				/* fall thru */
 			default:
 				fprintf(stderr,"Unknown option '-%c'\n", opt);
-				fprintf(stderr,"usage: %s [-V <proto_vers>] [-p <dest_port>] [-2] [-r] [-h]\n", argv[0]);
+				fprintf(stderr,"usage: %s [-V <proto_vers>] [-p <dest_port>] [-2] [-r] [-w <max_outstanding>] [-n <threads_per_vc>] [-I] [-P <io_pool_workers>] [-U] [-S <rx_shards>] [-B <busy_poll_us>] [-M] [-h]\n", argv[0]);
 				return rval;
 		}
 		if ( i_p && 1 != sscanf(optarg,"%i",i_p) ) {
@@ -179,6 +294,11 @@ int  depack2   = 0;
 		}
 	}
 
+	if ( nthreads < 1 ) {
+		fprintf(stderr,"Invalid number of threads '%i'\n", nthreads);
+		return 1;
+	}
+
 	switch ( ivers ) {
 		case 3: vers = IProtoStackBuilder::SRP_UDP_V3; break;
 		case 2: vers = IProtoStackBuilder::SRP_UDP_V2; break;
@@ -209,7 +329,12 @@ int  depack2   = 0;
 	}
 
 	try {
+		if ( poolSize >= 0 ) {
+			INetIODev::setIOPoolSize( poolSize );
+		}
+
 		NetIODev comm = INetIODev::create("comm", 0);
+		comm->useIOPool( poolSize >= 0 );
 		MMIODev  mmio_vc_1 = IMMIODev::create("mmio_vc_1",0x10000,BE);
 		MMIODev  mmio_vc_2 = IMMIODev::create("mmio_vc_2",0x10000,BE);
 
@@ -219,6 +344,22 @@ int  depack2   = 0;
 //		bldr->setSRPDefaultWriteMode( SYNCHRONOUS );
 		bldr->setUdpPort          (    port );
 		bldr->useRssi             ( useRssi );
+		bldr->setSRPMuxRunToCompletion( inl );
+		if ( uring ) {
+			// batch TX so that the ring is used for sending, too
+			bldr->setUdpIOUring    (    true );
+			bldr->setUdpTxBatchSize(       4 );
+		}
+		if ( shards > 0 ) {
+			bldr->setUdpShardedRx  (    true );
+			bldr->setUdpNumRxThreads( shards );
+		}
+		if ( busyPoll > 0 ) {
+			bldr->setSRPBusyPollUS( busyPoll );
+		}
+		if ( maxOut > 0 ) {
+			bldr->setSRPMaxOutstanding( maxOut );
+		}
 		if ( tDest >= 0 ) {
 			bldr->setTDestMuxTDEST(   tDest );
 			if ( depack2 ) {
@@ -242,45 +383,85 @@ int  depack2   = 0;
 		mmio_vc_1->addAtAddress( f, REGBASE + REG_ARR_OFF + 0,              nelms, 2*sizeof(M::ELT) );
 		mmio_vc_2->addAtAddress( f, REGBASE + REG_ARR_OFF + sizeof(M::ELT), nelms, 2*sizeof(M::ELT) );
 
-		pthread_t even_tid;
-		pthread_t odd_tid;
+		TstArg *targs = new TstArg[2*nthreads];
+
+		unsigned slice = nelms / nthreads;
 
-		if ( do_even ) {
-			if ( pthread_create( &even_tid, 0, test_thread, (void*)1 ) ) {
+		for ( i = 0; i < 2*nthreads; i++ ) {
+			j = i % nthreads;
+			targs[i].vc_idx = 1 + i / nthreads;
+			targs[i].lo     = j * slice;
+			targs[i].hi     = ( j == nthreads - 1 ? nelms : (j + 1) * slice ) - 1;
+			if ( pthread_create( &targs[i].tid, 0, test_thread, &targs[i] ) ) {
 				perror("pthread_create failed");
-				throw TestFailed();
+				break;
 			}
-			have_even = true;
+			nstarted++;
 		}
 
-		if ( do_odd ) {
-			if ( pthread_create( &odd_tid, 0, test_thread, (void*)2 ) ) {
-				perror("pthread_create failed");
-				throw TestFailed();
+		void *stat;
+		bool  failed = ( nstarted < 2*nthreads );
+
+		for ( i = 0; i < nstarted; i++ ) {
+			if ( pthread_join( targs[i].tid, &stat ) ) {
+				perror("pthread_join");
+				failed = true;
+			} else if ( stat ) {
+				fprintf(stderr,"Tester (vc %" PRIdPTR ", [%u-%u]) returned failure status\n", targs[i].vc_idx, targs[i].lo, targs[i].hi);
+				failed = true;
 			}
-			have_odd = true;
 		}
 
-		void *stat;
+		delete [] targs;
 
-		if ( have_even ) {
-			if ( pthread_join( even_tid, &stat ) ) {
-				perror("pthread_join (even)");
+		if ( failed ) {
+			throw TestFailed();
+		}
+
+		if ( rmw && ! rmw_test( mmio_vc_1 ) ) {
+			throw TestFailed();
+		}
+
+		if ( busyPoll > 0 ) {
+			// the RX thread competes for the replies; it usually wins
+			// so look at both VCs
+			SRPStats st1 = ISRPStats::create( comm->findByName("mmio_vc_1/val") );
+			SRPStats st2 = ISRPStats::create( comm->findByName("mmio_vc_2/val") );
+			if ( 0 == st1->getBusyPollHits() + st2->getBusyPollHits() ) {
+				fprintf(stderr,"No reply was received by busy-polling\n");
 				throw TestFailed();
 			}
-			if ( stat ) {
-				fprintf(stderr,"Even-tester returned failure status\n");
+			// and the UDP module must agree
+			ProtoModUdp udp = findUdp( comm->findByName("mmio_vc_1/val") );
+			if ( 0 == udp->getNumRxPolled() ) {
+				fprintf(stderr,"No reply was received by polling the UDP module\n");
+				udp->dumpInfo( stderr );
 				throw TestFailed();
 			}
 		}
 
-		if ( have_odd ) {
-			if ( pthread_join( odd_tid, &stat ) ) {
-				perror("pthread_join (even)");
+		if ( poolSize >= 0 ) {
+			// the pool size is not configured by the device; a dump
+			// must not pin it to the size of the running pool
+			std::string fnam = std::string( argv[0] ) + "_dump.yaml";
+			if ( dumpHas( comm, fnam.c_str(), "ioPoolSize" ) ) {
+				fprintf(stderr,"Dump of NetIODev contains 'ioPoolSize'\n");
 				throw TestFailed();
 			}
-			if ( stat ) {
-				fprintf(stderr,"Even-tester returned failure status\n");
+		}
+
+		if ( shards > 1 ) {
+			// the two VCs must be served by different shards
+			ProtoModUdp udp = findUdp( comm->findByName("mmio_vc_1/val") );
+			unsigned    busy;
+
+			for ( i = 0, busy = 0; i < (int)udp->getNumRxShards(); i++ ) {
+				if ( udp->getNumShardRxDgrams( i ) > 0 )
+					busy++;
+			}
+			if ( busy < 2 ) {
+				fprintf(stderr,"Replies received by %u shard(s) only\n", busy);
+				udp->dumpInfo( stderr );
 				throw TestFailed();
 			}
 		}
@@ -290,8 +471,6 @@ int  depack2   = 0;
 		throw;
 	} catch (TestFailed) {
 		printf("SRPMUX TEST FAILED\n");
-		if ( have_even ) {
-		}
 		throw;
 	}
 	printf("SRPMUX TEST PASSED\n");
@@ -58,12 +58,26 @@ unsigned    nelms = arr->getNelms();
 TYPE        buf[nelms];
 unsigned    i;
 
-		if ( patt ) {
-			arr->setVal(patt);
+		if ( async ) {
+			AIO aio = AIO( new CAIO() );
+			if ( patt ) {
+				arr->setVal(aio, patt);
+			} else {
+				for ( i=0; i<nelms; i++ )
+					buf[i] = i;
+				arr->setVal( aio, buf, nelms );
+			}
+			// source buffer may be reused once setVal returns
+			memset(buf, ~patt, nelms*sizeof(buf[0]));
+			aio->wait();
 		} else {
-			for ( i=0; i<nelms; i++ )
-				buf[i] = i;
-			arr->setVal( buf, nelms );
+			if ( patt ) {
+				arr->setVal(patt);
+			} else {
+				for ( i=0; i<nelms; i++ )
+					buf[i] = i;
+				arr->setVal( buf, nelms );
+			}
 		}
 		
 		memset(buf, ~patt, nelms*sizeof(buf[0]));
@@ -112,22 +126,24 @@ int         depack2 = 0;
 unsigned    vers    = 3;
 unsigned    tdest   = 1000; /* off */
 unsigned    port    = 0;
+unsigned    depth   = 0; /* default */
 unsigned   *u_p;
 int         opt;
 
 IProtoStackBuilder::SRPProtoVersion pvers;
 
-	while ( (opt = getopt(argc, argv, "V:p:t:2h")) > 0 ) {
+	while ( (opt = getopt(argc, argv, "V:p:t:P:2h")) > 0 ) {
 		u_p = 0;
 		switch ( opt ) {
 			case 'V': u_p = &vers;  break;
 			case 'p': u_p = &port;  break;
 			case 't': u_p = &tdest; break;
+			case 'P': u_p = &depth; break;
 			case '2': depack2 = 1;  break;
 			case 'h':
 				rval = 0; /* fall thru */
 			default:
-				fprintf(stderr,"usage: %s [-V <srp_version> ] [-p <port> ] [-t <tdest> ] [-2] [-h]\n", argv[0]);
+				fprintf(stderr,"usage: %s [-V <srp_version> ] [-p <port> ] [-t <tdest> ] [-P <pipeline_depth> ] [-2] [-h]\n", argv[0]);
 				return rval;
 		}
 		if ( u_p && (1 != sscanf(optarg, "%i", u_p)) ) {
@@ -172,6 +188,7 @@ IProtoStackBuilder::SRPProtoVersion pvers;
 		pbldr->setSRPVersion(                 pvers );
 		pbldr->setUdpPort   (                  port );
 		pbldr->useRssi      (                  true );
+		pbldr->setSRPPipelineDepth(           depth );
 		if ( tdest > 255 ) {
 			pbldr->useTDestMux  (                 false );
 		} else {
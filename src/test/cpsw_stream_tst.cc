@@ -22,7 +22,7 @@ class TestFailed {};
 
 static void usage(const char *nm)
 {
-	fprintf(stderr,"Usage: %s [-h] [-s <port>] [-q <input_queue_depth>] [-Q <output queue depth>] [-L <log2(frameWinSize)>] [-l <fragWinSize>] [-T <timeout_us>] [-e err_percent] [-n n_frames] [-R] [-y dump-yaml] [-Y load-yaml] [-2]\n", nm);
+	fprintf(stderr,"Usage: %s [-h] [-s <port>] [-q <input_queue_depth>] [-Q <output queue depth>] [-L <log2(frameWinSize)>] [-l <fragWinSize>] [-T <timeout_us>] [-e err_percent] [-n n_frames] [-R] [-b rx_batch] [-B tx_batch] [-U tx_batch_us] [-O] [-I] [-y dump-yaml] [-Y load-yaml] [-2]\n", nm);
 }
 
 #define STRT(chnl) (0x01<<(chnl))
@@ -250,6 +250,11 @@ int      depack2     = 0;
 unsigned ngood       = NGOOD;
 int      quiet       = 1;
 unsigned nUdpThreads = 4;
+unsigned rxBatch     = 0;
+unsigned txBatch     = 0;
+unsigned txBatchUs   = 0;
+unsigned offload     = 0;
+unsigned inl         = 0;
 unsigned useRssi     = 0;
 unsigned tDest       = 0;
 unsigned sport       = 8193;
@@ -279,7 +284,7 @@ StrmCtxt ctxt[NUM_STREAMS];
 		ctxt[i].tdest   = -1;
 	}
 
-	while ( (opt=getopt(argc, argv, "dl:L:hT:e:n:Rs:t:y:Y:2")) > 0 ) {
+	while ( (opt=getopt(argc, argv, "dl:L:hT:e:n:Rs:t:y:Y:2b:B:U:OI")) > 0 ) {
 		i_p = 0;
 		switch ( opt ) {
 			case 'd': debug++;               break;
@@ -296,6 +301,11 @@ StrmCtxt ctxt[NUM_STREAMS];
 			case 'Y': use_yaml    = optarg;  break;
 			case 'y': dmp_yaml    = optarg;  break;
 			case '2': depack2 = 1;           break;
+			case 'b': i_p = &rxBatch;        break;
+			case 'B': i_p = &txBatch;        break;
+			case 'U': i_p = &txBatchUs;      break;
+			case 'O': offload = 1;           break;
+			case 'I': inl     = 1;           break;
 			default:
 			case 'h': usage(argv[0]); return 1;
 		}
@@ -346,6 +356,10 @@ try {
 		bldr->setUdpPort             (                            sport );
 		bldr->setUdpOutQueueDepth    (                          iQDepth );
 		bldr->setUdpNumRxThreads     (                      nUdpThreads );
+		bldr->setUdpRxBatchSize      (                          rxBatch );
+		bldr->setUdpTxBatchSize      (                          txBatch );
+		bldr->setUdpTxBatchUS        (                        txBatchUs );
+		bldr->setUdpSegmentOffload   (                          offload );
 	if ( depack2 ) {
 		bldr->setDepackVersion       ( IProtoStackBuilder::DEPACKETIZER_V2 );
 	}
@@ -353,6 +367,8 @@ try {
 		bldr->setDepackLdFrameWinSize(                   ldFrameWinSize );
 		bldr->setDepackLdFragWinSize (                    ldFragWinSize );
 		bldr->useRssi                (                          useRssi );
+		bldr->setDepackRunToCompletion(                             inl );
+		bldr->setTDestMuxRunToCompletion(                           inl );
 		if ( depack2 && tDest > 254 ) {
 			tDest = 0;
 		}
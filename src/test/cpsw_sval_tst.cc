@@ -632,6 +632,25 @@ v_be->getPath()->dump(stdout); std::cout << "\n";
 					throw TestFailed("unsigned <-> double mismatch");
 				}
 			}
+
+			// asynchronous write
+			for ( unsigned i=0; i<nelms; i++ )
+				dbl[i] = (double)(4-(int)i);
+
+			got = d_arr->setVal(wai, dbl, nelms);
+			if ( got != nelms )
+				throw TestFailed("double async write -- wrote less elements than expected");
+			wai->wait();
+
+			v_arr = IScalVal::create( root->findByName( nam ) );
+			v_arr->getVal(u16, nelms);
+
+			for ( int i=0; i<(int)nelms; i++ ) {
+				if ( (int16_t)u16[i] != 4-i ) {
+					printf("u16[%d]: %d - expected %d\n", i, (int16_t)u16[i], 4-i);
+					throw TestFailed("double async write mismatch");
+				}
+			}
 	}
 
 }
@@ -0,0 +1,207 @@
+ //@C Copyright Notice
+ //@C ================
+ //@C This file is part of CPSW. It is subject to the license terms in the LICENSE.txt
+ //@C file found in the top-level directory of this distribution and at
+ //@C https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html.
+ //@C
+ //@C No part of CPSW, including this file, may be copied, modified, propagated, or
+ //@C distributed except according to the terms contained in the LICENSE.txt file.
+
+// Receive length-prefixed frames over TCP and verify them. A plain
+// socket acts as the peer; it writes the stream in pieces which ignore
+// the frame boundaries so that length headers and frames straddle the
+// reads (and the end of the receive slab). Some frames are bigger than
+// a slab.
+//
+// Option -u receives with io_uring.
+
+#include <cpsw_api_builder.h>
+#include <cpsw_proto_mod_tcp.h>
+#include <cpsw_tst_check.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <pthread.h>
+#include <vector>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+
+#define NFRAMES 400
+#define MAXPIECE 20000
+
+static uint32_t lcg(uint32_t *s)
+{
+	*s = *s * 1664525 + 1013904223;
+	return *s >> 8;
+}
+
+static uint8_t pattern(unsigned frame, unsigned off)
+{
+	return (uint8_t)(frame*13 + off + (off >> 8));
+}
+
+static uint32_t frameSize(unsigned frame, uint32_t *seed)
+{
+	// sizes around (and beyond) what fits a slab
+	switch ( frame % 50 ) {
+		case 10: return IBuf::CAPA_SLAB - 4; // header + frame fill a slab
+		case 20: return IBuf::CAPA_SLAB - 3;
+		case 30: return IBuf::CAPA_SLAB + 1;
+		case 40: return 3*IBuf::CAPA_SLAB + 17;
+		default: break;
+	}
+	return 1 + lcg( seed ) % 9000;
+}
+
+struct Peer {
+	int                  sd_;
+	std::vector<uint8_t> stream_;
+	bool                 ok_;
+};
+
+// write the stream in pieces of random size with occasional pauses
+static void *writer(void *arg)
+{
+Peer     *p    = (Peer*)arg;
+uint32_t  seed = 1;
+size_t    off, n;
+ssize_t   put;
+
+	p->ok_ = false;
+	for ( off = 0; off < p->stream_.size(); off += put ) {
+		n = 1 + lcg( &seed ) % MAXPIECE;
+		if ( n > p->stream_.size() - off )
+			n = p->stream_.size() - off;
+		if ( (put = ::write( p->sd_, &p->stream_[off], n )) <= 0 ) {
+			perror("peer write");
+			return 0;
+		}
+		if ( 0 == lcg( &seed ) % 4 )
+			usleep( 1000 );
+	}
+	p->ok_ = true;
+	return 0;
+}
+
+int
+main(int argc, char **argv)
+{
+int                  lsd;
+struct sockaddr_in   sa;
+socklen_t            sl = sizeof(sa);
+int                  opt, one = 1;
+bool                 useUring = false;
+uint32_t             seed     = 7;
+uint32_t             siz[NFRAMES];
+uint32_t             len;
+unsigned             i, off;
+uint64_t             tot;
+Peer                 peer;
+pthread_t            tid;
+std::vector<uint8_t> buf;
+CTimeout             tmo( 5000000 );
+
+	while ( (opt = getopt(argc, argv, "u")) > 0 ) {
+		switch ( opt ) {
+			case 'u': useUring = true; break;
+			default:
+				fprintf(stderr,"usage: %s [-u]\n", argv[0]);
+				return 1;
+		}
+	}
+
+	// the stream
+	for ( i = 0, tot = 0; i < NFRAMES; i++ ) {
+		siz[i] = frameSize( i, &seed );
+		len    = htonl( siz[i] );
+		peer.stream_.insert( peer.stream_.end(), (uint8_t*)&len, (uint8_t*)&len + sizeof(len) );
+		for ( off = 0; off < siz[i]; off++ )
+			peer.stream_.push_back( pattern( i, off ) );
+		tot += siz[i];
+	}
+
+	if ( (lsd = ::socket( AF_INET, SOCK_STREAM, 0 )) < 0 ) {
+		perror("socket");
+		return 1;
+	}
+	memset( &sa, 0, sizeof(sa) );
+	sa.sin_family      = AF_INET;
+	sa.sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+	sa.sin_port        = 0;
+	if ( ::bind( lsd, (struct sockaddr*)&sa, sizeof(sa) ) || ::getsockname( lsd, (struct sockaddr*)&sa, &sl ) || ::listen( lsd, 1 ) ) {
+		perror("bind/listen");
+		return 1;
+	}
+
+	try {
+	// connects right away
+	ProtoModTcp tcp  = CShObj::create<ProtoModTcp>( &sa,
+	                                                (unsigned) 16,
+	                                                (int)      IProtoStackBuilder::DFLT_THREAD_PRIORITY,
+	                                                (const LibSocksProxy*)     0,
+	                                                (const struct sockaddr_in*)0,
+	                                                useUring );
+	ProtoDoor   door = tcp->open();
+
+		if ( (peer.sd_ = ::accept( lsd, 0, 0 )) < 0 ) {
+			perror("accept");
+			throw TestFailed();
+		}
+		// don't let the peer coalesce the pieces
+		if ( ::setsockopt( peer.sd_, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one) ) ) {
+			perror("setsockopt(TCP_NODELAY)");
+			throw TestFailed();
+		}
+
+		tcp->modStartupOnce();
+
+		if ( pthread_create( &tid, 0, writer, &peer ) ) {
+			perror("pthread_create");
+			throw TestFailed();
+		}
+
+		for ( i = 0; i < NFRAMES; i++ ) {
+			BufChain bc = door->pop( &tmo, IProtoPort::REL_TIMEOUT );
+			if ( ! bc ) {
+				fprintf(stderr,"Frame %u not received\n", i);
+				throw TestFailed();
+			}
+			chk("frame size", bc->getSize(), siz[i]);
+			buf.resize( siz[i] );
+			bc->extract( &buf[0], 0, siz[i] );
+			for ( off = 0; off < siz[i]; off++ ) {
+				if ( buf[off] != pattern( i, off ) ) {
+					fprintf(stderr,"Frame %u (%u bytes): data mismatch at %u\n", i, siz[i], off);
+					throw TestFailed();
+				}
+			}
+		}
+
+		pthread_join( tid, 0 );
+		if ( ! peer.ok_ )
+			throw TestFailed("peer failed to write");
+
+		chk("RX frames", tcp->getNumRxDgrams(), NFRAMES);
+		chk("RX octets", tcp->getNumRxOctets(), tot);
+
+		printf("io_uring: %c\n", tcp->hasIOUringRx() ? 'Y' : 'N');
+		tcp->dumpInfo( stdout );
+
+		door.reset();
+		tcp->modShutdownOnce();
+		close( peer.sd_ );
+
+	} catch ( CPSWError &e ) {
+		fprintf(stderr,"CPSW Error caught: %s\n", e.getInfo().c_str());
+		throw;
+	}
+
+	close( lsd );
+
+	printf("Test PASSED\n");
+	return 0;
+}
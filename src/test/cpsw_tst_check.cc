@@ -0,0 +1,54 @@
+ //@C Copyright Notice
+ //@C ================
+ //@C This file is part of CPSW. It is subject to the license terms in the LICENSE.txt
+ //@C file found in the top-level directory of this distribution and at
+ //@C https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html.
+ //@C
+ //@C No part of CPSW, including this file, may be copied, modified, propagated, or
+ //@C distributed except according to the terms contained in the LICENSE.txt file.
+
+#include <cpsw_tst_check.h>
+#include <stdio.h>
+
+#define __STDC_FORMAT_MACROS
+#include <inttypes.h>
+
+void chk(const char *what, uint64_t got, uint64_t exp)
+{
+	if ( got != exp ) {
+		fprintf(stderr, "%s: got %" PRIu64 " (0x%" PRIx64 "), expected %" PRIu64 " (0x%" PRIx64 ")\n", what, got, got, exp, exp);
+		throw TestFailed( what );
+	}
+}
+
+CTstAIO::CTstAIO(unsigned pending)
+: pending_( pending ),
+  errors_ ( 0       )
+{
+}
+
+void
+CTstAIO::callback(CPSWError *err)
+{
+CMtx::lg guard( this );
+	if ( err )
+		errors_++;
+	if ( 0 == --pending_ )
+		pthread_cond_signal( CCond::getp() );
+}
+
+void
+CTstAIO::wait()
+{
+CMtx::lg guard( this );
+	while ( pending_ ) {
+		pthread_cond_wait( CCond::getp(), CMtx::getp() );
+	}
+}
+
+unsigned
+CTstAIO::getNumErrors()
+{
+CMtx::lg guard( this );
+	return errors_;
+}
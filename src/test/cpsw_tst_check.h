@@ -0,0 +1,54 @@
+ //@C Copyright Notice
+ //@C ================
+ //@C This file is part of CPSW. It is subject to the license terms in the LICENSE.txt
+ //@C file found in the top-level directory of this distribution and at
+ //@C https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html.
+ //@C
+ //@C No part of CPSW, including this file, may be copied, modified, propagated, or
+ //@C distributed except according to the terms contained in the LICENSE.txt file.
+
+#ifndef CPSW_TST_CHECK_H
+#define CPSW_TST_CHECK_H
+
+// helpers shared by the test programs
+
+#include <cpsw_api_user.h>
+#include <cpsw_mutex.h>
+#include <cpsw_condvar.h>
+#include <stdint.h>
+#include <string>
+
+class TestFailed {
+public:
+	std::string msg_;
+
+	TestFailed(const char *m = "")
+	: msg_(m)
+	{
+	}
+};
+
+// throw TestFailed (after printing a message) if 'got' != 'exp'
+void chk(const char *what, uint64_t got, uint64_t exp);
+
+// Completion of a number of asynchronous operations. Errors are
+// counted (the error type is lost when the completion clones it).
+class CTstAIO;
+typedef shared_ptr<CTstAIO> TstAIO;
+
+class CTstAIO : public CMtx, public CCond, public IAsyncIO {
+private:
+	unsigned pending_;
+	unsigned errors_;
+public:
+	CTstAIO(unsigned pending = 1);
+
+	virtual void     callback(CPSWError *err);
+
+	// block until all operations have completed
+	virtual void     wait();
+
+	virtual unsigned getNumErrors();
+};
+
+#endif
@@ -0,0 +1,238 @@
+ //@C Copyright Notice
+ //@C ================
+ //@C This file is part of CPSW. It is subject to the license terms in the LICENSE.txt
+ //@C file found in the top-level directory of this distribution and at
+ //@C https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html.
+ //@C
+ //@C No part of CPSW, including this file, may be copied, modified, propagated, or
+ //@C distributed except according to the terms contained in the LICENSE.txt file.
+
+// Exercise UDP segmentation offload over loopback. A plain socket
+// acts as the peer; it receives our GSO batches and sends GSO packets
+// back which the (GRO-enabled) RX thread must split.
+
+#include <cpsw_api_builder.h>
+#include <cpsw_proto_mod_udp.h>
+#include <cpsw_tst_check.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/udp.h>
+#include <arpa/inet.h>
+
+#define __STDC_FORMAT_MACROS
+#include <inttypes.h>
+
+#ifndef SOL_UDP
+#define SOL_UDP     17
+#endif
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103
+#endif
+
+#define NSEGS 16
+
+static uint8_t pattern(unsigned run, unsigned seg, unsigned off)
+{
+	return (uint8_t)(run*31 + seg*7 + off);
+}
+
+static unsigned segLen(unsigned segSize, unsigned seg)
+{
+	// last one is short
+	return NSEGS - 1 == seg ? segSize/2 : segSize;
+}
+
+static void fill(uint8_t *buf, unsigned run, unsigned segSize)
+{
+unsigned seg, off;
+	for ( seg = 0; seg < NSEGS; seg++ ) {
+		for ( off = 0; off < segLen( segSize, seg ); off++ ) {
+			*buf++ = pattern( run, seg, off );
+		}
+	}
+}
+
+static void check(const uint8_t *buf, unsigned len, unsigned run, unsigned seg, unsigned segSize)
+{
+unsigned off;
+	if ( len != segLen( segSize, seg ) ) {
+		fprintf(stderr,"Run %u, segment %u: got %u bytes, expected %u\n", run, seg, len, segLen( segSize, seg ));
+		throw TestFailed();
+	}
+	for ( off = 0; off < len; off++ ) {
+		if ( buf[off] != pattern( run, seg, off ) ) {
+			fprintf(stderr,"Run %u, segment %u: data mismatch at %u\n", run, seg, off);
+			throw TestFailed();
+		}
+	}
+}
+
+// push a batch from CPSW; the peer must see individual datagrams
+static void testTx(ProtoDoor door, int peer, struct sockaddr_in *from, unsigned run, unsigned segSize)
+{
+static uint8_t buf[65536];
+unsigned       seg;
+int            got;
+socklen_t      sl;
+
+	fill( buf, run, segSize );
+	for ( seg = 0; seg < NSEGS; seg++ ) {
+		BufChain bc = IBufChain::create();
+		bc->insert( buf + seg*segSize, 0, segLen( segSize, seg ) );
+		if ( ! door->push( bc, &TIMEOUT_INDEFINITE, IProtoPort::REL_TIMEOUT ) ) {
+			fprintf(stderr,"Push failed\n");
+			throw TestFailed();
+		}
+	}
+
+	for ( seg = 0; seg < NSEGS; seg++ ) {
+		sl  = sizeof(*from);
+		got = ::recvfrom( peer, buf, sizeof(buf), 0, (struct sockaddr*)from, &sl );
+		if ( got < 0 ) {
+			perror("peer recvfrom");
+			throw TestFailed();
+		}
+		check( buf, got, run, seg, segSize );
+	}
+}
+
+// send a GSO packet from the peer; CPSW must deliver the segments
+static void testRx(ProtoDoor door, int peer, struct sockaddr_in *to, unsigned run, unsigned segSize)
+{
+static uint8_t buf[65536];
+union {
+	char           buf_[ CMSG_SPACE( sizeof(uint16_t) ) ];
+	struct cmsghdr align_;
+}              ctrl;
+struct iovec   iov;
+struct msghdr  mh;
+struct cmsghdr *cmsg;
+unsigned       seg;
+CTimeout       tmo( 2000000 );
+
+	fill( buf, run, segSize );
+	iov.iov_base = buf;
+	iov.iov_len  = (NSEGS - 1)*segSize + segLen( segSize, NSEGS - 1 );
+
+	memset( &mh, 0, sizeof(mh) );
+	mh.msg_name       = to;
+	mh.msg_namelen    = sizeof(*to);
+	mh.msg_iov        = &iov;
+	mh.msg_iovlen     = 1;
+	mh.msg_control    = ctrl.buf_;
+	mh.msg_controllen = sizeof(ctrl.buf_);
+	cmsg              = CMSG_FIRSTHDR( &mh );
+	cmsg->cmsg_level  = SOL_UDP;
+	cmsg->cmsg_type   = UDP_SEGMENT;
+	cmsg->cmsg_len    = CMSG_LEN( sizeof(uint16_t) );
+	*(uint16_t*)CMSG_DATA( cmsg ) = segSize;
+
+	if ( ::sendmsg( peer, &mh, 0 ) < 0 ) {
+		perror("peer sendmsg (GSO)");
+		throw TestFailed();
+	}
+
+	for ( seg = 0; seg < NSEGS; seg++ ) {
+		BufChain bc = door->pop( &tmo, IProtoPort::REL_TIMEOUT );
+		if ( ! bc ) {
+			fprintf(stderr,"Run %u: segment %u not received\n", run, seg);
+			throw TestFailed();
+		}
+		bc->extract( buf, 0, bc->getSize() );
+		check( buf, bc->getSize(), run, seg, segSize );
+	}
+}
+
+int
+main(int argc, char **argv)
+{
+int                peer;
+struct sockaddr_in pa, ca;
+socklen_t          sl = sizeof(pa);
+struct timeval     tv;
+unsigned           run, i;
+int                val;
+unsigned           segSizes[] = { 1000, 3000 };
+bool               peerGso;
+
+	if ( (peer = ::socket( AF_INET, SOCK_DGRAM, 0 )) < 0 ) {
+		perror("socket");
+		return 1;
+	}
+	memset( &pa, 0, sizeof(pa) );
+	pa.sin_family      = AF_INET;
+	pa.sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+	pa.sin_port        = 0;
+	if ( ::bind( peer, (struct sockaddr*)&pa, sizeof(pa) ) || ::getsockname( peer, (struct sockaddr*)&pa, &sl ) ) {
+		perror("bind");
+		return 1;
+	}
+	tv.tv_sec  = 2;
+	tv.tv_usec = 0;
+	if ( ::setsockopt( peer, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv) ) ) {
+		perror("setsockopt(SO_RCVTIMEO)");
+		return 1;
+	}
+	sl      = sizeof(val);
+	peerGso = 0 == ::getsockopt( peer, SOL_UDP, UDP_SEGMENT, &val, &sl );
+
+	try {
+	ProtoModUdp udp = CShObj::create<ProtoModUdp>( &pa,
+	                                               (unsigned) 2*NSEGS,
+	                                               (int)      IProtoStackBuilder::DFLT_THREAD_PRIORITY,
+	                                               (unsigned) 1,
+	                                               (int)      0,
+	                                               (unsigned) 4,
+	                                               (unsigned) NSEGS,
+	                                               (unsigned) 1000000,
+	                                               true );
+	ProtoDoor   door = udp->open();
+
+		udp->modStartupOnce();
+
+		printf("GSO: %c, GRO: %c\n", udp->hasGso() ? 'Y' : 'N', udp->hasGro() ? 'Y' : 'N');
+
+		for ( run = 0, i = 0; i < sizeof(segSizes)/sizeof(segSizes[0]); i++ ) {
+			// twice per size
+			testTx( door, peer, &ca, run++, segSizes[i] );
+			testTx( door, peer, &ca, run++, segSizes[i] );
+		}
+
+		chk("TX dgrams", udp->getNumTxDgrams(), run*NSEGS);
+		// each batch fills up and goes out with a single syscall
+		chk("TX calls",  udp->getNumTxCalls(),  run);
+		chk("TX GSO segments", udp->getNumTxGsoSegs(), udp->hasGso() ? run*NSEGS : 0);
+
+		if ( peerGso ) {
+			for ( run = 0, i = 0; i < sizeof(segSizes)/sizeof(segSizes[0]); i++ ) {
+				testRx( door, peer, &ca, run++, segSizes[i] );
+				testRx( door, peer, &ca, run++, segSizes[i] );
+			}
+			chk("RX dgrams", udp->getNumRxDgrams(), run*NSEGS);
+			if ( udp->hasGro() ) {
+				chk("RX GRO segments", udp->getNumRxGroSegs(), run*NSEGS);
+				chk("RX calls",        udp->getNumRxCalls(),   run);
+			}
+		} else {
+			printf("Peer cannot send GSO packets; RX test skipped\n");
+		}
+
+		udp->dumpInfo( stdout );
+
+		door.reset();
+		udp->modShutdownOnce();
+
+	} catch ( CPSWError &e ) {
+		fprintf(stderr,"CPSW Error caught: %s\n", e.getInfo().c_str());
+		throw;
+	}
+
+	close( peer );
+
+	printf("Test PASSED\n");
+	return 0;
+}
@@ -0,0 +1,146 @@
+ //@C Copyright Notice
+ //@C ================
+ //@C This file is part of CPSW. It is subject to the license terms in the LICENSE.txt
+ //@C file found in the top-level directory of this distribution and at
+ //@C https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html.
+ //@C
+ //@C No part of CPSW, including this file, may be copied, modified, propagated, or
+ //@C distributed except according to the terms contained in the LICENSE.txt file.
+
+// Verify that a datagram which is pushed while another thread is
+// flushing a TX batch (and which is thus sent by that thread) reports
+// a failure to its pusher.
+//
+// The UDP module is subclassed; sending a datagram which starts
+// with BAD fails and every send is slowed down so that the second
+// push finds the first one's flush in progress.
+
+#include <cpsw_api_builder.h>
+#include <cpsw_proto_mod_udp.h>
+#include <cpsw_tst_check.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#define GOOD  0x00
+#define BAD   0xff
+#define SLOW  200000 // us
+
+class CSlowUdp;
+typedef shared_ptr<CSlowUdp> SlowUdp;
+
+class CSlowUdp : public CProtoModUdp {
+public:
+	volatile bool sending_;
+
+	CSlowUdp(Key &k, struct sockaddr_in *dest)
+	: CProtoModUdp( k, dest, 4, IProtoStackBuilder::DFLT_THREAD_PRIORITY, 1, 0, 1, 8 ),
+	  sending_( false )
+	{
+	}
+
+	virtual bool sendDgrams(BufChain *bcs, unsigned n, bool wait, const CTimeout *timeout, int sd)
+	{
+	unsigned i;
+	uint8_t  b;
+
+		sending_ = true;
+		usleep( SLOW );
+		for ( i = 0; i < n; i++ ) {
+			bcs[i]->extract( &b, 0, sizeof(b) );
+			if ( BAD == b )
+				return false;
+		}
+		return CProtoModUdp::sendDgrams( bcs, n, wait, timeout, sd );
+	}
+};
+
+struct Pusher {
+	ProtoDoor door_;
+	uint8_t   b_;
+	bool      ok_;
+};
+
+static bool push(ProtoDoor door, uint8_t b)
+{
+BufChain bc = IBufChain::create();
+	bc->insert( &b, 0, sizeof(b) );
+	return door->push( bc, &TIMEOUT_INDEFINITE, IProtoPort::REL_TIMEOUT );
+}
+
+static void *pushThread(void *arg)
+{
+Pusher *p = (Pusher*)arg;
+	p->ok_ = push( p->door_, p->b_ );
+	return 0;
+}
+
+int
+main(int argc, char **argv)
+{
+int                peer;
+struct sockaddr_in pa;
+socklen_t          sl = sizeof(pa);
+pthread_t          tid;
+Pusher             first;
+bool               ok;
+
+	if ( (peer = ::socket( AF_INET, SOCK_DGRAM, 0 )) < 0 ) {
+		perror("socket");
+		return 1;
+	}
+	memset( &pa, 0, sizeof(pa) );
+	pa.sin_family      = AF_INET;
+	pa.sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+	pa.sin_port        = 0;
+	if ( ::bind( peer, (struct sockaddr*)&pa, sizeof(pa) ) || ::getsockname( peer, (struct sockaddr*)&pa, &sl ) ) {
+		perror("bind");
+		return 1;
+	}
+
+	try {
+	SlowUdp   udp  = CShObj::create<SlowUdp>( &pa );
+	ProtoDoor door = udp->open();
+
+		udp->modStartupOnce();
+
+		// a good datagram sent by a pusher which finds the module idle
+		first.door_ = door;
+		first.b_    = GOOD;
+		first.ok_   = false;
+		if ( pthread_create( &tid, 0, pushThread, &first ) ) {
+			perror("pthread_create");
+			throw TestFailed();
+		}
+		while ( ! udp->sending_ )
+			usleep( 1000 );
+
+		// this one is appended to the batch and sent by 'first'
+		ok = push( door, BAD );
+
+		pthread_join( tid, 0 );
+		first.door_.reset();
+
+		chk("first push (good)",                first.ok_, true );
+		chk("push during flush (bad)",          ok,        false);
+		chk("push when idle (good)",            push( door, GOOD ), true);
+		chk("TX dgrams",                        udp->getNumTxDgrams(), 3);
+
+		door.reset();
+		udp->modShutdownOnce();
+
+	} catch ( CPSWError &e ) {
+		fprintf(stderr,"CPSW Error caught: %s\n", e.getInfo().c_str());
+		throw;
+	}
+
+	close( peer );
+
+	printf("Test PASSED\n");
+	return 0;
+}
@@ -103,7 +103,8 @@ try {
 
 	const char *passes[] = {
 		"true",
-		"false"
+		"false",
+		"false"  // load with posted writes
 	};
 
 	for ( unsigned pass = 0; pass < sizeof(passes)/sizeof(passes[0]); pass ++ ) {
@@ -151,7 +152,7 @@ try {
 			val2->setVal( (uint64_t) 0x00000000 );
 		} else {
 			uint64_t got;
-			if ( 16 != (got = top->loadConfigFromYaml( cnfg )) ) {
+			if ( 16 != (got = top->loadConfigFromYaml( cnfg, 2 == pass )) ) {
 				printf("got %" PRId64 "\n", got);
 				throw TestFailed("Unexpected number of config values loaded");
 			}
@@ -182,20 +183,33 @@ try {
 
 			
 		{
-		uint64_t put;
+		uint64_t   put;
+		YAML::Node prefetched;
+
+			if ( cnfg )
+				prefetched = YAML::Clone( cnfg );
 
 			put = top->dumpConfigToYaml( cnfg );
-			if ( ! ( (0 == pass && 32 == put) || (1 == pass && 16 == put)) ) {
+			if ( ! ( (0 == pass && 32 == put) || (pass >= 1 && 16 == put)) ) {
 				printf("Put %" PRId64 " (pass %d)\n", put, pass);
 				throw TestFailed("Unexpected number of config elements dumped");
 			}
+
+			// a dump with prefetched values must produce the same result
+			if ( put != top->dumpConfigToYaml( prefetched, true ) )
+				throw TestFailed("Unexpected number of config elements dumped (prefetch)");
+			YAML::Emitter e1, e2;
+			e1 << cnfg;
+			e2 << prefetched;
+			if ( std::string( e1.c_str() ) != std::string( e2.c_str() ) )
+				throw TestFailed("Config dumped with prefetch differs");
 		}
 {
 YAML::Emitter e;
 e << cnfg;
 std::cout << e.c_str() << "\n";
 }
-		if ( 1 == pass ) {
+		if ( pass >= 1 ) {
 			// 'val2' should not be present
 			YAML::const_iterator it( YAML::NodeFind<YAML::Node>(cnfg,0)["mmio"].begin() );
 			YAML::const_iterator ite( YAML::NodeFind<YAML::Node>(cnfg,0)["mmio"].end() );
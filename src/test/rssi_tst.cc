@@ -19,7 +19,10 @@ static void sh(int sig)
 
 static void usage(const char *nm)
 {
-	fprintf(stderr,"Usage: %s [-s <sleep_us>] [-n <packets>] [-L <percent dropped packets>] [-G garblDepth] [-h]\n", nm);
+	fprintf(stderr,"Usage: %s [-s <sleep_us>] [-n <packets>] [-L <percent dropped packets>] [-G garblDepth] [-W ldWindow] [-e] [-a] [-h]\n", nm);
+	fprintf(stderr,"       -a: use fixed (not adaptive) retransmission timeout\n");
+	fprintf(stderr,"       -W: log2 of the window size (max. unACKed segments)\n");
+	fprintf(stderr,"       -e: client does not support selective ACKs (EACK)\n");
 	fprintf(stderr,"Note: garbled packet depth quickly leads to out-of sequence packets\n");
 	fprintf(stderr,"      probability a packet is delayed more than N cycles is ((Depth-1)/Depth)^N\n");
 }
@@ -32,17 +35,27 @@ unsigned sleep_us                = 0;
 unsigned dropped_packets_percent = 0;
 unsigned garbl_depth             = 0;
 unsigned n_packets               = 100000;
+unsigned ld_window               = CRssiConfigParams::LD_MAX_UNACKED_SEGS_DFLT;
+unsigned loop_depth;
+bool     failed                  = false;
 int      opt;
 unsigned *i_p;
 int      rval = 1;
+CRssiConfigParams clientConfig;
+CRssiConfigParams serverConfig;
 
-	while ( (opt = getopt(argc, argv, "s:L:G:n:h")) > 0 ) {
+	while ( (opt = getopt(argc, argv, "s:L:G:n:W:eah")) > 0 ) {
 		i_p = 0;
 		switch (opt) {
 			case 's': i_p = &sleep_us;                break;
 			case 'L': i_p = &dropped_packets_percent; break;
 			case 'G': i_p = &garbl_depth;             break;
 			case 'n': i_p = &n_packets;               break;
+			case 'W': i_p = &ld_window;               break;
+
+			case 'e': clientConfig.selectiveAck_ = false; continue;
+			case 'a': clientConfig.adaptiveRex_  = false;
+			          serverConfig.adaptiveRex_  = false; continue;
 
 			case 'h': rval = 0;
 			default:
@@ -61,18 +74,32 @@ int      rval = 1;
 		return 1;
 	}
 
+	if ( ld_window > CRssiConfigParams::LD_MAX_UNACKED_SEGS_MAX ) {
+		fprintf(stderr,"requested window too large\n");
+		usage(argv[0]);
+		return 1;
+	}
+
+	clientConfig.ldMaxUnackedSegs_ = ld_window;
+	serverConfig.ldMaxUnackedSegs_ = ld_window;
+
+	// loopback must be able to hold a full window
+	loop_depth = (1 << ld_window) + 4;
+	if ( loop_depth < 32 )
+		loop_depth = 32;
+
 	if ( signal(SIGINT, sh) ) {
 		perror("Unable to install signal handler");
 	}
 
 for ( j=0; j<1; j++ ) {
-	RssiPort  server = CRssiPort::create(true);
-	RssiPort  client = CRssiPort::create(false);
+	RssiPort  server = CRssiPort::create(true, &serverConfig);
+	RssiPort  client = CRssiPort::create(false, &clientConfig);
 	ProtoPort sSink  = ISink::create("Server Sink");
 	ProtoPort cSink  = ISink::create("Client Sink", sleep_us);
 	unsigned i = 0;
 
-	LoopbackPorts loop = ILoopbackPorts::create(32,dropped_packets_percent,garbl_depth);
+	LoopbackPorts loop = ILoopbackPorts::create(loop_depth,dropped_packets_percent,garbl_depth);
 
 	printf("Loopback created\n");
 	client->attach( loop->getPortA() );
@@ -98,6 +125,28 @@ for ( j=0; j<1; j++ ) {
 	server->dumpStats(stderr);
 	client->dumpStats(stderr);
 
+	if ( serverConfig.adaptiveRex_ && 0 == server->getNumRttSamples() ) {
+		fprintf(stderr,"FAILED: no RTT measured\n");
+		failed = true;
+	}
+
+	if ( server->hasSelectiveAck() != clientConfig.selectiveAck_ || client->hasSelectiveAck() != clientConfig.selectiveAck_ ) {
+		fprintf(stderr,"FAILED: selective ACKs %snegotiated\n", clientConfig.selectiveAck_ ? "not " : "");
+		failed = true;
+	}
+
+	if ( clientConfig.selectiveAck_ ) {
+		// with loss the client EACKs out-of-order segments which
+		// the server then does not retransmit
+		if ( dropped_packets_percent > 0 && 0 == server->getNumRexSkipped() ) {
+			fprintf(stderr,"FAILED: no retransmission skipped (EACKs sent: %u)\n", client->getNumEacksSent());
+			failed = true;
+		}
+	} else if ( client->getNumEacksSent() || server->getNumEacksRcvd() || server->getNumRexSkipped() ) {
+		fprintf(stderr,"FAILED: EACKs used although disabled\n");
+		failed = true;
+	}
+
 	sSink->stop();
 	cSink->stop();
 	client->stop();
@@ -112,5 +161,5 @@ for ( j=0; j<1; j++ ) {
 		IBuf::numBufsAlloced(),
 		IBuf::numBufsInUse());
 #endif
-	return 0;
+	return failed ? 1 : 0;
 }